@@ -0,0 +1,123 @@
+/*
+ * bench-build.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Measures program build time: the first (cold) build, rebuilding the same
+   source from scratch (warm), and rebuilding from Gocl's binary cache */
+
+#include "bench-common.h"
+
+static gint num_builds = 10;
+
+static GOptionEntry entries[] =
+{
+  { "builds", 'b', 0, G_OPTION_ARG_INT, &num_builds,
+    "Number of warm and cached builds to measure (default 10)", "N" },
+  { NULL }
+};
+
+/* the salt makes the source unique to this run, so that on-disk caches left
+   by previous runs, the driver's or Gocl's, are never hit by the cold build */
+static const gchar *source_template =
+  "#define SALT %uu\n"
+  "\n"
+  "__kernel void\n"
+  "blur (__global const float *in, __global float *out, int width)\n"
+  "{\n"
+  "  int x = get_global_id (0);\n"
+  "  int y = get_global_id (1);\n"
+  "  float sum = 0.0f;\n"
+  "  int i, j;\n"
+  "\n"
+  "  for (j = -2; j <= 2; j++)\n"
+  "    for (i = -2; i <= 2; i++)\n"
+  "      sum += in[clamp (y + j, 0, width - 1) * width +\n"
+  "                clamp (x + i, 0, width - 1)];\n"
+  "\n"
+  "  out[y * width + x] = sum / 25.0f + (float) (SALT & 1);\n"
+  "}\n";
+
+static gboolean
+build (const gchar *source, gboolean use_cache, gint64 *elapsed)
+{
+  GoclProgram *program;
+  gint64 start;
+  gboolean result;
+
+  start = g_get_monotonic_time ();
+
+  program = gocl_program_new (bench_get_context (), &source, 1);
+  if (program == NULL)
+    return bench_fail ("create program");
+
+  gocl_program_set_use_cache (program, use_cache);
+  result = gocl_program_build_sync (program, "");
+
+  *elapsed = g_get_monotonic_time () - start;
+
+  g_object_unref (program);
+
+  if (! result)
+    return bench_fail ("build program");
+
+  return TRUE;
+}
+
+static gboolean
+run (void)
+{
+  gchar *source;
+  gint64 elapsed, warm_total = 0, cached_total = 0;
+  guint n, i;
+  gboolean result = FALSE;
+
+  n = MAX (num_builds, 1);
+  source = g_strdup_printf (source_template, g_random_int ());
+
+  if (! build (source, FALSE, &elapsed))
+    goto out;
+  bench_report ("cold", 0, 1, elapsed / 1000.0, "ms");
+
+  for (i = 0; i < n; i++)
+    {
+      if (! build (source, FALSE, &elapsed))
+        goto out;
+      warm_total += elapsed;
+    }
+  bench_report ("warm", 0, n, warm_total / 1000.0 / n, "ms");
+
+  /* the first build with the cache enabled populates it */
+  if (! build (source, TRUE, &elapsed))
+    goto out;
+  bench_report ("cache_populate", 0, 1, elapsed / 1000.0, "ms");
+
+  for (i = 0; i < n; i++)
+    {
+      if (! build (source, TRUE, &elapsed))
+        goto out;
+      cached_total += elapsed;
+    }
+  bench_report ("cached", 0, n, cached_total / 1000.0 / n, "ms");
+
+  result = TRUE;
+
+ out:
+  g_free (source);
+
+  return result;
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  if (bench_init (&argc, &argv, "build", entries))
+    run ();
+
+  return bench_finish ();
+}
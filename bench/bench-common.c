@@ -0,0 +1,343 @@
+/*
+ * bench-common.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+#include <string.h>
+
+#include "bench-common.h"
+
+typedef struct
+{
+  gchar *variant;
+  guint64 size;
+  guint iterations;
+  gdouble value;
+  gchar *unit;
+} Record;
+
+static const gchar *bench_name = NULL;
+
+static gchar *format = NULL;
+static gint iterations = 1000;
+static gboolean use_cpu = FALSE;
+
+static GoclContext *context = NULL;
+static GoclDevice *device = NULL;
+
+static GPtrArray *records = NULL;
+static gboolean failed = FALSE;
+
+static GMainLoop *wait_loop = NULL;
+static GError *wait_error = NULL;
+
+static GOptionEntry common_entries[] =
+{
+  { "format", 'f', 0, G_OPTION_ARG_STRING, &format,
+    "Output format, 'csv' or 'json' (default csv)", "FORMAT" },
+  { "iterations", 'n', 0, G_OPTION_ARG_INT, &iterations,
+    "Number of iterations of each measurement (default 1000)", "N" },
+  { "cpu", 'c', 0, G_OPTION_ARG_NONE, &use_cpu,
+    "Run on the default CPU context instead of the GPU one", NULL },
+  { NULL }
+};
+
+static void
+free_record (gpointer data)
+{
+  Record *record = data;
+
+  g_free (record->variant);
+  g_free (record->unit);
+  g_slice_free (Record, record);
+}
+
+static void
+print_csv (void)
+{
+  guint i;
+
+  g_print ("benchmark,variant,size,iterations,value,unit\n");
+
+  for (i = 0; i < records->len; i++)
+    {
+      Record *record = g_ptr_array_index (records, i);
+      gchar value[G_ASCII_DTOSTR_BUF_SIZE];
+
+      g_ascii_dtostr (value, sizeof (value), record->value);
+      g_print ("%s,%s,%" G_GUINT64_FORMAT ",%u,%s,%s\n",
+               bench_name,
+               record->variant,
+               record->size,
+               record->iterations,
+               value,
+               record->unit);
+    }
+}
+
+static void
+print_json (void)
+{
+  guint i;
+
+  g_print ("{\n"
+           "  \"benchmark\": \"%s\",\n"
+           "  \"gocl_version\": \"%s\",\n"
+           "  \"device_type\": \"%s\",\n"
+           "  \"results\": [",
+           bench_name,
+           GOCL_VERSION,
+           use_cpu ? "cpu" : "gpu");
+
+  for (i = 0; i < records->len; i++)
+    {
+      Record *record = g_ptr_array_index (records, i);
+      gchar value[G_ASCII_DTOSTR_BUF_SIZE];
+
+      g_ascii_dtostr (value, sizeof (value), record->value);
+      g_print ("%s\n    { \"variant\": \"%s\", \"size\": %" G_GUINT64_FORMAT
+               ", \"iterations\": %u, \"value\": %s, \"unit\": \"%s\" }",
+               i > 0 ? "," : "",
+               record->variant,
+               record->size,
+               record->iterations,
+               value,
+               record->unit);
+    }
+
+  g_print ("\n  ]\n}\n");
+}
+
+static void
+on_event_complete (GoclEvent *event,
+                   GError    *error,
+                   gpointer   user_data)
+{
+  if (error != NULL)
+    wait_error = g_error_copy (error);
+
+  g_main_loop_quit (wait_loop);
+}
+
+/* Parses the command line options common to all benchmarks plus the ones
+ * given in ENTRIES, and sets up the context and device the benchmark runs
+ * on. Returns FALSE and prints the reason if anything fails.
+ */
+gboolean
+bench_init (gint           *argc,
+            gchar        ***argv,
+            const gchar    *name,
+            GOptionEntry   *entries)
+{
+  GOptionContext *option_context;
+  GError *error = NULL;
+
+#ifndef GLIB_VERSION_2_36
+  g_type_init ();
+#endif
+
+  bench_name = name;
+  records = g_ptr_array_new_with_free_func (free_record);
+
+  option_context = g_option_context_new (NULL);
+  g_option_context_add_main_entries (option_context, common_entries, NULL);
+  if (entries != NULL)
+    g_option_context_add_main_entries (option_context, entries, NULL);
+
+  if (! g_option_context_parse (option_context, argc, argv, &error))
+    {
+      g_printerr ("%s: %s\n", bench_name, error->message);
+      g_error_free (error);
+      g_option_context_free (option_context);
+      failed = TRUE;
+      return FALSE;
+    }
+  g_option_context_free (option_context);
+
+  if (format != NULL &&
+      g_strcmp0 (format, "csv") != 0 &&
+      g_strcmp0 (format, "json") != 0)
+    {
+      g_printerr ("%s: unknown output format '%s'\n", bench_name, format);
+      failed = TRUE;
+      return FALSE;
+    }
+
+  if (iterations < 1)
+    {
+      g_printerr ("%s: iterations must be a positive number\n", bench_name);
+      failed = TRUE;
+      return FALSE;
+    }
+
+  if (use_cpu)
+    context = gocl_context_get_default_cpu_sync ();
+  else
+    context = gocl_context_get_default_gpu_sync ();
+
+  if (context == NULL)
+    return bench_fail ("create context");
+
+  device = gocl_context_get_device_by_index (context, 0);
+  if (device == NULL)
+    return bench_fail ("get device");
+
+  return TRUE;
+}
+
+/* Prints all the results reported so far in the requested format and frees
+ * the resources taken by bench_init(). Returns the exit code for main().
+ */
+gint
+bench_finish (void)
+{
+  if (records != NULL && ! failed)
+    {
+      if (g_strcmp0 (format, "json") == 0)
+        print_json ();
+      else
+        print_csv ();
+    }
+
+  if (records != NULL)
+    g_ptr_array_unref (records);
+  records = NULL;
+
+  if (wait_loop != NULL)
+    g_main_loop_unref (wait_loop);
+  wait_loop = NULL;
+
+  if (device != NULL)
+    g_object_unref (device);
+  device = NULL;
+
+  if (context != NULL)
+    g_object_unref (context);
+  context = NULL;
+
+  g_free (format);
+  format = NULL;
+
+  return failed ? 1 : 0;
+}
+
+GoclContext *
+bench_get_context (void)
+{
+  return context;
+}
+
+GoclDevice *
+bench_get_device (void)
+{
+  return device;
+}
+
+guint
+bench_get_iterations (void)
+{
+  return (guint) iterations;
+}
+
+/* Builds SOURCE in the benchmark's context and returns the kernel
+ * KERNEL_NAME from it, or NULL on error.
+ */
+GoclKernel *
+bench_build_kernel (const gchar *source, const gchar *kernel_name)
+{
+  GoclProgram *program;
+  GoclKernel *kernel = NULL;
+
+  program = gocl_program_new (context, &source, 1);
+  if (program == NULL)
+    {
+      bench_fail ("create program");
+      return NULL;
+    }
+
+  if (! gocl_program_build_sync (program, ""))
+    bench_fail ("build program");
+  else if ((kernel = gocl_program_get_kernel (program, kernel_name)) == NULL)
+    bench_fail ("get kernel");
+
+  g_object_unref (program);
+
+  return kernel;
+}
+
+/* Waits for EVENT to complete by iterating a main loop until its
+ * gocl_event_then() callback is delivered, the way asynchronous Gocl
+ * applications wait for events.
+ */
+gboolean
+bench_wait_event (GoclEvent *event)
+{
+  if (event == NULL)
+    return bench_fail ("enqueue command");
+
+  if (wait_loop == NULL)
+    wait_loop = g_main_loop_new (NULL, FALSE);
+
+  gocl_event_then (event, on_event_complete, NULL);
+  g_main_loop_run (wait_loop);
+
+  if (wait_error != NULL)
+    {
+      g_printerr ("%s: command failed: %s\n", bench_name, wait_error->message);
+      g_error_free (wait_error);
+      wait_error = NULL;
+      failed = TRUE;
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Records one measurement. VARIANT names what was measured, SIZE is the
+ * transfer size in bytes or 0 when not meaningful, and VALUE is expressed
+ * in UNIT.
+ */
+void
+bench_report (const gchar *variant,
+              guint64      size,
+              guint        num_iterations,
+              gdouble      value,
+              const gchar *unit)
+{
+  Record *record;
+
+  record = g_slice_new (Record);
+  record->variant = g_strdup (variant);
+  record->size = size;
+  record->iterations = num_iterations;
+  record->value = value;
+  record->unit = g_strdup (unit);
+
+  g_ptr_array_add (records, record);
+}
+
+/* Prints the last Gocl error for the failed step WHAT, and flags the run as
+ * failed so that no partial results are printed. Always returns FALSE.
+ */
+gboolean
+bench_fail (const gchar *what)
+{
+  GError *error;
+
+  error = gocl_error_get_last ();
+  g_printerr ("%s: failed to %s: %s\n",
+              bench_name,
+              what,
+              error != NULL ? error->message : "unknown error");
+  if (error != NULL)
+    g_error_free (error);
+
+  failed = TRUE;
+
+  return FALSE;
+}
@@ -0,0 +1,42 @@
+/*
+ * bench-common.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+#ifndef __BENCH_COMMON_H__
+#define __BENCH_COMMON_H__
+
+#include <gocl.h>
+
+G_BEGIN_DECLS
+
+gboolean      bench_init                 (gint          *argc,
+                                          gchar       ***argv,
+                                          const gchar   *name,
+                                          GOptionEntry  *entries);
+gint          bench_finish               (void);
+
+GoclContext * bench_get_context          (void);
+GoclDevice *  bench_get_device           (void);
+guint         bench_get_iterations       (void);
+
+GoclKernel *  bench_build_kernel         (const gchar *source,
+                                          const gchar *kernel_name);
+
+gboolean      bench_wait_event           (GoclEvent *event);
+
+void          bench_report               (const gchar *variant,
+                                          guint64      size,
+                                          guint        num_iterations,
+                                          gdouble      value,
+                                          const gchar *unit);
+gboolean      bench_fail                 (const gchar *what);
+
+G_END_DECLS
+
+#endif /* __BENCH_COMMON_H__ */
@@ -0,0 +1,89 @@
+/*
+ * bench-enqueue.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Measures the host overhead of launching an empty kernel, which is almost
+   entirely the cost of the wrapper plus the driver's enqueue path */
+
+#include "bench-common.h"
+
+#define WARMUP_RUNS 16
+
+static const gchar *source =
+  "__kernel void empty (void)\n"
+  "{\n"
+  "}\n";
+
+static gboolean
+run (GoclKernel *kernel)
+{
+  GoclDevice *device = bench_get_device ();
+  guint n = bench_get_iterations ();
+  GoclEvent *event = NULL;
+  gint64 start, enqueued, end;
+  guint i;
+
+  for (i = 0; i < WARMUP_RUNS; i++)
+    if (! gocl_kernel_run_in_device_sync (kernel, device, NULL))
+      return bench_fail ("run kernel");
+
+  /* asynchronous: time spent in the call itself, then until all finished */
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n; i++)
+    {
+      event = gocl_kernel_run_in_device (kernel, device, NULL);
+      if (event == NULL)
+        return bench_fail ("run kernel");
+    }
+  enqueued = g_get_monotonic_time ();
+
+  if (! bench_wait_event (event))
+    return FALSE;
+  end = g_get_monotonic_time ();
+
+  bench_report ("run_in_device", 0, n,
+                (enqueued - start) * 1000.0 / n, "ns/call");
+  bench_report ("run_in_device_throughput", 0, n,
+                n * 1000000.0 / (end - start), "kernels/s");
+
+  /* synchronous: full round trip of a single launch */
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n; i++)
+    if (! gocl_kernel_run_in_device_sync (kernel, device, NULL))
+      return bench_fail ("run kernel");
+  end = g_get_monotonic_time ();
+
+  bench_report ("run_in_device_sync", 0, n,
+                (end - start) * 1000.0 / n, "ns/call");
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  GoclKernel *kernel;
+
+  if (! bench_init (&argc, &argv, "enqueue", NULL))
+    return bench_finish ();
+
+  kernel = bench_build_kernel (source, "empty");
+  if (kernel != NULL)
+    {
+      gocl_kernel_set_work_dimension (kernel, 1);
+      gocl_kernel_set_global_work_size (kernel, 1, 0, 0);
+      gocl_kernel_set_local_work_size (kernel, 0, 0, 0);
+
+      run (kernel);
+
+      g_object_unref (kernel);
+    }
+
+  return bench_finish ();
+}
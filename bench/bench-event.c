@@ -0,0 +1,124 @@
+/*
+ * bench-event.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Measures how long it takes for a gocl_event_then() callback to reach the
+   main loop, compared to waiting for the same command synchronously */
+
+#include "bench-common.h"
+
+static GMainLoop *main_loop;
+static gint64 callback_time;
+static gboolean callback_failed;
+
+static void
+on_event_complete (GoclEvent *event,
+                   GError    *error,
+                   gpointer   user_data)
+{
+  callback_time = g_get_monotonic_time ();
+  callback_failed = error != NULL;
+
+  g_main_loop_quit (main_loop);
+}
+
+static gboolean
+wait_callback (GoclEvent *event)
+{
+  gocl_event_then (event, on_event_complete, NULL);
+  g_main_loop_run (main_loop);
+
+  return ! callback_failed;
+}
+
+static gboolean
+run (GoclBuffer *buffer)
+{
+  GoclQueue *queue;
+  guint n = bench_get_iterations ();
+  gint64 start, sync_total = 0, then_total = 0, resolved_total = 0;
+  guint32 value = 0;
+  guint i;
+
+  queue = gocl_device_get_default_queue (bench_get_device ());
+
+  for (i = 0; i < n; i++)
+    {
+      GoclEvent *event;
+
+      /* baseline, blocking the calling thread */
+      start = g_get_monotonic_time ();
+      if (! gocl_buffer_write_sync (buffer, queue, &value, sizeof (value), 0,
+                                    NULL))
+        return bench_fail ("write buffer");
+      sync_total += g_get_monotonic_time () - start;
+
+      /* same command, completion delivered through the main loop */
+      start = g_get_monotonic_time ();
+      event = gocl_buffer_write (buffer, queue, &value, sizeof (value), 0,
+                                 NULL);
+      if (event == NULL)
+        return bench_fail ("write buffer");
+
+      g_object_ref (event);
+      if (! wait_callback (event))
+        {
+          g_object_unref (event);
+          return bench_fail ("complete event");
+        }
+      then_total += callback_time - start;
+
+      /* an event that is already resolved only pays the dispatch */
+      start = g_get_monotonic_time ();
+      wait_callback (event);
+      resolved_total += callback_time - start;
+
+      g_object_unref (event);
+    }
+
+  bench_report ("write_sync_roundtrip", sizeof (value), n,
+                (gdouble) sync_total / n, "us");
+  bench_report ("then_roundtrip", sizeof (value), n,
+                (gdouble) then_total / n, "us");
+  bench_report ("then_latency", sizeof (value), n,
+                (gdouble) (then_total - sync_total) / n, "us");
+  bench_report ("then_resolved", 0, n,
+                (gdouble) resolved_total / n, "us");
+
+  return TRUE;
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  GoclBuffer *buffer;
+
+  if (! bench_init (&argc, &argv, "event", NULL))
+    return bench_finish ();
+
+  main_loop = g_main_loop_new (NULL, FALSE);
+
+  buffer = gocl_buffer_new (bench_get_context (),
+                            GOCL_BUFFER_FLAGS_READ_WRITE,
+                            sizeof (guint32),
+                            NULL);
+  if (buffer == NULL)
+    {
+      bench_fail ("create buffer");
+    }
+  else
+    {
+      run (buffer);
+      g_object_unref (buffer);
+    }
+
+  g_main_loop_unref (main_loop);
+
+  return bench_finish ();
+}
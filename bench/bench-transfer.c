@@ -0,0 +1,171 @@
+/*
+ * bench-transfer.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Measures buffer read and write bandwidth against transfer size, for the
+   synchronous and asynchronous paths and for pageable and pinned memory */
+
+#include <string.h>
+
+#include "bench-common.h"
+
+#define MIN_SIZE       4096
+#define BYTES_PER_SIZE (256 * 1024 * 1024)
+
+static gint max_size_mb = 64;
+
+static GOptionEntry entries[] =
+{
+  { "max-size", 's', 0, G_OPTION_ARG_INT, &max_size_mb,
+    "Largest transfer size to measure, in MiB (default 64)", "MIB" },
+  { NULL }
+};
+
+static GoclEvent *
+transfer (GoclBuffer *buffer,
+          GoclQueue  *queue,
+          gboolean    read,
+          gpointer    ptr,
+          gsize       size)
+{
+  if (read)
+    return gocl_buffer_read (buffer, queue, ptr, size, 0, NULL);
+  else
+    return gocl_buffer_write (buffer, queue, ptr, size, 0, NULL);
+}
+
+static gboolean
+transfer_sync (GoclBuffer *buffer,
+               GoclQueue  *queue,
+               gboolean    read,
+               gpointer    ptr,
+               gsize       size)
+{
+  if (read)
+    return gocl_buffer_read_sync (buffer, queue, ptr, size, 0, NULL);
+  else
+    return gocl_buffer_write_sync (buffer, queue, ptr, size, 0, NULL);
+}
+
+static gboolean
+measure (GoclBuffer  *buffer,
+         GoclQueue   *queue,
+         gboolean     read,
+         gboolean     sync,
+         const gchar *host,
+         gpointer     ptr,
+         gsize        size)
+{
+  gchar *variant;
+  guint n, i;
+  gint64 start, elapsed;
+
+  /* keep the amount of data moved per measurement roughly constant */
+  n = CLAMP (BYTES_PER_SIZE / size, 4, bench_get_iterations ());
+
+  /* warm up */
+  if (! transfer_sync (buffer, queue, read, ptr, size))
+    return bench_fail (read ? "read buffer" : "write buffer");
+
+  start = g_get_monotonic_time ();
+  if (sync)
+    {
+      for (i = 0; i < n; i++)
+        if (! transfer_sync (buffer, queue, read, ptr, size))
+          return bench_fail (read ? "read buffer" : "write buffer");
+    }
+  else
+    {
+      GoclEvent *event = NULL;
+
+      /* the default queue is in-order, so the last event completes last */
+      for (i = 0; i < n; i++)
+        {
+          event = transfer (buffer, queue, read, ptr, size);
+          if (event == NULL)
+            return bench_fail (read ? "read buffer" : "write buffer");
+        }
+
+      if (! bench_wait_event (event))
+        return FALSE;
+    }
+  elapsed = MAX (g_get_monotonic_time () - start, 1);
+
+  variant = g_strdup_printf ("%s%s_%s",
+                             read ? "read" : "write",
+                             sync ? "_sync" : "",
+                             host);
+  bench_report (variant, size, n,
+                ((gdouble) size * n / (1024.0 * 1024.0)) /
+                (elapsed / (gdouble) G_USEC_PER_SEC),
+                "MiB/s");
+  g_free (variant);
+
+  return TRUE;
+}
+
+static gboolean
+run (void)
+{
+  GoclContext *context = bench_get_context ();
+  GoclQueue *queue;
+  GoclBuffer *buffer;
+  gpointer pageable, pinned;
+  gsize max_size, size;
+  gboolean result = TRUE;
+
+  max_size = (gsize) MAX (max_size_mb, 1) * 1024 * 1024;
+  queue = gocl_device_get_default_queue (bench_get_device ());
+
+  buffer = gocl_buffer_new (context,
+                            GOCL_BUFFER_FLAGS_READ_WRITE,
+                            max_size,
+                            NULL);
+  if (buffer == NULL)
+    return bench_fail ("create buffer");
+
+  pageable = g_malloc0 (max_size);
+
+  pinned = gocl_context_alloc_pinned (context, max_size);
+  if (pinned == NULL)
+    {
+      g_free (pageable);
+      g_object_unref (buffer);
+      return bench_fail ("allocate pinned memory");
+    }
+  memset (pinned, 0, max_size);
+
+  for (size = MIN_SIZE; size <= max_size && result; size *= 2)
+    {
+      result =
+        measure (buffer, queue, FALSE, TRUE, "pageable", pageable, size) &&
+        measure (buffer, queue, TRUE, TRUE, "pageable", pageable, size) &&
+        measure (buffer, queue, FALSE, FALSE, "pageable", pageable, size) &&
+        measure (buffer, queue, TRUE, FALSE, "pageable", pageable, size) &&
+        measure (buffer, queue, FALSE, TRUE, "pinned", pinned, size) &&
+        measure (buffer, queue, TRUE, TRUE, "pinned", pinned, size) &&
+        measure (buffer, queue, FALSE, FALSE, "pinned", pinned, size) &&
+        measure (buffer, queue, TRUE, FALSE, "pinned", pinned, size);
+    }
+
+  gocl_context_free_pinned (context, pinned);
+  g_free (pageable);
+  g_object_unref (buffer);
+
+  return result;
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  if (bench_init (&argc, &argv, "transfer", entries))
+    run ();
+
+  return bench_finish ();
+}
@@ -0,0 +1,722 @@
+/*
+ * gocl-buffer-pool.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-buffer-pool
+ * @short_description: Object that recycles buffers of a context
+ * @stability: Unstable
+ *
+ * A #GoclBufferPool hands out #GoclBuffer objects from a #GoclContext,
+ * recycling the ones that are released instead of freeing them. This
+ * avoids the cost of allocating device memory when an application
+ * repeatedly creates and destroys buffers of similar sizes.
+ *
+ * A pool is created with gocl_buffer_pool_new(), specifying the context and
+ * the #GoclBufferFlags of the buffers it will hand out. Buffers are obtained
+ * with gocl_buffer_pool_acquire(), and returned to the pool with
+ * gocl_buffer_pool_release() once they are no longer in use. Requested sizes
+ * are rounded up to a size class, and each size class keeps its own list of
+ * free buffers. The contents of a recycled buffer are undefined.
+ *
+ * Optionally, if a slab size is set with gocl_buffer_pool_set_slab_size(),
+ * small buffers are created as sub-buffers of larger slabs, using
+ * clCreateSubBuffer(), which reduces the number of device allocations
+ * further.
+ *
+ * The total amount of memory allocated by the pool, and the amount kept in
+ * free lists, can be limited with gocl_buffer_pool_set_max_size() and
+ * gocl_buffer_pool_set_max_cached_size(), respectively. Usage statistics,
+ * including high-water marks, are retrieved with
+ * gocl_buffer_pool_get_stats().
+ *
+ * The methods of a #GoclBufferPool can be called from any thread.
+ **/
+
+/**
+ * GoclBufferPoolClass:
+ * @parent_class: The parent class
+ *
+ * The class for #GoclBufferPool objects.
+ **/
+
+/**
+ * GoclBufferPoolStats:
+ * @allocated_size: Bytes of device memory currently allocated by the pool
+ * @in_use_size: Bytes currently handed out to the application
+ * @cached_size: Bytes currently kept in free lists
+ * @peak_allocated_size: Highest value reached by @allocated_size
+ * @peak_in_use_size: Highest value reached by @in_use_size
+ * @num_hits: Number of acquisitions served from a free list
+ * @num_misses: Number of acquisitions that needed a new buffer
+ *
+ * Usage statistics of a #GoclBufferPool, retrieved with
+ * gocl_buffer_pool_get_stats().
+ **/
+
+#include <string.h>
+
+#include "gocl-buffer-pool.h"
+
+#include "gocl-private.h"
+#include "gocl-decls.h"
+
+/* smallest size class, in bytes */
+#define MIN_CLASS_SIZE 256
+
+/* minimum number of chunks a slab must hold to be worth using */
+#define MIN_CHUNKS_PER_SLAB 4
+
+typedef struct
+{
+  guint64 size;
+
+  GQueue free_list;
+
+  /* buffers of this class are carved out of slabs */
+  gboolean use_slabs;
+  gsize stride;
+  GoclBuffer *slab;
+  gsize slab_offset;
+} SizeClass;
+
+struct _GoclBufferPoolPrivate
+{
+  GoclContext *context;
+  guint flags;
+
+  GMutex mutex;
+
+  GHashTable *classes;
+  GHashTable *in_use;
+  GList *slabs;
+
+  gsize max_size;
+  gsize max_cached_size;
+  gsize slab_size;
+  gsize alignment;
+
+  GoclBufferPoolStats stats;
+};
+
+/* properties */
+enum
+{
+  PROP_0,
+  PROP_CONTEXT,
+  PROP_FLAGS
+};
+
+static void           gocl_buffer_pool_class_init            (GoclBufferPoolClass *class);
+static void           gocl_buffer_pool_init                  (GoclBufferPool *self);
+static void           gocl_buffer_pool_finalize              (GObject *obj);
+
+static void           set_property                           (GObject      *obj,
+                                                              guint         prop_id,
+                                                              const GValue *value,
+                                                              GParamSpec   *pspec);
+static void           get_property                           (GObject    *obj,
+                                                              guint       prop_id,
+                                                              GValue     *value,
+                                                              GParamSpec *pspec);
+
+static void           free_size_class                        (gpointer data);
+
+G_DEFINE_TYPE (GoclBufferPool, gocl_buffer_pool, G_TYPE_OBJECT);
+
+#define GOCL_BUFFER_POOL_GET_PRIVATE(obj)                       \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                          \
+                                GOCL_TYPE_BUFFER_POOL,          \
+                                GoclBufferPoolPrivate))         \
+
+static void
+gocl_buffer_pool_class_init (GoclBufferPoolClass *class)
+{
+  GObjectClass *obj_class = G_OBJECT_CLASS (class);
+
+  obj_class->finalize = gocl_buffer_pool_finalize;
+  obj_class->get_property = get_property;
+  obj_class->set_property = set_property;
+
+  g_object_class_install_property (obj_class, PROP_CONTEXT,
+                                   g_param_spec_object ("context",
+                                                        "Context",
+                                                        "The context where buffers are created",
+                                                        GOCL_TYPE_CONTEXT,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_FLAGS,
+                                   g_param_spec_uint ("flags",
+                                                      "Buffer flags",
+                                                      "The flags used when creating buffers",
+                                                      GOCL_BUFFER_FLAGS_READ_WRITE,
+                                                      GOCL_BUFFER_FLAGS_COPY_HOST_PTR,
+                                                      GOCL_BUFFER_FLAGS_READ_WRITE,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
+
+  g_type_class_add_private (class, sizeof (GoclBufferPoolPrivate));
+}
+
+static void
+gocl_buffer_pool_init (GoclBufferPool *self)
+{
+  GoclBufferPoolPrivate *priv;
+
+  self->priv = priv = GOCL_BUFFER_POOL_GET_PRIVATE (self);
+
+  g_mutex_init (&priv->mutex);
+
+  priv->classes = g_hash_table_new_full (g_int64_hash,
+                                         g_int64_equal,
+                                         NULL,
+                                         free_size_class);
+  priv->in_use = g_hash_table_new_full (g_direct_hash,
+                                        g_direct_equal,
+                                        g_object_unref,
+                                        NULL);
+  priv->slabs = NULL;
+
+  priv->max_size = 0;
+  priv->max_cached_size = 0;
+  priv->slab_size = 0;
+  priv->alignment = 0;
+
+  memset (&priv->stats, 0, sizeof (GoclBufferPoolStats));
+}
+
+static void
+gocl_buffer_pool_finalize (GObject *obj)
+{
+  GoclBufferPool *self = GOCL_BUFFER_POOL (obj);
+
+  if (g_hash_table_size (self->priv->in_use) > 0)
+    g_warning ("Buffer pool finalized with %u buffers still in use",
+               g_hash_table_size (self->priv->in_use));
+
+  g_hash_table_unref (self->priv->in_use);
+  g_hash_table_unref (self->priv->classes);
+  g_list_free_full (self->priv->slabs, g_object_unref);
+
+  g_mutex_clear (&self->priv->mutex);
+
+  g_object_unref (self->priv->context);
+
+  G_OBJECT_CLASS (gocl_buffer_pool_parent_class)->finalize (obj);
+}
+
+static void
+set_property (GObject      *obj,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GoclBufferPool *self;
+
+  self = GOCL_BUFFER_POOL (obj);
+
+  switch (prop_id)
+    {
+    case PROP_CONTEXT:
+      self->priv->context = g_value_dup_object (value);
+      break;
+
+    case PROP_FLAGS:
+      self->priv->flags = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+get_property (GObject    *obj,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GoclBufferPool *self;
+
+  self = GOCL_BUFFER_POOL (obj);
+
+  switch (prop_id)
+    {
+    case PROP_CONTEXT:
+      g_value_set_object (value, self->priv->context);
+      break;
+
+    case PROP_FLAGS:
+      g_value_set_uint (value, self->priv->flags);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+free_size_class (gpointer data)
+{
+  SizeClass *class = data;
+  GoclBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&class->free_list)) != NULL)
+    g_object_unref (buffer);
+
+  g_slice_free (SizeClass, class);
+}
+
+/* sizes are rounded up to a quarter of their power of two, so at most 25%
+   of each buffer is wasted */
+static gsize
+get_class_size (gsize size)
+{
+  guint bits;
+  gsize step;
+
+  if (size <= MIN_CLASS_SIZE)
+    return MIN_CLASS_SIZE;
+
+  bits = g_bit_storage (size - 1);
+  step = (gsize) 1 << (bits - 3);
+
+  return (size + step - 1) & ~(step - 1);
+}
+
+/* the base address alignment of sub-buffers is the largest of all devices
+   in the context */
+static gsize
+get_alignment (GoclBufferPool *self)
+{
+  guint i;
+
+  if (self->priv->alignment > 0)
+    return self->priv->alignment;
+
+  self->priv->alignment = MIN_CLASS_SIZE;
+
+  for (i = 0; i < gocl_context_get_num_devices (self->priv->context); i++)
+    {
+      GoclDevice *device;
+      guint align_bits;
+
+      device = gocl_context_get_device_by_index (self->priv->context, i);
+      align_bits = gocl_device_get_info (device)->mem_base_addr_align;
+      g_object_unref (device);
+
+      self->priv->alignment = MAX (self->priv->alignment, align_bits / 8);
+    }
+
+  return self->priv->alignment;
+}
+
+static SizeClass *
+get_size_class (GoclBufferPool *self, gsize size)
+{
+  SizeClass *class;
+  guint64 class_size;
+
+  class_size = get_class_size (size);
+
+  class = g_hash_table_lookup (self->priv->classes, &class_size);
+  if (class != NULL)
+    return class;
+
+  class = g_slice_new0 (SizeClass);
+  class->size = class_size;
+  g_queue_init (&class->free_list);
+
+  if (self->priv->slab_size > 0)
+    {
+      gsize alignment;
+
+      alignment = get_alignment (self);
+      class->stride = (class_size + alignment - 1) / alignment * alignment;
+      class->use_slabs =
+        self->priv->slab_size / class->stride >= MIN_CHUNKS_PER_SLAB;
+    }
+
+  g_hash_table_insert (self->priv->classes, &class->size, class);
+
+  return class;
+}
+
+static void
+update_allocated_size (GoclBufferPool *self, gssize delta)
+{
+  GoclBufferPoolStats *stats = &self->priv->stats;
+
+  stats->allocated_size += delta;
+  if (stats->allocated_size > stats->peak_allocated_size)
+    stats->peak_allocated_size = stats->allocated_size;
+}
+
+static void
+drop_cached_buffers (GoclBufferPool *self)
+{
+  GHashTableIter iter;
+  SizeClass *class;
+
+  g_hash_table_iter_init (&iter, self->priv->classes);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &class))
+    {
+      GoclBuffer *buffer;
+
+      /* chunks don't own their memory, so there is nothing to free */
+      if (class->use_slabs)
+        continue;
+
+      while ((buffer = g_queue_pop_head (&class->free_list)) != NULL)
+        {
+          g_object_unref (buffer);
+          self->priv->stats.cached_size -= class->size;
+          update_allocated_size (self, - (gssize) class->size);
+        }
+    }
+}
+
+static gboolean
+reserve (GoclBufferPool *self, gsize size)
+{
+  if (self->priv->max_size == 0)
+    return TRUE;
+
+  if (self->priv->stats.allocated_size + size > self->priv->max_size)
+    drop_cached_buffers (self);
+
+  if (self->priv->stats.allocated_size + size > self->priv->max_size)
+    {
+      gocl_error_check_opencl_internal (CL_MEM_OBJECT_ALLOCATION_FAILURE);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static GoclBuffer *
+new_buffer (GoclBufferPool *self, SizeClass *class)
+{
+  GoclBuffer *buffer;
+
+  if (! reserve (self, class->size))
+    return NULL;
+
+  buffer = gocl_buffer_new (self->priv->context,
+                            self->priv->flags,
+                            class->size,
+                            NULL);
+  if (buffer != NULL)
+    update_allocated_size (self, class->size);
+
+  return buffer;
+}
+
+static GoclBuffer *
+new_chunk (GoclBufferPool *self, SizeClass *class)
+{
+  GoclBuffer *buffer;
+
+  if (class->slab == NULL ||
+      class->slab_offset + class->stride > self->priv->slab_size)
+    {
+      if (! reserve (self, self->priv->slab_size))
+        return NULL;
+
+      class->slab = gocl_buffer_new (self->priv->context,
+                                     self->priv->flags,
+                                     self->priv->slab_size,
+                                     NULL);
+      if (class->slab == NULL)
+        return NULL;
+
+      update_allocated_size (self, self->priv->slab_size);
+
+      self->priv->slabs = g_list_prepend (self->priv->slabs, class->slab);
+      class->slab_offset = 0;
+    }
+
+  buffer = gocl_buffer_new_sub_buffer (class->slab,
+                                       0,
+                                       class->slab_offset,
+                                       class->size);
+  if (buffer != NULL)
+    class->slab_offset += class->stride;
+
+  return buffer;
+}
+
+/* public */
+
+/**
+ * gocl_buffer_pool_new:
+ * @context: A #GoclContext to create buffers in
+ * @flags: An OR'ed combination of values from #GoclBufferFlags, used for all
+ * the buffers of the pool. Host pointer flags other than
+ * %GOCL_BUFFER_FLAGS_ALLOC_HOST_PTR are not allowed.
+ *
+ * Creates a new, empty buffer pool for @context.
+ *
+ * Returns: (transfer full): A newly created #GoclBufferPool
+ **/
+GoclBufferPool *
+gocl_buffer_pool_new (GoclContext *context, guint flags)
+{
+  g_return_val_if_fail (GOCL_IS_CONTEXT (context), NULL);
+  g_return_val_if_fail ((flags & (GOCL_BUFFER_FLAGS_USE_HOST_PTR |
+                                  GOCL_BUFFER_FLAGS_COPY_HOST_PTR)) == 0,
+                        NULL);
+
+  return g_object_new (GOCL_TYPE_BUFFER_POOL,
+                       "context", context,
+                       "flags", flags,
+                       NULL);
+}
+
+/**
+ * gocl_buffer_pool_get_context:
+ * @self: The #GoclBufferPool
+ *
+ * Retrieves the #GoclContext the pool creates buffers in.
+ *
+ * Returns: (transfer none): A #GoclContext. The returned object is owned by
+ *   the pool, do not free.
+ **/
+GoclContext *
+gocl_buffer_pool_get_context (GoclBufferPool *self)
+{
+  g_return_val_if_fail (GOCL_IS_BUFFER_POOL (self), NULL);
+
+  return self->priv->context;
+}
+
+/**
+ * gocl_buffer_pool_acquire:
+ * @self: The #GoclBufferPool
+ * @size: The minimum size of the buffer, in bytes
+ *
+ * Obtains a buffer of at least @size bytes from the pool. If a buffer of the
+ * same size class was previously released, it is reused. Otherwise, a new
+ * buffer is created. The contents of the returned buffer are undefined.
+ *
+ * The returned buffer is owned by the pool, and must be given back with
+ * gocl_buffer_pool_release() when no longer in use.
+ *
+ * On error, or if creating a new buffer would exceed the limit set with
+ * gocl_buffer_pool_set_max_size(), %NULL is returned.
+ *
+ * Returns: (transfer none): A #GoclBuffer, or %NULL on error
+ **/
+GoclBuffer *
+gocl_buffer_pool_acquire (GoclBufferPool *self, gsize size)
+{
+  GoclBufferPoolStats *stats;
+  SizeClass *class;
+  GoclBuffer *buffer;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER_POOL (self), NULL);
+  g_return_val_if_fail (size > 0, NULL);
+
+  stats = &self->priv->stats;
+
+  g_mutex_lock (&self->priv->mutex);
+
+  class = get_size_class (self, size);
+
+  buffer = g_queue_pop_head (&class->free_list);
+  if (buffer != NULL)
+    {
+      stats->num_hits++;
+      stats->cached_size -= class->size;
+    }
+  else
+    {
+      stats->num_misses++;
+
+      if (class->use_slabs)
+        buffer = new_chunk (self, class);
+      else
+        buffer = new_buffer (self, class);
+    }
+
+  if (buffer != NULL)
+    {
+      g_hash_table_insert (self->priv->in_use, buffer, class);
+
+      stats->in_use_size += class->size;
+      if (stats->in_use_size > stats->peak_in_use_size)
+        stats->peak_in_use_size = stats->in_use_size;
+    }
+
+  g_mutex_unlock (&self->priv->mutex);
+
+  return buffer;
+}
+
+/**
+ * gocl_buffer_pool_release:
+ * @self: The #GoclBufferPool
+ * @buffer: A #GoclBuffer obtained with gocl_buffer_pool_acquire()
+ *
+ * Gives @buffer back to the pool, so that it can be handed out again. If
+ * keeping it would exceed the limit set with
+ * gocl_buffer_pool_set_max_cached_size(), the buffer is freed instead.
+ *
+ * Operations that use @buffer must have completed before releasing it.
+ **/
+void
+gocl_buffer_pool_release (GoclBufferPool *self, GoclBuffer *buffer)
+{
+  GoclBufferPoolStats *stats;
+  SizeClass *class;
+
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+  g_return_if_fail (GOCL_IS_BUFFER (buffer));
+
+  stats = &self->priv->stats;
+
+  g_mutex_lock (&self->priv->mutex);
+
+  class = g_hash_table_lookup (self->priv->in_use, buffer);
+  if (class == NULL)
+    {
+      g_mutex_unlock (&self->priv->mutex);
+      g_warning ("Buffer %p is not in use in buffer pool %p", buffer, self);
+      return;
+    }
+
+  g_hash_table_steal (self->priv->in_use, buffer);
+  stats->in_use_size -= class->size;
+
+  if (! class->use_slabs &&
+      self->priv->max_cached_size > 0 &&
+      stats->cached_size + class->size > self->priv->max_cached_size)
+    {
+      g_object_unref (buffer);
+      update_allocated_size (self, - (gssize) class->size);
+    }
+  else
+    {
+      g_queue_push_head (&class->free_list, buffer);
+      stats->cached_size += class->size;
+    }
+
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_buffer_pool_trim:
+ * @self: The #GoclBufferPool
+ *
+ * Frees all the buffers kept in free lists. Memory used by slabs is kept for
+ * as long as the pool lives.
+ **/
+void
+gocl_buffer_pool_trim (GoclBufferPool *self)
+{
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+
+  g_mutex_lock (&self->priv->mutex);
+  drop_cached_buffers (self);
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_buffer_pool_set_max_size:
+ * @self: The #GoclBufferPool
+ * @max_size: The maximum size, in bytes, or zero for no limit
+ *
+ * Sets the maximum amount of device memory the pool can allocate, including
+ * the buffers in use, the ones in free lists and the slabs. When a new
+ * allocation would exceed this limit, the free lists are flushed, and if
+ * still not enough, gocl_buffer_pool_acquire() fails. By default there is
+ * no limit.
+ **/
+void
+gocl_buffer_pool_set_max_size (GoclBufferPool *self, gsize max_size)
+{
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+
+  g_mutex_lock (&self->priv->mutex);
+  self->priv->max_size = max_size;
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_buffer_pool_set_max_cached_size:
+ * @self: The #GoclBufferPool
+ * @max_cached_size: The maximum size, in bytes, or zero for no limit
+ *
+ * Sets the maximum amount of memory kept in free lists. Buffers released
+ * beyond this limit are freed. By default there is no limit.
+ **/
+void
+gocl_buffer_pool_set_max_cached_size (GoclBufferPool *self,
+                                      gsize           max_cached_size)
+{
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+
+  g_mutex_lock (&self->priv->mutex);
+  self->priv->max_cached_size = max_cached_size;
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_buffer_pool_set_slab_size:
+ * @self: The #GoclBufferPool
+ * @slab_size: The size of each slab, in bytes, or zero to disable slabs
+ *
+ * Enables sub-allocation of small buffers from slabs of @slab_size bytes.
+ * Size classes that fit at least four times in a slab are created as
+ * sub-buffers with clCreateSubBuffer(). The setting only affects size
+ * classes not used before, so it is normally called right after creating
+ * the pool. Slabs are disabled by default.
+ **/
+void
+gocl_buffer_pool_set_slab_size (GoclBufferPool *self, gsize slab_size)
+{
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+
+  g_mutex_lock (&self->priv->mutex);
+  self->priv->slab_size = slab_size;
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_buffer_pool_get_stats:
+ * @self: The #GoclBufferPool
+ * @stats: (out caller-allocates): A #GoclBufferPoolStats to fill
+ *
+ * Retrieves a snapshot of the usage statistics of the pool.
+ **/
+void
+gocl_buffer_pool_get_stats (GoclBufferPool      *self,
+                            GoclBufferPoolStats *stats)
+{
+  g_return_if_fail (GOCL_IS_BUFFER_POOL (self));
+  g_return_if_fail (stats != NULL);
+
+  g_mutex_lock (&self->priv->mutex);
+  *stats = self->priv->stats;
+  g_mutex_unlock (&self->priv->mutex);
+}
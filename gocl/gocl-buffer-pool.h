@@ -0,0 +1,96 @@
+/*
+ * gocl-buffer-pool.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+#ifndef __GOCL_BUFFER_POOL_H__
+#define __GOCL_BUFFER_POOL_H__
+
+#include <glib-object.h>
+
+#include "gocl-context.h"
+#include "gocl-buffer.h"
+
+G_BEGIN_DECLS
+
+#define GOCL_TYPE_BUFFER_POOL              (gocl_buffer_pool_get_type ())
+#define GOCL_BUFFER_POOL(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GOCL_TYPE_BUFFER_POOL, GoclBufferPool))
+#define GOCL_BUFFER_POOL_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GOCL_TYPE_BUFFER_POOL, GoclBufferPoolClass))
+#define GOCL_IS_BUFFER_POOL(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GOCL_TYPE_BUFFER_POOL))
+#define GOCL_IS_BUFFER_POOL_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GOCL_TYPE_BUFFER_POOL))
+#define GOCL_BUFFER_POOL_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GOCL_TYPE_BUFFER_POOL, GoclBufferPoolClass))
+
+typedef struct _GoclBufferPoolClass GoclBufferPoolClass;
+typedef struct _GoclBufferPool GoclBufferPool;
+typedef struct _GoclBufferPoolPrivate GoclBufferPoolPrivate;
+
+typedef struct _GoclBufferPoolStats GoclBufferPoolStats;
+
+struct _GoclBufferPool
+{
+  GObject parent_instance;
+
+  GoclBufferPoolPrivate *priv;
+};
+
+struct _GoclBufferPoolClass
+{
+  GObjectClass parent_class;
+};
+
+struct _GoclBufferPoolStats
+{
+  gsize allocated_size;
+  gsize in_use_size;
+  gsize cached_size;
+
+  gsize peak_allocated_size;
+  gsize peak_in_use_size;
+
+  guint64 num_hits;
+  guint64 num_misses;
+};
+
+GType                  gocl_buffer_pool_get_type               (void) G_GNUC_CONST;
+
+GoclBufferPool *       gocl_buffer_pool_new                    (GoclContext *context,
+                                                                guint        flags);
+
+GoclContext *          gocl_buffer_pool_get_context            (GoclBufferPool *self);
+
+GoclBuffer *           gocl_buffer_pool_acquire                (GoclBufferPool *self,
+                                                                gsize           size);
+void                   gocl_buffer_pool_release                (GoclBufferPool *self,
+                                                                GoclBuffer     *buffer);
+
+void                   gocl_buffer_pool_trim                   (GoclBufferPool *self);
+
+void                   gocl_buffer_pool_set_max_size           (GoclBufferPool *self,
+                                                                gsize           max_size);
+void                   gocl_buffer_pool_set_max_cached_size    (GoclBufferPool *self,
+                                                                gsize           max_cached_size);
+void                   gocl_buffer_pool_set_slab_size          (GoclBufferPool *self,
+                                                                gsize           slab_size);
+
+void                   gocl_buffer_pool_get_stats              (GoclBufferPool      *self,
+                                                                GoclBufferPoolStats *stats);
+
+G_END_DECLS
+
+#endif /* __GOCL_BUFFER_POOL_H__ */
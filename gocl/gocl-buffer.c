@@ -42,6 +42,18 @@
  * Both gocl_buffer_write_sync() and gocl_buffer_read_sync() block program
  * execution, while gocl_buffer_write() and gocl_buffer_read() are asynchronous
  * versions and safe to call from the application's main loop.
+ *
+ * Alternatively, a region of the buffer can be mapped into host memory with
+ * gocl_buffer_map() or gocl_buffer_map_sync(), and later unmapped with
+ * gocl_buffer_unmap() or gocl_buffer_unmap_sync(). When the buffer is
+ * allocated in host accessible memory, this avoids copying the data.
+ *
+ * Data can also be moved between buffers without going through host memory,
+ * with gocl_buffer_copy() and gocl_buffer_copy_rect(), and a buffer can be
+ * filled with a repeated pattern, for instance to clear it, with
+ * gocl_buffer_fill(). Rectangular regions of 2D or 3D data are transferred
+ * with gocl_buffer_read_rect() and gocl_buffer_write_rect(). All of them
+ * have a blocking _sync version as well.
  **/
 
 /**
@@ -72,6 +84,9 @@ struct _GoclBufferPrivate
   guint flags;
   gsize size;
   gpointer host_ptr;
+
+  GoclBuffer *parent;
+  guint64 origin;
 };
 
 /* properties */
@@ -81,9 +96,16 @@ enum
   PROP_CONTEXT,
   PROP_FLAGS,
   PROP_SIZE,
-  PROP_HOST_PTR
+  PROP_HOST_PTR,
+  PROP_PARENT,
+  PROP_ORIGIN
 };
 
+/* flags that can be specified when creating a sub-buffer */
+#define SUB_BUFFER_FLAGS_MASK (GOCL_BUFFER_FLAGS_READ_WRITE | \
+                               GOCL_BUFFER_FLAGS_WRITE_ONLY | \
+                               GOCL_BUFFER_FLAGS_READ_ONLY)
+
 static void           gocl_buffer_class_init            (GoclBufferClass *class);
 static void           gocl_buffer_initable_iface_init   (GInitableIface *iface);
 static gboolean       gocl_buffer_initable_init         (GInitable     *initable,
@@ -173,6 +195,24 @@ gocl_buffer_class_init (GoclBufferClass *class)
                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                          G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (obj_class, PROP_PARENT,
+                                   g_param_spec_object ("parent",
+                                                        "Parent buffer",
+                                                        "The buffer this sub-buffer is created from",
+                                                        GOCL_TYPE_BUFFER,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_ORIGIN,
+                                   g_param_spec_uint64 ("origin",
+                                                        "Origin",
+                                                        "The offset of this sub-buffer in the parent buffer",
+                                                        0,
+                                                        G_MAXUINT64,
+                                                        0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
   g_type_class_add_private (class, sizeof (GoclBufferPrivate));
 }
 
@@ -191,6 +231,21 @@ gocl_buffer_initable_init (GInitable     *initable,
   cl_context ctx;
   cl_int err_code;
 
+  if (self->priv->parent != NULL)
+    {
+      cl_buffer_region region;
+
+      region.origin = self->priv->origin;
+      region.size = self->priv->size;
+
+      self->priv->buf = clCreateSubBuffer (self->priv->parent->priv->buf,
+                                           self->priv->flags & SUB_BUFFER_FLAGS_MASK,
+                                           CL_BUFFER_CREATE_TYPE_REGION,
+                                           &region,
+                                           &err_code);
+      return ! gocl_error_check_opencl (err_code, error);
+    }
+
   ctx = gocl_context_get_context (self->priv->context);
 
   err_code = GOCL_BUFFER_GET_CLASS (self)->create_cl_mem (self,
@@ -209,7 +264,12 @@ gocl_buffer_init (GoclBuffer *self)
 
   self->priv = priv = GOCL_BUFFER_GET_PRIVATE (self);
 
+  GOCL_TRACE_OBJECT_NEW (GOCL_TRACE_OBJECT_BUFFER);
+
   priv->host_ptr = NULL;
+
+  priv->parent = NULL;
+  priv->origin = 0;
 }
 
 static void
@@ -217,7 +277,13 @@ gocl_buffer_finalize (GObject *obj)
 {
   GoclBuffer *self = GOCL_BUFFER (obj);
 
-  clReleaseMemObject (self->priv->buf);
+  if (self->priv->buf != NULL)
+    clReleaseMemObject (self->priv->buf);
+
+  if (self->priv->parent != NULL)
+    g_object_unref (self->priv->parent);
+
+  GOCL_TRACE_OBJECT_FREE (GOCL_TRACE_OBJECT_BUFFER);
 
   G_OBJECT_CLASS (gocl_buffer_parent_class)->finalize (obj);
 }
@@ -250,6 +316,14 @@ set_property (GObject      *obj,
       self->priv->host_ptr = g_value_get_pointer (value);
       break;
 
+    case PROP_PARENT:
+      self->priv->parent = g_value_dup_object (value);
+      break;
+
+    case PROP_ORIGIN:
+      self->priv->origin = g_value_get_uint64 (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -284,6 +358,14 @@ get_property (GObject    *obj,
       g_value_set_pointer (value, self->priv->host_ptr);
       break;
 
+    case PROP_PARENT:
+      g_value_set_object (value, self->priv->parent);
+      break;
+
+    case PROP_ORIGIN:
+      g_value_set_uint64 (value, self->priv->origin);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -334,6 +416,387 @@ read_all (GoclBuffer          *self,
                               out_event);
 }
 
+/* enqueues a read into or a write from @ptr. Every transfer goes through
+   here so that pinned memory is tracked and not recycled while in use,
+   which takes an event even when the caller does not want one */
+static cl_int
+enqueue_transfer (GoclBuffer              *self,
+                  GoclQueue               *queue,
+                  gboolean                 write,
+                  gboolean                 blocking,
+                  gpointer                 ptr,
+                  gsize                    size,
+                  goffset                  offset,
+                  const GoclEventWaitList *wait_list,
+                  const gchar             *trace_name,
+                  cl_event                *event)
+{
+  cl_int err_code;
+  cl_event _event = NULL;
+  gboolean track;
+  gint64 trace_start;
+
+  track = event != NULL
+    || gocl_context_is_pinned (self->priv->context, ptr, size);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  if (write)
+    err_code = clEnqueueWriteBuffer (gocl_queue_get_queue (queue),
+                                     self->priv->buf,
+                                     blocking,
+                                     offset,
+                                     size,
+                                     ptr,
+                                     wait_list->len,
+                                     wait_list->events,
+                                     track ? &_event : NULL);
+  else
+    err_code = clEnqueueReadBuffer (gocl_queue_get_queue (queue),
+                                    self->priv->buf,
+                                    blocking,
+                                    offset,
+                                    size,
+                                    ptr,
+                                    wait_list->len,
+                                    wait_list->events,
+                                    track ? &_event : NULL);
+  GOCL_TRACE_END ("buffer", trace_name, NULL, trace_start);
+
+  if (err_code == CL_SUCCESS && track)
+    gocl_context_track_pinned_transfer (self->priv->context,
+                                        ptr,
+                                        size,
+                                        _event);
+
+  if (event != NULL)
+    *event = _event;
+  else if (_event != NULL)
+    clReleaseEvent (_event);
+
+  return err_code;
+}
+
+static GoclEvent *
+enqueue_read (GoclBuffer              *self,
+              GoclQueue               *queue,
+              gpointer                 target_ptr,
+              gsize                    size,
+              goffset                  offset,
+              const GoclEventWaitList *wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+
+  err_code = enqueue_transfer (self,
+                               queue,
+                               FALSE,
+                               FALSE,
+                               target_ptr,
+                               size,
+                               offset,
+                               wait_list,
+                               "read",
+                               &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+static GoclEvent *
+enqueue_write (GoclBuffer              *self,
+               GoclQueue               *queue,
+               const gpointer           data,
+               gsize                    size,
+               goffset                  offset,
+               const GoclEventWaitList *wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+
+  err_code = enqueue_transfer (self,
+                               queue,
+                               TRUE,
+                               FALSE,
+                               data,
+                               size,
+                               offset,
+                               wait_list,
+                               "write",
+                               &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/* enqueues a read or a write without an event */
+static cl_int
+enqueue_transfer_detached (GoclBuffer              *self,
+                           GoclQueue               *queue,
+                           gboolean                 write,
+                           gpointer                 ptr,
+                           gsize                    size,
+                           goffset                  offset,
+                           const GoclEventWaitList *wait_list)
+{
+  cl_int err_code;
+
+  err_code = enqueue_transfer (self,
+                               queue,
+                               write,
+                               FALSE,
+                               ptr,
+                               size,
+                               offset,
+                               wait_list,
+                               write ? "write-detached" : "read-detached",
+                               NULL);
+  if (err_code != CL_SUCCESS)
+    return err_code;
+
+  gocl_queue_add_detached (queue);
+
+  return CL_SUCCESS;
+}
+
+static cl_int
+enqueue_copy (GoclBuffer              *self,
+              GoclQueue               *queue,
+              GoclBuffer              *target,
+              gsize                    size,
+              goffset                  src_offset,
+              goffset                  dst_offset,
+              const GoclEventWaitList *wait_list,
+              cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueCopyBuffer (gocl_queue_get_queue (queue),
+                                  self->priv->buf,
+                                  target->priv->buf,
+                                  src_offset,
+                                  dst_offset,
+                                  size,
+                                  wait_list->len,
+                                  wait_list->events,
+                                  event);
+  GOCL_TRACE_END ("buffer", "copy", NULL, trace_start);
+
+  return err_code;
+}
+
+static cl_int
+enqueue_fill (GoclBuffer              *self,
+              GoclQueue               *queue,
+              gconstpointer            pattern,
+              gsize                    pattern_size,
+              gsize                    size,
+              goffset                  offset,
+              const GoclEventWaitList *wait_list,
+              cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueFillBuffer (gocl_queue_get_queue (queue),
+                                  self->priv->buf,
+                                  pattern,
+                                  pattern_size,
+                                  offset,
+                                  size,
+                                  wait_list->len,
+                                  wait_list->events,
+                                  event);
+  GOCL_TRACE_END ("buffer", "fill", NULL, trace_start);
+
+  return err_code;
+}
+
+/* the span of host memory a rectangular transfer touches, as an offset
+   from the host pointer and a size */
+static void
+get_host_rect_span (const gsize *host_origin,
+                    const gsize *region,
+                    gsize        host_row_pitch,
+                    gsize        host_slice_pitch,
+                    gsize       *offset,
+                    gsize       *size)
+{
+  if (host_row_pitch == 0)
+    host_row_pitch = region[0];
+  if (host_slice_pitch == 0)
+    host_slice_pitch = host_row_pitch * region[1];
+
+  *offset = host_origin[2] * host_slice_pitch
+    + host_origin[1] * host_row_pitch
+    + host_origin[0];
+  *size = (region[2] - 1) * host_slice_pitch
+    + (region[1] - 1) * host_row_pitch
+    + region[0];
+}
+
+/* keeps pinned memory used by a rectangular transfer from being recycled
+   while in use, like enqueue_transfer() does for linear ones */
+static void
+track_rect_transfer (GoclBuffer  *self,
+                     gpointer     ptr,
+                     const gsize *host_origin,
+                     const gsize *region,
+                     gsize        host_row_pitch,
+                     gsize        host_slice_pitch,
+                     cl_event     event)
+{
+  gsize offset;
+  gsize size;
+
+  get_host_rect_span (host_origin,
+                      region,
+                      host_row_pitch,
+                      host_slice_pitch,
+                      &offset,
+                      &size);
+  gocl_context_track_pinned_transfer (self->priv->context,
+                                      (const guint8 *) ptr + offset,
+                                      size,
+                                      event);
+}
+
+static cl_int
+enqueue_read_rect (GoclBuffer              *self,
+                   GoclQueue               *queue,
+                   gpointer                 target_ptr,
+                   const gsize             *buffer_origin,
+                   const gsize             *host_origin,
+                   const gsize             *region,
+                   gsize                    buffer_row_pitch,
+                   gsize                    buffer_slice_pitch,
+                   gsize                    host_row_pitch,
+                   gsize                    host_slice_pitch,
+                   const GoclEventWaitList *wait_list,
+                   cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueReadBufferRect (gocl_queue_get_queue (queue),
+                                      self->priv->buf,
+                                      CL_FALSE,
+                                      buffer_origin,
+                                      host_origin,
+                                      region,
+                                      buffer_row_pitch,
+                                      buffer_slice_pitch,
+                                      host_row_pitch,
+                                      host_slice_pitch,
+                                      target_ptr,
+                                      wait_list->len,
+                                      wait_list->events,
+                                      event);
+  GOCL_TRACE_END ("buffer", "read-rect", NULL, trace_start);
+
+  if (err_code == CL_SUCCESS)
+    track_rect_transfer (self,
+                         target_ptr,
+                         host_origin,
+                         region,
+                         host_row_pitch,
+                         host_slice_pitch,
+                         *event);
+
+  return err_code;
+}
+
+static cl_int
+enqueue_write_rect (GoclBuffer              *self,
+                    GoclQueue               *queue,
+                    const gpointer           data,
+                    const gsize             *buffer_origin,
+                    const gsize             *host_origin,
+                    const gsize             *region,
+                    gsize                    buffer_row_pitch,
+                    gsize                    buffer_slice_pitch,
+                    gsize                    host_row_pitch,
+                    gsize                    host_slice_pitch,
+                    const GoclEventWaitList *wait_list,
+                    cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueWriteBufferRect (gocl_queue_get_queue (queue),
+                                       self->priv->buf,
+                                       CL_FALSE,
+                                       buffer_origin,
+                                       host_origin,
+                                       region,
+                                       buffer_row_pitch,
+                                       buffer_slice_pitch,
+                                       host_row_pitch,
+                                       host_slice_pitch,
+                                       data,
+                                       wait_list->len,
+                                       wait_list->events,
+                                       event);
+  GOCL_TRACE_END ("buffer", "write-rect", NULL, trace_start);
+
+  if (err_code == CL_SUCCESS)
+    track_rect_transfer (self,
+                         data,
+                         host_origin,
+                         region,
+                         host_row_pitch,
+                         host_slice_pitch,
+                         *event);
+
+  return err_code;
+}
+
+static cl_int
+enqueue_copy_rect (GoclBuffer              *self,
+                   GoclQueue               *queue,
+                   GoclBuffer              *target,
+                   const gsize             *src_origin,
+                   const gsize             *dst_origin,
+                   const gsize             *region,
+                   gsize                    src_row_pitch,
+                   gsize                    src_slice_pitch,
+                   gsize                    dst_row_pitch,
+                   gsize                    dst_slice_pitch,
+                   const GoclEventWaitList *wait_list,
+                   cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueCopyBufferRect (gocl_queue_get_queue (queue),
+                                      self->priv->buf,
+                                      target->priv->buf,
+                                      src_origin,
+                                      dst_origin,
+                                      region,
+                                      src_row_pitch,
+                                      src_slice_pitch,
+                                      dst_row_pitch,
+                                      dst_slice_pitch,
+                                      wait_list->len,
+                                      wait_list->events,
+                                      event);
+  GOCL_TRACE_END ("buffer", "copy-rect", NULL, trace_start);
+
+  return err_code;
+}
+
 /* public */
 
 /**
@@ -370,6 +833,70 @@ gocl_buffer_new (GoclContext  *context,
                          NULL);
 }
 
+/**
+ * gocl_buffer_new_sub_buffer:
+ * @self: The parent #GoclBuffer
+ * @flags: An OR'ed combination of %GOCL_BUFFER_FLAGS_READ_WRITE,
+ * %GOCL_BUFFER_FLAGS_WRITE_ONLY and %GOCL_BUFFER_FLAGS_READ_ONLY, or zero to
+ * inherit the flags of @self
+ * @origin: The offset of the sub-buffer in @self, in bytes
+ * @size: The size of the sub-buffer, in bytes
+ *
+ * Creates a new buffer that refers to a region of @size bytes of @self,
+ * starting at @origin, using clCreateSubBuffer(). No new memory is allocated;
+ * the sub-buffer shares the memory of its parent, and keeps a reference to it.
+ *
+ * @origin must be aligned to the base address alignment of the devices in the
+ * context (CL_DEVICE_MEM_BASE_ADDR_ALIGN).
+ *
+ * Returns: (transfer full): A newly created #GoclBuffer, or %NULL on error
+ **/
+GoclBuffer *
+gocl_buffer_new_sub_buffer (GoclBuffer *self,
+                            guint       flags,
+                            goffset     origin,
+                            gsize       size)
+{
+  GError **error;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (self->priv->parent == NULL, NULL);
+
+  error = gocl_error_prepare ();
+
+  flags &= SUB_BUFFER_FLAGS_MASK;
+  if (flags == 0)
+    flags = self->priv->flags & SUB_BUFFER_FLAGS_MASK;
+  if (flags == 0)
+    flags = GOCL_BUFFER_FLAGS_READ_WRITE;
+
+  return g_initable_new (GOCL_TYPE_BUFFER,
+                         NULL,
+                         error,
+                         "context", self->priv->context,
+                         "flags", flags,
+                         "size", size,
+                         "parent", self,
+                         "origin", (guint64) origin,
+                         NULL);
+}
+
+/**
+ * gocl_buffer_get_size:
+ * @self: The #GoclBuffer
+ *
+ * Retrieves the size of the buffer, in bytes.
+ *
+ * Returns: The size of the buffer
+ **/
+gsize
+gocl_buffer_get_size (GoclBuffer *self)
+{
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), 0);
+
+  return self->priv->size;
+}
+
 /**
  * gocl_buffer_get_buffer:
  * @self: The #GoclBuffer
@@ -403,91 +930,119 @@ gocl_buffer_get_context (GoclBuffer *buffer)
   return buffer->priv->context;
 }
 
+GoclEvent *
+gocl_buffer_read (GoclBuffer *self,
+                  GoclQueue  *queue,
+                  gpointer    target_ptr,
+                  gsize       size,
+                  goffset     offset,
+                  GList      *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = enqueue_read (self, queue, target_ptr, size, offset, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
 /**
- * gocl_buffer_read:
+ * gocl_buffer_read_v:
  * @self: The #GoclBuffer
  * @queue: A #GoclQueue where the operation will be enqueued
  * @target_ptr: (array length=size) (element-type guint8): The pointer to copy
  * the data to
  * @size: The size of the data to be read
  * @offset: The offset to start reading from
- * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
- * object to wait for, or %NULL
- *
- * Asynchronously reads a block of data of @size bytes from remote context
- * into host memory, starting at @offset. The operation is enqueued in
- * @queue, and the program execution continues without blocking. For a
- * synchronous version of this methid, see gocl_buffer_read_sync().
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
  *
- * A #GoclEvent is returned so that the application can get notified when the
- * operation finishes, by calling gocl_event_then(). Also, the returned event
- * can be added to the @event_wait_list argument of other operations, to
- * synchronize their execution with the completion of this operation.
- *
- * If @event_wait_list is provided, the read operation will start only when
- * all the #GoclEvent in the list have triggered.
+ * Same as gocl_buffer_read(), but takes the events to wait for as an array.
+ * Wait lists of a few events are passed to OpenCL without allocating any
+ * memory, which makes this the preferred variant for applications that
+ * enqueue many small operations.
  *
  * Returns: (transfer none): A #GoclEvent to get notified when the read
  * operation finishes
  **/
 GoclEvent *
-gocl_buffer_read (GoclBuffer *self,
-                  GoclQueue  *queue,
-                  gpointer    target_ptr,
-                  gsize       size,
-                  goffset     offset,
-                  GList      *event_wait_list)
+gocl_buffer_read_v (GoclBuffer        *self,
+                    GoclQueue         *queue,
+                    gpointer           target_ptr,
+                    gsize              size,
+                    goffset            offset,
+                    GoclEvent * const *event_wait_list,
+                    guint              num_events)
 {
-  GError *error = NULL;
-  cl_int err_code;
-  cl_event event;
-  cl_command_queue _queue;
-
-  GoclEvent *_event = NULL;
-  GoclEventResolverFunc resolver_func;
-
-  cl_event *_event_wait_list = NULL;
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
 
   g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
   g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list, NULL);
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  event = enqueue_read (self, queue, target_ptr, size, offset, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
 
-  _queue = gocl_queue_get_queue (queue);
+  return event;
+}
 
-  err_code = clEnqueueReadBuffer (_queue,
-                                  self->priv->buf,
-                                  CL_FALSE,
-                                  offset,
-                                  size,
-                                  target_ptr,
-                                  g_list_length (event_wait_list),
-                                  _event_wait_list,
-                                  &event);
-  g_free (_event_wait_list);
+/**
+ * gocl_buffer_read_detached:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: (array length=size) (element-type guint8): The pointer to copy
+ * the data to
+ * @size: The size of the data to be read
+ * @offset: The offset to start reading from
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_buffer_read_v(), but no event is created for the operation.
+ * The data in @target_ptr is available once a fence enqueued afterwards on
+ * @queue completes, see gocl_queue_fence(). The events in @event_wait_list
+ * must remain alive until the operation starts, since no reference to them
+ * is kept.
+ *
+ * Returns: %TRUE if the operation was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_buffer_read_detached (GoclBuffer        *self,
+                           GoclQueue         *queue,
+                           gpointer           target_ptr,
+                           gsize              size,
+                           goffset            offset,
+                           GoclEvent * const *event_wait_list,
+                           guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  cl_int err_code;
 
-  if (gocl_error_check_opencl (err_code, &error))
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             NULL);
-      resolver_func = gocl_event_steal_resolver_func (_event);
-      resolver_func (_event, error);
-      g_error_free (error);
-    }
-  else
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             "event", event,
-                             NULL);
-      gocl_event_set_event_wait_list (_event, event_wait_list);
-      gocl_event_steal_resolver_func (_event);
-    }
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
 
-  gocl_event_idle_unref (_event);
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  err_code = enqueue_transfer_detached (self,
+                                        queue,
+                                        FALSE,
+                                        target_ptr,
+                                        size,
+                                        offset,
+                                        &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
 
-  return _event;
+  return ! gocl_error_check_opencl_internal (err_code);
 }
 
 /**
@@ -517,127 +1072,150 @@ gocl_buffer_read_sync (GoclBuffer *self,
                        goffset     offset,
                        GList      *event_wait_list)
 {
-  cl_command_queue _queue;
   cl_int err_code;
-  cl_event *_event_wait_list = NULL;
+  GoclEventWaitList wait_list;
 
   g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
   g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list, NULL);
-
-  _queue = gocl_queue_get_queue (queue);
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
 
-  err_code = clEnqueueReadBuffer (_queue,
-                                  self->priv->buf,
-                                  CL_TRUE,
-                                  offset,
-                                  size,
-                                  target_ptr,
-                                  g_list_length (event_wait_list),
-                                  _event_wait_list,
-                                  NULL);
+  err_code = enqueue_transfer (self,
+                               queue,
+                               FALSE,
+                               TRUE,
+                               target_ptr,
+                               size,
+                               offset,
+                               &wait_list,
+                               "read-sync",
+                               NULL);
 
-  g_free (_event_wait_list);
+  gocl_event_wait_list_clear (&wait_list);
 
   return ! gocl_error_check_opencl_internal (err_code);
 }
 
+GoclEvent *
+gocl_buffer_write (GoclBuffer     *self,
+                   GoclQueue      *queue,
+                   const gpointer  data,
+                   gsize           size,
+                   goffset         offset,
+                   GList          *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = enqueue_write (self, queue, data, size, offset, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
 /**
- * gocl_buffer_write:
+ * gocl_buffer_write_v:
  * @self: The #GoclBuffer
  * @queue: A #GoclQueue where the operation will be enqueued
  * @data: A pointer to write data from
  * @size: The size of the data to be written
  * @offset: The offset to start writing data to
- * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
- * object to wait for, or %NULL
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
  *
- * Asynchronously writes a block of data of @size bytes from host memory into
- * remote context, starting at @offset. The operation is enqueued in
- * @queue, and the program execution continues without blocking. For a
- * synchronous version of this methid, see gocl_buffer_write_sync().
- *
- * A #GoclEvent is returned so that the application can get notified when the
- * operation finishes, by calling gocl_event_then(). Also, the returned event
- * can be added to the @event_wait_list argument of other operations, to
- * synchronize their execution with the completion of this operation.
- *
- * If @event_wait_list is provided, the write operation will start only when
- * all the #GoclEvent in the list have triggered.
+ * Same as gocl_buffer_write(), but takes the events to wait for as an
+ * array, like gocl_buffer_read_v().
  *
  * Returns: (transfer none): A #GoclEvent to get notified when the write
  * operation finishes
  **/
 GoclEvent *
-gocl_buffer_write (GoclBuffer     *self,
-                   GoclQueue      *queue,
-                   const gpointer  data,
-                   gsize           size,
-                   goffset         offset,
-                   GList          *event_wait_list)
+gocl_buffer_write_v (GoclBuffer        *self,
+                     GoclQueue         *queue,
+                     const gpointer     data,
+                     gsize              size,
+                     goffset            offset,
+                     GoclEvent * const *event_wait_list,
+                     guint              num_events)
 {
-  GError *error = NULL;
-  cl_int err_code;
-  cl_event event;
-  cl_command_queue _queue;
-
-  GoclEvent *_event = NULL;
-  GoclEventResolverFunc resolver_func;
-
-  cl_event *_event_wait_list = NULL;
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
 
   g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
   g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list, NULL);
-
-  _queue = gocl_queue_get_queue (queue);
-
-  err_code = clEnqueueWriteBuffer (_queue,
-                                   self->priv->buf,
-                                   CL_FALSE,
-                                   offset,
-                                   size,
-                                   data,
-                                   g_list_length (event_wait_list),
-                                   _event_wait_list,
-                                   &event);
-  g_free (_event_wait_list);
-
-  if (gocl_error_check_opencl (err_code, &error))
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             NULL);
-      resolver_func = gocl_event_steal_resolver_func (_event);
-      resolver_func (_event, error);
-      g_error_free (error);
-    }
-  else
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             "event", event,
-                             NULL);
-      gocl_event_set_event_wait_list (_event, event_wait_list);
-      gocl_event_steal_resolver_func (_event);
-    }
-
-  gocl_event_idle_unref (_event);
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  event = enqueue_write (self, queue, data, size, offset, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
 
-  return _event;
+  return event;
 }
 
 /**
- * gocl_buffer_write_sync:
+ * gocl_buffer_write_detached:
  * @self: The #GoclBuffer
  * @queue: A #GoclQueue where the operation will be enqueued
  * @data: A pointer to write data from
  * @size: The size of the data to be written
  * @offset: The offset to start writing data to
- * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
- * object to wait for, or %NULL
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_buffer_write_v(), but no event is created for the operation.
+ * @data must not be modified until a fence enqueued afterwards on @queue
+ * completes, see gocl_queue_fence(). The events in @event_wait_list must
+ * remain alive until the operation starts, since no reference to them is
+ * kept.
+ *
+ * Returns: %TRUE if the operation was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_buffer_write_detached (GoclBuffer        *self,
+                            GoclQueue         *queue,
+                            const gpointer     data,
+                            gsize              size,
+                            goffset            offset,
+                            GoclEvent * const *event_wait_list,
+                            guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  cl_int err_code;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  err_code = enqueue_transfer_detached (self,
+                                        queue,
+                                        TRUE,
+                                        data,
+                                        size,
+                                        offset,
+                                        &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_buffer_write_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @data: A pointer to write data from
+ * @size: The size of the data to be written
+ * @offset: The offset to start writing data to
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
  *
  * Writes a block of data of @size bytes from host memory into remote context
  * memory, starting at @offset. The operation is actually enqueued in @queue, and
@@ -655,30 +1233,1025 @@ gocl_buffer_write_sync (GoclBuffer     *self,
                         goffset         offset,
                         GList          *event_wait_list)
 {
-  cl_command_queue _queue;
   cl_int err_code;
-  cl_event *_event_wait_list = NULL;
+  GoclEventWaitList wait_list;
 
   g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
   g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list, NULL);
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_transfer (self,
+                               queue,
+                               TRUE,
+                               TRUE,
+                               data,
+                               size,
+                               offset,
+                               &wait_list,
+                               "write-sync",
+                               NULL);
+
+  gocl_event_wait_list_clear (&wait_list);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_buffer_map_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @size: The size of the region to map, in bytes
+ * @offset: The offset of the region to map
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Maps a region of @size bytes of the buffer, starting at @offset, into the
+ * host address space, blocking the program execution until the operation
+ * finishes. For an asynchronous version of this method, see
+ * gocl_buffer_map().
+ *
+ * For buffers created with %GOCL_BUFFER_FLAGS_ALLOC_HOST_PTR or
+ * %GOCL_BUFFER_FLAGS_USE_HOST_PTR, the returned pointer normally refers to the
+ * buffer memory itself, so the host can read and write its contents in place,
+ * without additional copies.
+ *
+ * The region must be unmapped with gocl_buffer_unmap_sync() or
+ * gocl_buffer_unmap() before the buffer is used again by a kernel.
+ *
+ * Returns: (transfer none): A pointer to the mapped region, or %NULL on error
+ **/
+gpointer
+gocl_buffer_map_sync (GoclBuffer *self,
+                      GoclQueue  *queue,
+                      guint       map_flags,
+                      gsize       size,
+                      goffset     offset,
+                      GList      *event_wait_list)
+{
+  cl_command_queue _queue;
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+  gpointer mapped_ptr;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
 
   _queue = gocl_queue_get_queue (queue);
 
-  err_code = clEnqueueWriteBuffer (_queue,
+  mapped_ptr = clEnqueueMapBuffer (_queue,
                                    self->priv->buf,
                                    CL_TRUE,
+                                   map_flags,
                                    offset,
                                    size,
-                                   data,
-                                   g_list_length (event_wait_list),
-                                   _event_wait_list,
-                                   NULL);
+                                   wait_list.len,
+                                   wait_list.events,
+                                   NULL,
+                                   &err_code);
+  gocl_event_wait_list_clear (&wait_list);
 
-  g_free (_event_wait_list);
+  if (gocl_error_check_opencl_internal (err_code))
+    return NULL;
 
-  return ! gocl_error_check_opencl_internal (err_code);
+  return mapped_ptr;
+}
+
+/**
+ * gocl_buffer_map:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @size: The size of the region to map, in bytes
+ * @offset: The offset of the region to map
+ * @mapped_ptr: (out) (transfer none): A pointer to retrieve the address of
+ * the mapped region
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously maps a region of @size bytes of the buffer, starting at
+ * @offset, into the host address space. The address of the mapped region is
+ * stored in @mapped_ptr right away, but its contents must not be accessed
+ * until the returned #GoclEvent triggers. For a synchronous version of this
+ * method, see gocl_buffer_map_sync().
+ *
+ * If @event_wait_list is provided, the map operation will start only when
+ * all the #GoclEvent in the list have triggered.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the map
+ * operation finishes
+ **/
+GoclEvent *
+gocl_buffer_map (GoclBuffer *self,
+                 GoclQueue  *queue,
+                 guint       map_flags,
+                 gsize       size,
+                 goffset     offset,
+                 gpointer   *mapped_ptr,
+                 GList      *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  cl_command_queue _queue;
+  GoclEvent *_event;
+
+  GoclEventWaitList wait_list;
+  gpointer ptr;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (mapped_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  _queue = gocl_queue_get_queue (queue);
+
+  ptr = clEnqueueMapBuffer (_queue,
+                            self->priv->buf,
+                            CL_FALSE,
+                            map_flags,
+                            offset,
+                            size,
+                            wait_list.len,
+                            wait_list.events,
+                            &event,
+                            &err_code);
+
+  *mapped_ptr = err_code == CL_SUCCESS ? ptr : NULL;
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_unmap_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @mapped_ptr: A pointer previously returned by gocl_buffer_map_sync() or
+ * gocl_buffer_map()
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Unmaps a region of the buffer previously mapped into the host address
+ * space, blocking the program execution until the operation finishes. After
+ * this call, @mapped_ptr is no longer valid.
+ *
+ * This method also works for #GoclImage objects mapped with
+ * gocl_image_map_sync() or gocl_image_map().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_unmap_sync (GoclBuffer *self,
+                        GoclQueue  *queue,
+                        gpointer    mapped_ptr,
+                        GList      *event_wait_list)
+{
+  cl_command_queue _queue;
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (mapped_ptr != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  _queue = gocl_queue_get_queue (queue);
+
+  err_code = clEnqueueUnmapMemObject (_queue,
+                                      self->priv->buf,
+                                      mapped_ptr,
+                                      wait_list.len,
+                                      wait_list.events,
+                                      &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  clWaitForEvents (1, &event);
+  clReleaseEvent (event);
+
+  return TRUE;
+}
+
+/**
+ * gocl_buffer_unmap:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @mapped_ptr: A pointer previously returned by gocl_buffer_map_sync() or
+ * gocl_buffer_map()
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously unmaps a region of the buffer previously mapped into the
+ * host address space. The host must not access @mapped_ptr after calling
+ * this method. For a synchronous version of this method, see
+ * gocl_buffer_unmap_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the unmap
+ * operation finishes
+ **/
+GoclEvent *
+gocl_buffer_unmap (GoclBuffer *self,
+                   GoclQueue  *queue,
+                   gpointer    mapped_ptr,
+                   GList      *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  cl_command_queue _queue;
+  GoclEvent *_event;
+
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (mapped_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  _queue = gocl_queue_get_queue (queue);
+
+  err_code = clEnqueueUnmapMemObject (_queue,
+                                      self->priv->buf,
+                                      mapped_ptr,
+                                      wait_list.len,
+                                      wait_list.events,
+                                      &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_copy_sync:
+ * @self: The #GoclBuffer to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @size: The number of bytes to copy
+ * @src_offset: The offset in @self to start copying from
+ * @dst_offset: The offset in @target to start copying to
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Copies @size bytes from this buffer into @target, without going through
+ * host memory, and blocks the program execution until the copy finishes.
+ * For a non-blocking version of this method, see gocl_buffer_copy().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_copy_sync (GoclBuffer *self,
+                       GoclQueue  *queue,
+                       GoclBuffer *target,
+                       gsize       size,
+                       goffset     src_offset,
+                       goffset     dst_offset,
+                       GList      *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy (self,
+                           queue,
+                           target,
+                           size,
+                           src_offset,
+                           dst_offset,
+                           &wait_list,
+                           &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_buffer_copy:
+ * @self: The #GoclBuffer to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @size: The number of bytes to copy
+ * @src_offset: The offset in @self to start copying from
+ * @dst_offset: The offset in @target to start copying to
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously copies @size bytes from this buffer into @target, without
+ * going through host memory. For a blocking version of this method, see
+ * gocl_buffer_copy_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the copy
+ * finishes
+ **/
+GoclEvent *
+gocl_buffer_copy (GoclBuffer *self,
+                  GoclQueue  *queue,
+                  GoclBuffer *target,
+                  gsize       size,
+                  goffset     src_offset,
+                  goffset     dst_offset,
+                  GList      *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy (self,
+                           queue,
+                           target,
+                           size,
+                           src_offset,
+                           dst_offset,
+                           &wait_list,
+                           &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_copy_detached:
+ * @self: The #GoclBuffer to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @size: The number of bytes to copy
+ * @src_offset: The offset in @self to start copying from
+ * @dst_offset: The offset in @target to start copying to
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_buffer_copy(), but no event is created for the operation.
+ * Its completion is signalled by the next fence of @queue, see
+ * gocl_queue_fence(). The events in @event_wait_list must remain alive
+ * until the operation starts, since no reference to them is kept.
+ *
+ * Returns: %TRUE if the operation was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_buffer_copy_detached (GoclBuffer        *self,
+                           GoclQueue         *queue,
+                           GoclBuffer        *target,
+                           gsize              size,
+                           goffset            src_offset,
+                           goffset            dst_offset,
+                           GoclEvent * const *event_wait_list,
+                           guint              num_events)
+{
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), FALSE);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+
+  err_code = enqueue_copy (self,
+                           queue,
+                           target,
+                           size,
+                           src_offset,
+                           dst_offset,
+                           &wait_list,
+                           NULL);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  gocl_queue_add_detached (queue);
+
+  return TRUE;
+}
+
+/**
+ * gocl_buffer_fill_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @pattern: (array length=pattern_size) (element-type guint8): The pattern
+ * to fill the buffer with
+ * @pattern_size: The size of @pattern, in bytes. It must be 1, 2, 4, 8, 16,
+ * 32, 64 or 128
+ * @size: The number of bytes to fill, a multiple of @pattern_size
+ * @offset: The offset in the buffer to start filling at, a multiple of
+ * @pattern_size
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Fills a region of the buffer by repeating @pattern, blocking the program
+ * execution until the operation finishes. This is the efficient way of
+ * clearing a buffer, since no data needs to be transferred from the host.
+ * For a non-blocking version of this method, see gocl_buffer_fill().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_fill_sync (GoclBuffer    *self,
+                       GoclQueue     *queue,
+                       gconstpointer  pattern,
+                       gsize          pattern_size,
+                       gsize          size,
+                       goffset        offset,
+                       GList         *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (pattern != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_fill (self,
+                           queue,
+                           pattern,
+                           pattern_size,
+                           size,
+                           offset,
+                           &wait_list,
+                           &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_buffer_fill:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @pattern: (array length=pattern_size) (element-type guint8): The pattern
+ * to fill the buffer with. It is copied, so it can be freed right away
+ * @pattern_size: The size of @pattern, in bytes. It must be 1, 2, 4, 8, 16,
+ * 32, 64 or 128
+ * @size: The number of bytes to fill, a multiple of @pattern_size
+ * @offset: The offset in the buffer to start filling at, a multiple of
+ * @pattern_size
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously fills a region of the buffer by repeating @pattern. For a
+ * blocking version of this method, see gocl_buffer_fill_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the operation
+ * finishes
+ **/
+GoclEvent *
+gocl_buffer_fill (GoclBuffer    *self,
+                  GoclQueue     *queue,
+                  gconstpointer  pattern,
+                  gsize          pattern_size,
+                  gsize          size,
+                  goffset        offset,
+                  GList         *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (pattern != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_fill (self,
+                           queue,
+                           pattern,
+                           pattern_size,
+                           size,
+                           offset,
+                           &wait_list,
+                           &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_fill_detached:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @pattern: (array length=pattern_size) (element-type guint8): The pattern
+ * to fill the buffer with. It is copied, so it can be freed right away
+ * @pattern_size: The size of @pattern, in bytes. It must be 1, 2, 4, 8, 16,
+ * 32, 64 or 128
+ * @size: The number of bytes to fill, a multiple of @pattern_size
+ * @offset: The offset in the buffer to start filling at, a multiple of
+ * @pattern_size
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent objects to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_buffer_fill(), but no event is created for the operation.
+ * Its completion is signalled by the next fence of @queue, see
+ * gocl_queue_fence(). The events in @event_wait_list must remain alive
+ * until the operation starts, since no reference to them is kept.
+ *
+ * Returns: %TRUE if the operation was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_buffer_fill_detached (GoclBuffer        *self,
+                           GoclQueue         *queue,
+                           gconstpointer      pattern,
+                           gsize              pattern_size,
+                           gsize              size,
+                           goffset            offset,
+                           GoclEvent * const *event_wait_list,
+                           guint              num_events)
+{
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (pattern != NULL, FALSE);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+
+  err_code = enqueue_fill (self,
+                           queue,
+                           pattern,
+                           pattern_size,
+                           size,
+                           offset,
+                           &wait_list,
+                           NULL);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  gocl_queue_add_detached (queue);
+
+  return TRUE;
+}
+
+/**
+ * gocl_buffer_read_rect_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: A pointer to host memory to copy the data into
+ * @buffer_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in the buffer
+ * @host_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in host memory
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to read
+ * @buffer_row_pitch: The length of each row in the buffer, in bytes, or 0 to
+ * use @region's width
+ * @buffer_slice_pitch: The size of each slice in the buffer, in bytes, or 0
+ * to compute it from @buffer_row_pitch
+ * @host_row_pitch: The length of each row in host memory, in bytes, or 0 to
+ * use @region's width
+ * @host_slice_pitch: The size of each slice in host memory, in bytes, or 0
+ * to compute it from @host_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Reads a 2D or 3D rectangular region of the buffer into a rectangular region
+ * of host memory, blocking the program execution until the operation
+ * finishes. For a non-blocking version of this method, see
+ * gocl_buffer_read_rect().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_read_rect_sync (GoclBuffer  *self,
+                            GoclQueue   *queue,
+                            gpointer     target_ptr,
+                            const gsize *buffer_origin,
+                            const gsize *host_origin,
+                            const gsize *region,
+                            gsize        buffer_row_pitch,
+                            gsize        buffer_slice_pitch,
+                            gsize        host_row_pitch,
+                            gsize        host_slice_pitch,
+                            GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (target_ptr != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_read_rect (self,
+                                queue,
+                                target_ptr,
+                                buffer_origin,
+                                host_origin,
+                                region,
+                                buffer_row_pitch,
+                                buffer_slice_pitch,
+                                host_row_pitch,
+                                host_slice_pitch,
+                                &wait_list,
+                                &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_buffer_read_rect:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: A pointer to host memory to copy the data into
+ * @buffer_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in the buffer
+ * @host_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in host memory
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to read
+ * @buffer_row_pitch: The length of each row in the buffer, in bytes, or 0 to
+ * use @region's width
+ * @buffer_slice_pitch: The size of each slice in the buffer, in bytes, or 0
+ * to compute it from @buffer_row_pitch
+ * @host_row_pitch: The length of each row in host memory, in bytes, or 0 to
+ * use @region's width
+ * @host_slice_pitch: The size of each slice in host memory, in bytes, or 0
+ * to compute it from @host_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously reads a 2D or 3D rectangular region of the buffer into a
+ * rectangular region of host memory. The contents of @target_ptr are valid
+ * only after the returned #GoclEvent triggers. For a blocking version of
+ * this method, see gocl_buffer_read_rect_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the read
+ * operation finishes
+ **/
+GoclEvent *
+gocl_buffer_read_rect (GoclBuffer  *self,
+                       GoclQueue   *queue,
+                       gpointer     target_ptr,
+                       const gsize *buffer_origin,
+                       const gsize *host_origin,
+                       const gsize *region,
+                       gsize        buffer_row_pitch,
+                       gsize        buffer_slice_pitch,
+                       gsize        host_row_pitch,
+                       gsize        host_slice_pitch,
+                       GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (target_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_read_rect (self,
+                                queue,
+                                target_ptr,
+                                buffer_origin,
+                                host_origin,
+                                region,
+                                buffer_row_pitch,
+                                buffer_slice_pitch,
+                                host_row_pitch,
+                                host_slice_pitch,
+                                &wait_list,
+                                &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_write_rect_sync:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @data: A pointer to host memory to copy the data from
+ * @buffer_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in the buffer
+ * @host_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in host memory
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to write
+ * @buffer_row_pitch: The length of each row in the buffer, in bytes, or 0 to
+ * use @region's width
+ * @buffer_slice_pitch: The size of each slice in the buffer, in bytes, or 0
+ * to compute it from @buffer_row_pitch
+ * @host_row_pitch: The length of each row in host memory, in bytes, or 0 to
+ * use @region's width
+ * @host_slice_pitch: The size of each slice in host memory, in bytes, or 0
+ * to compute it from @host_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Writes a rectangular region of host memory into a 2D or 3D rectangular
+ * region of the buffer, blocking the program execution until the operation
+ * finishes. For a non-blocking version of this method, see
+ * gocl_buffer_write_rect().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_write_rect_sync (GoclBuffer     *self,
+                             GoclQueue      *queue,
+                             const gpointer  data,
+                             const gsize    *buffer_origin,
+                             const gsize    *host_origin,
+                             const gsize    *region,
+                             gsize           buffer_row_pitch,
+                             gsize           buffer_slice_pitch,
+                             gsize           host_row_pitch,
+                             gsize           host_slice_pitch,
+                             GList          *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_write_rect (self,
+                                 queue,
+                                 data,
+                                 buffer_origin,
+                                 host_origin,
+                                 region,
+                                 buffer_row_pitch,
+                                 buffer_slice_pitch,
+                                 host_row_pitch,
+                                 host_slice_pitch,
+                                 &wait_list,
+                                 &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_buffer_write_rect:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @data: A pointer to host memory to copy the data from. It must remain
+ * valid until the operation finishes
+ * @buffer_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in the buffer
+ * @host_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in host memory
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to write
+ * @buffer_row_pitch: The length of each row in the buffer, in bytes, or 0 to
+ * use @region's width
+ * @buffer_slice_pitch: The size of each slice in the buffer, in bytes, or 0
+ * to compute it from @buffer_row_pitch
+ * @host_row_pitch: The length of each row in host memory, in bytes, or 0 to
+ * use @region's width
+ * @host_slice_pitch: The size of each slice in host memory, in bytes, or 0
+ * to compute it from @host_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously writes a rectangular region of host memory into a 2D or 3D
+ * rectangular region of the buffer. For a blocking version of this method,
+ * see gocl_buffer_write_rect_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the write
+ * operation finishes
+ **/
+GoclEvent *
+gocl_buffer_write_rect (GoclBuffer     *self,
+                        GoclQueue      *queue,
+                        const gpointer  data,
+                        const gsize    *buffer_origin,
+                        const gsize    *host_origin,
+                        const gsize    *region,
+                        gsize           buffer_row_pitch,
+                        gsize           buffer_slice_pitch,
+                        gsize           host_row_pitch,
+                        gsize           host_slice_pitch,
+                        GList          *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (data != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_write_rect (self,
+                                 queue,
+                                 data,
+                                 buffer_origin,
+                                 host_origin,
+                                 region,
+                                 buffer_row_pitch,
+                                 buffer_slice_pitch,
+                                 host_row_pitch,
+                                 host_slice_pitch,
+                                 &wait_list,
+                                 &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_buffer_copy_rect_sync:
+ * @self: The #GoclBuffer to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @src_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in @self
+ * @dst_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in @target
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to copy
+ * @src_row_pitch: The length of each row in @self, in bytes, or 0 to use
+ * @region's width
+ * @src_slice_pitch: The size of each slice in @self, in bytes, or 0 to
+ * compute it from @src_row_pitch
+ * @dst_row_pitch: The length of each row in @target, in bytes, or 0 to use
+ * @region's width
+ * @dst_slice_pitch: The size of each slice in @target, in bytes, or 0 to
+ * compute it from @dst_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Copies a 2D or 3D rectangular region of this buffer into a rectangular
+ * region of @target, blocking the program execution until the copy
+ * finishes. For a non-blocking version of this method, see
+ * gocl_buffer_copy_rect().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_buffer_copy_rect_sync (GoclBuffer  *self,
+                            GoclQueue   *queue,
+                            GoclBuffer  *target,
+                            const gsize *src_origin,
+                            const gsize *dst_origin,
+                            const gsize *region,
+                            gsize        src_row_pitch,
+                            gsize        src_slice_pitch,
+                            gsize        dst_row_pitch,
+                            gsize        dst_slice_pitch,
+                            GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_rect (self,
+                                queue,
+                                target,
+                                src_origin,
+                                dst_origin,
+                                region,
+                                src_row_pitch,
+                                src_slice_pitch,
+                                dst_row_pitch,
+                                dst_slice_pitch,
+                                &wait_list,
+                                &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_buffer_copy_rect:
+ * @self: The #GoclBuffer to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @src_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in @self
+ * @dst_origin: (array fixed-size=3): The (x in bytes, y, z) origin of the
+ * region in @target
+ * @region: (array fixed-size=3): The (width in bytes, height, depth) of the
+ * region to copy
+ * @src_row_pitch: The length of each row in @self, in bytes, or 0 to use
+ * @region's width
+ * @src_slice_pitch: The size of each slice in @self, in bytes, or 0 to
+ * compute it from @src_row_pitch
+ * @dst_row_pitch: The length of each row in @target, in bytes, or 0 to use
+ * @region's width
+ * @dst_slice_pitch: The size of each slice in @target, in bytes, or 0 to
+ * compute it from @dst_row_pitch
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously copies a 2D or 3D rectangular region of this buffer into a
+ * rectangular region of @target. For a blocking version of this method, see
+ * gocl_buffer_copy_rect_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the copy
+ * finishes
+ **/
+GoclEvent *
+gocl_buffer_copy_rect (GoclBuffer  *self,
+                       GoclQueue   *queue,
+                       GoclBuffer  *target,
+                       const gsize *src_origin,
+                       const gsize *dst_origin,
+                       const gsize *region,
+                       gsize        src_row_pitch,
+                       gsize        src_slice_pitch,
+                       gsize        dst_row_pitch,
+                       gsize        dst_slice_pitch,
+                       GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_rect (self,
+                                queue,
+                                target,
+                                src_origin,
+                                dst_origin,
+                                region,
+                                src_row_pitch,
+                                src_slice_pitch,
+                                dst_row_pitch,
+                                dst_slice_pitch,
+                                &wait_list,
+                                &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
 }
 
 /**
@@ -741,7 +2314,8 @@ gocl_buffer_list_to_array (GList *list, guint *len)
  *
  * Reads all the data in buffer from remote context into the host memory
  * referenced by @target_ptr. The operation is enqueued in @queue, and the
- * program execution blocks until the read finishes.
+ * program execution blocks until the read finishes. For a non-blocking
+ * version of this method, see gocl_buffer_read_all().
  *
  * If @size is not %NULL, it will store the total size read.
  *
@@ -760,16 +2334,17 @@ gocl_buffer_read_all_sync (GoclBuffer *self,
   GoclBufferClass *class;
   cl_command_queue _queue;
   cl_int err_code;
-  cl_event *_event_wait_list = NULL;
-  guint event_wait_list_len;
+  cl_event event = NULL;
+  GoclEventWaitList wait_list;
   cl_mem buffer;
+  gsize _size = 0;
+  gint64 trace_start;
 
   g_return_val_if_fail (GOCL_IS_BUFFER (self), FALSE);
   g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
   g_return_val_if_fail (target_ptr != NULL, FALSE);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list,
-                                               &event_wait_list_len);
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
 
   _queue = gocl_queue_get_queue (queue);
 
@@ -778,16 +2353,107 @@ gocl_buffer_read_all_sync (GoclBuffer *self,
   class = GOCL_BUFFER_GET_CLASS (self);
   g_assert (class->read_all != NULL);
 
+  trace_start = GOCL_TRACE_BEGIN ();
   err_code = class->read_all (self,
                               buffer,
                               _queue,
                               target_ptr,
-                              size,
+                              &_size,
                               TRUE,
-                              _event_wait_list,
-                              event_wait_list_len,
-                              NULL);
-  g_free (_event_wait_list);
+                              wait_list.events,
+                              wait_list.len,
+                              &event);
+  GOCL_TRACE_END ("buffer", "read-all-sync", NULL, trace_start);
+  gocl_event_wait_list_clear (&wait_list);
+
+  /* the same tracking as gocl_buffer_read_all() */
+  if (err_code == CL_SUCCESS)
+    {
+      gocl_context_track_pinned_transfer (self->priv->context,
+                                          target_ptr,
+                                          _size,
+                                          event);
+      clReleaseEvent (event);
+    }
+
+  if (size != NULL)
+    *size = _size;
 
   return ! gocl_error_check_opencl_internal (err_code);
 }
+
+/**
+ * gocl_buffer_read_all:
+ * @self: The #GoclBuffer
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: (array length=size) (element-type guint8) (allow-none): The
+ * pointer to copy the data to
+ * @size: (out) (allow-none): A pointer to retrieve the size of the buffer,
+ * or %NULL
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously reads all the data in buffer from remote context into the
+ * host memory referenced by @target_ptr. The size is stored in @size right
+ * away, but the contents of @target_ptr must not be accessed until the
+ * returned #GoclEvent triggers. For a blocking version of this method, see
+ * gocl_buffer_read_all_sync().
+ *
+ * For a #GoclImage, the whole image is read with its rows tightly packed.
+ * To read only a region of an image, see gocl_image_read().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the read
+ * operation finishes
+ **/
+GoclEvent *
+gocl_buffer_read_all (GoclBuffer *self,
+                      GoclQueue  *queue,
+                      gpointer    target_ptr,
+                      gsize      *size,
+                      GList      *event_wait_list)
+{
+  GoclBufferClass *class;
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+  gsize _size = 0;
+  gint64 trace_start;
+
+  g_return_val_if_fail (GOCL_IS_BUFFER (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (target_ptr != NULL, NULL);
+
+  class = GOCL_BUFFER_GET_CLASS (self);
+  g_assert (class->read_all != NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = class->read_all (self,
+                              self->priv->buf,
+                              gocl_queue_get_queue (queue),
+                              target_ptr,
+                              &_size,
+                              FALSE,
+                              wait_list.events,
+                              wait_list.len,
+                              &event);
+  GOCL_TRACE_END ("buffer", "read-all", NULL, trace_start);
+
+  /* keep pinned memory from being recycled while in use */
+  if (err_code == CL_SUCCESS)
+    gocl_context_track_pinned_transfer (self->priv->context,
+                                        target_ptr,
+                                        _size,
+                                        event);
+
+  if (size != NULL)
+    *size = _size;
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
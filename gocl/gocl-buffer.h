@@ -73,12 +73,33 @@ struct _GoclBufferClass
 
 GType                  gocl_buffer_get_type                   (void) G_GNUC_CONST;
 
+GoclBuffer *           gocl_buffer_new_sub_buffer             (GoclBuffer *self,
+                                                               guint       flags,
+                                                               goffset     origin,
+                                                               gsize       size);
+
+gsize                  gocl_buffer_get_size                   (GoclBuffer *self);
+
 GoclEvent *            gocl_buffer_read                       (GoclBuffer *self,
                                                                GoclQueue  *queue,
                                                                gpointer    target_ptr,
                                                                gsize       size,
                                                                goffset     offset,
                                                                GList      *event_wait_list);
+GoclEvent *            gocl_buffer_read_v                     (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               gpointer           target_ptr,
+                                                               gsize              size,
+                                                               goffset            offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+gboolean               gocl_buffer_read_detached              (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               gpointer           target_ptr,
+                                                               gsize              size,
+                                                               goffset            offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
 gboolean               gocl_buffer_read_sync                  (GoclBuffer  *self,
                                                                GoclQueue   *queue,
                                                                gpointer     target_ptr,
@@ -91,6 +112,20 @@ GoclEvent *            gocl_buffer_write                      (GoclBuffer     *s
                                                                gsize           size,
                                                                goffset         offset,
                                                                GList          *event_wait_list);
+GoclEvent *            gocl_buffer_write_v                    (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               const gpointer     data,
+                                                               gsize              size,
+                                                               goffset            offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+gboolean               gocl_buffer_write_detached             (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               const gpointer     data,
+                                                               gsize              size,
+                                                               goffset            offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
 gboolean               gocl_buffer_write_sync                 (GoclBuffer      *self,
                                                                GoclQueue       *queue,
                                                                const gpointer   data,
@@ -98,11 +133,151 @@ gboolean               gocl_buffer_write_sync                 (GoclBuffer      *
                                                                goffset          offset,
                                                                GList           *event_wait_list);
 
+gpointer               gocl_buffer_map_sync                   (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               guint        map_flags,
+                                                               gsize        size,
+                                                               goffset      offset,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_buffer_map                        (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               guint        map_flags,
+                                                               gsize        size,
+                                                               goffset      offset,
+                                                               gpointer    *mapped_ptr,
+                                                               GList       *event_wait_list);
+gboolean               gocl_buffer_unmap_sync                 (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               gpointer     mapped_ptr,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_buffer_unmap                      (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               gpointer     mapped_ptr,
+                                                               GList       *event_wait_list);
+
+gboolean               gocl_buffer_copy_sync                  (GoclBuffer *self,
+                                                               GoclQueue  *queue,
+                                                               GoclBuffer *target,
+                                                               gsize       size,
+                                                               goffset     src_offset,
+                                                               goffset     dst_offset,
+                                                               GList      *event_wait_list);
+GoclEvent *            gocl_buffer_copy                       (GoclBuffer *self,
+                                                               GoclQueue  *queue,
+                                                               GoclBuffer *target,
+                                                               gsize       size,
+                                                               goffset     src_offset,
+                                                               goffset     dst_offset,
+                                                               GList      *event_wait_list);
+gboolean               gocl_buffer_copy_detached              (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               GoclBuffer        *target,
+                                                               gsize              size,
+                                                               goffset            src_offset,
+                                                               goffset            dst_offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+
+gboolean               gocl_buffer_fill_sync                  (GoclBuffer    *self,
+                                                               GoclQueue     *queue,
+                                                               gconstpointer  pattern,
+                                                               gsize          pattern_size,
+                                                               gsize          size,
+                                                               goffset        offset,
+                                                               GList         *event_wait_list);
+GoclEvent *            gocl_buffer_fill                       (GoclBuffer    *self,
+                                                               GoclQueue     *queue,
+                                                               gconstpointer  pattern,
+                                                               gsize          pattern_size,
+                                                               gsize          size,
+                                                               goffset        offset,
+                                                               GList         *event_wait_list);
+gboolean               gocl_buffer_fill_detached              (GoclBuffer        *self,
+                                                               GoclQueue         *queue,
+                                                               gconstpointer      pattern,
+                                                               gsize              pattern_size,
+                                                               gsize              size,
+                                                               goffset            offset,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+
+gboolean               gocl_buffer_read_rect_sync             (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               gpointer     target_ptr,
+                                                               const gsize *buffer_origin,
+                                                               const gsize *host_origin,
+                                                               const gsize *region,
+                                                               gsize        buffer_row_pitch,
+                                                               gsize        buffer_slice_pitch,
+                                                               gsize        host_row_pitch,
+                                                               gsize        host_slice_pitch,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_buffer_read_rect                  (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               gpointer     target_ptr,
+                                                               const gsize *buffer_origin,
+                                                               const gsize *host_origin,
+                                                               const gsize *region,
+                                                               gsize        buffer_row_pitch,
+                                                               gsize        buffer_slice_pitch,
+                                                               gsize        host_row_pitch,
+                                                               gsize        host_slice_pitch,
+                                                               GList       *event_wait_list);
+gboolean               gocl_buffer_write_rect_sync            (GoclBuffer     *self,
+                                                               GoclQueue      *queue,
+                                                               const gpointer  data,
+                                                               const gsize    *buffer_origin,
+                                                               const gsize    *host_origin,
+                                                               const gsize    *region,
+                                                               gsize           buffer_row_pitch,
+                                                               gsize           buffer_slice_pitch,
+                                                               gsize           host_row_pitch,
+                                                               gsize           host_slice_pitch,
+                                                               GList          *event_wait_list);
+GoclEvent *            gocl_buffer_write_rect                 (GoclBuffer     *self,
+                                                               GoclQueue      *queue,
+                                                               const gpointer  data,
+                                                               const gsize    *buffer_origin,
+                                                               const gsize    *host_origin,
+                                                               const gsize    *region,
+                                                               gsize           buffer_row_pitch,
+                                                               gsize           buffer_slice_pitch,
+                                                               gsize           host_row_pitch,
+                                                               gsize           host_slice_pitch,
+                                                               GList          *event_wait_list);
+gboolean               gocl_buffer_copy_rect_sync             (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               GoclBuffer  *target,
+                                                               const gsize *src_origin,
+                                                               const gsize *dst_origin,
+                                                               const gsize *region,
+                                                               gsize        src_row_pitch,
+                                                               gsize        src_slice_pitch,
+                                                               gsize        dst_row_pitch,
+                                                               gsize        dst_slice_pitch,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_buffer_copy_rect                  (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               GoclBuffer  *target,
+                                                               const gsize *src_origin,
+                                                               const gsize *dst_origin,
+                                                               const gsize *region,
+                                                               gsize        src_row_pitch,
+                                                               gsize        src_slice_pitch,
+                                                               gsize        dst_row_pitch,
+                                                               gsize        dst_slice_pitch,
+                                                               GList       *event_wait_list);
+
 gboolean               gocl_buffer_read_all_sync              (GoclBuffer  *self,
                                                                GoclQueue   *queue,
                                                                gpointer     target_ptr,
                                                                gsize       *size,
                                                                GList       *event_wait_list);
+GoclEvent *            gocl_buffer_read_all                   (GoclBuffer  *self,
+                                                               GoclQueue   *queue,
+                                                               gpointer     target_ptr,
+                                                               gsize       *size,
+                                                               GList       *event_wait_list);
 
 cl_mem *               gocl_buffer_list_to_array              (GList *list,
                                                                guint *len);
@@ -0,0 +1,218 @@
+/*
+ * gocl-cache.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/* Internal functions to store and retrieve data (program binaries, tuning
+   results, etc) in the user's cache directory, under
+   $XDG_CACHE_HOME/gocl. This API is private, not supposed to be used in
+   applications. */
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include "gocl-private.h"
+
+/* bump this whenever the format of cached files changes */
+#define CACHE_FORMAT_VERSION "1"
+
+static void
+checksum_update_string (GChecksum *checksum, const gchar *str)
+{
+  if (str != NULL)
+    g_checksum_update (checksum, (const guchar *) str, strlen (str));
+
+  /* include the terminator so that consecutive strings don't collide */
+  g_checksum_update (checksum, (const guchar *) "", 1);
+}
+
+static void
+checksum_update_device_info (GChecksum      *checksum,
+                             cl_device_id    device_id,
+                             cl_device_info  param)
+{
+  gchar value[1025] = {0, };
+
+  clGetDeviceInfo (device_id, param, sizeof (value) - 1, value, NULL);
+  checksum_update_string (checksum, value);
+}
+
+static void
+checksum_update_platform_info (GChecksum        *checksum,
+                               cl_platform_id    platform_id,
+                               cl_platform_info  param)
+{
+  gchar value[1025] = {0, };
+
+  clGetPlatformInfo (platform_id, param, sizeof (value) - 1, value, NULL);
+  checksum_update_string (checksum, value);
+}
+
+/**
+ * gocl_cache_get_dir:
+ *
+ * Retrieves the directory where Gocl stores cached data, which is
+ * <i>gocl</i> inside the user's cache directory (normally
+ * <i>$XDG_CACHE_HOME</i>).
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer none): The cache directory
+ **/
+const gchar *
+gocl_cache_get_dir (void)
+{
+  static gchar *cache_dir = NULL;
+
+  if (g_once_init_enter (&cache_dir))
+    {
+      gchar *dir;
+
+      dir = g_build_filename (g_get_user_cache_dir (), "gocl", NULL);
+      g_once_init_leave (&cache_dir, dir);
+    }
+
+  return cache_dir;
+}
+
+/**
+ * gocl_cache_checksum_new:
+ * @device_id: The #cl_device_id the cached data is specific to
+ *
+ * Creates a new checksum for computing cache keys, already fed with the
+ * properties that identify @device_id: the device name and version, the
+ * driver version, and the platform name and version. Callers are expected
+ * to add any other data the cached entry depends on, and then obtain the
+ * key with g_checksum_get_string().
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer full): A new #GChecksum. Free with g_checksum_free().
+ **/
+GChecksum *
+gocl_cache_checksum_new (cl_device_id device_id)
+{
+  GChecksum *checksum;
+  cl_platform_id platform_id = NULL;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  checksum_update_string (checksum, CACHE_FORMAT_VERSION);
+
+  checksum_update_device_info (checksum, device_id, CL_DEVICE_NAME);
+  checksum_update_device_info (checksum, device_id, CL_DEVICE_VERSION);
+  checksum_update_device_info (checksum, device_id, CL_DRIVER_VERSION);
+
+  clGetDeviceInfo (device_id,
+                   CL_DEVICE_PLATFORM,
+                   sizeof (cl_platform_id),
+                   &platform_id,
+                   NULL);
+  checksum_update_platform_info (checksum, platform_id, CL_PLATFORM_NAME);
+  checksum_update_platform_info (checksum, platform_id, CL_PLATFORM_VERSION);
+
+  return checksum;
+}
+
+/**
+ * gocl_cache_checksum_add_string:
+ * @checksum: A #GChecksum created with gocl_cache_checksum_new()
+ * @str: (allow-none): A string, or %NULL
+ *
+ * Feeds @str into a cache key checksum, keeping it distinguishable from the
+ * data added before and after it.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_cache_checksum_add_string (GChecksum *checksum, const gchar *str)
+{
+  checksum_update_string (checksum, str);
+}
+
+/**
+ * gocl_cache_load:
+ * @key: The key of the cached entry
+ * @suffix: The file suffix of this type of entries
+ * @size: (out): A pointer to retrieve the size of the data
+ *
+ * Retrieves the contents of a cached entry, if it exists.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer full): The cached data, or %NULL if not found. Free
+ * with g_free().
+ **/
+gpointer
+gocl_cache_load (const gchar *key, const gchar *suffix, gsize *size)
+{
+  gchar *basename;
+  gchar *filename;
+  gchar *contents = NULL;
+
+  basename = g_strconcat (key, suffix, NULL);
+  filename = g_build_filename (gocl_cache_get_dir (), basename, NULL);
+  g_free (basename);
+
+  if (! g_file_get_contents (filename, &contents, size, NULL))
+    contents = NULL;
+
+  g_free (filename);
+
+  return contents;
+}
+
+/**
+ * gocl_cache_save:
+ * @key: The key of the cached entry
+ * @suffix: The file suffix of this type of entries
+ * @data: The data to store
+ * @size: The size of @data, in bytes
+ *
+ * Stores @data in the cache under @key, replacing any previous entry
+ * atomically. Failing to write the cache is not considered an error, since
+ * the data can always be regenerated.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: %TRUE if the data was stored, %FALSE otherwise
+ **/
+gboolean
+gocl_cache_save (const gchar   *key,
+                 const gchar   *suffix,
+                 gconstpointer  data,
+                 gsize          size)
+{
+  gchar *basename;
+  gchar *filename;
+  gboolean result;
+
+  if (g_mkdir_with_parents (gocl_cache_get_dir (), 0700) != 0)
+    return FALSE;
+
+  basename = g_strconcat (key, suffix, NULL);
+  filename = g_build_filename (gocl_cache_get_dir (), basename, NULL);
+  g_free (basename);
+
+  result = g_file_set_contents (filename, data, size, NULL);
+
+  g_free (filename);
+
+  return result;
+}
@@ -0,0 +1,747 @@
+/*
+ * gocl-command-list.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-command-list
+ * @short_description: Object that batches operations on a command queue
+ * @stability: Unstable
+ *
+ * A #GoclCommandList records a sequence of operations on a #GoclQueue, like
+ * buffer writes, kernel executions and buffer reads, and submits them to the
+ * device in one go. Compared to calling gocl_buffer_write(),
+ * gocl_kernel_run_in_queue() and gocl_buffer_read() separately, no
+ * #GoclEvent is created for each operation, and the commands are flushed to
+ * the device only once, which greatly reduces the per-operation overhead
+ * when many small operations are issued.
+ *
+ * A command list is created with gocl_command_list_new(). Operations are
+ * recorded with gocl_command_list_write_buffer(),
+ * gocl_command_list_run_kernel() and gocl_command_list_read_buffer(), and
+ * each of them implicitly depends on the previous one, even if the queue
+ * was created with %GOCL_QUEUE_FLAGS_OUT_OF_ORDER. Dependencies on events
+ * from outside the list are added with gocl_command_list_wait_for().
+ *
+ * Recording an operation enqueues it immediately, so it captures the
+ * current arguments and work sizes of a kernel, but the device is not
+ * asked to start executing until gocl_command_list_submit() or
+ * gocl_command_list_submit_sync() is called. Submitting returns a single
+ * #GoclEvent for the whole batch, and leaves the list empty and ready to
+ * record a new batch.
+ *
+ * Operations are non-blocking, so the memory passed to
+ * gocl_command_list_write_buffer() and gocl_command_list_read_buffer() must
+ * remain valid until the batch completes.
+ *
+ * If recording an operation fails, the following operations of the batch
+ * are ignored, and the error is reported by the submit methods.
+ *
+ * Buffers and images shared with OpenGL are acquired and released inside a
+ * batch with gocl_command_list_acquire_gl_objects() and
+ * gocl_command_list_release_gl_objects(), so that the acquisition, the
+ * kernel executions and the release are submitted as one chain, without
+ * blocking the host in between. When the device supports the
+ * <i>cl_khr_gl_event</i> extension, acquiring and releasing synchronize
+ * implicitly with the GL context that is current in the calling thread, so
+ * no glFinish() is needed before recording, and GL commands issued after
+ * the batch is submitted wait for the release. Work from other GL contexts
+ * is waited for with gocl_command_list_wait_for_gl_sync(). Without the
+ * extension, glFinish() must be called before recording the acquisition,
+ * and the returned #GoclEvent must trigger before GL uses the objects
+ * again.
+ **/
+
+/**
+ * GoclCommandListClass:
+ * @parent_class: The parent class
+ *
+ * The class for #GoclCommandList objects.
+ **/
+
+#include "gocl-command-list.h"
+
+#include "gocl-private.h"
+#include "gocl-decls.h"
+
+struct _GoclCommandListPrivate
+{
+  GoclQueue *queue;
+  gboolean out_of_order;
+
+  /* events the next command waits for */
+  GArray *wait_list;
+
+  /* references to the external events of the batch */
+  GList *events;
+
+  /* events created from GL sync objects, owned by the list */
+  GArray *gl_sync_events;
+
+  /* last command of the batch, only tracked on out-of-order queues */
+  cl_event last_event;
+
+  guint num_commands;
+  cl_int err_code;
+};
+
+/* properties */
+enum
+{
+  PROP_0,
+  PROP_QUEUE
+};
+
+static void           gocl_command_list_class_init            (GoclCommandListClass *class);
+static void           gocl_command_list_init                  (GoclCommandList *self);
+static void           gocl_command_list_dispose               (GObject *obj);
+static void           gocl_command_list_finalize              (GObject *obj);
+static void           gocl_command_list_constructed           (GObject *obj);
+
+static void           set_property                            (GObject      *obj,
+                                                               guint         prop_id,
+                                                               const GValue *value,
+                                                               GParamSpec   *pspec);
+static void           get_property                            (GObject    *obj,
+                                                               guint       prop_id,
+                                                               GValue     *value,
+                                                               GParamSpec *pspec);
+
+static void           reset                                   (GoclCommandList *self);
+
+G_DEFINE_TYPE (GoclCommandList, gocl_command_list, G_TYPE_OBJECT);
+
+#define GOCL_COMMAND_LIST_GET_PRIVATE(obj)                      \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                          \
+                                GOCL_TYPE_COMMAND_LIST,         \
+                                GoclCommandListPrivate))        \
+
+static void
+gocl_command_list_class_init (GoclCommandListClass *class)
+{
+  GObjectClass *obj_class = G_OBJECT_CLASS (class);
+
+  obj_class->dispose = gocl_command_list_dispose;
+  obj_class->finalize = gocl_command_list_finalize;
+  obj_class->constructed = gocl_command_list_constructed;
+  obj_class->get_property = get_property;
+  obj_class->set_property = set_property;
+
+  g_object_class_install_property (obj_class, PROP_QUEUE,
+                                   g_param_spec_object ("queue",
+                                                        "Command queue",
+                                                        "The command queue where operations are enqueued",
+                                                        GOCL_TYPE_QUEUE,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_type_class_add_private (class, sizeof (GoclCommandListPrivate));
+}
+
+static void
+gocl_command_list_init (GoclCommandList *self)
+{
+  GoclCommandListPrivate *priv;
+
+  self->priv = priv = GOCL_COMMAND_LIST_GET_PRIVATE (self);
+
+  priv->queue = NULL;
+  priv->out_of_order = FALSE;
+
+  priv->wait_list = g_array_new (FALSE, FALSE, sizeof (cl_event));
+  priv->events = NULL;
+  priv->gl_sync_events = g_array_new (FALSE, FALSE, sizeof (cl_event));
+  priv->last_event = NULL;
+
+  priv->num_commands = 0;
+  priv->err_code = CL_SUCCESS;
+}
+
+static void
+gocl_command_list_dispose (GObject *obj)
+{
+  GoclCommandList *self = GOCL_COMMAND_LIST (obj);
+
+  reset (self);
+
+  if (self->priv->queue != NULL)
+    {
+      g_object_unref (self->priv->queue);
+      self->priv->queue = NULL;
+    }
+
+  G_OBJECT_CLASS (gocl_command_list_parent_class)->dispose (obj);
+}
+
+static void
+gocl_command_list_finalize (GObject *obj)
+{
+  GoclCommandList *self = GOCL_COMMAND_LIST (obj);
+
+  g_array_unref (self->priv->wait_list);
+  g_array_unref (self->priv->gl_sync_events);
+
+  G_OBJECT_CLASS (gocl_command_list_parent_class)->finalize (obj);
+}
+
+static void
+gocl_command_list_constructed (GObject *obj)
+{
+  GoclCommandList *self = GOCL_COMMAND_LIST (obj);
+
+  if (self->priv->queue != NULL)
+    self->priv->out_of_order =
+      (gocl_queue_get_flags (self->priv->queue) &
+       GOCL_QUEUE_FLAGS_OUT_OF_ORDER) != 0;
+}
+
+static void
+set_property (GObject      *obj,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GoclCommandList *self = GOCL_COMMAND_LIST (obj);
+
+  switch (prop_id)
+    {
+    case PROP_QUEUE:
+      self->priv->queue = g_value_dup_object (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+get_property (GObject    *obj,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GoclCommandList *self = GOCL_COMMAND_LIST (obj);
+
+  switch (prop_id)
+    {
+    case PROP_QUEUE:
+      g_value_set_object (value, self->priv->queue);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+reset (GoclCommandList *self)
+{
+  guint i;
+
+  g_array_set_size (self->priv->wait_list, 0);
+
+  for (i = 0; i < self->priv->gl_sync_events->len; i++)
+    clReleaseEvent (g_array_index (self->priv->gl_sync_events, cl_event, i));
+  g_array_set_size (self->priv->gl_sync_events, 0);
+
+  if (self->priv->events != NULL)
+    {
+      g_list_free_full (self->priv->events, g_object_unref);
+      self->priv->events = NULL;
+    }
+
+  if (self->priv->last_event != NULL)
+    {
+      clReleaseEvent (self->priv->last_event);
+      self->priv->last_event = NULL;
+    }
+
+  self->priv->num_commands = 0;
+  self->priv->err_code = CL_SUCCESS;
+}
+
+/* prepares the wait list of the next command. Returns %FALSE if a previous
+   command failed, in which case the command must not be enqueued */
+static gboolean
+begin_command (GoclCommandList *self)
+{
+  if (self->priv->err_code != CL_SUCCESS)
+    return FALSE;
+
+  if (self->priv->last_event != NULL)
+    g_array_append_val (self->priv->wait_list, self->priv->last_event);
+
+  return TRUE;
+}
+
+static void
+end_command (GoclCommandList *self, cl_int err_code, cl_event event)
+{
+  g_array_set_size (self->priv->wait_list, 0);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    {
+      self->priv->err_code = err_code;
+      return;
+    }
+
+  if (self->priv->last_event != NULL)
+    clReleaseEvent (self->priv->last_event);
+  self->priv->last_event = event;
+
+  self->priv->num_commands++;
+}
+
+/* enqueues a marker for the whole batch and flushes the queue */
+static cl_int
+flush_commands (GoclCommandList *self, cl_event *event)
+{
+  cl_command_queue queue;
+  cl_int err_code;
+
+  if (self->priv->err_code != CL_SUCCESS)
+    return self->priv->err_code;
+
+  queue = gocl_queue_get_queue (self->priv->queue);
+
+  /* with an empty wait list, the marker waits for every previous command
+     of the queue. External events that no command consumed yet are added
+     explicitly, and then the last command must be added too */
+  if (self->priv->wait_list->len > 0)
+    begin_command (self);
+
+  err_code =
+    clEnqueueMarkerWithWaitList (queue,
+                                 self->priv->wait_list->len,
+                                 self->priv->wait_list->len > 0 ?
+                                   (cl_event *) self->priv->wait_list->data : NULL,
+                                 event);
+  if (err_code != CL_SUCCESS)
+    return err_code;
+
+  err_code = clFlush (queue);
+  if (err_code != CL_SUCCESS)
+    clReleaseEvent (*event);
+
+  return err_code;
+}
+
+/* public */
+
+/**
+ * gocl_command_list_new:
+ * @queue: The #GoclQueue where operations will be enqueued
+ *
+ * Creates a new, empty command list for @queue.
+ *
+ * Returns: (transfer full): A newly created #GoclCommandList
+ **/
+GoclCommandList *
+gocl_command_list_new (GoclQueue *queue)
+{
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  return g_object_new (GOCL_TYPE_COMMAND_LIST,
+                       "queue", queue,
+                       NULL);
+}
+
+/**
+ * gocl_command_list_get_queue:
+ * @self: The #GoclCommandList
+ *
+ * Retrieves the command queue where the operations of this list are
+ * enqueued.
+ *
+ * Returns: (transfer none): The #GoclQueue of the list
+ **/
+GoclQueue *
+gocl_command_list_get_queue (GoclCommandList *self)
+{
+  g_return_val_if_fail (GOCL_IS_COMMAND_LIST (self), NULL);
+
+  return self->priv->queue;
+}
+
+/**
+ * gocl_command_list_get_num_commands:
+ * @self: The #GoclCommandList
+ *
+ * Retrieves the number of operations recorded since the list was created
+ * or last submitted.
+ *
+ * Returns: The number of recorded operations
+ **/
+guint
+gocl_command_list_get_num_commands (GoclCommandList *self)
+{
+  g_return_val_if_fail (GOCL_IS_COMMAND_LIST (self), 0);
+
+  return self->priv->num_commands;
+}
+
+/**
+ * gocl_command_list_wait_for:
+ * @self: The #GoclCommandList
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Makes the next recorded operation wait for all the events in
+ * @event_wait_list, in addition to the previous operation of the list.
+ * References to the events are kept until the batch is submitted.
+ **/
+void
+gocl_command_list_wait_for (GoclCommandList *self, GList *event_wait_list)
+{
+  GList *node;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+
+  for (node = event_wait_list; node != NULL; node = node->next)
+    {
+      GoclEvent *event;
+      cl_event _event;
+
+      g_return_if_fail (GOCL_IS_EVENT (node->data));
+      event = GOCL_EVENT (node->data);
+
+      _event = gocl_event_get_event (event);
+      g_array_append_val (self->priv->wait_list, _event);
+
+      self->priv->events = g_list_prepend (self->priv->events,
+                                           g_object_ref (event));
+    }
+}
+
+/**
+ * gocl_command_list_write_buffer:
+ * @self: The #GoclCommandList
+ * @buffer: The #GoclBuffer to write to
+ * @data: A pointer to the memory to copy, which must remain valid until the
+ * batch completes
+ * @size: The number of bytes to write
+ * @offset: The offset inside the buffer to start writing at
+ *
+ * Records a non-blocking write of @size bytes from @data into @buffer.
+ **/
+void
+gocl_command_list_write_buffer (GoclCommandList *self,
+                                GoclBuffer      *buffer,
+                                const gpointer   data,
+                                gsize            size,
+                                goffset          offset)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+  g_return_if_fail (GOCL_IS_BUFFER (buffer));
+
+  if (! begin_command (self))
+    return;
+
+  err_code =
+    clEnqueueWriteBuffer (gocl_queue_get_queue (self->priv->queue),
+                          gocl_buffer_get_buffer (buffer),
+                          CL_FALSE,
+                          offset,
+                          size,
+                          data,
+                          self->priv->wait_list->len,
+                          self->priv->wait_list->len > 0 ?
+                            (cl_event *) self->priv->wait_list->data : NULL,
+                          self->priv->out_of_order ? &event : NULL);
+
+  end_command (self, err_code, event);
+}
+
+/**
+ * gocl_command_list_read_buffer:
+ * @self: The #GoclCommandList
+ * @buffer: The #GoclBuffer to read from
+ * @target_ptr: A pointer to the memory to copy into, which must remain valid
+ * until the batch completes
+ * @size: The number of bytes to read
+ * @offset: The offset inside the buffer to start reading from
+ *
+ * Records a non-blocking read of @size bytes from @buffer into @target_ptr.
+ * The contents of @target_ptr are only valid after the batch completes.
+ **/
+void
+gocl_command_list_read_buffer (GoclCommandList *self,
+                               GoclBuffer      *buffer,
+                               gpointer         target_ptr,
+                               gsize            size,
+                               goffset          offset)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+  g_return_if_fail (GOCL_IS_BUFFER (buffer));
+
+  if (! begin_command (self))
+    return;
+
+  err_code =
+    clEnqueueReadBuffer (gocl_queue_get_queue (self->priv->queue),
+                         gocl_buffer_get_buffer (buffer),
+                         CL_FALSE,
+                         offset,
+                         size,
+                         target_ptr,
+                         self->priv->wait_list->len,
+                         self->priv->wait_list->len > 0 ?
+                           (cl_event *) self->priv->wait_list->data : NULL,
+                         self->priv->out_of_order ? &event : NULL);
+
+  end_command (self, err_code, event);
+}
+
+/**
+ * gocl_command_list_run_kernel:
+ * @self: The #GoclCommandList
+ * @kernel: The #GoclKernel to run
+ *
+ * Records an execution of @kernel, using its current arguments and work
+ * sizes. Arguments can be changed right after this call to record another
+ * execution with different values.
+ **/
+void
+gocl_command_list_run_kernel (GoclCommandList *self, GoclKernel *kernel)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+  g_return_if_fail (GOCL_IS_KERNEL (kernel));
+
+  if (! begin_command (self))
+    return;
+
+  err_code =
+    gocl_kernel_enqueue (kernel,
+                         gocl_queue_get_queue (self->priv->queue),
+                         NULL,
+                         NULL,
+                         self->priv->wait_list->len,
+                         (cl_event *) self->priv->wait_list->data,
+                         self->priv->out_of_order ? &event : NULL);
+
+  end_command (self, err_code, event);
+}
+
+/**
+ * gocl_command_list_acquire_gl_objects:
+ * @self: The #GoclCommandList
+ * @objects: (array length=num_objects): The #GoclBuffer (or deriving)
+ * objects to acquire, which were created from OpenGL objects
+ * @num_objects: The number of objects in @objects
+ *
+ * Records the acquisition of @objects for use by the following operations
+ * of the batch. The objects must be released with
+ * gocl_command_list_release_gl_objects() before the batch is submitted.
+ *
+ * This method works only if the <i>cl_khr_gl_sharing</i> OpenCL extension is
+ * supported.
+ **/
+void
+gocl_command_list_acquire_gl_objects (GoclCommandList    *self,
+                                      GoclBuffer * const *objects,
+                                      guint               num_objects)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+  g_return_if_fail (objects != NULL || num_objects == 0);
+
+  if (num_objects == 0 || ! begin_command (self))
+    return;
+
+  err_code =
+    gocl_device_enqueue_gl_objects (gocl_queue_get_queue (self->priv->queue),
+                                    TRUE,
+                                    objects,
+                                    num_objects,
+                                    self->priv->wait_list->len,
+                                    (cl_event *) self->priv->wait_list->data,
+                                    self->priv->out_of_order ? &event : NULL);
+
+  end_command (self, err_code, event);
+}
+
+/**
+ * gocl_command_list_release_gl_objects:
+ * @self: The #GoclCommandList
+ * @objects: (array length=num_objects): The #GoclBuffer (or deriving)
+ * objects to release, previously acquired with
+ * gocl_command_list_acquire_gl_objects()
+ * @num_objects: The number of objects in @objects
+ *
+ * Records the release of @objects, handing them back to OpenGL once the
+ * previous operations of the batch complete.
+ **/
+void
+gocl_command_list_release_gl_objects (GoclCommandList    *self,
+                                      GoclBuffer * const *objects,
+                                      guint               num_objects)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_if_fail (GOCL_IS_COMMAND_LIST (self));
+  g_return_if_fail (objects != NULL || num_objects == 0);
+
+  if (num_objects == 0 || ! begin_command (self))
+    return;
+
+  err_code =
+    gocl_device_enqueue_gl_objects (gocl_queue_get_queue (self->priv->queue),
+                                    FALSE,
+                                    objects,
+                                    num_objects,
+                                    self->priv->wait_list->len,
+                                    (cl_event *) self->priv->wait_list->data,
+                                    self->priv->out_of_order ? &event : NULL);
+
+  end_command (self, err_code, event);
+}
+
+/**
+ * gocl_command_list_wait_for_gl_sync:
+ * @self: The #GoclCommandList
+ * @gl_sync: A GL fence sync object, as a <i>GLsync</i> created with
+ * glFenceSync()
+ *
+ * Makes the next recorded operation wait until @gl_sync is signaled, as
+ * gocl_command_list_wait_for() does for #GoclEvent objects. This lets the
+ * acquisition of GL objects wait for GL rendering on the device itself,
+ * instead of stalling the host with glFinish().
+ *
+ * This requires the <i>cl_khr_gl_event</i> OpenCL extension, see
+ * gocl_device_has_extension(). If it is not supported, nothing is recorded
+ * and %FALSE is returned, in which case glFinish() must be called before
+ * recording the acquisition.
+ *
+ * Returns: %TRUE if the sync object will be waited for, %FALSE otherwise
+ **/
+gboolean
+gocl_command_list_wait_for_gl_sync (GoclCommandList *self, gpointer gl_sync)
+{
+  cl_int err_code = CL_SUCCESS;
+  cl_event event;
+
+  g_return_val_if_fail (GOCL_IS_COMMAND_LIST (self), FALSE);
+  g_return_val_if_fail (gl_sync != NULL, FALSE);
+
+  event =
+    gocl_device_create_event_from_gl_sync (gocl_queue_get_device (self->priv->queue),
+                                           gl_sync,
+                                           &err_code);
+  if (event == NULL)
+    {
+      /* a missing extension is not an error of the batch */
+      if (err_code != CL_INVALID_OPERATION &&
+          gocl_error_check_opencl_internal (err_code))
+        {
+          if (self->priv->err_code == CL_SUCCESS)
+            self->priv->err_code = err_code;
+        }
+
+      return FALSE;
+    }
+
+  g_array_append_val (self->priv->wait_list, event);
+  g_array_append_val (self->priv->gl_sync_events, event);
+
+  return TRUE;
+}
+
+/**
+ * gocl_command_list_submit:
+ * @self: The #GoclCommandList
+ *
+ * Submits all the operations recorded so far to the device, without
+ * blocking. The list is emptied, and can be used to record a new batch
+ * right away.
+ *
+ * Returns: (transfer none): A #GoclEvent that triggers when all the
+ * operations of the batch have completed, or with the error of the first
+ * operation that could not be recorded
+ **/
+GoclEvent *
+gocl_command_list_submit (GoclCommandList *self)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_COMMAND_LIST (self), NULL);
+
+  err_code = flush_commands (self, &event);
+
+  gocl_event_wait_list_init (&wait_list, self->priv->events);
+  _event = gocl_event_new_from_result (self->priv->queue,
+                                       err_code,
+                                       event,
+                                       &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_set_label (_event, "command-list");
+
+  reset (self);
+
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_command_list_submit_sync:
+ * @self: The #GoclCommandList
+ *
+ * Submits all the operations recorded so far to the device, and blocks
+ * until they complete. The list is emptied, and can be used to record a new
+ * batch right away.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_command_list_submit_sync (GoclCommandList *self)
+{
+  cl_int err_code;
+  cl_event event;
+
+  g_return_val_if_fail (GOCL_IS_COMMAND_LIST (self), FALSE);
+
+  err_code = flush_commands (self, &event);
+
+  reset (self);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  err_code = clWaitForEvents (1, &event);
+  clReleaseEvent (event);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
@@ -0,0 +1,94 @@
+/*
+ * gocl-command-list.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+#ifndef __GOCL_COMMAND_LIST_H__
+#define __GOCL_COMMAND_LIST_H__
+
+#include <glib-object.h>
+
+#include "gocl-queue.h"
+#include "gocl-buffer.h"
+#include "gocl-kernel.h"
+#include "gocl-event.h"
+
+G_BEGIN_DECLS
+
+#define GOCL_TYPE_COMMAND_LIST              (gocl_command_list_get_type ())
+#define GOCL_COMMAND_LIST(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GOCL_TYPE_COMMAND_LIST, GoclCommandList))
+#define GOCL_COMMAND_LIST_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GOCL_TYPE_COMMAND_LIST, GoclCommandListClass))
+#define GOCL_IS_COMMAND_LIST(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GOCL_TYPE_COMMAND_LIST))
+#define GOCL_IS_COMMAND_LIST_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GOCL_TYPE_COMMAND_LIST))
+#define GOCL_COMMAND_LIST_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GOCL_TYPE_COMMAND_LIST, GoclCommandListClass))
+
+typedef struct _GoclCommandListClass GoclCommandListClass;
+typedef struct _GoclCommandList GoclCommandList;
+typedef struct _GoclCommandListPrivate GoclCommandListPrivate;
+
+struct _GoclCommandList
+{
+  GObject parent_instance;
+
+  GoclCommandListPrivate *priv;
+};
+
+struct _GoclCommandListClass
+{
+  GObjectClass parent_class;
+};
+
+GType                  gocl_command_list_get_type              (void) G_GNUC_CONST;
+
+GoclCommandList *      gocl_command_list_new                   (GoclQueue *queue);
+
+GoclQueue *            gocl_command_list_get_queue             (GoclCommandList *self);
+guint                  gocl_command_list_get_num_commands      (GoclCommandList *self);
+
+void                   gocl_command_list_wait_for              (GoclCommandList *self,
+                                                                GList           *event_wait_list);
+
+void                   gocl_command_list_write_buffer          (GoclCommandList *self,
+                                                                GoclBuffer      *buffer,
+                                                                const gpointer   data,
+                                                                gsize            size,
+                                                                goffset          offset);
+void                   gocl_command_list_read_buffer           (GoclCommandList *self,
+                                                                GoclBuffer      *buffer,
+                                                                gpointer         target_ptr,
+                                                                gsize            size,
+                                                                goffset          offset);
+void                   gocl_command_list_run_kernel            (GoclCommandList *self,
+                                                                GoclKernel      *kernel);
+
+void                   gocl_command_list_acquire_gl_objects    (GoclCommandList    *self,
+                                                                GoclBuffer * const *objects,
+                                                                guint               num_objects);
+void                   gocl_command_list_release_gl_objects    (GoclCommandList    *self,
+                                                                GoclBuffer * const *objects,
+                                                                guint               num_objects);
+gboolean               gocl_command_list_wait_for_gl_sync      (GoclCommandList *self,
+                                                                gpointer         gl_sync);
+
+GoclEvent *            gocl_command_list_submit                (GoclCommandList *self);
+gboolean               gocl_command_list_submit_sync           (GoclCommandList *self);
+
+G_END_DECLS
+
+#endif /* __GOCL_COMMAND_LIST_H__ */
@@ -29,11 +29,18 @@
  * the first step an OpenCL application performs.
  *
  * A #GoclContext can be created with gocl_context_new_sync(), providing the
- * type of device which is a value from #GoclDeviceType. For convenience, the
+ * type of device which is a value from #GoclDeviceType. The first OpenCL
+ * platform of the system is used, unless another one is chosen with
+ * gocl_context_new_for_platform_sync(). For convenience, the
  * methods gocl_context_get_default_cpu_sync() and
  * gocl_context_get_default_gpu_sync() are provided to easily retrieve
  * pre-created CPU and GPU contexts, respectively.
  *
+ * Creating a context can block for a noticeable time on some drivers. To
+ * avoid stalling a main loop, gocl_context_new() and
+ * gocl_context_new_for_platform() create it in a worker thread, and
+ * gocl_context_init_devices() then prepares all its devices in parallel.
+ *
  * For GPU devices, it is possible to share object with existing OpenGL contexts
  * if the <i>cl_khr_gl_sharing</i> extension is supported. To enable this
  * support, gocl_context_gpu_new_sync() is used, passing the pointers to the
@@ -43,6 +50,30 @@
  * gocl_context_get_device_by_index(), where index must be a value between 0 and
  * the maximum number of devices in the context, minus one. Number of devices can
  * be obtained with gocl_context_get_num_devices().
+ *
+ * Host memory allocated with g_malloc() is pageable, and most drivers copy it
+ * into an internal staging area before transferring it to the device. A
+ * context also hands out pinned host memory with gocl_context_alloc_pinned(),
+ * backed by a %GOCL_BUFFER_FLAGS_ALLOC_HOST_PTR buffer that stays mapped for
+ * its whole lifetime. Passing pinned memory to gocl_buffer_read(),
+ * gocl_buffer_write() and their _sync versions lets the driver transfer it
+ * with DMA directly, which often doubles the bandwidth on discrete GPUs.
+ * Pinned memory is returned with gocl_context_free_pinned() and recycled for
+ * later allocations of a similar size, and idle regions are released with
+ * gocl_context_trim_pinned().
+ *
+ * On OpenCL 2.0 devices, a context can also allocate shared virtual memory
+ * with gocl_context_svm_alloc(), which the host and the devices address
+ * with the same pointers. Coarse-grained allocations are mapped for host
+ * access with gocl_context_svm_map_sync() or gocl_context_svm_map(), while
+ * fine-grained ones can be accessed at any time.
+ *
+ * Contexts, devices, queues and buffers can be shared freely between threads:
+ * the default contexts, lazily created command queues and pinned memory are
+ * all set up safely on first use, and errors reported by gocl_error_get_last()
+ * are kept per thread. Kernels, command lists and streams, on the other hand,
+ * hold mutable state such as kernel arguments, so each one must be used by a
+ * single thread at a time.
  **/
 
 /**
@@ -65,9 +96,24 @@
 
 #define DEFAULT_PLATFORM_INDEX 0
 
+#define MIN_PINNED_SIZE 4096
+
+typedef struct
+{
+  cl_mem buffer;
+  gpointer ptr;
+  gsize size;
+  gboolean in_use;
+
+  /* the asynchronous transfers that use the region and may still be in
+     flight, as #cl_event */
+  GArray *events;
+} PinnedRegion;
+
 struct _GoclContextPrivate
 {
   cl_platform_id platform_id;
+  guint platform_index;
 
   cl_context context;
   GoclDeviceType device_type;
@@ -75,13 +121,32 @@ struct _GoclContextPrivate
   cl_device_id devices[MAX_DEVICES];
   cl_uint num_devices;
 
+  /* the live GoclDevice of each index, if any. Held weakly, since every
+     device holds a reference on its context */
+  GMutex device_objects_mutex;
+  GWeakRef device_objects[MAX_DEVICES];
+
+  /* taken on first use, shared by every GoclDevice of the same index */
+  gsize device_snapshots_loaded[MAX_DEVICES];
+  GoclDeviceSnapshot device_snapshots[MAX_DEVICES];
+
   gpointer gl_context;
   gpointer gl_display;
+
+  GMutex pinned_mutex;
+  GPtrArray *pinned_regions;
+  cl_command_queue pinned_queue;
 };
 
+/* platforms are discovered once per process */
+static gsize gocl_platforms_loaded = 0;
+static cl_int gocl_platforms_err_code = CL_SUCCESS;
 static cl_platform_id gocl_platforms[MAX_PLATFORMS];
 static cl_uint gocl_num_platforms = 0;
 
+/* default contexts are created once, and live until the process exits.
+   The mutex only serializes their creation, never reading them */
+static GMutex gocl_context_default_mutex;
 static GoclContext *gocl_context_default_gpu = NULL;
 static GoclContext *gocl_context_default_cpu = NULL;
 
@@ -90,6 +155,7 @@ enum
 {
   PROP_0,
   PROP_DEVICE_TYPE,
+  PROP_PLATFORM_INDEX,
   PROP_GL_CONTEXT,
   PROP_GL_DISPLAY
 };
@@ -99,6 +165,7 @@ static void           gocl_context_initable_iface_init   (GInitableIface *iface)
 static gboolean       gocl_context_initable_init         (GInitable     *initable,
                                                           GCancellable  *cancellable,
                                                           GError       **error);
+static void           gocl_context_async_initable_iface_init (GAsyncInitableIface *iface);
 static void           gocl_context_init                  (GoclContext *self);
 static void           gocl_context_finalize              (GObject *obj);
 
@@ -113,7 +180,9 @@ static void           get_property                       (GObject    *obj,
 
 G_DEFINE_TYPE_WITH_CODE (GoclContext, gocl_context, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
-                                                gocl_context_initable_iface_init));
+                                                gocl_context_initable_iface_init)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_ASYNC_INITABLE,
+                                                gocl_context_async_initable_iface_init));
 
 #define GOCL_CONTEXT_GET_PRIVATE(obj)                   \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                  \
@@ -139,6 +208,16 @@ gocl_context_class_init (GoclContextClass *class)
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                       G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (obj_class, PROP_PLATFORM_INDEX,
+                                   g_param_spec_uint ("platform-index",
+                                                      "Platform index",
+                                                      "The index of the OpenCL platform to use",
+                                                      0,
+                                                      MAX_PLATFORMS - 1,
+                                                      DEFAULT_PLATFORM_INDEX,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
+
   g_object_class_install_property (obj_class, PROP_GL_CONTEXT,
                                    g_param_spec_pointer ("gl-context",
                                                          "GL context",
@@ -155,12 +234,64 @@ gocl_context_class_init (GoclContextClass *class)
   g_type_class_add_private (class, sizeof (GoclContextPrivate));
 }
 
+static gboolean
+get_platforms (GError **error)
+{
+  if (g_once_init_enter (&gocl_platforms_loaded))
+    {
+      cl_uint num_platforms = 0;
+
+      gocl_platforms_err_code = clGetPlatformIDs (MAX_PLATFORMS,
+                                                  gocl_platforms,
+                                                  &num_platforms);
+      if (gocl_platforms_err_code == CL_SUCCESS)
+        gocl_num_platforms = MIN (num_platforms, MAX_PLATFORMS);
+
+      g_once_init_leave (&gocl_platforms_loaded, 1);
+    }
+
+  return ! gocl_error_check_opencl (gocl_platforms_err_code, error);
+}
+
+static GoclContext *
+get_default_context (GoclContext **context, GoclDeviceType device_type)
+{
+  GoclContext *_context;
+
+  _context = g_atomic_pointer_get (context);
+  if (_context == NULL)
+    {
+      g_mutex_lock (&gocl_context_default_mutex);
+
+      _context = *context;
+      if (_context == NULL)
+        {
+          /* a failed creation is retried on the next call */
+          _context = gocl_context_new_sync (device_type);
+          g_atomic_pointer_set (context, _context);
+        }
+
+      g_mutex_unlock (&gocl_context_default_mutex);
+
+      if (_context == NULL)
+        return NULL;
+    }
+
+  return g_object_ref (_context);
+}
+
 static void
 gocl_context_initable_iface_init (GInitableIface *iface)
 {
   iface->init = gocl_context_initable_init;
 }
 
+static void
+gocl_context_async_initable_iface_init (GAsyncInitableIface *iface)
+{
+  /* the default implementation runs GInitable's init in a thread */
+}
+
 static gboolean
 gocl_context_initable_init (GInitable     *initable,
                             GCancellable  *cancellable,
@@ -170,18 +301,16 @@ gocl_context_initable_init (GInitable     *initable,
   cl_int err_code = 0;
   cl_context_properties props[7] = {0, };
 
-  /* get platform ids */
-  if (gocl_num_platforms == 0)
+  if (! get_platforms (error))
+    return FALSE;
+
+  if (self->priv->platform_index >= gocl_num_platforms)
     {
-      err_code = clGetPlatformIDs (MAX_PLATFORMS,
-                                   gocl_platforms,
-                                   &gocl_num_platforms);
-      if (gocl_error_check_opencl (err_code, error))
-        return FALSE;
+      gocl_error_check_opencl (CL_INVALID_PLATFORM, error);
+      return FALSE;
     }
 
-  /* @TODO: currently using platform 0 only */
-  self->priv->platform_id = gocl_platforms[DEFAULT_PLATFORM_INDEX];
+  self->priv->platform_id = gocl_platforms[self->priv->platform_index];
 
   /* get devices */
   err_code = clGetDeviceIDs (self->priv->platform_id,
@@ -189,6 +318,11 @@ gocl_context_initable_init (GInitable     *initable,
                              MAX_DEVICES,
                              self->priv->devices,
                              &self->priv->num_devices);
+  if (gocl_error_check_opencl (err_code, error))
+    return FALSE;
+
+  /* the platform may have more devices than we can hold */
+  self->priv->num_devices = MIN (self->priv->num_devices, MAX_DEVICES);
 
   /* setup context properties */
   props[0] = CL_CONTEXT_PLATFORM;
@@ -204,12 +338,14 @@ gocl_context_initable_init (GInitable     *initable,
       props[5] = (cl_context_properties) self->priv->gl_display;
     }
 
-  /* create the context */
-  self->priv->context = clCreateContextFromType (props,
-                                                 self->priv->device_type,
-                                                 NULL,
-                                                 NULL,
-                                                 &err_code);
+  /* create the context on exactly the devices listed above, so that
+     device indices match the devices the context was created for */
+  self->priv->context = clCreateContext (props,
+                                         self->priv->num_devices,
+                                         self->priv->devices,
+                                         NULL,
+                                         NULL,
+                                         &err_code);
   if (gocl_error_check_opencl (err_code, error))
     return FALSE;
 
@@ -220,26 +356,207 @@ static void
 gocl_context_init (GoclContext *self)
 {
   GoclContextPrivate *priv;
+  guint i;
 
   self->priv = priv = GOCL_CONTEXT_GET_PRIVATE (self);
 
   priv->context = NULL;
+
+  g_mutex_init (&priv->device_objects_mutex);
+  for (i = 0; i < MAX_DEVICES; i++)
+    g_weak_ref_init (&priv->device_objects[i], NULL);
+
+  g_mutex_init (&priv->pinned_mutex);
+  priv->pinned_regions = g_ptr_array_new ();
+  priv->pinned_queue = NULL;
+}
+
+/* drops the transfers of @region that completed, and tells whether no
+   transfer is using it anymore. Called with the pinned mutex held */
+static gboolean
+pinned_region_is_idle (PinnedRegion *region)
+{
+  guint i = 0;
+
+  while (i < region->events->len)
+    {
+      cl_event event = g_array_index (region->events, cl_event, i);
+      cl_int status;
+      cl_int err_code;
+
+      err_code = clGetEventInfo (event,
+                                 CL_EVENT_COMMAND_EXECUTION_STATUS,
+                                 sizeof (cl_int),
+                                 &status,
+                                 NULL);
+      if (err_code == CL_SUCCESS && status > CL_COMPLETE)
+        {
+          i++;
+          continue;
+        }
+
+      clReleaseEvent (event);
+      g_array_remove_index_fast (region->events, i);
+    }
+
+  return region->events->len == 0;
+}
+
+static void
+free_pinned_region (GoclContext *self, PinnedRegion *region)
+{
+  guint i;
+
+  if (region->events->len > 0)
+    clWaitForEvents (region->events->len,
+                     (cl_event *) region->events->data);
+  for (i = 0; i < region->events->len; i++)
+    clReleaseEvent (g_array_index (region->events, cl_event, i));
+  g_array_unref (region->events);
+
+  clEnqueueUnmapMemObject (self->priv->pinned_queue,
+                           region->buffer,
+                           region->ptr,
+                           0,
+                           NULL,
+                           NULL);
+  clFinish (self->priv->pinned_queue);
+  clReleaseMemObject (region->buffer);
+
+  g_slice_free (PinnedRegion, region);
+}
+
+static gint
+compare_pinned_regions (gconstpointer a, gconstpointer b)
+{
+  guintptr ptr_a = (guintptr) (*(PinnedRegion * const *) a)->ptr;
+  guintptr ptr_b = (guintptr) (*(PinnedRegion * const *) b)->ptr;
+
+  return ptr_a < ptr_b ? -1 : (ptr_a > ptr_b ? 1 : 0);
+}
+
+/* finds the region that contains the @size bytes starting at @ptr, with a
+   binary search over the regions, which are kept sorted by address and
+   never overlap. Called with the pinned mutex held */
+static PinnedRegion *
+find_pinned_region (GoclContext *self, gconstpointer ptr, gsize size)
+{
+  GPtrArray *regions = self->priv->pinned_regions;
+  guintptr addr = (guintptr) ptr;
+  PinnedRegion *region;
+  guint low = 0;
+  guint high = regions->len;
+
+  /* the last region starting at or before @ptr is the only candidate */
+  while (low < high)
+    {
+      guint mid = low + (high - low) / 2;
+
+      region = g_ptr_array_index (regions, mid);
+      if ((guintptr) region->ptr <= addr)
+        low = mid + 1;
+      else
+        high = mid;
+    }
+
+  if (low == 0)
+    return NULL;
+
+  region = g_ptr_array_index (regions, low - 1);
+  if (addr + size > (guintptr) region->ptr + region->size)
+    return NULL;
+
+  return region;
+}
+
+/* allocates and maps a new region. Called with the pinned mutex held */
+static PinnedRegion *
+new_pinned_region (GoclContext *self, gsize size)
+{
+  PinnedRegion *region;
+  cl_mem buffer;
+  gpointer ptr;
+  cl_int err_code;
+
+  if (self->priv->pinned_queue == NULL)
+    {
+      self->priv->pinned_queue = clCreateCommandQueue (self->priv->context,
+                                                       self->priv->devices[0],
+                                                       0,
+                                                       &err_code);
+      if (gocl_error_check_opencl_internal (err_code))
+        {
+          self->priv->pinned_queue = NULL;
+          return NULL;
+        }
+    }
+
+  buffer = clCreateBuffer (self->priv->context,
+                           CL_MEM_ALLOC_HOST_PTR,
+                           size,
+                           NULL,
+                           &err_code);
+  if (gocl_error_check_opencl_internal (err_code))
+    return NULL;
+
+  ptr = clEnqueueMapBuffer (self->priv->pinned_queue,
+                            buffer,
+                            CL_TRUE,
+                            CL_MAP_READ | CL_MAP_WRITE,
+                            0,
+                            size,
+                            0,
+                            NULL,
+                            NULL,
+                            &err_code);
+  if (gocl_error_check_opencl_internal (err_code))
+    {
+      clReleaseMemObject (buffer);
+      return NULL;
+    }
+
+  region = g_slice_new0 (PinnedRegion);
+  region->buffer = buffer;
+  region->ptr = ptr;
+  region->size = size;
+  region->events = g_array_new (FALSE, FALSE, sizeof (cl_event));
+
+  /* regions are only added when none can be recycled, so sorting them
+     here is rare compared to the lookups it speeds up */
+  g_ptr_array_add (self->priv->pinned_regions, region);
+  g_ptr_array_sort (self->priv->pinned_regions, compare_pinned_regions);
+
+  return region;
 }
 
 static void
 gocl_context_finalize (GObject *obj)
 {
   GoclContext *self = GOCL_CONTEXT (obj);
+  guint i;
+
+  for (i = 0; i < MAX_DEVICES; i++)
+    {
+      g_weak_ref_clear (&self->priv->device_objects[i]);
+      if (self->priv->device_snapshots_loaded[i] != 0)
+        gocl_device_clear_snapshot (&self->priv->device_snapshots[i]);
+    }
+  g_mutex_clear (&self->priv->device_objects_mutex);
+
+  for (i = 0; i < self->priv->pinned_regions->len; i++)
+    free_pinned_region (self,
+                        g_ptr_array_index (self->priv->pinned_regions, i));
+  g_ptr_array_unref (self->priv->pinned_regions);
+
+  if (self->priv->pinned_queue != NULL)
+    clReleaseCommandQueue (self->priv->pinned_queue);
+
+  g_mutex_clear (&self->priv->pinned_mutex);
 
   if (self->priv->context != NULL)
     clReleaseContext (self->priv->context);
 
   G_OBJECT_CLASS (gocl_context_parent_class)->finalize (obj);
-
-  if (self == gocl_context_default_cpu)
-    gocl_context_default_cpu = NULL;
-  else if (self == gocl_context_default_gpu)
-    gocl_context_default_cpu = NULL;
 }
 
 static void
@@ -258,6 +575,10 @@ set_property (GObject      *obj,
       self->priv->device_type = g_value_get_uint (value);
       break;
 
+    case PROP_PLATFORM_INDEX:
+      self->priv->platform_index = g_value_get_uint (value);
+      break;
+
     case PROP_GL_CONTEXT:
       self->priv->gl_context = g_value_get_pointer (value);
       break;
@@ -288,6 +609,10 @@ get_property (GObject    *obj,
       g_value_set_uint (value, self->priv->device_type);
       break;
 
+    case PROP_PLATFORM_INDEX:
+      g_value_set_uint (value, self->priv->platform_index);
+      break;
+
     case PROP_GL_CONTEXT:
       g_value_set_pointer (value, self->priv->gl_context);
       break;
@@ -302,6 +627,58 @@ get_property (GObject    *obj,
     }
 }
 
+static void
+free_device_list (GList *devices)
+{
+  g_list_free_full (devices, g_object_unref);
+}
+
+typedef struct
+{
+  GSimpleAsyncResult *res;
+  GList *devices;
+  guint pending;
+  GError *error;
+} InitDevicesClosure;
+
+static void
+on_device_ready (GObject      *obj,
+                 GAsyncResult *result,
+                 gpointer      user_data)
+{
+  InitDevicesClosure *closure = user_data;
+  GError *error = NULL;
+
+  if (! gocl_device_init_queues_finish (GOCL_DEVICE (obj), result, &error))
+    {
+      if (closure->error == NULL)
+        closure->error = error;
+      else
+        g_error_free (error);
+    }
+
+  closure->pending--;
+  if (closure->pending > 0)
+    return;
+
+  if (closure->error != NULL)
+    {
+      g_simple_async_result_take_error (closure->res, closure->error);
+      g_list_free_full (closure->devices, g_object_unref);
+    }
+  else
+    {
+      g_simple_async_result_set_op_res_gpointer (closure->res,
+                                                 closure->devices,
+                                                 (GDestroyNotify) free_device_list);
+    }
+
+  g_simple_async_result_complete (closure->res);
+  g_object_unref (closure->res);
+
+  g_slice_free (InitDevicesClosure, closure);
+}
+
 /* public */
 
 /**
@@ -328,6 +705,203 @@ gocl_context_new_sync (GoclDeviceType device_type)
                          NULL);
 }
 
+/**
+ * gocl_context_new:
+ * @device_type: A value from #GoclDeviceType
+ * @cancellable: (allow-none): A #GCancellable object, or %NULL
+ * @callback: (allow-none): Callback to be called upon completion, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass in @callback, or %NULL
+ *
+ * Asynchronously creates a #GoclContext of the type specified in
+ * @device_type. Discovering platforms and devices, and creating the OpenCL
+ * context, can take a noticeable time on some drivers, so this is done in a
+ * worker thread and the calling thread is never blocked. When the operation
+ * completes, @callback is called in the thread-default main context of the
+ * caller, and gocl_context_new_finish() is used to retrieve the context.
+ * For a blocking version of this method, see gocl_context_new_sync().
+ **/
+void
+gocl_context_new (GoclDeviceType       device_type,
+                  GCancellable        *cancellable,
+                  GAsyncReadyCallback  callback,
+                  gpointer             user_data)
+{
+  g_async_initable_new_async (GOCL_TYPE_CONTEXT,
+                              G_PRIORITY_DEFAULT,
+                              cancellable,
+                              callback,
+                              user_data,
+                              "device-type", device_type,
+                              NULL);
+}
+
+/**
+ * gocl_context_new_for_platform:
+ * @platform_index: The index of the OpenCL platform to use
+ * @device_type: A value from #GoclDeviceType
+ * @cancellable: (allow-none): A #GCancellable object, or %NULL
+ * @callback: (allow-none): Callback to be called upon completion, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass in @callback, or %NULL
+ *
+ * Asynchronously creates a #GoclContext of the type specified in
+ * @device_type, on the @platform_index-th OpenCL platform of the system.
+ * The result is retrieved with gocl_context_new_finish(). For a blocking
+ * version of this method, see gocl_context_new_for_platform_sync().
+ **/
+void
+gocl_context_new_for_platform (guint                platform_index,
+                               GoclDeviceType       device_type,
+                               GCancellable        *cancellable,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
+{
+  g_async_initable_new_async (GOCL_TYPE_CONTEXT,
+                              G_PRIORITY_DEFAULT,
+                              cancellable,
+                              callback,
+                              user_data,
+                              "platform-index", platform_index,
+                              "device-type", device_type,
+                              NULL);
+}
+
+/**
+ * gocl_context_new_finish:
+ * @result: The #GAsyncResult object from callback's arguments
+ * @error: (out) (allow-none): A pointer to a #GError, or %NULL
+ *
+ * Retrieves the result of a gocl_context_new() or
+ * gocl_context_new_for_platform() asynchronous operation. On error, %NULL
+ * is returned and @error is filled accordingly.
+ *
+ * Returns: (transfer full): A newly created #GoclContext, or %NULL on error
+ **/
+GoclContext *
+gocl_context_new_finish (GAsyncResult  *result,
+                         GError       **error)
+{
+  GObject *source;
+  GObject *obj;
+
+  g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+
+  source = g_async_result_get_source_object (result);
+  obj = g_async_initable_new_finish (G_ASYNC_INITABLE (source), result, error);
+  g_object_unref (source);
+
+  return obj != NULL ? GOCL_CONTEXT (obj) : NULL;
+}
+
+/**
+ * gocl_context_new_for_platform_sync:
+ * @platform_index: The index of the OpenCL platform to use
+ * @device_type: A value from #GoclDeviceType
+ *
+ * Attempts to create a #GoclContext of the type specified in @device_type,
+ * on the @platform_index-th OpenCL platform of the system. The number of
+ * platforms is obtained with gocl_context_get_num_platforms(). All the
+ * devices of @device_type in the platform are added to the context.
+ *
+ * Returns: (transfer full): A newly created #GoclContext, or %NULL on error
+ **/
+GoclContext *
+gocl_context_new_for_platform_sync (guint          platform_index,
+                                    GoclDeviceType device_type)
+{
+  GError **error;
+
+  error = gocl_error_prepare ();
+
+  return g_initable_new (GOCL_TYPE_CONTEXT,
+                         NULL,
+                         error,
+                         "platform-index", platform_index,
+                         "device-type", device_type,
+                         NULL);
+}
+
+/**
+ * gocl_context_get_num_platforms:
+ *
+ * Obtains the number of OpenCL platforms available in the system. Platforms
+ * are selected by index with gocl_context_new_for_platform_sync().
+ *
+ * Returns: The number of platforms, or 0 on error
+ **/
+guint
+gocl_context_get_num_platforms (void)
+{
+  GError **error;
+
+  error = gocl_error_prepare ();
+  if (! get_platforms (error))
+    return 0;
+
+  return gocl_num_platforms;
+}
+
+/**
+ * gocl_context_get_platform_name:
+ * @platform_index: The index of a platform
+ *
+ * Retrieves the name of the @platform_index-th OpenCL platform, which is
+ * useful to choose a platform by vendor.
+ *
+ * Returns: (transfer full): A newly allocated string, or %NULL on error
+ **/
+gchar *
+gocl_context_get_platform_name (guint platform_index)
+{
+  GError **error;
+  cl_int err_code;
+  gchar *name;
+  gsize size;
+
+  error = gocl_error_prepare ();
+  if (! get_platforms (error))
+    return NULL;
+
+  g_return_val_if_fail (platform_index < gocl_num_platforms, NULL);
+
+  err_code = clGetPlatformInfo (gocl_platforms[platform_index],
+                                CL_PLATFORM_NAME,
+                                0,
+                                NULL,
+                                &size);
+  if (gocl_error_check_opencl (err_code, error))
+    return NULL;
+
+  name = g_malloc0 (size + 1);
+  err_code = clGetPlatformInfo (gocl_platforms[platform_index],
+                                CL_PLATFORM_NAME,
+                                size,
+                                name,
+                                NULL);
+  if (gocl_error_check_opencl (err_code, error))
+    {
+      g_free (name);
+      return NULL;
+    }
+
+  return name;
+}
+
+/**
+ * gocl_context_get_platform_index:
+ * @self: The #GoclContext
+ *
+ * Retrieves the index of the OpenCL platform this context was created on.
+ *
+ * Returns: The platform index
+ **/
+guint
+gocl_context_get_platform_index (GoclContext *self)
+{
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), 0);
+
+  return self->priv->platform_index;
+}
+
 /**
  * gocl_context_gpu_new_sync:
  * @gl_context: (allow-none): A GL context, or %NULL
@@ -362,20 +936,19 @@ gocl_context_gpu_new_sync (gpointer gl_context, gpointer gl_display)
  *
  * Returns platform's default GPU context. The first call to this method will
  * attempt to create a new #GoclContext using a device type of
- * %GOCL_DEVICE_TYPE_GPU. Upon success, the context is cached and subsequent
- * calls will return the same object, increasing its reference count.
+ * %GOCL_DEVICE_TYPE_GPU. Upon success, the context is cached until the
+ * program exits, and subsequent calls will return the same object,
+ * increasing its reference count.
+ *
+ * This method can be called from any thread. Only the first successful call
+ * takes a lock; later calls are lock-free.
  *
  * Returns: (transfer full): A #GoclContext object, or %NULL on error
  **/
 GoclContext *
 gocl_context_get_default_gpu_sync (void)
 {
-  if (gocl_context_default_gpu != NULL)
-    g_object_ref (gocl_context_default_gpu);
-  else
-    gocl_context_default_gpu = gocl_context_new_sync (CL_DEVICE_TYPE_GPU);
-
-  return gocl_context_default_gpu;
+  return get_default_context (&gocl_context_default_gpu, GOCL_DEVICE_TYPE_GPU);
 }
 
 /**
@@ -383,20 +956,19 @@ gocl_context_get_default_gpu_sync (void)
  *
  * Returns platform's default CPU context. The first call to this method will
  * attempt to create a new #GoclContext using a device type of
- * %GOCL_DEVICE_TYPE_CPU. Upon success, the context is cached and subsequent calls
- * will return the same object, increasing its reference count.
+ * %GOCL_DEVICE_TYPE_CPU. Upon success, the context is cached until the
+ * program exits, and subsequent calls will return the same object,
+ * increasing its reference count.
+ *
+ * This method can be called from any thread. Only the first successful call
+ * takes a lock; later calls are lock-free.
  *
  * Returns: (transfer full): A #GoclContext object, or %NULL on error
  **/
 GoclContext *
 gocl_context_get_default_cpu_sync (void)
 {
-  if (gocl_context_default_cpu != NULL)
-    g_object_ref (gocl_context_default_cpu);
-  else
-    gocl_context_default_cpu = gocl_context_new_sync (CL_DEVICE_TYPE_CPU);
-
-  return gocl_context_default_cpu;
+  return get_default_context (&gocl_context_default_cpu, GOCL_DEVICE_TYPE_CPU);
 }
 
 /**
@@ -443,9 +1015,11 @@ gocl_context_get_num_devices (GoclContext *self)
  * Use gocl_context_get_num_devices() to get the number of devices in the
  * context.
  *
- * Notice that method creates a new #GoclDevice instance every time is called.
+ * The same #GoclDevice instance is returned for a given index for as long as
+ * any reference to it is alive, so the queues created on it, for example by
+ * gocl_context_init_devices(), are found by later lookups too.
  *
- * Returns: (transfer full): A newly created #GoclDevice
+ * Returns: (transfer full): A #GoclDevice. Free with g_object_unref()
  **/
 GoclDevice *
 gocl_context_get_device_by_index (GoclContext *self, guint device_index)
@@ -455,10 +1029,679 @@ gocl_context_get_device_by_index (GoclContext *self, guint device_index)
   g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
   g_return_val_if_fail (device_index < self->priv->num_devices, NULL);
 
-  device = g_object_new (GOCL_TYPE_DEVICE,
-                         "context", self,
-                         "id", self->priv->devices[device_index],
-                         NULL);
+  g_mutex_lock (&self->priv->device_objects_mutex);
+
+  device = g_weak_ref_get (&self->priv->device_objects[device_index]);
+  if (device == NULL)
+    {
+      device = g_object_new (GOCL_TYPE_DEVICE,
+                             "context", self,
+                             "id", self->priv->devices[device_index],
+                             NULL);
+      g_weak_ref_set (&self->priv->device_objects[device_index], device);
+    }
+
+  g_mutex_unlock (&self->priv->device_objects_mutex);
 
   return device;
 }
+
+/**
+ * gocl_context_init_devices:
+ * @self: The #GoclContext
+ * @cancellable: (allow-none): A #GCancellable object, or %NULL
+ * @callback: (allow-none): Callback to be called upon completion, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass in @callback, or %NULL
+ *
+ * Asynchronously obtains all the devices of the context, with their default
+ * and transfer command queues already created (see
+ * gocl_device_init_queues()). All the devices are initialized in parallel,
+ * in worker threads, and @callback is called once every one of them is
+ * ready. The devices are retrieved with gocl_context_init_devices_finish().
+ * While the application holds them, gocl_context_get_device_by_index()
+ * returns these same devices, with their queues.
+ **/
+void
+gocl_context_init_devices (GoclContext         *self,
+                           GCancellable        *cancellable,
+                           GAsyncReadyCallback  callback,
+                           gpointer             user_data)
+{
+  InitDevicesClosure *closure;
+  GList *node;
+  guint i;
+
+  g_return_if_fail (GOCL_IS_CONTEXT (self));
+
+  closure = g_slice_new0 (InitDevicesClosure);
+  closure->res = g_simple_async_result_new (G_OBJECT (self),
+                                            callback,
+                                            user_data,
+                                            gocl_context_init_devices);
+
+  if (self->priv->num_devices == 0)
+    {
+      g_simple_async_result_complete_in_idle (closure->res);
+      g_object_unref (closure->res);
+      g_slice_free (InitDevicesClosure, closure);
+      return;
+    }
+
+  for (i = 0; i < self->priv->num_devices; i++)
+    closure->devices = g_list_append (closure->devices,
+                                      gocl_context_get_device_by_index (self, i));
+
+  closure->pending = self->priv->num_devices;
+
+  for (node = closure->devices; node != NULL; node = node->next)
+    gocl_device_init_queues (GOCL_DEVICE (node->data),
+                             cancellable,
+                             on_device_ready,
+                             closure);
+}
+
+/**
+ * gocl_context_init_devices_finish:
+ * @self: The #GoclContext
+ * @result: The #GAsyncResult object from callback's arguments
+ * @error: (out) (allow-none): A pointer to a #GError, or %NULL
+ *
+ * Retrieves the result of a gocl_context_init_devices() asynchronous
+ * operation. On error, %NULL is returned and @error is filled accordingly.
+ *
+ * Returns: (transfer full) (element-type Gocl.Device): A list with a
+ * #GoclDevice for each device of the context, in order, to be freed with
+ * g_list_free_full() and g_object_unref()
+ **/
+GList *
+gocl_context_init_devices_finish (GoclContext   *self,
+                                  GAsyncResult  *result,
+                                  GError       **error)
+{
+  GSimpleAsyncResult *res;
+  GList *devices;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+                                                        G_OBJECT (self),
+                                                        gocl_context_init_devices),
+                        NULL);
+
+  res = G_SIMPLE_ASYNC_RESULT (result);
+  if (g_simple_async_result_propagate_error (res, error))
+    return NULL;
+
+  devices = g_simple_async_result_get_op_res_gpointer (res);
+
+  return g_list_copy_deep (devices, (GCopyFunc) g_object_ref, NULL);
+}
+
+/**
+ * gocl_context_alloc_pinned:
+ * @self: The #GoclContext
+ * @size: The number of bytes to allocate
+ *
+ * Allocates @size bytes of pinned (page-locked) host memory, that can be
+ * transferred to and from the devices of this context with DMA, without
+ * intermediate copies. The memory is backed by a buffer created with
+ * %GOCL_BUFFER_FLAGS_ALLOC_HOST_PTR, which remains mapped until the context
+ * is finalized.
+ *
+ * Sizes are rounded up to a power of two, and memory previously returned
+ * with gocl_context_free_pinned() is reused when possible, so repeatedly
+ * allocating staging memory is cheap. This method can be called from any
+ * thread.
+ *
+ * Returns: (transfer none): A pointer to the pinned memory, to be freed with
+ * gocl_context_free_pinned(), or %NULL on error
+ **/
+gpointer
+gocl_context_alloc_pinned (GoclContext *self, gsize size)
+{
+  PinnedRegion *region = NULL;
+  gsize region_size;
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+  g_return_val_if_fail (size > 0, NULL);
+
+  region_size = MAX (size, MIN_PINNED_SIZE);
+  region_size = (gsize) 1 << g_bit_storage (region_size - 1);
+
+  g_mutex_lock (&self->priv->pinned_mutex);
+
+  for (i = 0; i < self->priv->pinned_regions->len; i++)
+    {
+      PinnedRegion *candidate =
+        g_ptr_array_index (self->priv->pinned_regions, i);
+
+      /* a freed region may still be the source or target of a transfer
+         enqueued before it was freed */
+      if (! candidate->in_use &&
+          candidate->size == region_size &&
+          pinned_region_is_idle (candidate))
+        {
+          region = candidate;
+          break;
+        }
+    }
+
+  if (region == NULL)
+    region = new_pinned_region (self, region_size);
+
+  if (region != NULL)
+    region->in_use = TRUE;
+
+  g_mutex_unlock (&self->priv->pinned_mutex);
+
+  return region != NULL ? region->ptr : NULL;
+}
+
+/**
+ * gocl_context_free_pinned:
+ * @self: The #GoclContext
+ * @ptr: A pointer returned by gocl_context_alloc_pinned()
+ *
+ * Returns pinned memory to the context, to be reused by later calls to
+ * gocl_context_alloc_pinned(). It is safe to free the memory while an
+ * asynchronous gocl_buffer_read() or gocl_buffer_write() still uses it; it
+ * will not be handed out again until the transfer completes.
+ **/
+void
+gocl_context_free_pinned (GoclContext *self, gpointer ptr)
+{
+  PinnedRegion *region;
+
+  g_return_if_fail (GOCL_IS_CONTEXT (self));
+
+  if (ptr == NULL)
+    return;
+
+  g_mutex_lock (&self->priv->pinned_mutex);
+
+  region = find_pinned_region (self, ptr, 0);
+  if (region != NULL && region->ptr == ptr && region->in_use)
+    region->in_use = FALSE;
+  else
+    region = NULL;
+
+  g_mutex_unlock (&self->priv->pinned_mutex);
+
+  g_return_if_fail (region != NULL);
+}
+
+/**
+ * gocl_context_is_pinned:
+ * @self: The #GoclContext
+ * @ptr: A pointer to host memory
+ * @size: The number of bytes starting at @ptr
+ *
+ * Tells whether the @size bytes starting at @ptr lie within pinned memory
+ * allocated with gocl_context_alloc_pinned().
+ *
+ * Returns: %TRUE if the memory is pinned, %FALSE otherwise
+ **/
+gboolean
+gocl_context_is_pinned (GoclContext *self, gconstpointer ptr, gsize size)
+{
+  gboolean result;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+
+  g_mutex_lock (&self->priv->pinned_mutex);
+  result = find_pinned_region (self, ptr, size) != NULL;
+  g_mutex_unlock (&self->priv->pinned_mutex);
+
+  return result;
+}
+
+/**
+ * gocl_context_trim_pinned:
+ * @self: The #GoclContext
+ *
+ * Releases all the pinned memory that has been freed with
+ * gocl_context_free_pinned() and is not used by any transfer anymore.
+ **/
+void
+gocl_context_trim_pinned (GoclContext *self)
+{
+  guint i = 0;
+
+  g_return_if_fail (GOCL_IS_CONTEXT (self));
+
+  g_mutex_lock (&self->priv->pinned_mutex);
+
+  while (i < self->priv->pinned_regions->len)
+    {
+      PinnedRegion *region = g_ptr_array_index (self->priv->pinned_regions, i);
+
+      if (! region->in_use && pinned_region_is_idle (region))
+        {
+          g_ptr_array_remove_index (self->priv->pinned_regions, i);
+          free_pinned_region (self, region);
+        }
+      else
+        {
+          i++;
+        }
+    }
+
+  g_mutex_unlock (&self->priv->pinned_mutex);
+}
+
+/**
+ * gocl_context_supports_image_format:
+ * @self: The #GoclContext
+ * @flags: An OR'ed combination of values from #GoclBufferFlags
+ * @type: Image type value from #GoclImageType
+ * @channel_order: The channel order, a value from #GoclImageChannelOrder or
+ * any other channel order supported by the platform
+ * @channel_type: The channel data type, a value from #GoclImageChannelType
+ *
+ * Checks whether images of @type with the given pixel format can be created
+ * in this context with @flags, using gocl_image_new_full().
+ *
+ * Returns: %TRUE if the format is supported, %FALSE otherwise
+ **/
+gboolean
+gocl_context_supports_image_format (GoclContext   *self,
+                                    guint          flags,
+                                    GoclImageType  type,
+                                    guint          channel_order,
+                                    guint          channel_type)
+{
+  cl_int err_code;
+  cl_uint num_formats = 0;
+  cl_image_format *formats;
+  gboolean result = FALSE;
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+
+  err_code = clGetSupportedImageFormats (self->priv->context,
+                                         flags,
+                                         type,
+                                         0,
+                                         NULL,
+                                         &num_formats);
+  if (gocl_error_check_opencl_internal (err_code) || num_formats == 0)
+    return FALSE;
+
+  formats = g_new (cl_image_format, num_formats);
+
+  err_code = clGetSupportedImageFormats (self->priv->context,
+                                         flags,
+                                         type,
+                                         num_formats,
+                                         formats,
+                                         NULL);
+  if (! gocl_error_check_opencl_internal (err_code))
+    {
+      for (i = 0; i < num_formats && ! result; i++)
+        result = formats[i].image_channel_order == channel_order &&
+          formats[i].image_channel_data_type == channel_type;
+    }
+
+  g_free (formats);
+
+  return result;
+}
+
+/**
+ * gocl_context_svm_alloc:
+ * @self: The #GoclContext
+ * @flags: An OR'ed combination of values from #GoclBufferFlags and
+ * #GoclSvmFlags
+ * @size: The size of the allocation, in bytes
+ * @alignment: The minimum alignment of the allocation, in bytes, or 0 for
+ * the alignment of the largest OpenCL data type
+ *
+ * Allocates @size bytes of shared virtual memory, which is addressed with
+ * the same pointers by the host and by the devices of the context. Data
+ * structures holding pointers, like graphs or trees, can then be built in
+ * place and used by kernels without flattening or copying them. Kernels
+ * receive the pointers with gocl_kernel_set_argument_svm().
+ *
+ * The host can only access coarse-grained allocations while they are
+ * mapped with gocl_context_svm_map_sync() or gocl_context_svm_map().
+ * Fine-grained allocations, which require devices supporting
+ * %GOCL_SVM_CAPABILITIES_FINE_GRAIN_BUFFER, can be accessed at any time.
+ *
+ * This requires OpenCL 2.0 devices, see
+ * gocl_device_get_svm_capabilities(). Upon error, %NULL is returned.
+ *
+ * Returns: (transfer full): The shared memory. Free with
+ * gocl_context_svm_free().
+ **/
+gpointer
+gocl_context_svm_alloc (GoclContext *self,
+                        guint        flags,
+                        gsize        size,
+                        guint        alignment)
+{
+#ifdef CL_VERSION_2_0
+  gpointer ptr;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+  g_return_val_if_fail (size > 0, NULL);
+
+  ptr = clSVMAlloc (self->priv->context, flags, size, alignment);
+
+  /* clSVMAlloc() does not report the reason of a failure */
+  if (ptr == NULL)
+    gocl_error_check_opencl_internal (CL_MEM_OBJECT_ALLOCATION_FAILURE);
+  else
+    gocl_error_prepare ();
+
+  return ptr;
+#else
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+
+  gocl_error_check_opencl_internal (CL_INVALID_OPERATION);
+
+  return NULL;
+#endif
+}
+
+/**
+ * gocl_context_svm_free:
+ * @self: The #GoclContext
+ * @svm_ptr: Memory allocated with gocl_context_svm_alloc()
+ *
+ * Frees shared virtual memory. The memory is released right away, so all
+ * the commands using it must have completed.
+ **/
+void
+gocl_context_svm_free (GoclContext *self, gpointer svm_ptr)
+{
+  g_return_if_fail (GOCL_IS_CONTEXT (self));
+
+#ifdef CL_VERSION_2_0
+  if (svm_ptr != NULL)
+    clSVMFree (self->priv->context, svm_ptr);
+#endif
+}
+
+/**
+ * gocl_context_svm_map_sync:
+ * @self: The #GoclContext
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @svm_ptr: A pointer into memory allocated with gocl_context_svm_alloc()
+ * @size: The size of the region to map, in bytes
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Maps a region of @size bytes of coarse-grained shared memory starting at
+ * @svm_ptr for host access, blocking the program execution until the
+ * operation finishes. Unlike buffer maps, the host then accesses the
+ * memory through @svm_ptr itself, so only the regions that change need to
+ * be updated. Mapping is not needed for fine-grained memory.
+ *
+ * The region must be unmapped with gocl_context_svm_unmap_sync() or
+ * gocl_context_svm_unmap() before a kernel uses it again.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_context_svm_map_sync (GoclContext *self,
+                           GoclQueue   *queue,
+                           guint        map_flags,
+                           gpointer     svm_ptr,
+                           gsize        size,
+                           GList       *event_wait_list)
+{
+#ifdef CL_VERSION_2_0
+  GoclEventWaitList wait_list;
+  cl_int err_code;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (svm_ptr != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = clEnqueueSVMMap (gocl_queue_get_queue (queue),
+                              CL_TRUE,
+                              map_flags,
+                              svm_ptr,
+                              size,
+                              wait_list.len,
+                              wait_list.events,
+                              NULL);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+#else
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+
+  return ! gocl_error_check_opencl_internal (CL_INVALID_OPERATION);
+#endif
+}
+
+/**
+ * gocl_context_svm_map:
+ * @self: The #GoclContext
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @svm_ptr: A pointer into memory allocated with gocl_context_svm_alloc()
+ * @size: The size of the region to map, in bytes
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously maps a region of coarse-grained shared memory for host
+ * access. The memory must not be accessed until the returned #GoclEvent
+ * triggers. For a synchronous version of this method, see
+ * gocl_context_svm_map_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the map
+ * operation finishes
+ **/
+GoclEvent *
+gocl_context_svm_map (GoclContext *self,
+                      GoclQueue   *queue,
+                      guint        map_flags,
+                      gpointer     svm_ptr,
+                      gsize        size,
+                      GList       *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  cl_event event = NULL;
+  cl_int err_code;
+  GoclEvent *_event;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (svm_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+#ifdef CL_VERSION_2_0
+  err_code = clEnqueueSVMMap (gocl_queue_get_queue (queue),
+                              CL_FALSE,
+                              map_flags,
+                              svm_ptr,
+                              size,
+                              wait_list.len,
+                              wait_list.events,
+                              &event);
+#else
+  err_code = CL_INVALID_OPERATION;
+#endif
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_context_svm_unmap_sync:
+ * @self: The #GoclContext
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @svm_ptr: A pointer previously mapped with gocl_context_svm_map_sync() or
+ * gocl_context_svm_map()
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Unmaps a region of coarse-grained shared memory, making the changes of
+ * the host visible to the devices, and blocks the program execution until
+ * the operation finishes.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_context_svm_unmap_sync (GoclContext *self,
+                             GoclQueue   *queue,
+                             gpointer     svm_ptr,
+                             GList       *event_wait_list)
+{
+#ifdef CL_VERSION_2_0
+  GoclEventWaitList wait_list;
+  cl_event event;
+  cl_int err_code;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (svm_ptr != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = clEnqueueSVMUnmap (gocl_queue_get_queue (queue),
+                                svm_ptr,
+                                wait_list.len,
+                                wait_list.events,
+                                &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+#else
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), FALSE);
+
+  return ! gocl_error_check_opencl_internal (CL_INVALID_OPERATION);
+#endif
+}
+
+/**
+ * gocl_context_svm_unmap:
+ * @self: The #GoclContext
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @svm_ptr: A pointer previously mapped with gocl_context_svm_map_sync() or
+ * gocl_context_svm_map()
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously unmaps a region of coarse-grained shared memory. For a
+ * synchronous version of this method, see gocl_context_svm_unmap_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the unmap
+ * operation finishes
+ **/
+GoclEvent *
+gocl_context_svm_unmap (GoclContext *self,
+                        GoclQueue   *queue,
+                        gpointer     svm_ptr,
+                        GList       *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  cl_event event = NULL;
+  cl_int err_code;
+  GoclEvent *_event;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (svm_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+#ifdef CL_VERSION_2_0
+  err_code = clEnqueueSVMUnmap (gocl_queue_get_queue (queue),
+                                svm_ptr,
+                                wait_list.len,
+                                wait_list.events,
+                                &event);
+#else
+  err_code = CL_INVALID_OPERATION;
+#endif
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_context_track_pinned_transfer:
+ * @self: The #GoclContext
+ * @ptr: The host memory used by the transfer
+ * @size: The size of the transfer, in bytes
+ * @event: The #cl_event of the transfer
+ *
+ * If @ptr is pinned memory of this context, adds @event to the transfers
+ * that use it, so that the memory is not recycled before all of them
+ * complete. Does nothing for pageable memory.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_context_track_pinned_transfer (GoclContext   *self,
+                                    gconstpointer  ptr,
+                                    gsize          size,
+                                    cl_event       event)
+{
+  PinnedRegion *region;
+
+  g_mutex_lock (&self->priv->pinned_mutex);
+
+  region = find_pinned_region (self, ptr, size);
+  if (region != NULL)
+    {
+      /* completed transfers are dropped first, so the set stays small */
+      pinned_region_is_idle (region);
+
+      clRetainEvent (event);
+      g_array_append_val (region->events, event);
+    }
+
+  g_mutex_unlock (&self->priv->pinned_mutex);
+}
+
+/**
+ * gocl_context_get_device_snapshot:
+ * @self: The #GoclContext
+ * @device_id: The #cl_device_id of one of the context devices
+ *
+ * Retrieves the capabilities of the device, querying them from the driver
+ * only the first time. The snapshot is kept per device index, so every
+ * #GoclDevice returned by gocl_context_get_device_by_index() for the same
+ * index shares it.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer none): A #GoclDeviceSnapshot, valid for the lifetime
+ *   of the context
+ **/
+const GoclDeviceSnapshot *
+gocl_context_get_device_snapshot (GoclContext *self, cl_device_id device_id)
+{
+  static gchar *no_extension_names[] = { NULL };
+  static const GoclDeviceSnapshot empty_snapshot = { { 0 },
+                                                     no_extension_names };
+  guint i;
+
+  for (i = 0; i < self->priv->num_devices; i++)
+    if (self->priv->devices[i] == device_id)
+      break;
+
+  g_return_val_if_fail (i < self->priv->num_devices, &empty_snapshot);
+
+  if (g_once_init_enter (&self->priv->device_snapshots_loaded[i]))
+    {
+      gocl_device_load_snapshot (device_id, &self->priv->device_snapshots[i]);
+      g_once_init_leave (&self->priv->device_snapshots_loaded[i], 1);
+    }
+
+  return &self->priv->device_snapshots[i];
+}
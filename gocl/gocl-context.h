@@ -23,6 +23,7 @@
 #define __GOCL_CONTEXT_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <CL/opencl.h>
 
 #ifdef HAS_COGL
@@ -61,9 +62,26 @@ struct _GoclContextClass
 GType                  gocl_context_get_type                   (void) G_GNUC_CONST;
 
 GoclContext *          gocl_context_new_sync                   (GoclDeviceType device_type);
+GoclContext *          gocl_context_new_for_platform_sync      (guint          platform_index,
+                                                                GoclDeviceType device_type);
+void                   gocl_context_new                        (GoclDeviceType       device_type,
+                                                                GCancellable        *cancellable,
+                                                                GAsyncReadyCallback  callback,
+                                                                gpointer             user_data);
+void                   gocl_context_new_for_platform           (guint                platform_index,
+                                                                GoclDeviceType       device_type,
+                                                                GCancellable        *cancellable,
+                                                                GAsyncReadyCallback  callback,
+                                                                gpointer             user_data);
+GoclContext *          gocl_context_new_finish                 (GAsyncResult  *result,
+                                                                GError       **error);
 GoclContext *          gocl_context_gpu_new_sync               (gpointer gl_context,
                                                                 gpointer gl_display);
 
+guint                  gocl_context_get_num_platforms          (void);
+gchar *                gocl_context_get_platform_name          (guint platform_index);
+guint                  gocl_context_get_platform_index         (GoclContext *self);
+
 GoclContext *          gocl_context_get_default_cpu_sync       (void);
 GoclContext *          gocl_context_get_default_gpu_sync       (void);
 
@@ -71,6 +89,55 @@ guint                  gocl_context_get_num_devices            (GoclContext *sel
 
 GoclDevice *           gocl_context_get_device_by_index        (GoclContext *self,
                                                                 guint        device_index);
+void                   gocl_context_init_devices               (GoclContext         *self,
+                                                                GCancellable        *cancellable,
+                                                                GAsyncReadyCallback  callback,
+                                                                gpointer             user_data);
+GList *                gocl_context_init_devices_finish        (GoclContext   *self,
+                                                                GAsyncResult  *result,
+                                                                GError       **error);
+
+gpointer               gocl_context_alloc_pinned               (GoclContext *self,
+                                                                gsize        size);
+void                   gocl_context_free_pinned                (GoclContext *self,
+                                                                gpointer     ptr);
+gboolean               gocl_context_is_pinned                  (GoclContext   *self,
+                                                                gconstpointer  ptr,
+                                                                gsize          size);
+void                   gocl_context_trim_pinned                (GoclContext *self);
+
+gboolean               gocl_context_supports_image_format      (GoclContext   *self,
+                                                                guint          flags,
+                                                                GoclImageType  type,
+                                                                guint          channel_order,
+                                                                guint          channel_type);
+
+gpointer               gocl_context_svm_alloc                  (GoclContext *self,
+                                                                guint        flags,
+                                                                gsize        size,
+                                                                guint        alignment);
+void                   gocl_context_svm_free                   (GoclContext *self,
+                                                                gpointer     svm_ptr);
+gboolean               gocl_context_svm_map_sync               (GoclContext *self,
+                                                                GoclQueue   *queue,
+                                                                guint        map_flags,
+                                                                gpointer     svm_ptr,
+                                                                gsize        size,
+                                                                GList       *event_wait_list);
+GoclEvent *            gocl_context_svm_map                    (GoclContext *self,
+                                                                GoclQueue   *queue,
+                                                                guint        map_flags,
+                                                                gpointer     svm_ptr,
+                                                                gsize        size,
+                                                                GList       *event_wait_list);
+gboolean               gocl_context_svm_unmap_sync             (GoclContext *self,
+                                                                GoclQueue   *queue,
+                                                                gpointer     svm_ptr,
+                                                                GList       *event_wait_list);
+GoclEvent *            gocl_context_svm_unmap                  (GoclContext *self,
+                                                                GoclQueue   *queue,
+                                                                gpointer     svm_ptr,
+                                                                GList       *event_wait_list);
 
 /* GoclDevice headers */
 GoclContext *          gocl_device_get_context                 (GoclDevice *device);
@@ -90,9 +157,24 @@ GoclImage *            gocl_image_new                          (GoclContext   *c
                                                                 gsize          width,
                                                                 gsize          height,
                                                                 gsize          depth);
+GoclImage *            gocl_image_new_full                     (GoclContext   *context,
+                                                                guint          flags,
+                                                                gpointer       host_ptr,
+                                                                GoclImageType  type,
+                                                                guint          channel_order,
+                                                                guint          channel_type,
+                                                                gsize          width,
+                                                                gsize          height,
+                                                                gsize          depth,
+                                                                gsize          array_size);
 GoclImage *            gocl_image_new_from_gl_texture          (GoclContext *context,
                                                                 guint        flags,
                                                                 guint        texture);
+GoclImage *            gocl_image_new_from_gl_texture_full     (GoclContext *context,
+                                                                guint        flags,
+                                                                guint        target,
+                                                                gint         miplevel,
+                                                                guint        texture);
 #ifdef HAS_COGL
 GoclImage *            gocl_image_new_from_cogl_texture        (GoclContext *context,
                                                                 guint        flags,
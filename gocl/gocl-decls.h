@@ -94,6 +94,24 @@ typedef enum
   GOCL_QUEUE_FLAGS_PROFILING    = CL_QUEUE_PROFILING_ENABLE
 } GoclQueueFlags;
 
+/**
+ * GoclMapFlags:
+ * @GOCL_MAP_FLAGS_READ:                    The mapped region is going to be
+ *                                          read by the host.
+ * @GOCL_MAP_FLAGS_WRITE:                   The mapped region is going to be
+ *                                          written by the host.
+ * @GOCL_MAP_FLAGS_WRITE_INVALIDATE_REGION: The mapped region is going to be
+ *                                          completely overwritten by the host,
+ *                                          so its previous contents need not
+ *                                          be transferred.
+ **/
+typedef enum
+{
+  GOCL_MAP_FLAGS_READ                    = CL_MAP_READ,
+  GOCL_MAP_FLAGS_WRITE                   = CL_MAP_WRITE,
+  GOCL_MAP_FLAGS_WRITE_INVALIDATE_REGION = CL_MAP_WRITE_INVALIDATE_REGION
+} GoclMapFlags;
+
 /**
  * GoclImageType:
  * @GOCL_IMAGE_TYPE_1D:        Unidimensional image
@@ -113,6 +131,187 @@ typedef enum
   GOCL_IMAGE_TYPE_3D        = CL_MEM_OBJECT_IMAGE3D
 } GoclImageType;
 
+/**
+ * GoclImageChannelOrder:
+ * @GOCL_IMAGE_CHANNEL_ORDER_R:         Single channel (red)
+ * @GOCL_IMAGE_CHANNEL_ORDER_A:         Single channel (alpha)
+ * @GOCL_IMAGE_CHANNEL_ORDER_RG:        Two channels (red, green)
+ * @GOCL_IMAGE_CHANNEL_ORDER_RA:        Two channels (red, alpha)
+ * @GOCL_IMAGE_CHANNEL_ORDER_RGB:       Three channels, only valid with packed
+ *                                      channel types
+ * @GOCL_IMAGE_CHANNEL_ORDER_RGBA:      Four channels, red first. This is the
+ *                                      default.
+ * @GOCL_IMAGE_CHANNEL_ORDER_BGRA:      Four channels, blue first
+ * @GOCL_IMAGE_CHANNEL_ORDER_ARGB:      Four channels, alpha first
+ * @GOCL_IMAGE_CHANNEL_ORDER_INTENSITY: Single channel replicated to all
+ *                                      components when read
+ * @GOCL_IMAGE_CHANNEL_ORDER_LUMINANCE: Single channel replicated to the color
+ *                                      components when read
+ *
+ * Channel orders of an image. Any other value accepted by the OpenCL
+ * platform, like those defined by vendor extensions, can also be used.
+ **/
+typedef enum
+{
+  GOCL_IMAGE_CHANNEL_ORDER_R         = CL_R,
+  GOCL_IMAGE_CHANNEL_ORDER_A         = CL_A,
+  GOCL_IMAGE_CHANNEL_ORDER_RG        = CL_RG,
+  GOCL_IMAGE_CHANNEL_ORDER_RA        = CL_RA,
+  GOCL_IMAGE_CHANNEL_ORDER_RGB       = CL_RGB,
+  GOCL_IMAGE_CHANNEL_ORDER_RGBA      = CL_RGBA,
+  GOCL_IMAGE_CHANNEL_ORDER_BGRA      = CL_BGRA,
+  GOCL_IMAGE_CHANNEL_ORDER_ARGB      = CL_ARGB,
+  GOCL_IMAGE_CHANNEL_ORDER_INTENSITY = CL_INTENSITY,
+  GOCL_IMAGE_CHANNEL_ORDER_LUMINANCE = CL_LUMINANCE
+} GoclImageChannelOrder;
+
+/**
+ * GoclImageChannelType:
+ * @GOCL_IMAGE_CHANNEL_TYPE_SNORM_INT8:       Normalized signed 8-bit integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_SNORM_INT16:      Normalized signed 16-bit integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT8:       Normalized unsigned 8-bit
+ *                                            integer. This is the default.
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT16:      Normalized unsigned 16-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNORM_SHORT_565:  Packed 5-6-5 normalized RGB
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNORM_SHORT_555:  Packed x-5-5-5 normalized RGB
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT_101010: Packed x-10-10-10 normalized RGB
+ * @GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT8:      Unnormalized signed 8-bit integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT16:     Unnormalized signed 16-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT32:     Unnormalized signed 32-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT8:    Unnormalized unsigned 8-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT16:   Unnormalized unsigned 16-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT32:   Unnormalized unsigned 32-bit
+ *                                            integer
+ * @GOCL_IMAGE_CHANNEL_TYPE_HALF_FLOAT:       16-bit floating point
+ * @GOCL_IMAGE_CHANNEL_TYPE_FLOAT:            32-bit floating point
+ *
+ * Data types of the channels of an image.
+ **/
+typedef enum
+{
+  GOCL_IMAGE_CHANNEL_TYPE_SNORM_INT8       = CL_SNORM_INT8,
+  GOCL_IMAGE_CHANNEL_TYPE_SNORM_INT16      = CL_SNORM_INT16,
+  GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT8       = CL_UNORM_INT8,
+  GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT16      = CL_UNORM_INT16,
+  GOCL_IMAGE_CHANNEL_TYPE_UNORM_SHORT_565  = CL_UNORM_SHORT_565,
+  GOCL_IMAGE_CHANNEL_TYPE_UNORM_SHORT_555  = CL_UNORM_SHORT_555,
+  GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT_101010 = CL_UNORM_INT_101010,
+  GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT8      = CL_SIGNED_INT8,
+  GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT16     = CL_SIGNED_INT16,
+  GOCL_IMAGE_CHANNEL_TYPE_SIGNED_INT32     = CL_SIGNED_INT32,
+  GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT8    = CL_UNSIGNED_INT8,
+  GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT16   = CL_UNSIGNED_INT16,
+  GOCL_IMAGE_CHANNEL_TYPE_UNSIGNED_INT32   = CL_UNSIGNED_INT32,
+  GOCL_IMAGE_CHANNEL_TYPE_HALF_FLOAT       = CL_HALF_FLOAT,
+  GOCL_IMAGE_CHANNEL_TYPE_FLOAT            = CL_FLOAT
+} GoclImageChannelType;
+
+/**
+ * GoclSvmFlags:
+ * @GOCL_SVM_FLAGS_COARSE_GRAIN: The allocation is coarse-grained: the host
+ *                               may only access it while mapped with
+ *                               gocl_context_svm_map_sync() or
+ *                               gocl_context_svm_map(). This is the default.
+ * @GOCL_SVM_FLAGS_FINE_GRAIN:   The allocation is fine-grained: the host
+ *                               and the devices can access it at any time,
+ *                               without mapping.
+ * @GOCL_SVM_FLAGS_ATOMICS:      Atomic operations on the allocation are
+ *                               visible to the host and the devices. Only
+ *                               valid together with
+ *                               %GOCL_SVM_FLAGS_FINE_GRAIN.
+ *
+ * Values for the SVM allocations of gocl_context_svm_alloc(), which are ORed
+ * with the values from #GoclBufferFlags. The values match the OpenCL 2.0
+ * ones, but are defined here so they are available with older headers.
+ **/
+typedef enum
+{
+  GOCL_SVM_FLAGS_COARSE_GRAIN = 0,
+  GOCL_SVM_FLAGS_FINE_GRAIN   = 1 << 10,
+  GOCL_SVM_FLAGS_ATOMICS      = 1 << 11
+} GoclSvmFlags;
+
+/**
+ * GoclSvmCapabilities:
+ * @GOCL_SVM_CAPABILITIES_COARSE_GRAIN_BUFFER: Coarse-grained allocations
+ *                                             are supported
+ * @GOCL_SVM_CAPABILITIES_FINE_GRAIN_BUFFER:   Fine-grained allocations are
+ *                                             supported
+ * @GOCL_SVM_CAPABILITIES_FINE_GRAIN_SYSTEM:   Any memory allocated by the
+ *                                             host can be shared with the
+ *                                             device
+ * @GOCL_SVM_CAPABILITIES_ATOMICS:             Atomic operations on
+ *                                             fine-grained allocations are
+ *                                             supported
+ *
+ * The shared virtual memory capabilities of a device, as returned by
+ * gocl_device_get_svm_capabilities().
+ **/
+typedef enum
+{
+  GOCL_SVM_CAPABILITIES_COARSE_GRAIN_BUFFER = 1 << 0,
+  GOCL_SVM_CAPABILITIES_FINE_GRAIN_BUFFER   = 1 << 1,
+  GOCL_SVM_CAPABILITIES_FINE_GRAIN_SYSTEM   = 1 << 2,
+  GOCL_SVM_CAPABILITIES_ATOMICS             = 1 << 3
+} GoclSvmCapabilities;
+
+/**
+ * GoclDeviceExtension:
+ * @GOCL_DEVICE_EXTENSION_KHR_FP64:                   cl_khr_fp64
+ * @GOCL_DEVICE_EXTENSION_KHR_FP16:                   cl_khr_fp16
+ * @GOCL_DEVICE_EXTENSION_KHR_GL_SHARING:             cl_khr_gl_sharing
+ * @GOCL_DEVICE_EXTENSION_KHR_GL_EVENT:               cl_khr_gl_event
+ * @GOCL_DEVICE_EXTENSION_KHR_GLOBAL_INT32_ATOMICS:   cl_khr_global_int32_base_atomics
+ * @GOCL_DEVICE_EXTENSION_KHR_LOCAL_INT32_ATOMICS:    cl_khr_local_int32_base_atomics
+ * @GOCL_DEVICE_EXTENSION_KHR_INT64_ATOMICS:          cl_khr_int64_base_atomics
+ * @GOCL_DEVICE_EXTENSION_KHR_BYTE_ADDRESSABLE_STORE: cl_khr_byte_addressable_store
+ * @GOCL_DEVICE_EXTENSION_KHR_3D_IMAGE_WRITES:        cl_khr_3d_image_writes
+ * @GOCL_DEVICE_EXTENSION_KHR_IMAGE2D_FROM_BUFFER:    cl_khr_image2d_from_buffer
+ * @GOCL_DEVICE_EXTENSION_KHR_SUBGROUPS:              cl_khr_subgroups
+ * @GOCL_DEVICE_EXTENSION_KHR_SPIR:                   cl_khr_spir
+ *
+ * Well-known OpenCL extensions, as reported in the @extensions bitset of
+ * #GoclDeviceInfo.
+ **/
+typedef enum
+{
+  GOCL_DEVICE_EXTENSION_KHR_FP64                   = 1 << 0,
+  GOCL_DEVICE_EXTENSION_KHR_FP16                   = 1 << 1,
+  GOCL_DEVICE_EXTENSION_KHR_GL_SHARING             = 1 << 2,
+  GOCL_DEVICE_EXTENSION_KHR_GL_EVENT               = 1 << 3,
+  GOCL_DEVICE_EXTENSION_KHR_GLOBAL_INT32_ATOMICS   = 1 << 4,
+  GOCL_DEVICE_EXTENSION_KHR_LOCAL_INT32_ATOMICS    = 1 << 5,
+  GOCL_DEVICE_EXTENSION_KHR_INT64_ATOMICS          = 1 << 6,
+  GOCL_DEVICE_EXTENSION_KHR_BYTE_ADDRESSABLE_STORE = 1 << 7,
+  GOCL_DEVICE_EXTENSION_KHR_3D_IMAGE_WRITES        = 1 << 8,
+  GOCL_DEVICE_EXTENSION_KHR_IMAGE2D_FROM_BUFFER    = 1 << 9,
+  GOCL_DEVICE_EXTENSION_KHR_SUBGROUPS              = 1 << 10,
+  GOCL_DEVICE_EXTENSION_KHR_SPIR                   = 1 << 11
+} GoclDeviceExtension;
+
+/**
+ * GoclTraceObject:
+ * @GOCL_TRACE_OBJECT_BUFFER:  #GoclBuffer objects
+ * @GOCL_TRACE_OBJECT_EVENT:   #GoclEvent objects
+ * @GOCL_TRACE_OBJECT_KERNEL:  #GoclKernel objects
+ * @GOCL_TRACE_OBJECT_PROGRAM: #GoclProgram objects
+ *
+ * The types of objects whose number of live instances is counted when
+ * tracing is built in. See gocl_trace_get_num_objects().
+ **/
+typedef enum
+{
+  GOCL_TRACE_OBJECT_BUFFER = 0,
+  GOCL_TRACE_OBJECT_EVENT,
+  GOCL_TRACE_OBJECT_KERNEL,
+  GOCL_TRACE_OBJECT_PROGRAM
+} GoclTraceObject;
+
 G_END_DECLS
 
 #endif /* __GOCL_DECLS_H__ */
@@ -32,9 +32,31 @@
  * gocl_device_get_max_work_group_size() is used. The number of compute units can be
  * retrieved with gocl_device_get_max_compute_units().
  *
+ * The capabilities of a device, like memory sizes, preferred vector widths,
+ * image limits and well-known extensions, are queried once, on first use,
+ * and kept in a #GoclDeviceInfo snapshot returned by gocl_device_get_info().
+ * The getters above and gocl_device_has_extension() read from that snapshot
+ * too, so they are cheap enough to be used in per-dispatch decisions.
+ *
  * To enqueue operations on this device, a #GoclQueue provides a default command queue
  * which is obtained by calling gocl_device_get_default_queue(). More device queues can
- * be created by passing this object as 'device' property in the #GoclQueue constructor.
+ * be created with gocl_queue_new(). To avoid blocking while the queues are
+ * created, gocl_device_init_queues() creates them in worker threads.
+ *
+ * A device can also manage several compute queues, set with
+ * gocl_device_set_num_compute_queues() and picked in a round-robin fashion by
+ * gocl_device_get_compute_queue(), and a dedicated transfer queue obtained with
+ * gocl_device_get_transfer_queue(). This allows host-device copies to overlap
+ * with kernel execution.
+ *
+ * Objects shared with OpenGL are acquired and released with
+ * gocl_device_acquire_gl_objects() and gocl_device_release_gl_objects(). To
+ * run kernels on them every frame without blocking the host, record the
+ * acquisition, the kernel runs and the release in a #GoclCommandList.
+ *
+ * A #GoclDevice can be shared across threads. Its command queues are
+ * created lazily without locking; if several threads race to create the
+ * same queue, only one of them is kept.
  **/
 
 /**
@@ -44,6 +66,7 @@
  * The class for #GoclDevice objects.
  **/
 
+#include <string.h>
 #include <gio/gio.h>
 
 #include "gocl-device.h"
@@ -53,16 +76,37 @@
 #include "gocl-decls.h"
 #include "gocl-context.h"
 
+#define MAX_COMPUTE_QUEUES 16
+
+/* objects converted to a cl_mem array on the stack when acquiring or
+   releasing GL objects */
+#define GL_OBJECTS_PREALLOC 8
+
+/* from cl_khr_gl_event, declared here to not depend on the version of
+   the OpenCL headers */
+typedef cl_event (CL_API_CALL * CreateEventFromGLsyncFunc) (cl_context  context,
+                                                            gpointer    sync,
+                                                            cl_int     *err_code);
+
 struct _GoclDevicePrivate
 {
   GoclContext *context;
   cl_device_id device_id;
 
-  gsize max_work_group_size;
+  /* owned by the context, and shared with every device of the same id */
+  const GoclDeviceSnapshot *snapshot;
 
   GoclQueue *queue;
 
-  gchar *extensions;
+  /* compute queue 0 is the default queue, not stored here */
+  GoclQueue *compute_queues[MAX_COMPUTE_QUEUES - 1];
+  guint num_compute_queues;
+  gint next_compute_queue;
+
+  GoclQueue *transfer_queue;
+
+  gsize gl_event_loaded;
+  CreateEventFromGLsyncFunc create_event_from_gl_sync;
 };
 
 /* properties */
@@ -129,16 +173,22 @@ gocl_device_init (GoclDevice *self)
 
   self->priv = priv = GOCL_DEVICE_GET_PRIVATE (self);
 
-  priv->max_work_group_size = 0;
+  priv->snapshot = NULL;
+
   priv->queue = NULL;
 
-  priv->extensions = NULL;
+  memset (priv->compute_queues, 0, sizeof (priv->compute_queues));
+  priv->num_compute_queues = 1;
+  priv->next_compute_queue = 0;
+
+  priv->transfer_queue = NULL;
 }
 
 static void
 gocl_device_dispose (GObject *obj)
 {
   GoclDevice *self = GOCL_DEVICE (obj);
+  guint i;
 
   if (self->priv->context != NULL)
     {
@@ -152,16 +202,27 @@ gocl_device_dispose (GObject *obj)
       self->priv->queue = NULL;
     }
 
+  for (i = 0; i < MAX_COMPUTE_QUEUES - 1; i++)
+    {
+      if (self->priv->compute_queues[i] != NULL)
+        {
+          g_object_unref (self->priv->compute_queues[i]);
+          self->priv->compute_queues[i] = NULL;
+        }
+    }
+
+  if (self->priv->transfer_queue != NULL)
+    {
+      g_object_unref (self->priv->transfer_queue);
+      self->priv->transfer_queue = NULL;
+    }
+
   G_OBJECT_CLASS (gocl_device_parent_class)->dispose (obj);
 }
 
 static void
 gocl_device_finalize (GObject *obj)
 {
-  GoclDevice *self = GOCL_DEVICE (obj);
-
-  g_free (self->priv->extensions);
-
   G_OBJECT_CLASS (gocl_device_parent_class)->finalize (obj);
 }
 
@@ -217,22 +278,50 @@ get_property (GObject    *obj,
     }
 }
 
+static cl_int
+acquire_or_release_gl_objects (GoclQueue               *queue,
+                               gboolean                 acquire,
+                               GList                   *object_list,
+                               const GoclEventWaitList *wait_list,
+                               cl_event                *out_event)
+{
+  cl_int err_code;
+  GoclBuffer *objects_prealloc[GL_OBJECTS_PREALLOC];
+  GoclBuffer **objects = objects_prealloc;
+  guint len;
+  guint i;
+
+  len = g_list_length (object_list);
+  if (len > GL_OBJECTS_PREALLOC)
+    objects = g_new (GoclBuffer *, len);
+
+  for (i = 0; object_list != NULL; object_list = object_list->next, i++)
+    objects[i] = object_list->data;
+
+  err_code = gocl_device_enqueue_gl_objects (gocl_queue_get_queue (queue),
+                                             acquire,
+                                             objects,
+                                             len,
+                                             wait_list->len,
+                                             wait_list->events,
+                                             out_event);
+
+  if (objects != objects_prealloc)
+    g_free (objects);
+
+  return err_code;
+}
+
 static gboolean
-acquire_or_release_gl_objects (GoclDevice  *self,
-                               gboolean     acquire,
-                               GList       *object_list,
-                               GList       *event_wait_list,
-                               cl_event    *out_event)
+acquire_or_release_gl_objects_sync (GoclDevice *self,
+                                    gboolean    acquire,
+                                    GList      *object_list,
+                                    GList      *event_wait_list)
 {
   cl_int err_code;
+  cl_event event = NULL;
   GoclQueue *queue;
-  cl_command_queue _queue;
-
-  cl_event *_event_wait_list = NULL;
-  guint event_wait_list_len;
-
-  cl_mem *_object_list;
-  guint object_list_len;
+  GoclEventWaitList wait_list;
 
   g_return_val_if_fail (GOCL_IS_DEVICE (self), FALSE);
 
@@ -243,35 +332,260 @@ acquire_or_release_gl_objects (GoclDevice  *self,
   if (queue == NULL)
     return FALSE;
 
-  _queue = gocl_queue_get_queue (queue);
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  err_code = acquire_or_release_gl_objects (queue,
+                                            acquire,
+                                            object_list,
+                                            &wait_list,
+                                            &event);
+  gocl_event_wait_list_clear (&wait_list);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list,
-                                               &event_wait_list_len);
-  _object_list = gocl_buffer_list_to_array (object_list,
-                                            &object_list_len);
+  return gocl_event_wait_for_result (err_code, event);
+}
 
-  if (acquire)
-    err_code = clEnqueueAcquireGLObjects (_queue,
-                                          object_list_len,
-                                          _object_list,
-                                          event_wait_list_len,
-                                          _event_wait_list,
-                                          out_event);
-  else
-    err_code = clEnqueueReleaseGLObjects (_queue,
-                                          object_list_len,
-                                          _object_list,
-                                          event_wait_list_len,
-                                          _event_wait_list,
-                                          out_event);
+static GoclEvent *
+acquire_or_release_gl_objects_async (GoclDevice *self,
+                                     gboolean    acquire,
+                                     GList      *object_list,
+                                     GList      *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclQueue *queue;
+  GoclEventWaitList wait_list;
 
-  g_free (_event_wait_list);
-  g_free (_object_list);
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), NULL);
 
-  if (gocl_error_check_opencl_internal (err_code))
-    return FALSE;
+  queue = gocl_device_get_default_queue (self);
+  if (queue == NULL)
+    return NULL;
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  err_code = acquire_or_release_gl_objects (queue,
+                                            acquire,
+                                            object_list,
+                                            &wait_list,
+                                            &event);
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
 
-  return TRUE;
+  return _event;
+}
+
+/* returns the queue stored in @queue, creating it if needed. Several
+   threads may race to create it; the first one to store its queue wins,
+   and the others drop theirs, so reading is lock-free */
+static GoclQueue *
+get_queue (GoclDevice *self, GoclQueue **queue, guint flags)
+{
+  GoclQueue *_queue;
+
+  _queue = g_atomic_pointer_get (queue);
+  if (_queue != NULL)
+    return _queue;
+
+  _queue = gocl_queue_new (self, flags);
+  if (_queue == NULL)
+    return NULL;
+
+  if (! g_atomic_pointer_compare_and_exchange (queue, NULL, _queue))
+    {
+      g_object_unref (_queue);
+      _queue = g_atomic_pointer_get (queue);
+    }
+
+  return _queue;
+}
+
+typedef struct
+{
+  GoclDevice *self;
+  GSimpleAsyncResult *res;
+  guint pending;
+  GError *error;
+} InitQueuesClosure;
+
+typedef struct
+{
+  InitQueuesClosure *closure;
+  GoclQueue **queue;
+} QueueClosure;
+
+static void
+on_queue_ready (GObject      *obj,
+                GAsyncResult *result,
+                gpointer      user_data)
+{
+  QueueClosure *queue_closure = user_data;
+  InitQueuesClosure *closure = queue_closure->closure;
+  GObject *queue;
+  GError *error = NULL;
+
+  queue = g_async_initable_new_finish (G_ASYNC_INITABLE (obj), result, &error);
+  if (queue == NULL)
+    {
+      if (closure->error == NULL)
+        closure->error = error;
+      else
+        g_error_free (error);
+    }
+  else if (! g_atomic_pointer_compare_and_exchange (queue_closure->queue,
+                                                    NULL,
+                                                    queue))
+    {
+      /* the queue was created synchronously meanwhile */
+      g_object_unref (queue);
+    }
+
+  g_slice_free (QueueClosure, queue_closure);
+
+  closure->pending--;
+  if (closure->pending > 0)
+    return;
+
+  if (closure->error != NULL)
+    g_simple_async_result_take_error (closure->res, closure->error);
+
+  g_simple_async_result_complete (closure->res);
+  g_object_unref (closure->res);
+
+  g_slice_free (InitQueuesClosure, closure);
+}
+
+static void
+init_queue_async (InitQueuesClosure *closure,
+                  GoclQueue         **queue,
+                  GCancellable       *cancellable)
+{
+  QueueClosure *queue_closure;
+
+  queue_closure = g_slice_new (QueueClosure);
+  queue_closure->closure = closure;
+  queue_closure->queue = queue;
+
+  closure->pending++;
+
+  g_async_initable_new_async (GOCL_TYPE_QUEUE,
+                              G_PRIORITY_DEFAULT,
+                              cancellable,
+                              on_queue_ready,
+                              queue_closure,
+                              "device", closure->self,
+                              NULL);
+}
+
+static cl_uint
+get_device_uint (cl_device_id device_id, cl_device_info param)
+{
+  cl_uint value = 0;
+
+  clGetDeviceInfo (device_id, param, sizeof (cl_uint), &value, NULL);
+
+  return value;
+}
+
+static cl_ulong
+get_device_ulong (cl_device_id device_id, cl_device_info param)
+{
+  cl_ulong value = 0;
+
+  clGetDeviceInfo (device_id, param, sizeof (cl_ulong), &value, NULL);
+
+  return value;
+}
+
+static gsize
+get_device_size (cl_device_id device_id, cl_device_info param)
+{
+  gsize value = 0;
+
+  clGetDeviceInfo (device_id, param, sizeof (gsize), &value, NULL);
+
+  return value;
+}
+
+/* returns the GoclDeviceExtension flag of a well-known extension, or 0 */
+static guint
+get_extension_flag (const gchar *extension_name)
+{
+  static const struct
+  {
+    const gchar *name;
+    guint flag;
+  } extensions[] = {
+    { "cl_khr_fp64", GOCL_DEVICE_EXTENSION_KHR_FP64 },
+    { "cl_khr_fp16", GOCL_DEVICE_EXTENSION_KHR_FP16 },
+    { "cl_khr_gl_sharing", GOCL_DEVICE_EXTENSION_KHR_GL_SHARING },
+    { "cl_khr_gl_event", GOCL_DEVICE_EXTENSION_KHR_GL_EVENT },
+    { "cl_khr_global_int32_base_atomics",
+      GOCL_DEVICE_EXTENSION_KHR_GLOBAL_INT32_ATOMICS },
+    { "cl_khr_local_int32_base_atomics",
+      GOCL_DEVICE_EXTENSION_KHR_LOCAL_INT32_ATOMICS },
+    { "cl_khr_int64_base_atomics", GOCL_DEVICE_EXTENSION_KHR_INT64_ATOMICS },
+    { "cl_khr_byte_addressable_store",
+      GOCL_DEVICE_EXTENSION_KHR_BYTE_ADDRESSABLE_STORE },
+    { "cl_khr_3d_image_writes", GOCL_DEVICE_EXTENSION_KHR_3D_IMAGE_WRITES },
+    { "cl_khr_image2d_from_buffer",
+      GOCL_DEVICE_EXTENSION_KHR_IMAGE2D_FROM_BUFFER },
+    { "cl_khr_subgroups", GOCL_DEVICE_EXTENSION_KHR_SUBGROUPS },
+    { "cl_khr_spir", GOCL_DEVICE_EXTENSION_KHR_SPIR }
+  };
+  guint i;
+
+  for (i = 0; i < G_N_ELEMENTS (extensions); i++)
+    if (strcmp (extension_name, extensions[i].name) == 0)
+      return extensions[i].flag;
+
+  return 0;
+}
+
+static void
+load_extensions (cl_device_id id, GoclDeviceSnapshot *snapshot)
+{
+  gchar *value;
+  gsize value_size = 0;
+  cl_int err_code;
+  guint i;
+
+  err_code = clGetDeviceInfo (id,
+                              CL_DEVICE_EXTENSIONS,
+                              0,
+                              NULL,
+                              &value_size);
+  if (err_code != CL_SUCCESS || value_size == 0)
+    {
+      snapshot->extension_names = g_new0 (gchar *, 1);
+      return;
+    }
+
+  value = g_malloc0 (value_size + 1);
+  clGetDeviceInfo (id,
+                   CL_DEVICE_EXTENSIONS,
+                   value_size,
+                   value,
+                   NULL);
+
+  snapshot->extension_names = g_strsplit (g_strstrip (value), " ", -1);
+  g_free (value);
+
+  for (i = 0; snapshot->extension_names[i] != NULL; i++)
+    snapshot->info.extensions |=
+      get_extension_flag (snapshot->extension_names[i]);
+}
+
+/* the snapshot lives on the context, so that it is taken only once per
+   device id no matter how many GoclDevice instances wrap it */
+static const GoclDeviceInfo *
+get_info (GoclDevice *self)
+{
+  if (g_once_init_enter (&self->priv->snapshot))
+    g_once_init_leave (&self->priv->snapshot,
+                       gocl_context_get_device_snapshot (self->priv->context,
+                                                         self->priv->device_id));
+
+  return &self->priv->snapshot->info;
 }
 
 /* public */
@@ -292,6 +606,26 @@ gocl_device_get_id (GoclDevice *self)
   return self->priv->device_id;
 }
 
+/**
+ * gocl_device_get_info:
+ * @self: The #GoclDevice
+ *
+ * Retrieves a snapshot of the capabilities of the device. The properties
+ * are queried from the driver only the first time, so checking them later
+ * costs no more than reading a structure field. The snapshot is kept by the
+ * #GoclContext, and shared by every #GoclDevice instance of the same device.
+ *
+ * Returns: (transfer none): A #GoclDeviceInfo, owned by the device and
+ *   valid for its whole lifetime. Do not modify or free.
+ **/
+const GoclDeviceInfo *
+gocl_device_get_info (GoclDevice *self)
+{
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), NULL);
+
+  return get_info (self);
+}
+
 /**
  * gocl_device_get_context:
  * @device: The #GoclDevice
@@ -313,9 +647,9 @@ gocl_device_get_context (GoclDevice *device)
  * gocl_device_get_max_work_group_size:
  * @self: The #GoclDevice
  *
- * Retrieves the maximum work group size for the device,
- * by querying the @CL_DEVICE_MAX_WORK_GROUP_SIZE info key through
- * clGetDeviceInfo().
+ * Retrieves the maximum work group size for the device, from the
+ * CL_DEVICE_MAX_WORK_GROUP_SIZE info key kept in the device snapshot (see
+ * gocl_device_get_info()).
  * Upon success a value greater than zero is returned, otherwise zero
  * is returned.
  *
@@ -324,22 +658,9 @@ gocl_device_get_context (GoclDevice *device)
 gsize
 gocl_device_get_max_work_group_size (GoclDevice *self)
 {
-  cl_int err_code;
-
   g_return_val_if_fail (GOCL_IS_DEVICE (self), 0);
 
-  if (self->priv->max_work_group_size > 0)
-    return self->priv->max_work_group_size;
-
-  err_code = clGetDeviceInfo (self->priv->device_id,
-                              CL_DEVICE_MAX_WORK_GROUP_SIZE,
-                              sizeof (gsize),
-                              &self->priv->max_work_group_size,
-                              NULL);
-  if (gocl_error_check_opencl_internal (err_code))
-    return 0;
-
-  return self->priv->max_work_group_size;
+  return get_info (self)->max_work_group_size;
 }
 
 /**
@@ -357,19 +678,211 @@ gocl_device_get_default_queue (GoclDevice *self)
 {
   g_return_val_if_fail (GOCL_IS_DEVICE (self), NULL);
 
-  if (self->priv->queue == NULL)
+  return get_queue (self, &self->priv->queue, 0);
+}
+
+/**
+ * gocl_device_init_queues:
+ * @self: The #GoclDevice
+ * @cancellable: (allow-none): A #GCancellable object, or %NULL
+ * @callback: (allow-none): Callback to be called upon completion, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass in @callback, or %NULL
+ *
+ * Asynchronously creates the default queue and the transfer queue of the
+ * device, if they don't exist yet. Creating a command queue can block for a
+ * noticeable time on some drivers, so the queues are created in parallel,
+ * in worker threads. Once the operation completes,
+ * gocl_device_get_default_queue() and gocl_device_get_transfer_queue()
+ * return immediately. Use gocl_device_init_queues_finish() within
+ * @callback to retrieve the result of the operation.
+ **/
+void
+gocl_device_init_queues (GoclDevice          *self,
+                         GCancellable        *cancellable,
+                         GAsyncReadyCallback  callback,
+                         gpointer             user_data)
+{
+  InitQueuesClosure *closure;
+
+  g_return_if_fail (GOCL_IS_DEVICE (self));
+
+  closure = g_slice_new0 (InitQueuesClosure);
+  closure->self = self;
+  closure->res = g_simple_async_result_new (G_OBJECT (self),
+                                            callback,
+                                            user_data,
+                                            gocl_device_init_queues);
+
+  if (g_atomic_pointer_get (&self->priv->queue) == NULL)
+    init_queue_async (closure, &self->priv->queue, cancellable);
+  if (g_atomic_pointer_get (&self->priv->transfer_queue) == NULL)
+    init_queue_async (closure, &self->priv->transfer_queue, cancellable);
+
+  if (closure->pending == 0)
     {
-      GError **error;
-
-      error = gocl_error_prepare ();
-      self->priv->queue = g_initable_new (GOCL_TYPE_QUEUE,
-                                          NULL,
-                                          error,
-                                          "device", self,
-                                          NULL);
+      g_simple_async_result_complete_in_idle (closure->res);
+      g_object_unref (closure->res);
+      g_slice_free (InitQueuesClosure, closure);
     }
+}
+
+/**
+ * gocl_device_init_queues_finish:
+ * @self: The #GoclDevice
+ * @result: The #GAsyncResult object from callback's arguments
+ * @error: (out) (allow-none): A pointer to a #GError, or %NULL
+ *
+ * Retrieves the result of a gocl_device_init_queues() asynchronous
+ * operation. On error, %FALSE is returned and @error is filled accordingly.
+ *
+ * Returns: %TRUE on success, or %FALSE on error
+ **/
+gboolean
+gocl_device_init_queues_finish (GoclDevice    *self,
+                                GAsyncResult  *result,
+                                GError       **error)
+{
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), FALSE);
+  g_return_val_if_fail (g_simple_async_result_is_valid (result,
+                                                        G_OBJECT (self),
+                                                        gocl_device_init_queues),
+                        FALSE);
+
+  return
+    ! g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result),
+                                             error);
+}
+
+/**
+ * gocl_device_set_num_compute_queues:
+ * @self: The #GoclDevice
+ * @num_queues: The number of compute queues, between 1 and 16
+ *
+ * Sets the number of command queues that gocl_device_get_compute_queue()
+ * rotates through. The first compute queue is always the default queue
+ * returned by gocl_device_get_default_queue(), and the others are created
+ * with the same flags the first time they are needed. By default there is
+ * only one compute queue.
+ *
+ * Using several compute queues allows independent operations to execute
+ * concurrently on the device. Notice that operations enqueued on different
+ * queues are not ordered with respect to each other, so dependencies
+ * between them must be expressed with event wait lists.
+ *
+ * The number of compute queues should be set before the device is shared
+ * across threads.
+ **/
+void
+gocl_device_set_num_compute_queues (GoclDevice *self, guint num_queues)
+{
+  g_return_if_fail (GOCL_IS_DEVICE (self));
+  g_return_if_fail (num_queues > 0 && num_queues <= MAX_COMPUTE_QUEUES);
+
+  self->priv->num_compute_queues = num_queues;
+}
+
+/**
+ * gocl_device_get_num_compute_queues:
+ * @self: The #GoclDevice
+ *
+ * Retrieves the number of compute queues of the device, as set by
+ * gocl_device_set_num_compute_queues().
+ *
+ * Returns: The number of compute queues
+ **/
+guint
+gocl_device_get_num_compute_queues (GoclDevice *self)
+{
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), 0);
 
-  return self->priv->queue;
+  return self->priv->num_compute_queues;
+}
+
+/**
+ * gocl_device_get_compute_queue:
+ * @self: The #GoclDevice
+ *
+ * Picks one of the compute queues of the device, in a round-robin fashion.
+ * Consecutive calls return consecutive queues, so that independent work
+ * is spread across all of them. If the device has only one compute queue
+ * (the default), this is the same as gocl_device_get_default_queue().
+ *
+ * Returns: (transfer none): A #GoclQueue object, which is owned by the
+ *   device and should not be freed, or %NULL on error
+ **/
+GoclQueue *
+gocl_device_get_compute_queue (GoclDevice *self)
+{
+  GoclQueue *queue;
+  guint index;
+
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), NULL);
+
+  if (self->priv->num_compute_queues <= 1)
+    return gocl_device_get_default_queue (self);
+
+  index = (guint) g_atomic_int_add (&self->priv->next_compute_queue, 1) %
+    self->priv->num_compute_queues;
+
+  if (index == 0)
+    return gocl_device_get_default_queue (self);
+
+  queue = gocl_device_get_default_queue (self);
+  if (queue == NULL)
+    return NULL;
+
+  return get_queue (self,
+                    &self->priv->compute_queues[index - 1],
+                    gocl_queue_get_flags (queue));
+}
+
+/**
+ * gocl_device_get_transfer_queue:
+ * @self: The #GoclDevice
+ *
+ * Returns a command queue dedicated to data transfers, separate from the
+ * compute queues. Enqueuing buffer reads and writes on this queue allows
+ * them to overlap with kernel executions on devices that have independent
+ * copy engines. The queue is created the first time this method is called.
+ *
+ * Returns: (transfer none): A #GoclQueue object, which is owned by the
+ *   device and should not be freed, or %NULL on error
+ **/
+GoclQueue *
+gocl_device_get_transfer_queue (GoclDevice *self)
+{
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), NULL);
+
+  return get_queue (self, &self->priv->transfer_queue, 0);
+}
+
+/**
+ * gocl_queue_new:
+ * @device: The #GoclDevice to create the queue for
+ * @flags: An OR'ed combination of values from #GoclQueueFlags
+ *
+ * Creates a new command queue for @device. Besides the queues managed by
+ * the device itself (see gocl_device_get_default_queue(),
+ * gocl_device_get_compute_queue() and gocl_device_get_transfer_queue()),
+ * applications can create as many queues as they need.
+ *
+ * Returns: (transfer full): A newly created #GoclQueue, or %NULL on error
+ **/
+GoclQueue *
+gocl_queue_new (GoclDevice *device, guint flags)
+{
+  GError **error;
+
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), NULL);
+
+  error = gocl_error_prepare ();
+
+  return g_initable_new (GOCL_TYPE_QUEUE,
+                         NULL,
+                         error,
+                         "device", device,
+                         "flags", flags,
+                         NULL);
 }
 
 /**
@@ -378,76 +891,70 @@ gocl_device_get_default_queue (GoclDevice *self)
  * @extension_name: The OpenCL extension name, as string
  *
  * Tells whether the device supports a given OpenCL extension, described by
- * @extension_name.
+ * @extension_name. Well-known extensions, listed in #GoclDeviceExtension,
+ * are looked up in the bitset of the device snapshot, and others are
+ * compared with each of the extension names reported by the device.
  *
  * Returns: %TRUE if the device supports the extension, %FALSE otherwise
  **/
 gboolean
 gocl_device_has_extension (GoclDevice *self, const gchar *extension_name)
 {
+  const GoclDeviceInfo *info;
+  guint flag;
+  guint i;
+
   g_return_val_if_fail (GOCL_IS_DEVICE (self), FALSE);
   g_return_val_if_fail (extension_name != NULL, FALSE);
 
-  if (self->priv->extensions == NULL)
-    {
-      cl_int err_code;
-      gchar value[2049] = {0, };
-      gsize value_size;
-      GError *error = NULL;
-
-      err_code = clGetDeviceInfo (self->priv->device_id,
-                                  CL_DEVICE_EXTENSIONS,
-                                  2048,
-                                  value,
-                                  &value_size);
-      if (gocl_error_check_opencl (err_code, &error))
-        {
-          g_warning ("Error getting device info for CL_DEVICE_EXTENSIONS: %s",
-                     error->message);
-          g_error_free (error);
-          return FALSE;
-        }
+  info = get_info (self);
 
-      value[value_size] = '\0';
-      self->priv->extensions = g_strdup (value);
-    }
+  flag = get_extension_flag (extension_name);
+  if (flag != 0)
+    return (info->extensions & flag) != 0;
 
-  return
-    g_strstr_len (self->priv->extensions, -1, extension_name) != NULL;
+  for (i = 0; self->priv->snapshot->extension_names[i] != NULL; i++)
+    if (strcmp (self->priv->snapshot->extension_names[i], extension_name) == 0)
+      return TRUE;
+
+  return FALSE;
 }
 
 /**
  * gocl_device_get_max_compute_units:
  * @self: The #GoclDevice
  *
- * Retrieves the number of compute units in an OpenCL device, by querying
- * CL_DEVICE_MAX_COMPUTE_UNITS in device info.
+ * Retrieves the number of compute units in an OpenCL device, from
+ * CL_DEVICE_MAX_COMPUTE_UNITS in the device snapshot (see
+ * gocl_device_get_info()).
  *
  * Returns: The number of compute units in the device
  **/
 guint
 gocl_device_get_max_compute_units (GoclDevice *self)
 {
-  cl_int err_code;
-  cl_uint max_compute_units;
-  GError *error = NULL;
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), 0);
 
-  g_return_val_if_fail (GOCL_IS_DEVICE (self), FALSE);
+  return get_info (self)->max_compute_units;
+}
 
-  err_code = clGetDeviceInfo (self->priv->device_id,
-                              CL_DEVICE_MAX_COMPUTE_UNITS,
-                              sizeof (guint),
-                              &max_compute_units,
-                              NULL);
-  if (gocl_error_check_opencl (err_code, &error))
-    {
-      g_warning ("Error getting device info for CL_DEVICE_MAX_COMPUTE_UNITS: %s",
-                 error->message);
-      g_error_free (error);
-      return 0;
-    }
+/**
+ * gocl_device_get_svm_capabilities:
+ * @self: The #GoclDevice
+ *
+ * Retrieves the shared virtual memory capabilities of an OpenCL device,
+ * from CL_DEVICE_SVM_CAPABILITIES in the device snapshot (see
+ * gocl_device_get_info()). Devices older than OpenCL 2.0, or a Gocl built
+ * against older headers, report no capabilities.
+ *
+ * Returns: An OR'ed combination of values from #GoclSvmCapabilities
+ **/
+guint
+gocl_device_get_svm_capabilities (GoclDevice *self)
+{
+  g_return_val_if_fail (GOCL_IS_DEVICE (self), 0);
 
-  return (guint) max_compute_units;
+  return get_info (self)->svm_capabilities;
 }
 
 /**
@@ -474,21 +981,10 @@ gocl_device_acquire_gl_objects_sync (GoclDevice  *self,
                                      GList       *object_list,
                                      GList       *event_wait_list)
 {
-  cl_event event;
-
-  if (! acquire_or_release_gl_objects (self,
-                                       TRUE,
-                                       object_list,
-                                       event_wait_list,
-                                       &event))
-    {
-      return FALSE;
-    }
-
-  clWaitForEvents (1, &event);
-  clReleaseEvent (event);
-
-  return TRUE;
+  return acquire_or_release_gl_objects_sync (self,
+                                             TRUE,
+                                             object_list,
+                                             event_wait_list);
 }
 
 /**
@@ -515,41 +1011,10 @@ gocl_device_acquire_gl_objects (GoclDevice  *self,
                                 GList       *object_list,
                                 GList       *event_wait_list)
 {
-  GoclEvent *_event = NULL;
-  cl_event event;
-  GoclQueue *queue;
-
-  queue = gocl_device_get_default_queue (self);
-
-  if (! acquire_or_release_gl_objects (self,
-                                       TRUE,
-                                       object_list,
-                                       event_wait_list,
-                                       &event))
-    {
-      GError *error;
-      GoclEventResolverFunc resolver_func;
-
-      error = gocl_error_get_last ();
-
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             NULL);
-      resolver_func = gocl_event_steal_resolver_func (_event);
-      resolver_func (_event, error);
-      g_error_free (error);
-    }
-  else
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             "event", event,
-                             NULL);
-      gocl_event_set_event_wait_list (_event, event_wait_list);
-      gocl_event_steal_resolver_func (_event);
-    }
-
-  return _event;
+  return acquire_or_release_gl_objects_async (self,
+                                              TRUE,
+                                              object_list,
+                                              event_wait_list);
 }
 
 /**
@@ -573,21 +1038,10 @@ gocl_device_release_gl_objects_sync (GoclDevice  *self,
                                      GList       *object_list,
                                      GList       *event_wait_list)
 {
-  cl_event event;
-
-  if (! acquire_or_release_gl_objects (self,
-                                       FALSE,
-                                       object_list,
-                                       event_wait_list,
-                                       &event))
-    {
-      return FALSE;
-    }
-
-  clWaitForEvents (1, &event);
-  clReleaseEvent (event);
-
-  return TRUE;
+  return acquire_or_release_gl_objects_sync (self,
+                                             FALSE,
+                                             object_list,
+                                             event_wait_list);
 }
 
 /**
@@ -614,39 +1068,233 @@ gocl_device_release_gl_objects (GoclDevice  *self,
                                 GList       *object_list,
                                 GList       *event_wait_list)
 {
-  GoclEvent *_event = NULL;
-  cl_event event;
-  GoclQueue *queue;
+  return acquire_or_release_gl_objects_async (self,
+                                              FALSE,
+                                              object_list,
+                                              event_wait_list);
+}
 
-  queue = gocl_device_get_default_queue (self);
+/**
+ * gocl_device_enqueue_gl_objects:
+ * @queue: The #cl_command_queue to enqueue the operation in
+ * @acquire: %TRUE to acquire the objects, %FALSE to release them
+ * @objects: (array length=num_objects): The #GoclBuffer objects created from
+ * OpenGL objects
+ * @num_objects: The number of objects in @objects
+ * @num_events: The number of events in @event_wait_list
+ * @event_wait_list: (array length=num_events) (allow-none): The events to
+ * wait for
+ * @event: (out) (allow-none): A pointer to retrieve the event of the
+ * operation, or %NULL
+ *
+ * Enqueues the acquisition or release of a set of GL objects, converting
+ * them to an array of #cl_mem on the stack. If @num_objects is zero, a
+ * marker is enqueued instead so that @event is still valid.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: The OpenCL error code
+ **/
+cl_int
+gocl_device_enqueue_gl_objects (cl_command_queue    queue,
+                                gboolean            acquire,
+                                GoclBuffer * const *objects,
+                                guint               num_objects,
+                                guint               num_events,
+                                const cl_event     *event_wait_list,
+                                cl_event           *event)
+{
+  cl_int err_code;
+  cl_mem mems_prealloc[GL_OBJECTS_PREALLOC];
+  cl_mem *mems = mems_prealloc;
+  guint i;
 
-  if (! acquire_or_release_gl_objects (self,
-                                       FALSE,
-                                       object_list,
-                                       event_wait_list,
-                                       &event))
+  if (num_objects == 0)
     {
-      GError *error;
-      GoclEventResolverFunc resolver_func;
-
-      error = gocl_error_get_last ();
+      if (event == NULL)
+        return CL_SUCCESS;
 
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             NULL);
-      resolver_func = gocl_event_steal_resolver_func (_event);
-      resolver_func (_event, error);
-      g_error_free (error);
+      return clEnqueueMarkerWithWaitList (queue,
+                                          num_events,
+                                          num_events > 0 ? event_wait_list : NULL,
+                                          event);
     }
+
+  if (num_objects > GL_OBJECTS_PREALLOC)
+    mems = g_new (cl_mem, num_objects);
+
+  for (i = 0; i < num_objects; i++)
+    mems[i] = gocl_buffer_get_buffer (objects[i]);
+
+  if (acquire)
+    err_code = clEnqueueAcquireGLObjects (queue,
+                                          num_objects,
+                                          mems,
+                                          num_events,
+                                          num_events > 0 ? event_wait_list : NULL,
+                                          event);
   else
+    err_code = clEnqueueReleaseGLObjects (queue,
+                                          num_objects,
+                                          mems,
+                                          num_events,
+                                          num_events > 0 ? event_wait_list : NULL,
+                                          event);
+
+  if (mems != mems_prealloc)
+    g_free (mems);
+
+  return err_code;
+}
+
+/**
+ * gocl_device_create_event_from_gl_sync:
+ * @self: The #GoclDevice
+ * @gl_sync: A GL fence sync object, as a <i>GLsync</i>
+ * @err_code: (out): A pointer to retrieve the OpenCL error code
+ *
+ * Creates an OpenCL event that completes when @gl_sync is signaled, using
+ * the <i>cl_khr_gl_event</i> extension. If the device does not support the
+ * extension, %NULL is returned and @err_code is set to
+ * %CL_INVALID_OPERATION.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: A new #cl_event, or %NULL on error
+ **/
+cl_event
+gocl_device_create_event_from_gl_sync (GoclDevice *self,
+                                       gpointer    gl_sync,
+                                       cl_int     *err_code)
+{
+  if (g_once_init_enter (&self->priv->gl_event_loaded))
     {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             "event", event,
-                             NULL);
-      gocl_event_set_event_wait_list (_event, event_wait_list);
-      gocl_event_steal_resolver_func (_event);
+      CreateEventFromGLsyncFunc func = NULL;
+      cl_platform_id platform;
+
+      if (gocl_device_has_extension (self, "cl_khr_gl_event") &&
+          clGetDeviceInfo (self->priv->device_id,
+                           CL_DEVICE_PLATFORM,
+                           sizeof (cl_platform_id),
+                           &platform,
+                           NULL) == CL_SUCCESS)
+        {
+          func = (CreateEventFromGLsyncFunc)
+            clGetExtensionFunctionAddressForPlatform (platform,
+                                                      "clCreateEventFromGLsyncKHR");
+        }
+
+      self->priv->create_event_from_gl_sync = func;
+      g_once_init_leave (&self->priv->gl_event_loaded, 1);
     }
 
-  return _event;
+  if (self->priv->create_event_from_gl_sync == NULL)
+    {
+      *err_code = CL_INVALID_OPERATION;
+      return NULL;
+    }
+
+  return self->priv->create_event_from_gl_sync
+    (gocl_context_get_context (self->priv->context), gl_sync, err_code);
+}
+
+/**
+ * gocl_device_load_snapshot:
+ * @id: The #cl_device_id to query
+ * @snapshot: (out caller-allocates): A zero-filled #GoclDeviceSnapshot
+ *
+ * Queries the capabilities of the device into @snapshot. Every query that
+ * fails leaves its field as zero. Release with gocl_device_clear_snapshot().
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_device_load_snapshot (cl_device_id id, GoclDeviceSnapshot *snapshot)
+{
+  GoclDeviceInfo *info = &snapshot->info;
+
+  info->type = (guint) get_device_ulong (id, CL_DEVICE_TYPE);
+  info->vendor_id = get_device_uint (id, CL_DEVICE_VENDOR_ID);
+
+  info->max_compute_units = get_device_uint (id, CL_DEVICE_MAX_COMPUTE_UNITS);
+  info->max_clock_frequency =
+    get_device_uint (id, CL_DEVICE_MAX_CLOCK_FREQUENCY);
+  info->max_work_group_size =
+    get_device_size (id, CL_DEVICE_MAX_WORK_GROUP_SIZE);
+  clGetDeviceInfo (id,
+                   CL_DEVICE_MAX_WORK_ITEM_SIZES,
+                   sizeof (info->max_work_item_sizes),
+                   info->max_work_item_sizes,
+                   NULL);
+
+  info->global_mem_size = get_device_ulong (id, CL_DEVICE_GLOBAL_MEM_SIZE);
+  info->global_mem_cache_size =
+    get_device_ulong (id, CL_DEVICE_GLOBAL_MEM_CACHE_SIZE);
+  info->local_mem_size = get_device_ulong (id, CL_DEVICE_LOCAL_MEM_SIZE);
+  info->max_constant_buffer_size =
+    get_device_ulong (id, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE);
+  info->max_mem_alloc_size =
+    get_device_ulong (id, CL_DEVICE_MAX_MEM_ALLOC_SIZE);
+  info->mem_base_addr_align =
+    get_device_uint (id, CL_DEVICE_MEM_BASE_ADDR_ALIGN);
+  info->host_unified_memory =
+    get_device_uint (id, CL_DEVICE_HOST_UNIFIED_MEMORY) != CL_FALSE;
+
+  info->preferred_vector_width_char =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_CHAR);
+  info->preferred_vector_width_short =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_SHORT);
+  info->preferred_vector_width_int =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_INT);
+  info->preferred_vector_width_long =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_LONG);
+  info->preferred_vector_width_half =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_HALF);
+  info->preferred_vector_width_float =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT);
+  info->preferred_vector_width_double =
+    get_device_uint (id, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE);
+
+  info->image_support =
+    get_device_uint (id, CL_DEVICE_IMAGE_SUPPORT) != CL_FALSE;
+  if (info->image_support)
+    {
+      info->image2d_max_width =
+        get_device_size (id, CL_DEVICE_IMAGE2D_MAX_WIDTH);
+      info->image2d_max_height =
+        get_device_size (id, CL_DEVICE_IMAGE2D_MAX_HEIGHT);
+      info->image3d_max_width =
+        get_device_size (id, CL_DEVICE_IMAGE3D_MAX_WIDTH);
+      info->image3d_max_height =
+        get_device_size (id, CL_DEVICE_IMAGE3D_MAX_HEIGHT);
+      info->image3d_max_depth =
+        get_device_size (id, CL_DEVICE_IMAGE3D_MAX_DEPTH);
+      info->image_max_buffer_size =
+        get_device_size (id, CL_DEVICE_IMAGE_MAX_BUFFER_SIZE);
+      info->image_max_array_size =
+        get_device_size (id, CL_DEVICE_IMAGE_MAX_ARRAY_SIZE);
+    }
+
+#ifdef CL_VERSION_2_0
+  /* pre-2.0 devices do not know the query, and report nothing */
+  info->svm_capabilities =
+    (guint) get_device_ulong (id, CL_DEVICE_SVM_CAPABILITIES);
+#endif
+
+  load_extensions (id, snapshot);
+}
+
+/**
+ * gocl_device_clear_snapshot:
+ * @snapshot: A #GoclDeviceSnapshot filled by gocl_device_load_snapshot()
+ *
+ * Frees the memory held by @snapshot, but not @snapshot itself.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_device_clear_snapshot (GoclDeviceSnapshot *snapshot)
+{
+  g_strfreev (snapshot->extension_names);
+  snapshot->extension_names = NULL;
 }
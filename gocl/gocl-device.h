@@ -23,8 +23,10 @@
 #define __GOCL_DEVICE_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 #include <CL/opencl.h>
 
+#include "gocl-decls.h"
 #include "gocl-buffer.h"
 #include "gocl-queue.h"
 
@@ -53,18 +55,114 @@ struct _GoclDeviceClass
   GObjectClass parent_class;
 };
 
+/**
+ * GoclDeviceInfo:
+ * @type: The #GoclDeviceType of the device
+ * @vendor_id: A unique identifier of the device vendor
+ * @max_compute_units: The number of compute units
+ * @max_clock_frequency: The maximum clock frequency, in MHz
+ * @max_work_group_size: The maximum number of work-items in a work-group
+ * @max_work_item_sizes: The maximum number of work-items in each dimension
+ *   of a work-group
+ * @global_mem_size: The size of the global memory, in bytes
+ * @global_mem_cache_size: The size of the global memory cache, in bytes
+ * @local_mem_size: The size of the local memory, in bytes
+ * @max_constant_buffer_size: The maximum size of a constant buffer, in bytes
+ * @max_mem_alloc_size: The maximum size of a single allocation, in bytes
+ * @mem_base_addr_align: The alignment of buffers, in bits
+ * @host_unified_memory: Whether the device shares memory with the host
+ * @preferred_vector_width_char: The preferred vector width for char
+ * @preferred_vector_width_short: The preferred vector width for short
+ * @preferred_vector_width_int: The preferred vector width for int
+ * @preferred_vector_width_long: The preferred vector width for long
+ * @preferred_vector_width_half: The preferred vector width for half, or 0
+ *   if half precision is not supported
+ * @preferred_vector_width_float: The preferred vector width for float
+ * @preferred_vector_width_double: The preferred vector width for double, or
+ *   0 if double precision is not supported
+ * @image_support: Whether images are supported
+ * @image2d_max_width: The maximum width of 2D images, in pixels
+ * @image2d_max_height: The maximum height of 2D images, in pixels
+ * @image3d_max_width: The maximum width of 3D images, in pixels
+ * @image3d_max_height: The maximum height of 3D images, in pixels
+ * @image3d_max_depth: The maximum depth of 3D images, in pixels
+ * @image_max_buffer_size: The maximum number of pixels of 1D buffer images
+ * @image_max_array_size: The maximum number of images in an image array
+ * @svm_capabilities: An OR'ed combination of values from
+ *   #GoclSvmCapabilities
+ * @extensions: An OR'ed combination of values from #GoclDeviceExtension
+ *
+ * A snapshot of the capabilities of a device, retrieved with
+ * gocl_device_get_info(). Properties unknown to the device or the driver
+ * are zero.
+ **/
+typedef struct
+{
+  guint type;
+  guint vendor_id;
+
+  guint max_compute_units;
+  guint max_clock_frequency;
+  gsize max_work_group_size;
+  gsize max_work_item_sizes[3];
+
+  guint64 global_mem_size;
+  guint64 global_mem_cache_size;
+  guint64 local_mem_size;
+  guint64 max_constant_buffer_size;
+  guint64 max_mem_alloc_size;
+  guint mem_base_addr_align;
+  gboolean host_unified_memory;
+
+  guint preferred_vector_width_char;
+  guint preferred_vector_width_short;
+  guint preferred_vector_width_int;
+  guint preferred_vector_width_long;
+  guint preferred_vector_width_half;
+  guint preferred_vector_width_float;
+  guint preferred_vector_width_double;
+
+  gboolean image_support;
+  gsize image2d_max_width;
+  gsize image2d_max_height;
+  gsize image3d_max_width;
+  gsize image3d_max_height;
+  gsize image3d_max_depth;
+  gsize image_max_buffer_size;
+  gsize image_max_array_size;
+
+  guint svm_capabilities;
+  guint extensions;
+} GoclDeviceInfo;
+
 GType                  gocl_device_get_type                   (void) G_GNUC_CONST;
 
 cl_device_id           gocl_device_get_id                     (GoclDevice *self);
 
+const GoclDeviceInfo * gocl_device_get_info                   (GoclDevice *self);
+
 gsize                  gocl_device_get_max_work_group_size    (GoclDevice  *self);
 
 GoclQueue *            gocl_device_get_default_queue          (GoclDevice  *self);
+void                   gocl_device_init_queues                (GoclDevice          *self,
+                                                               GCancellable        *cancellable,
+                                                               GAsyncReadyCallback  callback,
+                                                               gpointer             user_data);
+gboolean               gocl_device_init_queues_finish         (GoclDevice    *self,
+                                                               GAsyncResult  *result,
+                                                               GError       **error);
+
+void                   gocl_device_set_num_compute_queues     (GoclDevice *self,
+                                                               guint       num_queues);
+guint                  gocl_device_get_num_compute_queues     (GoclDevice *self);
+GoclQueue *            gocl_device_get_compute_queue          (GoclDevice *self);
+GoclQueue *            gocl_device_get_transfer_queue         (GoclDevice *self);
 
 gboolean               gocl_device_has_extension              (GoclDevice   *self,
                                                                const gchar  *extension_name);
 
 guint                  gocl_device_get_max_compute_units      (GoclDevice *self);
+guint                  gocl_device_get_svm_capabilities       (GoclDevice *self);
 
 gboolean               gocl_device_acquire_gl_objects_sync    (GoclDevice  *self,
                                                                GList       *object_list,
@@ -80,6 +178,8 @@ GoclEvent *            gocl_device_release_gl_objects         (GoclDevice  *self
                                                                GList       *event_wait_list);
 
 /* GoclQueue headers */
+GoclQueue *            gocl_queue_new                         (GoclDevice *device,
+                                                               guint       flags);
 GoclDevice *           gocl_queue_get_device                  (GoclQueue *self);
 
 G_END_DECLS
@@ -26,12 +26,42 @@
  *
  * Internal functions related to error management. This API is private, not
  * supposed to be used in applications.
+ *
+ * The error of the last Gocl operation is kept per thread, and retrieved
+ * with gocl_error_get_last().
  **/
 
 #include "gocl-error.h"
 #include "gocl-private.h"
 
-static GError *last_error = NULL;
+static void           free_last_error                   (gpointer data);
+
+/* each thread has its own last error */
+static GPrivate last_error_key = G_PRIVATE_INIT (free_last_error);
+
+static void
+free_last_error (gpointer data)
+{
+  GError **last_error = data;
+
+  g_clear_error (last_error);
+  g_slice_free (GError *, last_error);
+}
+
+static GError **
+get_last_error (void)
+{
+  GError **last_error;
+
+  last_error = g_private_get (&last_error_key);
+  if (last_error == NULL)
+    {
+      last_error = g_slice_new0 (GError *);
+      g_private_set (&last_error_key, last_error);
+    }
+
+  return last_error;
+}
 
 static const gchar *
 get_error_code_description (cl_int err_code)
@@ -120,11 +150,13 @@ gocl_error_check_opencl (cl_int err_code, GError **error)
 gboolean
 gocl_error_check_opencl_internal (cl_int err_code)
 {
-  g_clear_error (&last_error);
+  GError **last_error = get_last_error ();
+
+  g_clear_error (last_error);
 
   if (err_code != CL_SUCCESS)
     {
-      g_set_error_literal (&last_error,
+      g_set_error_literal (last_error,
                            GOCL_OPENCL_ERROR,
                            err_code,
                            get_error_code_description (err_code));
@@ -139,8 +171,8 @@ gocl_error_check_opencl_internal (cl_int err_code)
 /**
  * gocl_error_prepare:
  *
- * Prepares the internal Gocl error for immediate use, by freeing it if
- * non-%NULL.
+ * Prepares the internal Gocl error of the calling thread for immediate use,
+ * by freeing it if non-%NULL.
  *
  * This is a Gocl private function, not exposed to applications.
  *
@@ -149,32 +181,39 @@ gocl_error_check_opencl_internal (cl_int err_code)
 GError **
 gocl_error_prepare (void)
 {
-  g_clear_error (&last_error);
+  GError **last_error = get_last_error ();
 
-  return &last_error;
+  g_clear_error (last_error);
+
+  return last_error;
 }
 
 /**
  * gocl_error_get_last:
  *
- * Retrieves the error that ocurred in the last Gocl operation, if any, or
- * %NULL if the last operation was successful.
+ * Retrieves the error that ocurred in the last Gocl operation of the
+ * calling thread, if any, or %NULL if the last operation was successful.
+ * Errors are kept per thread, so operations running concurrently in other
+ * threads never overwrite it.
  *
  * Returns: (transfer full): A pointer to a newly created error, or %NULL
  **/
 GError *
 gocl_error_get_last (void)
 {
-  return g_error_copy (last_error);
+  GError **last_error = get_last_error ();
+
+  return *last_error != NULL ? g_error_copy (*last_error) : NULL;
 }
 
 /**
  * gocl_error_free:
  *
- * Frees the internal Gocl error if it is not %NULL. Applications should
- * not normally need to ever call this function, except before the end of
+ * Frees the internal Gocl error of the calling thread if it is not %NULL.
+ * Applications should not normally need to ever call this function, since
+ * the error is freed when the thread exits, except before the end of
  * execution of the program, to avoid leaking memory from a potential error
- * in the last Gocl operation.
+ * in the last Gocl operation of the main thread.
  **/
 void
 gocl_error_free (void)
@@ -42,10 +42,25 @@
  * logic and allows for complex algorithms to be splitted in smaller,
  * synchronized routines.
  *
- * A #GoclEvent is always associated with a #GoclQueue, which represents
+ * A #GoclEvent is normally associated with a #GoclQueue, which represents
  * the command queue where the operation represented by the event was
  * originally queued. The #GoclQueue can be retrieved using
- * gocl_event_get_queue().
+ * gocl_event_get_queue(). The exception are the events of kernels run on
+ * the host with gocl_kernel_run_on_host(), which have no queue and can only
+ * be waited for by other host runs, or with gocl_event_then().
+ *
+ * If the queue was created with %GOCL_QUEUE_FLAGS_PROFILING, the timestamps
+ * of the operation can be obtained with gocl_event_get_profiling_info()
+ * once the event has triggered.
+ *
+ * The most frequent operations also have a _v variant, like
+ * gocl_kernel_run_in_queue_v() or gocl_buffer_write_v(), which take the
+ * wait list as an array of #GoclEvent's and its length instead of a #GList.
+ * Short wait lists are then handed to OpenCL without any memory allocation.
+ * Also, an event only watches the completion of its operation once
+ * gocl_event_then() is called on it, or when its queue is profiled, so
+ * events that are only used in wait lists cost little more than the
+ * underlying OpenCL event.
  **/
 
 /**
@@ -83,9 +98,19 @@
 #include "gocl-event.h"
 
 #include "gocl-private.h"
+#include "gocl-decls.h"
 #include "gocl-device.h"
 #include "gocl-context.h"
 
+/* interval between polls of the dispatcher, in microseconds */
+#define DISPATCHER_MIN_POLL_INTERVAL 20
+#define DISPATCHER_MAX_POLL_INTERVAL 1000
+
+/* platforms whose event callbacks only fire once the event is waited for */
+#define WAITED_CALLBACKS_PLATFORM "AMD Accelerated Parallel Processing"
+
+#define MAX_KNOWN_PLATFORMS 16
+
 struct _GoclEventPrivate
 {
   cl_event event;
@@ -98,16 +123,26 @@ struct _GoclEventPrivate
   GMutex mutex;
   gboolean already_resolved;
   gboolean waiting_event;
+  gboolean notify_set;
 
   GList *closure_list;
-  GThread *thread;
 
   gint complete_src_id;
   gint unref_src_id;
 
   gboolean is_user_event;
 
-  GList *event_wait_list;
+  /* signalled on resolution, for blocking waits on events without a
+     cl_event, like those of kernels run on the host */
+  GCond host_cond;
+  gboolean host_completed;
+
+  /* referenced events this one waits for, kept alive until it completes */
+  GoclEvent **wait_events;
+  guint num_wait_events;
+  GoclEvent *wait_events_prealloc[GOCL_EVENT_WAIT_LIST_PREALLOC];
+
+  gchar *label;
 };
 
 typedef struct
@@ -116,6 +151,9 @@ typedef struct
   gpointer user_data;
   GMainContext *context;
   GoclEvent *self;
+
+  /* when delivery was scheduled, if tracing */
+  gint64 scheduled_time;
 } Closure;
 
 /* properties */
@@ -156,6 +194,11 @@ static void           event_on_notify                  (cl_event event,
                                                         cl_int   event_command_exec_status,
                                                         gpointer user_data);
 
+static void           set_notify                       (GoclEvent *self);
+static void           set_wait_events                  (GoclEvent         *self,
+                                                        GoclEvent * const *events,
+                                                        guint              num_events);
+
 G_DEFINE_TYPE (GoclEvent, gocl_event, G_TYPE_OBJECT);
 
 #define GOCL_EVENT_GET_PRIVATE(obj)                \
@@ -198,6 +241,8 @@ gocl_event_init (GoclEvent *self)
 
   self->priv = priv = GOCL_EVENT_GET_PRIVATE (self);
 
+  GOCL_TRACE_OBJECT_NEW (GOCL_TRACE_OBJECT_EVENT);
+
   priv->event = NULL;
 
   priv->error = NULL;
@@ -207,16 +252,22 @@ gocl_event_init (GoclEvent *self)
   g_mutex_init (&priv->mutex);
   priv->already_resolved = FALSE;
   priv->waiting_event = FALSE;
+  priv->notify_set = FALSE;
 
   priv->closure_list = NULL;
-  priv->thread = NULL;
 
   priv->complete_src_id = 0;
   priv->unref_src_id = 0;
 
-  priv->is_user_event = TRUE;
+  priv->is_user_event = FALSE;
 
-  priv->event_wait_list = NULL;
+  g_cond_init (&priv->host_cond);
+  priv->host_completed = FALSE;
+
+  priv->wait_events = NULL;
+  priv->num_wait_events = 0;
+
+  priv->label = NULL;
 }
 
 static void
@@ -230,11 +281,7 @@ gocl_event_dispose (GObject *obj)
       self->priv->queue = NULL;
     }
 
-  if (self->priv->event_wait_list != NULL)
-    {
-      g_list_free_full (self->priv->event_wait_list, g_object_unref);
-      self->priv->event_wait_list = NULL;
-    }
+  set_wait_events (self, NULL, 0);
 
   G_OBJECT_CLASS (gocl_event_parent_class)->dispose (obj);
 }
@@ -250,9 +297,6 @@ gocl_event_finalize (GObject *obj)
   if (self->priv->error != NULL)
     g_error_free (self->priv->error);
 
-  if (self->priv->thread != NULL)
-    g_thread_unref (self->priv->thread);
-
   if (self->priv->closure_list != NULL)
     {
       /* @TODO: should we call any awaiting closure? */
@@ -260,6 +304,9 @@ gocl_event_finalize (GObject *obj)
     }
 
   g_mutex_clear (&self->priv->mutex);
+  g_cond_clear (&self->priv->host_cond);
+
+  g_free (self->priv->label);
 
   if (self->priv->complete_src_id != 0)
     {
@@ -267,6 +314,8 @@ gocl_event_finalize (GObject *obj)
       self->priv->complete_src_id = 0;
     }
 
+  GOCL_TRACE_OBJECT_FREE (GOCL_TRACE_OBJECT_EVENT);
+
   G_OBJECT_CLASS (gocl_event_parent_class)->finalize (obj);
 }
 
@@ -276,7 +325,9 @@ gocl_event_constructed (GObject *obj)
   GoclEvent *self = GOCL_EVENT (obj);
   cl_int err_code;
 
-  if (self->priv->event == NULL)
+  /* events without a queue represent operations run on the host, and are
+     only resolved through their resolver function */
+  if (self->priv->event == NULL && self->priv->queue != NULL)
     {
       GoclDevice *device;
       GoclContext *context;
@@ -291,11 +342,18 @@ gocl_event_constructed (GObject *obj)
         self->priv->is_user_event = TRUE;
     }
 
-  err_code = clSetEventCallback (self->priv->event,
-                                 CL_COMPLETE,
-                                 event_on_notify,
-                                 self);
-  gocl_error_check_opencl_internal (err_code);
+  /* completion is only watched when somebody needs it, either to call the
+     closures added with gocl_event_then(), or to profile the operation.
+     Registering a callback for every command is a noticeable cost at high
+     dispatch rates */
+  if (! self->priv->is_user_event &&
+      self->priv->queue != NULL &&
+      (gocl_queue_get_flags (self->priv->queue) &
+       GOCL_QUEUE_FLAGS_PROFILING) != 0)
+    {
+      self->priv->notify_set = TRUE;
+      set_notify (self);
+    }
 }
 
 static void
@@ -346,6 +404,63 @@ get_property (GObject    *obj,
     }
 }
 
+/* registers the completion callback of the OpenCL event, which keeps a
+   reference to the event until it is notified. The caller sets 'notify_set'
+   beforehand, and must not hold the mutex since some implementations run
+   the callback right away if the event already completed */
+static void
+set_notify (GoclEvent *self)
+{
+  cl_int err_code;
+
+  err_code = clSetEventCallback (self->priv->event,
+                                 CL_COMPLETE,
+                                 event_on_notify,
+                                 g_object_ref (self));
+  if (gocl_error_check_opencl_internal (err_code))
+    g_object_unref (self);
+}
+
+static void
+set_wait_events (GoclEvent         *self,
+                 GoclEvent * const *events,
+                 guint              num_events)
+{
+  GoclEvent **old_events;
+  guint num_old_events;
+  guint i;
+
+  old_events = self->priv->wait_events;
+  num_old_events = self->priv->num_wait_events;
+
+  if (num_events == 0)
+    {
+      self->priv->wait_events = NULL;
+    }
+  else
+    {
+      GoclEvent **new_events;
+
+      /* old events may still live in the preallocated array */
+      if (num_events <= GOCL_EVENT_WAIT_LIST_PREALLOC && old_events == NULL)
+        new_events = self->priv->wait_events_prealloc;
+      else
+        new_events = g_new (GoclEvent *, num_events);
+
+      for (i = 0; i < num_events; i++)
+        new_events[i] = g_object_ref (events[i]);
+
+      self->priv->wait_events = new_events;
+    }
+  self->priv->num_wait_events = num_events;
+
+  for (i = 0; i < num_old_events; i++)
+    g_object_unref (old_events[i]);
+
+  if (old_events != NULL && old_events != self->priv->wait_events_prealloc)
+    g_free (old_events);
+}
+
 static guint
 timeout_add (GMainContext *context,
              guint         timeout,
@@ -391,21 +506,142 @@ notify_event_completed_in_caller_context (gpointer user_data)
 {
   Closure *closure = user_data;
   GoclEvent *self = closure->self;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  if (trace_start != 0 && closure->scheduled_time != 0)
+    GOCL_TRACE_COUNTER ("event",
+                        "callback-delay",
+                        self->priv->label,
+                        trace_start - closure->scheduled_time);
 
   closure->callback (closure->self,
                      self->priv->error,
                      closure->user_data);
 
+  GOCL_TRACE_END ("event", "callback", self->priv->label, trace_start);
+
   free_closure (closure);
 
   return FALSE;
 }
 
+static const gchar *
+get_command_type_name (cl_command_type command_type)
+{
+  switch (command_type)
+    {
+    case CL_COMMAND_NDRANGE_KERNEL:
+      return "ndrange-kernel";
+    case CL_COMMAND_TASK:
+      return "task";
+    case CL_COMMAND_NATIVE_KERNEL:
+      return "native-kernel";
+    case CL_COMMAND_READ_BUFFER:
+      return "read-buffer";
+    case CL_COMMAND_WRITE_BUFFER:
+      return "write-buffer";
+    case CL_COMMAND_COPY_BUFFER:
+      return "copy-buffer";
+    case CL_COMMAND_READ_IMAGE:
+      return "read-image";
+    case CL_COMMAND_WRITE_IMAGE:
+      return "write-image";
+    case CL_COMMAND_COPY_IMAGE:
+      return "copy-image";
+    case CL_COMMAND_COPY_IMAGE_TO_BUFFER:
+      return "copy-image-to-buffer";
+    case CL_COMMAND_COPY_BUFFER_TO_IMAGE:
+      return "copy-buffer-to-image";
+    case CL_COMMAND_MAP_BUFFER:
+      return "map-buffer";
+    case CL_COMMAND_MAP_IMAGE:
+      return "map-image";
+    case CL_COMMAND_UNMAP_MEM_OBJECT:
+      return "unmap-mem-object";
+    case CL_COMMAND_MARKER:
+      return "marker";
+    case CL_COMMAND_ACQUIRE_GL_OBJECTS:
+      return "acquire-gl-objects";
+    case CL_COMMAND_RELEASE_GL_OBJECTS:
+      return "release-gl-objects";
+    case CL_COMMAND_READ_BUFFER_RECT:
+      return "read-buffer-rect";
+    case CL_COMMAND_WRITE_BUFFER_RECT:
+      return "write-buffer-rect";
+    case CL_COMMAND_COPY_BUFFER_RECT:
+      return "copy-buffer-rect";
+#ifdef CL_VERSION_1_2
+    case CL_COMMAND_BARRIER:
+      return "barrier";
+    case CL_COMMAND_FILL_BUFFER:
+      return "fill-buffer";
+    case CL_COMMAND_FILL_IMAGE:
+      return "fill-image";
+    case CL_COMMAND_MIGRATE_MEM_OBJECTS:
+      return "migrate-mem-objects";
+#endif
+    default:
+      return "unknown";
+    }
+}
+
+/* accumulates the timing of a completed event into its queue's profile,
+   if the queue was created with profiling enabled */
+static void
+add_profile_sample (GoclEvent *self)
+{
+  guint64 queued, start, end;
+  gchar *name;
+
+  if (self->priv->is_user_event ||
+      self->priv->error != NULL ||
+      self->priv->queue == NULL ||
+      (gocl_queue_get_flags (self->priv->queue) &
+       GOCL_QUEUE_FLAGS_PROFILING) == 0)
+    {
+      return;
+    }
+
+  if (! gocl_event_get_profiling_info (self, &queued, NULL, &start, &end))
+    return;
+
+  g_mutex_lock (&self->priv->mutex);
+  name = g_strdup (self->priv->label);
+  g_mutex_unlock (&self->priv->mutex);
+
+  if (name == NULL)
+    {
+      cl_command_type command_type;
+      cl_int err_code;
+
+      err_code = clGetEventInfo (self->priv->event,
+                                 CL_EVENT_COMMAND_TYPE,
+                                 sizeof (cl_command_type),
+                                 &command_type,
+                                 NULL);
+      if (gocl_error_check_opencl_internal (err_code))
+        return;
+
+      name = g_strdup (get_command_type_name (command_type));
+    }
+
+  GOCL_TRACE_COUNTER ("queue",
+                      "queue-wait",
+                      name,
+                      (gint64) (start - queued) / 1000);
+
+  gocl_queue_add_profile_sample (self->priv->queue, name, queued, start, end);
+  g_free (name);
+}
+
 static gboolean
 event_completed (gpointer user_data)
 {
   GoclEvent *self = GOCL_EVENT (user_data);
 
+  add_profile_sample (self);
+
   g_mutex_lock (&self->priv->mutex);
 
   self->priv->complete_src_id = 0;
@@ -418,6 +654,7 @@ event_completed (gpointer user_data)
     {
       Closure *closure = node->data;
 
+      closure->scheduled_time = GOCL_TRACE_BEGIN ();
       timeout_add (closure->context,
                    0,
                    G_PRIORITY_DEFAULT,
@@ -430,17 +667,26 @@ event_completed (gpointer user_data)
   g_list_free (self->priv->closure_list);
   self->priv->closure_list = NULL;
 
-  if (self->priv->event_wait_list != NULL)
-    {
-      g_list_free_full (self->priv->event_wait_list, g_object_unref);
-      self->priv->event_wait_list = NULL;
-    }
+  set_wait_events (self, NULL, 0);
 
   g_mutex_unlock (&self->priv->mutex);
 
   return FALSE;
 }
 
+static gboolean
+event_notified (gpointer user_data)
+{
+  GoclEvent *self = GOCL_EVENT (user_data);
+
+  event_completed (self);
+
+  /* drop the reference taken by set_notify() */
+  g_object_unref (self);
+
+  return FALSE;
+}
+
 static void
 event_on_notify (cl_event event,
                  cl_int   event_command_exec_status,
@@ -457,7 +703,7 @@ event_on_notify (cl_event event,
   self->priv->complete_src_id = timeout_add (self->priv->context,
                                              0,
                                              G_PRIORITY_DEFAULT,
-                                             event_completed,
+                                             event_notified,
                                              self);
   g_mutex_unlock (&self->priv->mutex);
 }
@@ -479,6 +725,9 @@ gocl_event_resolve (GoclEvent *self, GError *error)
                                              event_completed,
                                              self);
 
+  self->priv->host_completed = TRUE;
+  g_cond_broadcast (&self->priv->host_cond);
+
   g_mutex_unlock (&self->priv->mutex);
 
   if (self->priv->is_user_event)
@@ -495,20 +744,222 @@ gocl_event_resolve (GoclEvent *self, GError *error)
     }
 }
 
+typedef struct
+{
+  cl_platform_id id;
+  gboolean needs_wait;
+} KnownPlatform;
+
+/* platforms are never released, so entries stay valid for the process */
+G_LOCK_DEFINE_STATIC (known_platforms);
+static KnownPlatform known_platforms[MAX_KNOWN_PLATFORMS];
+static guint num_known_platforms = 0;
+
+static gboolean
+platform_needs_wait (cl_platform_id platform)
+{
+  gchar name[256] = { 0, };
+  gboolean needs_wait;
+  cl_int err_code;
+  guint i;
+
+  G_LOCK (known_platforms);
+  for (i = 0; i < num_known_platforms; i++)
+    if (known_platforms[i].id == platform)
+      {
+        needs_wait = known_platforms[i].needs_wait;
+        G_UNLOCK (known_platforms);
+        return needs_wait;
+      }
+  G_UNLOCK (known_platforms);
+
+  err_code = clGetPlatformInfo (platform,
+                                CL_PLATFORM_NAME,
+                                sizeof (name) - 1,
+                                name,
+                                NULL);
+  needs_wait = err_code != CL_SUCCESS
+    || strstr (name, WAITED_CALLBACKS_PLATFORM) != NULL;
+
+  G_LOCK (known_platforms);
+  if (num_known_platforms < MAX_KNOWN_PLATFORMS)
+    {
+      known_platforms[num_known_platforms].id = platform;
+      known_platforms[num_known_platforms].needs_wait = needs_wait;
+      num_known_platforms++;
+    }
+  G_UNLOCK (known_platforms);
+
+  return needs_wait;
+}
+
+/* tells whether the callbacks of @event only fire if it is waited for.
+   When in doubt they are assumed to, since the dispatcher works on every
+   platform, only less efficiently */
+static gboolean
+event_needs_dispatcher (cl_event event)
+{
+  cl_command_queue queue = NULL;
+  cl_device_id device = NULL;
+  cl_platform_id platform = NULL;
+
+  if (clGetEventInfo (event,
+                      CL_EVENT_COMMAND_QUEUE,
+                      sizeof (cl_command_queue),
+                      &queue,
+                      NULL) != CL_SUCCESS || queue == NULL)
+    return TRUE;
+
+  if (clGetCommandQueueInfo (queue,
+                             CL_QUEUE_DEVICE,
+                             sizeof (cl_device_id),
+                             &device,
+                             NULL) != CL_SUCCESS)
+    return TRUE;
+
+  if (clGetDeviceInfo (device,
+                       CL_DEVICE_PLATFORM,
+                       sizeof (cl_platform_id),
+                       &platform,
+                       NULL) != CL_SUCCESS)
+    return TRUE;
+
+  return platform_needs_wait (platform);
+}
+
 /* calling clWaitForEvents from a thread is oddly necessary because otherwise
-   the event callback doesn't trigger in AMD APP SDK platform */
+   the event callback doesn't trigger in AMD APP SDK platform. Other
+   platforms call event callbacks on their own, so their events never reach
+   the dispatcher and nothing polls them. For the rest, instead of spawning
+   one thread per event, a single dispatcher thread collects all pending
+   events. Blocking on them would serialize every completion behind the
+   slowest one, and stall all of them if one depends on a user event that
+   is resolved much later. So the dispatcher polls the execution status of
+   each event, and calls clWaitForEvents on it only once it has completed,
+   which returns right away. Completion is still notified through the event
+   callback set with clSetEventCallback(). */
+static gboolean
+dispatcher_event_is_done (cl_event event)
+{
+  cl_int err_code;
+  cl_int status;
+
+  err_code = clGetEventInfo (event,
+                             CL_EVENT_COMMAND_EXECUTION_STATUS,
+                             sizeof (cl_int),
+                             &status,
+                             NULL);
+  if (err_code != CL_SUCCESS)
+    {
+      g_warning ("Error querying OpenCL event status: %d\n", err_code);
+      return TRUE;
+    }
+
+  /* negative values are errors, which complete the event as well */
+  return status <= CL_COMPLETE;
+}
+
+static void
+dispatcher_event_release (cl_event event)
+{
+  cl_int err_code;
+
+  /* errors of the command itself are reported through its callback */
+  err_code = clWaitForEvents (1, &event);
+  if (err_code != CL_SUCCESS &&
+      err_code != CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST)
+    {
+      g_warning ("Error waiting for OpenCL event: %d\n", err_code);
+    }
+
+  err_code = clReleaseEvent (event);
+  if (err_code != CL_SUCCESS)
+    g_warning ("Error releasing OpenCL event: %d\n", err_code);
+}
+
 static gpointer
-wait_event_thread_func (gpointer user_data)
+dispatcher_thread_func (gpointer user_data)
 {
-  GoclEvent *self = GOCL_EVENT (user_data);
+  GAsyncQueue *queue = user_data;
+  GPtrArray *pending;
+  guint64 poll_interval = DISPATCHER_MIN_POLL_INTERVAL;
+
+  pending = g_ptr_array_new ();
+
+  while (TRUE)
+    {
+      cl_event event;
+      gboolean any_done = FALSE;
+      guint i;
 
-  g_assert (self->priv->event != NULL);
+      /* block only if there is nothing left to poll. Otherwise, sleep
+         until the next poll, but wake up for new events */
+      if (pending->len == 0)
+        event = g_async_queue_pop (queue);
+      else
+        event = g_async_queue_timeout_pop (queue, poll_interval);
 
-  clWaitForEvents (1, &self->priv->event);
+      if (event != NULL)
+        g_ptr_array_add (pending, event);
+
+      while ((event = g_async_queue_try_pop (queue)) != NULL)
+        g_ptr_array_add (pending, event);
+
+      i = 0;
+      while (i < pending->len)
+        {
+          event = g_ptr_array_index (pending, i);
+
+          if (dispatcher_event_is_done (event))
+            {
+              dispatcher_event_release (event);
+              g_ptr_array_remove_index_fast (pending, i);
+              any_done = TRUE;
+            }
+          else
+            {
+              i++;
+            }
+        }
+
+      /* back off while nothing completes, to not spin on long commands */
+      if (any_done)
+        poll_interval = DISPATCHER_MIN_POLL_INTERVAL;
+      else
+        poll_interval = MIN (poll_interval * 2, DISPATCHER_MAX_POLL_INTERVAL);
+    }
 
   return NULL;
 }
 
+static gpointer
+dispatcher_init (gpointer user_data)
+{
+  GAsyncQueue *queue;
+
+  queue = g_async_queue_new ();
+  g_thread_unref (g_thread_new ("gocl-event-dispatcher",
+                                dispatcher_thread_func,
+                                queue));
+
+  return queue;
+}
+
+static void
+dispatcher_push_event (cl_event event)
+{
+  static GOnce dispatcher_once = G_ONCE_INIT;
+  GAsyncQueue *queue;
+
+  if (! event_needs_dispatcher (event))
+    return;
+
+  queue = g_once (&dispatcher_once, dispatcher_init, NULL);
+
+  clRetainEvent (event);
+  g_async_queue_push (queue, event);
+}
+
 static gboolean
 unref_in_idle (gpointer user_data)
 {
@@ -543,9 +994,11 @@ gocl_event_get_event (GoclEvent *self)
  * @self: The #GoclEvent
  *
  * Retrieves the #GoclQueue object where the operation that created this
- * event was queued.
+ * event was queued. Events of operations run on the host, like those
+ * returned by gocl_kernel_run_on_host(), have no queue.
  *
- * Returns: (transfer none): The #GoclQueue associated with the event
+ * Returns: (transfer none): The #GoclQueue associated with the event, or
+ * %NULL for events of operations run on the host
  **/
 GoclQueue *
 gocl_event_get_queue (GoclEvent *self)
@@ -555,6 +1008,410 @@ gocl_event_get_queue (GoclEvent *self)
   return self->priv->queue;
 }
 
+/**
+ * gocl_event_new_from_result:
+ * @queue: The #GoclQueue where the operation was enqueued
+ * @err_code: The error code returned by OpenCL when enqueuing the operation
+ * @event: The #cl_event returned by OpenCL, ignored if @err_code is an error
+ * @wait_list: (allow-none): The #GoclEventWaitList the operation waits for,
+ * or %NULL
+ *
+ * Wraps the result of enqueuing an asynchronous operation into a new
+ * #GoclEvent. If @err_code describes an error, the returned event is
+ * already resolved with the corresponding #GError. Otherwise, the event
+ * takes ownership of @event and keeps references to the events in
+ * @wait_list.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer full): A newly created #GoclEvent
+ **/
+GoclEvent *
+gocl_event_new_from_result (GoclQueue               *queue,
+                            cl_int                   err_code,
+                            cl_event                 event,
+                            const GoclEventWaitList *wait_list)
+{
+  GoclEvent *self;
+  GError *error = NULL;
+
+  if (gocl_error_check_opencl (err_code, &error))
+    {
+      GoclEventResolverFunc resolver_func;
+
+      self = g_object_new (GOCL_TYPE_EVENT,
+                           "queue", queue,
+                           NULL);
+      resolver_func = gocl_event_steal_resolver_func (self);
+      resolver_func (self, error);
+      g_error_free (error);
+    }
+  else
+    {
+      self = g_object_new (GOCL_TYPE_EVENT,
+                           "queue", queue,
+                           "event", event,
+                           NULL);
+      if (wait_list != NULL)
+        set_wait_events (self, wait_list->gocl_events, wait_list->len);
+      gocl_event_steal_resolver_func (self);
+    }
+
+  return self;
+}
+
+/**
+ * gocl_event_new_host:
+ *
+ * Creates a new #GoclEvent that is not associated with any #GoclQueue nor
+ * #cl_event, to represent an operation run on the host. The creator must
+ * steal the resolver function with gocl_event_steal_resolver_func() and
+ * call it when the operation completes.
+ *
+ * Host events cannot appear in the wait list of operations enqueued on
+ * a device, since OpenCL does not know about them.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer full): A newly created #GoclEvent
+ **/
+GoclEvent *
+gocl_event_new_host (void)
+{
+  return g_object_new (GOCL_TYPE_EVENT, NULL);
+}
+
+/**
+ * gocl_event_wait:
+ * @self: The #GoclEvent
+ *
+ * Blocks until @self triggers, without depending on any main context to
+ * be running. Events with a #cl_event are waited for with
+ * clWaitForEvents(), and host events until they are resolved.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: %TRUE if the operation succeeded, %FALSE on error
+ **/
+gboolean
+gocl_event_wait (GoclEvent *self)
+{
+  gboolean result;
+
+  g_return_val_if_fail (GOCL_IS_EVENT (self), FALSE);
+
+  if (self->priv->event != NULL)
+    {
+      cl_int err_code;
+
+      err_code = clWaitForEvents (1, &self->priv->event);
+      if (gocl_error_check_opencl_internal (err_code))
+        return FALSE;
+    }
+  else
+    {
+      g_mutex_lock (&self->priv->mutex);
+      while (! self->priv->host_completed)
+        g_cond_wait (&self->priv->host_cond, &self->priv->mutex);
+      g_mutex_unlock (&self->priv->mutex);
+    }
+
+  g_mutex_lock (&self->priv->mutex);
+  result = self->priv->error == NULL;
+  g_mutex_unlock (&self->priv->mutex);
+
+  return result;
+}
+
+/**
+ * gocl_event_wait_list_init:
+ * @wait_list: A #GoclEventWaitList, normally allocated on the stack
+ * @event_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events, or %NULL
+ *
+ * Fills @wait_list with the events in @event_list, walking the list only
+ * once. Lists of up to %GOCL_EVENT_WAIT_LIST_PREALLOC events are stored in
+ * @wait_list itself, without allocating memory. The wait list must be
+ * released with gocl_event_wait_list_clear().
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_event_wait_list_init (GoclEventWaitList *wait_list, GList *event_list)
+{
+  guint size = GOCL_EVENT_WAIT_LIST_PREALLOC;
+  guint len = 0;
+  GList *node;
+
+  /* the list is left empty, and safe to clear, if any entry is invalid */
+  wait_list->gocl_events = NULL;
+  wait_list->events = NULL;
+  wait_list->owns_gocl_events = FALSE;
+  wait_list->len = 0;
+
+  for (node = event_list; node != NULL; node = node->next)
+    g_return_if_fail (GOCL_IS_EVENT (node->data));
+
+  wait_list->gocl_events = wait_list->gocl_events_prealloc;
+  wait_list->events = wait_list->events_prealloc;
+
+  for (; event_list != NULL; event_list = event_list->next)
+    {
+      GoclEvent *event = event_list->data;
+
+      if (len == size)
+        {
+          size *= 2;
+
+          if (wait_list->events == wait_list->events_prealloc)
+            {
+              wait_list->gocl_events = g_new (GoclEvent *, size);
+              wait_list->events = g_new (cl_event, size);
+              memcpy (wait_list->gocl_events,
+                      wait_list->gocl_events_prealloc,
+                      sizeof (GoclEvent *) * len);
+              memcpy (wait_list->events,
+                      wait_list->events_prealloc,
+                      sizeof (cl_event) * len);
+            }
+          else
+            {
+              wait_list->gocl_events = g_renew (GoclEvent *,
+                                                wait_list->gocl_events,
+                                                size);
+              wait_list->events = g_renew (cl_event, wait_list->events, size);
+            }
+        }
+
+      wait_list->gocl_events[len] = event;
+      wait_list->events[len] = event->priv->event;
+      len++;
+    }
+
+  wait_list->len = len;
+  wait_list->owns_gocl_events =
+    wait_list->gocl_events != wait_list->gocl_events_prealloc;
+
+  /* OpenCL requires a NULL wait list when it is empty */
+  if (len == 0)
+    wait_list->events = NULL;
+}
+
+/**
+ * gocl_event_wait_list_init_from_array:
+ * @wait_list: A #GoclEventWaitList, normally allocated on the stack
+ * @events: (array length=num_events) (allow-none): An array of #GoclEvent
+ * events, or %NULL
+ * @num_events: The number of events in @events
+ *
+ * Fills @wait_list with the events in @events, which must stay valid while
+ * @wait_list is in use. Only the internal #cl_event objects are copied, and
+ * no memory is allocated for up to %GOCL_EVENT_WAIT_LIST_PREALLOC events.
+ * The wait list must be released with gocl_event_wait_list_clear().
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_event_wait_list_init_from_array (GoclEventWaitList *wait_list,
+                                      GoclEvent * const *events,
+                                      guint              num_events)
+{
+  guint i;
+
+  /* the list is left empty, and safe to clear, if any entry is invalid */
+  wait_list->gocl_events = NULL;
+  wait_list->events = NULL;
+  wait_list->owns_gocl_events = FALSE;
+  wait_list->len = 0;
+
+  if (events == NULL)
+    return;
+
+  for (i = 0; i < num_events; i++)
+    g_return_if_fail (GOCL_IS_EVENT (events[i]));
+
+  wait_list->gocl_events = (GoclEvent **) events;
+  wait_list->len = num_events;
+
+  if (wait_list->len == 0)
+    wait_list->events = NULL;
+  else if (wait_list->len <= GOCL_EVENT_WAIT_LIST_PREALLOC)
+    wait_list->events = wait_list->events_prealloc;
+  else
+    wait_list->events = g_new (cl_event, wait_list->len);
+
+  for (i = 0; i < wait_list->len; i++)
+    wait_list->events[i] = events[i]->priv->event;
+}
+
+/**
+ * gocl_event_wait_list_clear:
+ * @wait_list: A #GoclEventWaitList
+ *
+ * Frees the memory allocated by gocl_event_wait_list_init() or
+ * gocl_event_wait_list_init_from_array(), if any.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_event_wait_list_clear (GoclEventWaitList *wait_list)
+{
+  if (wait_list->events != wait_list->events_prealloc)
+    g_free (wait_list->events);
+
+  if (wait_list->owns_gocl_events)
+    g_free (wait_list->gocl_events);
+
+  wait_list->events = NULL;
+  wait_list->gocl_events = NULL;
+  wait_list->owns_gocl_events = FALSE;
+  wait_list->len = 0;
+}
+
+/**
+ * gocl_event_wait_for_result:
+ * @err_code: The error code returned by OpenCL when enqueuing the operation
+ * @event: The #cl_event returned by OpenCL, ignored if @err_code is an error
+ *
+ * Blocks until the operation represented by @event completes, and releases
+ * @event. This is the blocking counterpart of gocl_event_new_from_result(),
+ * used to implement the _sync versions of asynchronous operations.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_event_wait_for_result (cl_int err_code, cl_event event)
+{
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  err_code = clWaitForEvents (1, &event);
+  clReleaseEvent (event);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_event_add_cl_callback:
+ * @event: A #cl_event
+ * @callback: The function to call when @event completes
+ * @user_data: The argument passed to @callback
+ *
+ * Registers @callback to be called by OpenCL, from any thread, when @event
+ * completes or fails, like clSetEventCallback(). On platforms that don't
+ * call event callbacks unless the event is waited for, @event is also
+ * handed to the event dispatcher. Unlike gocl_event_then(), no main
+ * context needs to be running.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ *
+ * Returns: The error code of clSetEventCallback()
+ **/
+cl_int
+gocl_event_add_cl_callback (cl_event  event,
+                            void (CL_CALLBACK *callback) (cl_event,
+                                                          cl_int,
+                                                          void *),
+                            gpointer  user_data)
+{
+  cl_int err_code;
+
+  err_code = clSetEventCallback (event, CL_COMPLETE, callback, user_data);
+  if (err_code == CL_SUCCESS)
+    dispatcher_push_event (event);
+
+  return err_code;
+}
+
+/**
+ * gocl_event_set_label:
+ * @self: The #GoclEvent
+ * @label: (allow-none): The name to profile the event under, or %NULL
+ *
+ * Sets the name under which the operation of this event is accumulated in
+ * the profile of its queue, like the kernel function name for kernel
+ * executions. If not set, the command type of the event is used.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_event_set_label (GoclEvent *self, const gchar *label)
+{
+  g_return_if_fail (GOCL_IS_EVENT (self));
+
+  g_mutex_lock (&self->priv->mutex);
+  g_free (self->priv->label);
+  self->priv->label = g_strdup (label);
+  g_mutex_unlock (&self->priv->mutex);
+}
+
+/**
+ * gocl_event_get_profiling_info:
+ * @self: The #GoclEvent
+ * @queued: (out) (allow-none): Return location for the time the operation
+ * was enqueued, or %NULL
+ * @submit: (out) (allow-none): Return location for the time the operation
+ * was submitted to the device, or %NULL
+ * @start: (out) (allow-none): Return location for the time the operation
+ * started executing, or %NULL
+ * @end: (out) (allow-none): Return location for the time the operation
+ * finished executing, or %NULL
+ *
+ * Retrieves the timestamps of the operation represented by this event, as
+ * device time counters in nanoseconds. Profiling information is only
+ * available if the event's queue was created with
+ * %GOCL_QUEUE_FLAGS_PROFILING, and once the operation has completed.
+ *
+ * Returns: %TRUE on success, %FALSE if profiling information is not available
+ **/
+gboolean
+gocl_event_get_profiling_info (GoclEvent *self,
+                               guint64   *queued,
+                               guint64   *submit,
+                               guint64   *start,
+                               guint64   *end)
+{
+  cl_ulong values[4];
+  const cl_profiling_info params[4] = {
+    CL_PROFILING_COMMAND_QUEUED,
+    CL_PROFILING_COMMAND_SUBMIT,
+    CL_PROFILING_COMMAND_START,
+    CL_PROFILING_COMMAND_END
+  };
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_EVENT (self), FALSE);
+
+  if (self->priv->event == NULL || self->priv->is_user_event)
+    return FALSE;
+
+  for (i = 0; i < 4; i++)
+    {
+      cl_int err_code;
+
+      err_code = clGetEventProfilingInfo (self->priv->event,
+                                          params[i],
+                                          sizeof (cl_ulong),
+                                          &values[i],
+                                          NULL);
+      if (gocl_error_check_opencl_internal (err_code))
+        return FALSE;
+    }
+
+  if (queued != NULL)
+    *queued = values[0];
+  if (submit != NULL)
+    *submit = values[1];
+  if (start != NULL)
+    *start = values[2];
+  if (end != NULL)
+    *end = values[3];
+
+  return TRUE;
+}
+
 /**
  * gocl_event_steal_resolver_func: (skip)
  * @self: The #GoclEvent
@@ -601,6 +1458,7 @@ gocl_event_then (GoclEvent         *self,
                  gpointer           user_data)
 {
   Closure *closure;
+  gboolean need_notify = FALSE;
 
   g_return_if_fail (GOCL_IS_EVENT (self));
   g_return_if_fail (callback != NULL);
@@ -615,6 +1473,7 @@ gocl_event_then (GoclEvent         *self,
 
   if (self->priv->already_resolved)
     {
+      closure->scheduled_time = GOCL_TRACE_BEGIN ();
       timeout_add (closure->context,
                    0,
                    G_PRIORITY_DEFAULT,
@@ -626,16 +1485,24 @@ gocl_event_then (GoclEvent         *self,
       self->priv->closure_list = g_list_append (self->priv->closure_list,
                                                 closure);
 
-      if (self->priv->event != NULL && ! self->priv->waiting_event)
+      /* user events are completed from the host with
+         clSetUserEventStatus(), so there is nothing to wait for */
+      if (self->priv->event != NULL &&
+          ! self->priv->is_user_event &&
+          ! self->priv->waiting_event)
         {
           self->priv->waiting_event = TRUE;
-          self->priv->thread = g_thread_new ("gocl-event-thread",
-                                             wait_event_thread_func,
-                                             self);
+          dispatcher_push_event (self->priv->event);
+
+          need_notify = ! self->priv->notify_set;
+          self->priv->notify_set = TRUE;
         }
     }
 
   g_mutex_unlock (&self->priv->mutex);
+
+  if (need_notify)
+    set_notify (self);
 }
 
 /**
@@ -644,9 +1511,8 @@ gocl_event_then (GoclEvent         *self,
  * @event_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
  * events that this event should wait for, or %NULL
  *
- * Stores a copy of the given #GList of #GoclEvent's to take ownership over the
- * list and guarantee that the events will remain alive until this event is
- * destroyed.
+ * Keeps a reference to each #GoclEvent in the given #GList, to guarantee that
+ * the events will remain alive until this event completes or is destroyed.
  *
  * This is a rather low-level method and should not normally be called by
  * applications.
@@ -654,24 +1520,17 @@ gocl_event_then (GoclEvent         *self,
 void
 gocl_event_set_event_wait_list (GoclEvent *self, GList *event_list)
 {
-  GList *new_list = NULL;
+  GoclEventWaitList wait_list;
 
   g_return_if_fail (GOCL_IS_EVENT (self));
 
-  if (self->priv->event_wait_list != NULL)
-    g_list_free_full (self->priv->event_wait_list, g_object_unref);
+  gocl_event_wait_list_init (&wait_list, event_list);
 
-  while (event_list != NULL)
-    {
-      g_return_if_fail (GOCL_IS_EVENT (event_list->data));
-
-      new_list = g_list_prepend (new_list,
-                                 g_object_ref (G_OBJECT (event_list->data)));
-
-      event_list = event_list->next;
-    }
+  g_mutex_lock (&self->priv->mutex);
+  set_wait_events (self, wait_list.gocl_events, wait_list.len);
+  g_mutex_unlock (&self->priv->mutex);
 
-  self->priv->event_wait_list = new_list;
+  gocl_event_wait_list_clear (&wait_list);
 }
 
 /**
@@ -692,8 +1551,8 @@ cl_event *
 gocl_event_list_to_array (GList *event_list, guint *len)
 {
   cl_event *event_arr = NULL;
-  gint i;
   guint _len;
+  guint i;
   GList *node;
 
   _len = g_list_length (event_list);
@@ -704,18 +1563,13 @@ gocl_event_list_to_array (GList *event_list, guint *len)
   if (_len == 0)
     return event_arr;
 
-  event_arr = g_new (cl_event, g_list_length (event_list));
+  event_arr = g_new (cl_event, _len);
 
-  node = event_list;
-  i = 0;
-  while (node != NULL)
+  for (node = event_list, i = 0; node != NULL; node = node->next, i++)
     {
       g_return_val_if_fail (GOCL_IS_EVENT (node->data), NULL);
 
-      event_arr[i] = gocl_event_get_event (GOCL_EVENT (node->data));
-
-      i++;
-      node = g_list_next (node);
+      event_arr[i] = GOCL_EVENT (node->data)->priv->event;
     }
 
   return event_arr;
@@ -62,12 +62,20 @@ GType                  gocl_event_get_type                   (void) G_GNUC_CONST
 
 GoclQueue *            gocl_event_get_queue                  (GoclEvent *self);
 
+gboolean               gocl_event_get_profiling_info         (GoclEvent *self,
+                                                              guint64   *queued,
+                                                              guint64   *submit,
+                                                              guint64   *start,
+                                                              guint64   *end);
+
 GoclEventResolverFunc  gocl_event_steal_resolver_func        (GoclEvent *self);
 
 void                   gocl_event_then                       (GoclEvent         *self,
                                                               GoclEventCallback  callback,
                                                               gpointer           user_data);
 
+GoclEvent *            gocl_queue_fence                      (GoclQueue *self);
+
 /* these methods should eventually be moved to a private header file,
    since they are not supposed to be called by applications */
 void                   gocl_event_set_event_wait_list        (GoclEvent *self,
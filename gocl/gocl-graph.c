@@ -0,0 +1,971 @@
+/*
+ * gocl-graph.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-graph
+ * @short_description: Object that runs a graph of dependent operations
+ * @stability: Unstable
+ *
+ * A #GoclGraph describes a set of operations and the dependencies between
+ * them, and enqueues the whole set every time it is run. Nodes are kernel
+ * executions, added with gocl_graph_add_kernel(), buffer transfers, added
+ * with gocl_graph_add_write_buffer() and gocl_graph_add_read_buffer(), and
+ * functions that run on the host, added with gocl_graph_add_host_func().
+ * Each method returns the index of the new node, and edges between nodes
+ * are declared with gocl_graph_add_dependency(). A node can only depend on
+ * nodes added before it, so the order in which nodes are added is always a
+ * valid execution order and the graph cannot have cycles.
+ *
+ * Every device node runs on a #GoclQueue, the one passed when adding it or
+ * the queue of the graph otherwise. Dependencies between device nodes are
+ * expressed only as OpenCL wait lists, so the host is not involved between
+ * them. Events are only requested for the nodes that need them: a
+ * dependency between two nodes of the same in-order queue is implicit, and
+ * costs nothing. Independent branches run concurrently when they are put on
+ * different queues, or on a queue created with
+ * %GOCL_QUEUE_FLAGS_OUT_OF_ORDER.
+ *
+ * Host nodes are the only ones that go through the host. When the graph is
+ * run with gocl_graph_run(), a host node is called from the main context
+ * that was the thread-default when the graph was run, once all its
+ * dependencies complete, and the nodes that depend on it wait on the device
+ * until it returns. With gocl_graph_run_sync(), host nodes are called from
+ * the calling thread.
+ *
+ * The graph is built once and can be run any number of times, for example
+ * once per frame. Kernels use the arguments and work sizes they have when
+ * the graph is run, and the memory passed to transfer nodes must remain
+ * valid until each run completes. A graph must not be modified or run from
+ * several threads at the same time.
+ **/
+
+/**
+ * GoclGraphClass:
+ * @parent_class: The parent class
+ *
+ * The class for #GoclGraph objects.
+ **/
+
+#include "gocl-graph.h"
+
+#include "gocl-private.h"
+#include "gocl-decls.h"
+#include "gocl-context.h"
+
+typedef enum
+{
+  NODE_TYPE_KERNEL,
+  NODE_TYPE_WRITE,
+  NODE_TYPE_READ,
+  NODE_TYPE_HOST
+} NodeType;
+
+typedef struct
+{
+  NodeType type;
+
+  /* device nodes */
+  GoclQueue *queue;
+  gboolean out_of_order;
+  GoclKernel *kernel;
+  GoclBuffer *buffer;
+  gpointer ptr;
+  gsize size;
+  goffset offset;
+
+  /* host nodes */
+  GoclGraphHostFunc func;
+  gpointer user_data;
+  GDestroyNotify notify;
+
+  /* indexes of the nodes this node depends on */
+  GArray *deps;
+
+  /* whether a dependent node needs the event of this node */
+  gboolean needs_event;
+
+  /* the event of this node during a run */
+  cl_event event;
+} Node;
+
+typedef struct
+{
+  GoclGraph *self;
+  Node *node;
+  cl_event user_event;
+  GMainContext *context;
+
+  gint pending;
+  gint status;
+} HostRun;
+
+struct _GoclGraphPrivate
+{
+  GoclQueue *queue;
+
+  GPtrArray *nodes;
+
+  /* the distinct queues of the device nodes, valid once prepared */
+  GPtrArray *queues;
+  gboolean prepared;
+
+  /* scratch wait list reused for every node */
+  GArray *wait_list;
+};
+
+/* properties */
+enum
+{
+  PROP_0,
+  PROP_QUEUE
+};
+
+static void           gocl_graph_class_init            (GoclGraphClass *class);
+static void           gocl_graph_init                  (GoclGraph *self);
+static void           gocl_graph_dispose               (GObject *obj);
+static void           gocl_graph_finalize              (GObject *obj);
+
+static void           set_property                     (GObject      *obj,
+                                                        guint         prop_id,
+                                                        const GValue *value,
+                                                        GParamSpec   *pspec);
+static void           get_property                     (GObject    *obj,
+                                                        guint       prop_id,
+                                                        GValue     *value,
+                                                        GParamSpec *pspec);
+
+static void           free_node                        (gpointer data);
+
+G_DEFINE_TYPE (GoclGraph, gocl_graph, G_TYPE_OBJECT);
+
+#define GOCL_GRAPH_GET_PRIVATE(obj)                    \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                 \
+                                GOCL_TYPE_GRAPH,       \
+                                GoclGraphPrivate))     \
+
+static void
+gocl_graph_class_init (GoclGraphClass *class)
+{
+  GObjectClass *obj_class = G_OBJECT_CLASS (class);
+
+  obj_class->dispose = gocl_graph_dispose;
+  obj_class->finalize = gocl_graph_finalize;
+  obj_class->get_property = get_property;
+  obj_class->set_property = set_property;
+
+  g_object_class_install_property (obj_class, PROP_QUEUE,
+                                   g_param_spec_object ("queue",
+                                                        "Command queue",
+                                                        "The command queue of the nodes that don't specify one",
+                                                        GOCL_TYPE_QUEUE,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_type_class_add_private (class, sizeof (GoclGraphPrivate));
+}
+
+static void
+gocl_graph_init (GoclGraph *self)
+{
+  GoclGraphPrivate *priv;
+
+  self->priv = priv = GOCL_GRAPH_GET_PRIVATE (self);
+
+  priv->queue = NULL;
+
+  priv->nodes = g_ptr_array_new_with_free_func (free_node);
+
+  priv->queues = g_ptr_array_new ();
+  priv->prepared = FALSE;
+
+  priv->wait_list = g_array_new (FALSE, FALSE, sizeof (cl_event));
+}
+
+static void
+gocl_graph_dispose (GObject *obj)
+{
+  GoclGraph *self = GOCL_GRAPH (obj);
+
+  /* nodes hold references to queues, kernels and buffers */
+  g_ptr_array_set_size (self->priv->nodes, 0);
+  g_ptr_array_set_size (self->priv->queues, 0);
+
+  if (self->priv->queue != NULL)
+    {
+      g_object_unref (self->priv->queue);
+      self->priv->queue = NULL;
+    }
+
+  G_OBJECT_CLASS (gocl_graph_parent_class)->dispose (obj);
+}
+
+static void
+gocl_graph_finalize (GObject *obj)
+{
+  GoclGraph *self = GOCL_GRAPH (obj);
+
+  g_ptr_array_unref (self->priv->nodes);
+  g_ptr_array_unref (self->priv->queues);
+  g_array_unref (self->priv->wait_list);
+
+  G_OBJECT_CLASS (gocl_graph_parent_class)->finalize (obj);
+}
+
+static void
+set_property (GObject      *obj,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GoclGraph *self = GOCL_GRAPH (obj);
+
+  switch (prop_id)
+    {
+    case PROP_QUEUE:
+      self->priv->queue = g_value_dup_object (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+get_property (GObject    *obj,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GoclGraph *self = GOCL_GRAPH (obj);
+
+  switch (prop_id)
+    {
+    case PROP_QUEUE:
+      g_value_set_object (value, self->priv->queue);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+free_node (gpointer data)
+{
+  Node *node = data;
+
+  if (node->queue != NULL)
+    g_object_unref (node->queue);
+  if (node->kernel != NULL)
+    g_object_unref (node->kernel);
+  if (node->buffer != NULL)
+    g_object_unref (node->buffer);
+
+  if (node->notify != NULL)
+    node->notify (node->user_data);
+
+  g_array_unref (node->deps);
+
+  g_slice_free (Node, node);
+}
+
+static guint
+add_node (GoclGraph *self, Node *node, GoclQueue *queue)
+{
+  if (node->type != NODE_TYPE_HOST)
+    {
+      node->queue = g_object_ref (queue != NULL ? queue : self->priv->queue);
+      node->out_of_order = (gocl_queue_get_flags (node->queue) &
+                            GOCL_QUEUE_FLAGS_OUT_OF_ORDER) != 0;
+    }
+
+  node->deps = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  g_ptr_array_add (self->priv->nodes, node);
+  self->priv->prepared = FALSE;
+
+  return self->priv->nodes->len - 1;
+}
+
+/* decides which nodes need an event, and collects the queues used */
+static void
+prepare (GoclGraph *self)
+{
+  GPtrArray *nodes = self->priv->nodes;
+  guint i;
+  guint j;
+
+  g_ptr_array_set_size (self->priv->queues, 0);
+
+  for (i = 0; i < nodes->len; i++)
+    {
+      Node *node = g_ptr_array_index (nodes, i);
+
+      node->needs_event = FALSE;
+
+      if (node->type == NODE_TYPE_HOST)
+        continue;
+
+      for (j = 0; j < self->priv->queues->len; j++)
+        if (g_ptr_array_index (self->priv->queues, j) == node->queue)
+          break;
+      if (j == self->priv->queues->len)
+        g_ptr_array_add (self->priv->queues, node->queue);
+    }
+
+  for (i = 0; i < nodes->len; i++)
+    {
+      Node *node = g_ptr_array_index (nodes, i);
+
+      for (j = 0; j < node->deps->len; j++)
+        {
+          Node *dep = g_ptr_array_index (nodes,
+                                         g_array_index (node->deps, guint, j));
+
+          /* host nodes always have an event during asynchronous runs, and
+             commands on the same in-order queue run in sequence anyway */
+          if (dep->type == NODE_TYPE_HOST)
+            continue;
+
+          if (node->type == NODE_TYPE_HOST ||
+              node->queue != dep->queue ||
+              dep->out_of_order)
+            {
+              dep->needs_event = TRUE;
+            }
+        }
+    }
+
+  self->priv->prepared = TRUE;
+}
+
+static gboolean
+run_host_func (gpointer user_data)
+{
+  HostRun *run = user_data;
+  cl_int status;
+
+  status = g_atomic_int_get (&run->status);
+  if (status == CL_SUCCESS)
+    run->node->func (run->self, run->node->user_data);
+
+  /* a failed dependency makes the nodes that depend on this one fail too */
+  clSetUserEventStatus (run->user_event,
+                        status == CL_SUCCESS ? CL_COMPLETE : status);
+  clReleaseEvent (run->user_event);
+
+  g_main_context_unref (run->context);
+  g_object_unref (run->self);
+  g_slice_free (HostRun, run);
+
+  return FALSE;
+}
+
+static void
+host_run_release_pending (HostRun *run)
+{
+  GSource *src;
+
+  if (! g_atomic_int_dec_and_test (&run->pending))
+    return;
+
+  src = g_idle_source_new ();
+  g_source_set_callback (src, run_host_func, run, NULL);
+  g_source_attach (src, run->context);
+  g_source_unref (src);
+}
+
+static void CL_CALLBACK
+on_host_dependency_completed (cl_event  event,
+                              cl_int    status,
+                              void     *user_data)
+{
+  HostRun *run = user_data;
+
+  if (status < 0)
+    g_atomic_int_compare_and_exchange (&run->status, CL_SUCCESS, status);
+
+  host_run_release_pending (run);
+}
+
+/* creates the user event of a host node, which completes once the host
+   function has been called after all the events in @wait_list */
+static cl_int
+start_host_node (GoclGraph *self, Node *node, GArray *wait_list)
+{
+  cl_int err_code;
+  cl_context context;
+  HostRun *run;
+  guint i;
+
+  context = gocl_context_get_context (
+              gocl_device_get_context (
+                gocl_queue_get_device (self->priv->queue)));
+
+  node->event = clCreateUserEvent (context, &err_code);
+  if (err_code != CL_SUCCESS)
+    {
+      node->event = NULL;
+      return err_code;
+    }
+
+  run = g_slice_new0 (HostRun);
+  run->self = g_object_ref (self);
+  run->node = node;
+  run->context = g_main_context_get_thread_default ();
+  if (run->context == NULL)
+    run->context = g_main_context_default ();
+  g_main_context_ref (run->context);
+  run->status = CL_SUCCESS;
+
+  /* the node keeps its own reference until the run is enqueued */
+  run->user_event = node->event;
+  clRetainEvent (node->event);
+
+  /* one extra count so the function is not scheduled before all the
+     callbacks are set */
+  run->pending = wait_list->len + 1;
+
+  for (i = 0; i < wait_list->len; i++)
+    {
+      err_code =
+        gocl_event_add_cl_callback (g_array_index (wait_list, cl_event, i),
+                                    on_host_dependency_completed,
+                                    run);
+      if (err_code != CL_SUCCESS)
+        on_host_dependency_completed (NULL, err_code, run);
+    }
+
+  host_run_release_pending (run);
+
+  return CL_SUCCESS;
+}
+
+static cl_int
+enqueue_node (GoclGraph *self, Node *node, GArray *wait_list)
+{
+  cl_command_queue queue = gocl_queue_get_queue (node->queue);
+  guint num_events = wait_list->len;
+  const cl_event *events =
+    num_events > 0 ? (const cl_event *) wait_list->data : NULL;
+  cl_event *event = node->needs_event ? &node->event : NULL;
+
+  switch (node->type)
+    {
+    case NODE_TYPE_KERNEL:
+      return gocl_kernel_enqueue (node->kernel,
+                                  queue,
+                                  NULL,
+                                  NULL,
+                                  num_events,
+                                  events,
+                                  event);
+
+    case NODE_TYPE_WRITE:
+      return clEnqueueWriteBuffer (queue,
+                                   gocl_buffer_get_buffer (node->buffer),
+                                   CL_FALSE,
+                                   node->offset,
+                                   node->size,
+                                   node->ptr,
+                                   num_events,
+                                   events,
+                                   event);
+
+    case NODE_TYPE_READ:
+      return clEnqueueReadBuffer (queue,
+                                  gocl_buffer_get_buffer (node->buffer),
+                                  CL_FALSE,
+                                  node->offset,
+                                  node->size,
+                                  node->ptr,
+                                  num_events,
+                                  events,
+                                  event);
+
+    default:
+      g_assert_not_reached ();
+      return CL_INVALID_OPERATION;
+    }
+}
+
+/* enqueues a single event that completes when every node of the run has
+   completed */
+static cl_int
+enqueue_end (GoclGraph               *self,
+             gboolean                 blocking,
+             const GoclEventWaitList *external,
+             cl_event                *event)
+{
+  GArray *wait_list = self->priv->wait_list;
+  GPtrArray *queues = self->priv->queues;
+  cl_command_queue queue = gocl_queue_get_queue (self->priv->queue);
+  cl_int err_code = CL_SUCCESS;
+  guint num_markers;
+  guint i;
+
+  g_array_set_size (wait_list, 0);
+
+  /* with an empty wait list, a marker waits for every previous command of
+     its queue, both for in-order and out-of-order queues */
+  for (i = 0; i < queues->len; i++)
+    {
+      cl_event marker;
+
+      err_code =
+        clEnqueueMarkerWithWaitList (gocl_queue_get_queue (g_ptr_array_index (queues, i)),
+                                     0,
+                                     NULL,
+                                     &marker);
+      if (err_code != CL_SUCCESS)
+        break;
+
+      g_array_append_val (wait_list, marker);
+    }
+  num_markers = wait_list->len;
+
+  if (err_code == CL_SUCCESS && ! blocking)
+    {
+      for (i = 0; i < self->priv->nodes->len; i++)
+        {
+          Node *node = g_ptr_array_index (self->priv->nodes, i);
+
+          if (node->type == NODE_TYPE_HOST && node->event != NULL)
+            g_array_append_val (wait_list, node->event);
+        }
+    }
+
+  if (err_code != CL_SUCCESS)
+    {
+      /* nothing to do */
+    }
+  else if (wait_list->len == 0)
+    {
+      /* no device or pending host nodes, so only the external events are
+         left to wait for */
+      err_code = clEnqueueMarkerWithWaitList (queue,
+                                              external->len,
+                                              external->len > 0 ?
+                                                external->events : NULL,
+                                              event);
+    }
+  else if (wait_list->len == 1 &&
+           num_markers == 1 &&
+           g_ptr_array_index (queues, 0) == self->priv->queue)
+    {
+      *event = g_array_index (wait_list, cl_event, 0);
+      num_markers = 0;
+    }
+  else
+    {
+      err_code = clEnqueueMarkerWithWaitList (queue,
+                                              wait_list->len,
+                                              (cl_event *) wait_list->data,
+                                              event);
+    }
+
+  for (i = 0; i < num_markers; i++)
+    clReleaseEvent (g_array_index (wait_list, cl_event, i));
+
+  g_array_set_size (wait_list, 0);
+
+  return err_code;
+}
+
+static cl_int
+run_graph (GoclGraph               *self,
+           gboolean                 blocking,
+           const GoclEventWaitList *external,
+           cl_event                *event)
+{
+  GPtrArray *nodes = self->priv->nodes;
+  GArray *wait_list = self->priv->wait_list;
+  cl_int err_code = CL_SUCCESS;
+  guint i;
+  guint j;
+
+  if (! self->priv->prepared)
+    prepare (self);
+
+  for (i = 0; i < nodes->len && err_code == CL_SUCCESS; i++)
+    {
+      Node *node = g_ptr_array_index (nodes, i);
+
+      g_array_set_size (wait_list, 0);
+
+      for (j = 0; j < node->deps->len; j++)
+        {
+          Node *dep = g_ptr_array_index (nodes,
+                                         g_array_index (node->deps, guint, j));
+
+          if (dep->event != NULL)
+            g_array_append_val (wait_list, dep->event);
+        }
+
+      if (node->deps->len == 0 && external->len > 0)
+        g_array_append_vals (wait_list, external->events, external->len);
+
+      if (node->type != NODE_TYPE_HOST)
+        {
+          err_code = enqueue_node (self, node, wait_list);
+        }
+      else if (! blocking)
+        {
+          err_code = start_host_node (self, node, wait_list);
+        }
+      else
+        {
+          /* waiting for events flushes their queues implicitly */
+          if (wait_list->len > 0)
+            err_code = clWaitForEvents (wait_list->len,
+                                        (cl_event *) wait_list->data);
+
+          if (err_code == CL_SUCCESS)
+            node->func (self, node->user_data);
+        }
+    }
+
+  if (err_code == CL_SUCCESS)
+    err_code = enqueue_end (self, blocking, external, event);
+
+  for (i = 0; i < nodes->len; i++)
+    {
+      Node *node = g_ptr_array_index (nodes, i);
+
+      if (node->event != NULL)
+        {
+          clReleaseEvent (node->event);
+          node->event = NULL;
+        }
+    }
+
+  g_array_set_size (wait_list, 0);
+
+  for (i = 0; i < self->priv->queues->len; i++)
+    clFlush (gocl_queue_get_queue (g_ptr_array_index (self->priv->queues, i)));
+  clFlush (gocl_queue_get_queue (self->priv->queue));
+
+  return err_code;
+}
+
+/* public */
+
+/**
+ * gocl_graph_new:
+ * @queue: The #GoclQueue where nodes that don't specify a queue are
+ * enqueued
+ *
+ * Creates a new, empty graph.
+ *
+ * Returns: (transfer full): A newly created #GoclGraph
+ **/
+GoclGraph *
+gocl_graph_new (GoclQueue *queue)
+{
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  return g_object_new (GOCL_TYPE_GRAPH,
+                       "queue", queue,
+                       NULL);
+}
+
+/**
+ * gocl_graph_get_queue:
+ * @self: The #GoclGraph
+ *
+ * Retrieves the command queue used by the nodes that don't specify one.
+ *
+ * Returns: (transfer none): The #GoclQueue of the graph
+ **/
+GoclQueue *
+gocl_graph_get_queue (GoclGraph *self)
+{
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), NULL);
+
+  return self->priv->queue;
+}
+
+/**
+ * gocl_graph_get_num_nodes:
+ * @self: The #GoclGraph
+ *
+ * Retrieves the number of nodes in the graph. Nodes are indexed from zero
+ * in the order they were added.
+ *
+ * Returns: The number of nodes
+ **/
+guint
+gocl_graph_get_num_nodes (GoclGraph *self)
+{
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), 0);
+
+  return self->priv->nodes->len;
+}
+
+/**
+ * gocl_graph_add_kernel:
+ * @self: The #GoclGraph
+ * @kernel: The #GoclKernel to run
+ * @queue: (allow-none): The #GoclQueue to run the kernel in, or %NULL to
+ * use the queue of the graph
+ *
+ * Adds a node that runs @kernel with the arguments and work sizes it has
+ * at the time the graph is run.
+ *
+ * Returns: The index of the new node
+ **/
+guint
+gocl_graph_add_kernel (GoclGraph  *self,
+                       GoclKernel *kernel,
+                       GoclQueue  *queue)
+{
+  Node *node;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (GOCL_IS_KERNEL (kernel), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (queue == NULL || GOCL_IS_QUEUE (queue),
+                        GOCL_GRAPH_INVALID_NODE);
+
+  node = g_slice_new0 (Node);
+  node->type = NODE_TYPE_KERNEL;
+  node->kernel = g_object_ref (kernel);
+
+  return add_node (self, node, queue);
+}
+
+/**
+ * gocl_graph_add_write_buffer:
+ * @self: The #GoclGraph
+ * @buffer: The #GoclBuffer to write to
+ * @data: A pointer to the memory to copy, which must remain valid until
+ * each run completes
+ * @size: The number of bytes to write
+ * @offset: The offset inside the buffer to start writing at
+ * @queue: (allow-none): The #GoclQueue to enqueue the write in, or %NULL to
+ * use the queue of the graph
+ *
+ * Adds a node that writes @size bytes from @data into @buffer, without
+ * blocking.
+ *
+ * Returns: The index of the new node
+ **/
+guint
+gocl_graph_add_write_buffer (GoclGraph      *self,
+                             GoclBuffer     *buffer,
+                             const gpointer  data,
+                             gsize           size,
+                             goffset         offset,
+                             GoclQueue      *queue)
+{
+  Node *node;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (buffer), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (queue == NULL || GOCL_IS_QUEUE (queue),
+                        GOCL_GRAPH_INVALID_NODE);
+
+  node = g_slice_new0 (Node);
+  node->type = NODE_TYPE_WRITE;
+  node->buffer = g_object_ref (buffer);
+  node->ptr = data;
+  node->size = size;
+  node->offset = offset;
+
+  return add_node (self, node, queue);
+}
+
+/**
+ * gocl_graph_add_read_buffer:
+ * @self: The #GoclGraph
+ * @buffer: The #GoclBuffer to read from
+ * @target_ptr: A pointer to the memory to copy into, which must remain
+ * valid until each run completes
+ * @size: The number of bytes to read
+ * @offset: The offset inside the buffer to start reading from
+ * @queue: (allow-none): The #GoclQueue to enqueue the read in, or %NULL to
+ * use the queue of the graph
+ *
+ * Adds a node that reads @size bytes from @buffer into @target_ptr, without
+ * blocking.
+ *
+ * Returns: The index of the new node
+ **/
+guint
+gocl_graph_add_read_buffer (GoclGraph  *self,
+                            GoclBuffer *buffer,
+                            gpointer    target_ptr,
+                            gsize       size,
+                            goffset     offset,
+                            GoclQueue  *queue)
+{
+  Node *node;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (buffer), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (queue == NULL || GOCL_IS_QUEUE (queue),
+                        GOCL_GRAPH_INVALID_NODE);
+
+  node = g_slice_new0 (Node);
+  node->type = NODE_TYPE_READ;
+  node->buffer = g_object_ref (buffer);
+  node->ptr = target_ptr;
+  node->size = size;
+  node->offset = offset;
+
+  return add_node (self, node, queue);
+}
+
+/**
+ * gocl_graph_add_host_func:
+ * @self: The #GoclGraph
+ * @func: (scope notified): The #GoclGraphHostFunc to call
+ * @user_data: (allow-none): Arbitrary data to pass to @func
+ * @notify: (allow-none): A function to free @user_data when the graph is
+ * destroyed, or %NULL
+ *
+ * Adds a node that calls @func on the host once all its dependencies
+ * complete. Nodes that depend on it don't start until @func returns. If a
+ * dependency fails, @func is not called and the nodes that depend on it
+ * fail too.
+ *
+ * Returns: The index of the new node
+ **/
+guint
+gocl_graph_add_host_func (GoclGraph         *self,
+                          GoclGraphHostFunc  func,
+                          gpointer           user_data,
+                          GDestroyNotify     notify)
+{
+  Node *node;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), GOCL_GRAPH_INVALID_NODE);
+  g_return_val_if_fail (func != NULL, GOCL_GRAPH_INVALID_NODE);
+
+  node = g_slice_new0 (Node);
+  node->type = NODE_TYPE_HOST;
+  node->func = func;
+  node->user_data = user_data;
+  node->notify = notify;
+
+  return add_node (self, node, NULL);
+}
+
+/**
+ * gocl_graph_add_dependency:
+ * @self: The #GoclGraph
+ * @node: The index of the dependent node
+ * @depends_on: The index of the node that @node depends on, which must
+ * have been added before @node
+ *
+ * Makes @node start only after @depends_on has completed.
+ **/
+void
+gocl_graph_add_dependency (GoclGraph *self,
+                           guint      node,
+                           guint      depends_on)
+{
+  Node *_node;
+  guint i;
+
+  g_return_if_fail (GOCL_IS_GRAPH (self));
+  g_return_if_fail (node < self->priv->nodes->len);
+  g_return_if_fail (depends_on < node);
+
+  _node = g_ptr_array_index (self->priv->nodes, node);
+
+  for (i = 0; i < _node->deps->len; i++)
+    if (g_array_index (_node->deps, guint, i) == depends_on)
+      return;
+
+  g_array_append_val (_node->deps, depends_on);
+  self->priv->prepared = FALSE;
+}
+
+/**
+ * gocl_graph_run:
+ * @self: The #GoclGraph
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events the nodes without dependencies wait for, or %NULL
+ *
+ * Enqueues all the nodes of the graph without blocking, and flushes their
+ * queues. Host nodes are called later from the thread-default main context
+ * of the caller. The graph can be run again right away, even if the
+ * previous run has not completed yet.
+ *
+ * Returns: (transfer none): A #GoclEvent that triggers when all the nodes
+ * of the run have completed, or with the error of the first node that
+ * could not be enqueued
+ **/
+GoclEvent *
+gocl_graph_run (GoclGraph *self, GList *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = run_graph (self, FALSE, &wait_list, &event);
+
+  _event = gocl_event_new_from_result (self->priv->queue,
+                                       err_code,
+                                       event,
+                                       &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_set_label (_event, "graph");
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_graph_run_sync:
+ * @self: The #GoclGraph
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events the nodes without dependencies wait for, or %NULL
+ *
+ * Enqueues all the nodes of the graph and blocks until they complete. Host
+ * nodes are called from the calling thread, once their dependencies
+ * complete. For a non-blocking version of this method, see
+ * gocl_graph_run().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_graph_run_sync (GoclGraph *self, GList *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_GRAPH (self), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  err_code = run_graph (self, TRUE, &wait_list, &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
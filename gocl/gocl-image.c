@@ -29,11 +29,32 @@
  * special type of buffer that holds pixel information in a convenient way.
  * As buffers, images are also directly accessible from OpenCL programs.
  *
- * Iamges are created using gocl_image_new() and
- * gocl_image_new_from_gl_texture().
+ * Images are created using gocl_image_new(), gocl_image_new_full() and
+ * gocl_image_new_from_gl_texture(). gocl_image_new() creates RGBA images
+ * with 8-bit normalized channels, while gocl_image_new_full() accepts any
+ * channel order and channel type from #GoclImageChannelOrder and
+ * #GoclImageChannelType, as well as image arrays. Use
+ * gocl_context_supports_image_format() to check whether a format is
+ * available before creating the image. Planar layouts like NV12 are
+ * commonly represented as two images, a full size %GOCL_IMAGE_CHANNEL_ORDER_R
+ * luma plane and a half size %GOCL_IMAGE_CHANNEL_ORDER_RG chroma plane,
+ * unless the platform exposes a vendor channel order for them, which can be
+ * passed to gocl_image_new_full() directly.
  *
- * Reading from and writing to images is done using the provided
- * #GoclBuffer APIs.
+ * A region of an image is transferred to or from host memory with
+ * gocl_image_read() and gocl_image_write(), and their blocking versions
+ * gocl_image_read_sync() and gocl_image_write_sync(). The whole image can
+ * also be read with gocl_buffer_read_all() or gocl_buffer_read_all_sync().
+ * Issuing the asynchronous reads on the queue returned by
+ * gocl_device_get_transfer_queue() lets the readback of a frame overlap
+ * the kernels of the next one. A region of an image can
+ * also be mapped into host memory with gocl_image_map() or
+ * gocl_image_map_sync(), and unmapped with gocl_buffer_unmap() or
+ * gocl_buffer_unmap_sync().
+ *
+ * Pixel data can be moved between an image and a #GoclBuffer without going
+ * through host memory, using gocl_image_copy_to_buffer() and
+ * gocl_image_copy_from_buffer().
  **/
 
 /**
@@ -51,11 +72,18 @@
 #include "gocl-private.h"
 #include "gocl-context.h"
 
+/* GL_TEXTURE_2D from gl.h */
+#define GL_TEXTURE_2D 0x0DE1
+
 struct _GoclImagePrivate
 {
   cl_image_desc props;
+  cl_image_format format;
+  gsize element_size;
 
   guint gl_texture;
+  guint gl_target;
+  gint gl_miplevel;
 };
 
 /* properties */
@@ -66,7 +94,12 @@ enum
   PROP_WIDTH,
   PROP_HEIGHT,
   PROP_DEPTH,
-  PROP_GL_TEXTURE
+  PROP_ARRAY_SIZE,
+  PROP_CHANNEL_ORDER,
+  PROP_CHANNEL_TYPE,
+  PROP_GL_TEXTURE,
+  PROP_GL_TARGET,
+  PROP_GL_MIPLEVEL
 };
 
 static void           gocl_image_class_init               (GoclImageClass *class);
@@ -152,6 +185,33 @@ gocl_image_class_init (GoclImageClass *class)
                                                         0,
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                         G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_ARRAY_SIZE,
+                                   g_param_spec_uint64 ("array-size",
+                                                        "Array size",
+                                                        "The number of images in an image array",
+                                                        0,
+                                                        G_MAXUINT64,
+                                                        0,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_CHANNEL_ORDER,
+                                   g_param_spec_uint ("channel-order",
+                                                      "Channel order",
+                                                      "The order of the channels of each pixel",
+                                                      0,
+                                                      G_MAXUINT,
+                                                      GOCL_IMAGE_CHANNEL_ORDER_RGBA,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_CHANNEL_TYPE,
+                                   g_param_spec_uint ("channel-type",
+                                                      "Channel type",
+                                                      "The data type of each channel",
+                                                      0,
+                                                      G_MAXUINT,
+                                                      GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT8,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
 
   g_object_class_install_property (obj_class, PROP_GL_TEXTURE,
                                    g_param_spec_uint ("gl-texture",
@@ -162,6 +222,24 @@ gocl_image_class_init (GoclImageClass *class)
                                                       0,
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                       G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_GL_TARGET,
+                                   g_param_spec_uint ("gl-target",
+                                                      "GL target",
+                                                      "The GL texture target of the GL texture",
+                                                      0,
+                                                      G_MAXUINT,
+                                                      GL_TEXTURE_2D,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (obj_class, PROP_GL_MIPLEVEL,
+                                   g_param_spec_int ("gl-miplevel",
+                                                     "GL mipmap level",
+                                                     "The mipmap level of the GL texture",
+                                                     0,
+                                                     G_MAXINT,
+                                                     0,
+                                                     G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                     G_PARAM_STATIC_STRINGS));
 
   g_type_class_add_private (class, sizeof (GoclImagePrivate));
 }
@@ -174,6 +252,9 @@ gocl_image_init (GoclImage *self)
   self->priv = priv = GOCL_IMAGE_GET_PRIVATE (self);
 
   memset (&priv->props, 0, sizeof (cl_image_desc));
+  priv->format.image_channel_order = GOCL_IMAGE_CHANNEL_ORDER_RGBA;
+  priv->format.image_channel_data_type = GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT8;
+  priv->element_size = 0;
 }
 
 static void
@@ -204,10 +285,30 @@ set_property (GObject      *obj,
       self->priv->props.image_depth = g_value_get_uint64 (value);
       break;
 
+    case PROP_ARRAY_SIZE:
+      self->priv->props.image_array_size = g_value_get_uint64 (value);
+      break;
+
+    case PROP_CHANNEL_ORDER:
+      self->priv->format.image_channel_order = g_value_get_uint (value);
+      break;
+
+    case PROP_CHANNEL_TYPE:
+      self->priv->format.image_channel_data_type = g_value_get_uint (value);
+      break;
+
     case PROP_GL_TEXTURE:
       self->priv->gl_texture = g_value_get_uint (value);
       break;
 
+    case PROP_GL_TARGET:
+      self->priv->gl_target = g_value_get_uint (value);
+      break;
+
+    case PROP_GL_MIPLEVEL:
+      self->priv->gl_miplevel = g_value_get_int (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -242,52 +343,83 @@ get_property (GObject    *obj,
       g_value_set_uint64 (value, self->priv->props.image_depth);
       break;
 
+    case PROP_ARRAY_SIZE:
+      g_value_set_uint64 (value, self->priv->props.image_array_size);
+      break;
+
+    case PROP_CHANNEL_ORDER:
+      g_value_set_uint (value, self->priv->format.image_channel_order);
+      break;
+
+    case PROP_CHANNEL_TYPE:
+      g_value_set_uint (value, self->priv->format.image_channel_data_type);
+      break;
+
     case PROP_GL_TEXTURE:
       g_value_set_uint (value, self->priv->gl_texture);
       break;
 
+    case PROP_GL_TARGET:
+      g_value_set_uint (value, self->priv->gl_target);
+      break;
+
+    case PROP_GL_MIPLEVEL:
+      g_value_set_int (value, self->priv->gl_miplevel);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
     }
 }
 
-static void
-get_image_info (GoclImage *self, cl_mem obj, cl_image_info param)
+static gboolean
+get_image_info (cl_mem         obj,
+                cl_image_info  param,
+                gsize          size,
+                gpointer       value)
 {
-  gsize value;
-  cl_int err_code = 0;
+  cl_int err_code;
   GError *error = NULL;
 
-  err_code = clGetImageInfo (obj,
-                             param,
-                             sizeof (gsize),
-                             &value,
-                             NULL);
+  err_code = clGetImageInfo (obj, param, size, value, NULL);
   if (gocl_error_check_opencl (err_code, &error))
     {
       g_warning ("Failed to obtain OpenCL image property: %s\n", error->message);
       g_error_free (error);
-      return;
+      return FALSE;
     }
 
-  switch (param)
-    {
-    case CL_IMAGE_WIDTH:
-      self->priv->props.image_width = value;
-      break;
-
-    case CL_IMAGE_HEIGHT:
-      self->priv->props.image_height = value;
-      break;
-
-    case CL_IMAGE_DEPTH:
-      self->priv->props.image_depth = value;
-      break;
+  return TRUE;
+}
 
-    default:
-      break;
+/* reads back the properties of an image not created by us, like those
+   shared with GL */
+static void
+update_props_from_cl_mem (GoclImage *self, cl_mem obj)
+{
+  cl_image_desc *props = &self->priv->props;
+  cl_mem_object_type type;
+
+  if (clGetMemObjectInfo (obj,
+                          CL_MEM_TYPE,
+                          sizeof (cl_mem_object_type),
+                          &type,
+                          NULL) == CL_SUCCESS)
+    {
+      props->image_type = type;
     }
+
+  get_image_info (obj, CL_IMAGE_FORMAT,
+                  sizeof (cl_image_format), &self->priv->format);
+  get_image_info (obj, CL_IMAGE_WIDTH,
+                  sizeof (gsize), &props->image_width);
+  get_image_info (obj, CL_IMAGE_HEIGHT,
+                  sizeof (gsize), &props->image_height);
+  get_image_info (obj, CL_IMAGE_DEPTH,
+                  sizeof (gsize), &props->image_depth);
+  get_image_info (obj, CL_IMAGE_ARRAY_SIZE,
+                  sizeof (gsize), &props->image_array_size);
 }
 
 static cl_int
@@ -305,37 +437,100 @@ create_cl_mem (GoclBuffer  *buffer,
     {
       *obj = clCreateFromGLTexture (context,
                                     flags,  /* OR'ed from GoclBufferFlags */
-                                    0x0DE1, /* GL_TEXTURE_2D from gl.h */
-                                    0,      /* miplevel = 0 for now */
+                                    self->priv->gl_target,
+                                    self->priv->gl_miplevel,
                                     self->priv->gl_texture,
                                     &err_code);
 
       if (err_code == CL_SUCCESS)
-        {
-          /* the only we currently support from GL */
-          self->priv->props.image_type = GOCL_IMAGE_TYPE_2D;
-
-          get_image_info (self, *obj, CL_IMAGE_WIDTH);
-          get_image_info (self, *obj, CL_IMAGE_HEIGHT);
-          get_image_info (self, *obj, CL_IMAGE_DEPTH);
-        }
+        update_props_from_cl_mem (self, *obj);
     }
   else
     {
-      /* by now, only RGBA as 8-bit unsigned integers is supported */
-      cl_image_format format = { CL_RGBA, CL_UNORM_INT8 };
-
       *obj = clCreateImage (context,
                             flags,
-                            &format,
+                            &self->priv->format,
                             &self->priv->props,
                             host_ptr,
                             &err_code);
     }
 
+  if (err_code == CL_SUCCESS)
+    get_image_info (*obj, CL_IMAGE_ELEMENT_SIZE,
+                    sizeof (gsize), &self->priv->element_size);
+
   return err_code;
 }
 
+static void
+get_region (GoclImage   *self,
+            const gsize *origin,
+            const gsize *region,
+            gsize       *out_origin,
+            gsize       *out_region)
+{
+  const cl_image_desc *props = &self->priv->props;
+
+  if (origin != NULL)
+    memcpy (out_origin, origin, sizeof (gsize) * 3);
+  else
+    memset (out_origin, 0, sizeof (gsize) * 3);
+
+  if (region != NULL)
+    {
+      memcpy (out_region, region, sizeof (gsize) * 3);
+      return;
+    }
+
+  /* unused dimensions must be 1, and arrays are indexed by the dimension
+     that follows the last one of each image */
+  out_region[0] = props->image_width;
+  out_region[1] = 1;
+  out_region[2] = 1;
+
+  switch (props->image_type)
+    {
+    case GOCL_IMAGE_TYPE_1D_ARRAY:
+      out_region[1] = props->image_array_size;
+      break;
+
+    case GOCL_IMAGE_TYPE_2D:
+      out_region[1] = props->image_height;
+      break;
+
+    case GOCL_IMAGE_TYPE_2D_ARRAY:
+      out_region[1] = props->image_height;
+      out_region[2] = props->image_array_size;
+      break;
+
+    case GOCL_IMAGE_TYPE_3D:
+      out_region[1] = props->image_height;
+      out_region[2] = props->image_depth;
+      break;
+
+    default:
+      break;
+    }
+}
+
+/* the amount of host memory touched by a transfer of @region with the
+   given pitches, as OpenCL computes them when they are zero */
+static gsize
+get_host_size (GoclImage   *self,
+               const gsize *region,
+               gsize        row_pitch,
+               gsize        slice_pitch)
+{
+  gsize row_size = region[0] * self->priv->element_size;
+
+  if (row_pitch == 0)
+    row_pitch = row_size;
+  if (slice_pitch == 0)
+    slice_pitch = row_pitch * region[1];
+
+  return slice_pitch * (region[2] - 1) + row_pitch * (region[1] - 1) + row_size;
+}
+
 static cl_int
 read_all (GoclBuffer          *buffer,
           cl_mem               image,
@@ -349,16 +544,13 @@ read_all (GoclBuffer          *buffer,
 {
   GoclImage *self = GOCL_IMAGE (buffer);
 
-  gsize origin[3] = {0, };
+  gsize origin[3];
   gsize region[3];
 
-  region[0] = self->priv->props.image_width;
-  region[1] = self->priv->props.image_height;
-  region[2] = self->priv->props.image_type == GOCL_IMAGE_TYPE_2D ?
-    1 : self->priv->props.image_depth;
+  get_region (self, NULL, NULL, origin, region);
 
   if (size != NULL)
-    *size = region[0] * region[1] * region[2] * 4 /* assuming RGBA */;
+    *size = region[0] * region[1] * region[2] * self->priv->element_size;
 
   return clEnqueueReadImage (queue,
                              image,
@@ -373,6 +565,164 @@ read_all (GoclBuffer          *buffer,
                              out_event);
 }
 
+static GoclEvent *
+enqueue_read (GoclImage               *self,
+              GoclQueue               *queue,
+              gboolean                 blocking,
+              gpointer                 target_ptr,
+              const gsize             *origin,
+              const gsize             *region,
+              gsize                    row_pitch,
+              gsize                    slice_pitch,
+              const GoclEventWaitList *wait_list,
+              cl_int                  *err_code)
+{
+  cl_event event = NULL;
+  GoclEvent *_event = NULL;
+  gsize _origin[3];
+  gsize _region[3];
+
+  get_region (self, origin, region, _origin, _region);
+
+  *err_code = clEnqueueReadImage (gocl_queue_get_queue (queue),
+                                  gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                                  blocking,
+                                  _origin,
+                                  _region,
+                                  row_pitch,
+                                  slice_pitch,
+                                  target_ptr,
+                                  wait_list->len,
+                                  wait_list->events,
+                                  blocking ? NULL : &event);
+
+  if (blocking)
+    return NULL;
+
+  /* keep pinned memory from being recycled while in use */
+  if (*err_code == CL_SUCCESS)
+    gocl_context_track_pinned_transfer (gocl_buffer_get_context (GOCL_BUFFER (self)),
+                                        target_ptr,
+                                        get_host_size (self,
+                                                       _region,
+                                                       row_pitch,
+                                                       slice_pitch),
+                                        event);
+
+  _event = gocl_event_new_from_result (queue, *err_code, event, wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+static GoclEvent *
+enqueue_write (GoclImage               *self,
+               GoclQueue               *queue,
+               gboolean                 blocking,
+               gconstpointer            data,
+               const gsize             *origin,
+               const gsize             *region,
+               gsize                    row_pitch,
+               gsize                    slice_pitch,
+               const GoclEventWaitList *wait_list,
+               cl_int                  *err_code)
+{
+  cl_event event = NULL;
+  GoclEvent *_event = NULL;
+  gsize _origin[3];
+  gsize _region[3];
+
+  get_region (self, origin, region, _origin, _region);
+
+  *err_code = clEnqueueWriteImage (gocl_queue_get_queue (queue),
+                                   gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                                   blocking,
+                                   _origin,
+                                   _region,
+                                   row_pitch,
+                                   slice_pitch,
+                                   data,
+                                   wait_list->len,
+                                   wait_list->events,
+                                   blocking ? NULL : &event);
+
+  if (blocking)
+    return NULL;
+
+  /* keep pinned memory from being recycled while in use */
+  if (*err_code == CL_SUCCESS)
+    gocl_context_track_pinned_transfer (gocl_buffer_get_context (GOCL_BUFFER (self)),
+                                        data,
+                                        get_host_size (self,
+                                                       _region,
+                                                       row_pitch,
+                                                       slice_pitch),
+                                        event);
+
+  _event = gocl_event_new_from_result (queue, *err_code, event, wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+static cl_int
+enqueue_copy_to_buffer (GoclImage               *self,
+                        GoclQueue               *queue,
+                        GoclBuffer              *target,
+                        const gsize             *origin,
+                        const gsize             *region,
+                        goffset                  dst_offset,
+                        const GoclEventWaitList *wait_list,
+                        cl_event                *event)
+{
+  cl_int err_code;
+  gsize _origin[3];
+  gsize _region[3];
+
+  get_region (self, origin, region, _origin, _region);
+
+  err_code = clEnqueueCopyImageToBuffer (gocl_queue_get_queue (queue),
+                                         gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                                         gocl_buffer_get_buffer (target),
+                                         _origin,
+                                         _region,
+                                         dst_offset,
+                                         wait_list->len,
+                                         wait_list->events,
+                                         event);
+
+  return err_code;
+}
+
+static cl_int
+enqueue_copy_from_buffer (GoclImage               *self,
+                          GoclQueue               *queue,
+                          GoclBuffer              *source,
+                          goffset                  src_offset,
+                          const gsize             *origin,
+                          const gsize             *region,
+                          const GoclEventWaitList *wait_list,
+                          cl_event                *event)
+{
+  cl_int err_code;
+  gsize _origin[3];
+  gsize _region[3];
+
+  get_region (self, origin, region, _origin, _region);
+
+  err_code = clEnqueueCopyBufferToImage (gocl_queue_get_queue (queue),
+                                         gocl_buffer_get_buffer (source),
+                                         gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                                         src_offset,
+                                         _origin,
+                                         _region,
+                                         wait_list->len,
+                                         wait_list->events,
+                                         event);
+
+  return err_code;
+}
+
 /* public */
 
 /**
@@ -385,8 +735,9 @@ read_all (GoclBuffer          *buffer,
  * @height: Image height in pixels, zero if image type is 1D
  * @depth: Image depth in pixels, or zero if image is not 3D
  *
- * Creates a new image buffer. Currently only 8-bits unsigned integer format is
- * supported, with RGBA channels.
+ * Creates a new image buffer with RGBA channels, each stored as an 8-bit
+ * normalized unsigned integer. For other formats and for image arrays, see
+ * gocl_image_new_full().
  * Other image properties like row pitch, slice pitch, etc. are assumed to be
  * zero by now.
  *
@@ -400,6 +751,51 @@ gocl_image_new (GoclContext   *context,
                 gsize          width,
                 gsize          height,
                 gsize          depth)
+{
+  return gocl_image_new_full (context,
+                              flags,
+                              host_ptr,
+                              type,
+                              GOCL_IMAGE_CHANNEL_ORDER_RGBA,
+                              GOCL_IMAGE_CHANNEL_TYPE_UNORM_INT8,
+                              width,
+                              height,
+                              depth,
+                              0);
+}
+
+/**
+ * gocl_image_new_full:
+ * @context: The #GoclContext to create the image in
+ * @flags: An OR'ed combination of values from #GoclBufferFlags
+ * @host_ptr: (allow-none): Pointer to host memory, or %NULL
+ * @type: Image type value from #GoclImageType
+ * @channel_order: The channel order, a value from #GoclImageChannelOrder or
+ * any other channel order supported by the platform
+ * @channel_type: The channel data type, a value from #GoclImageChannelType
+ * @width: Image width in pixels
+ * @height: Image height in pixels, zero if image type is 1D
+ * @depth: Image depth in pixels, or zero if image is not 3D
+ * @array_size: Number of images in the array, or zero if image is not an
+ * array
+ *
+ * Creates a new image buffer with the given pixel format. Not every format
+ * is supported by every platform, see gocl_context_supports_image_format().
+ * If @host_ptr is not %NULL, its rows are assumed to be tightly packed.
+ *
+ * Returns: (transfer full): A newly created #GoclImage, or %NULL on error
+ **/
+GoclImage *
+gocl_image_new_full (GoclContext   *context,
+                     guint          flags,
+                     gpointer       host_ptr,
+                     GoclImageType  type,
+                     guint          channel_order,
+                     guint          channel_type,
+                     gsize          width,
+                     gsize          height,
+                     gsize          depth,
+                     gsize          array_size)
 {
   GError **error;
 
@@ -414,9 +810,12 @@ gocl_image_new (GoclContext   *context,
                          "flags", flags,
                          "host-ptr", host_ptr,
                          "type", type,
-                         "width", width,
-                         "height", height,
-                         "depth", depth,
+                         "channel-order", channel_order,
+                         "channel-type", channel_type,
+                         "width", (guint64) width,
+                         "height", (guint64) height,
+                         "depth", (guint64) depth,
+                         "array-size", (guint64) array_size,
                          NULL);
 }
 
@@ -431,17 +830,51 @@ gocl_image_new (GoclContext   *context,
  * @context has been created for sharing with OpenGL, using
  * gocl_context_gpu_new_sync().
  *
+ * The texture is assumed to be a <i>GL_TEXTURE_2D</i>, and its first mipmap
+ * level is used. For other texture targets, see
+ * gocl_image_new_from_gl_texture_full().
+ *
  * Returns: (transfer full): A newly created #GoclImage, or %NULL on error
  **/
 GoclImage *
 gocl_image_new_from_gl_texture (GoclContext *context,
                                 guint        flags,
                                 guint        texture)
+{
+  return gocl_image_new_from_gl_texture_full (context,
+                                              flags,
+                                              GL_TEXTURE_2D,
+                                              0,
+                                              texture);
+}
+
+/**
+ * gocl_image_new_from_gl_texture_full:
+ * @context: The #GoclContext to create the image in
+ * @flags: An OR'ed combination of values from #GoclBufferFlags
+ * @target: The GL texture target, like <i>GL_TEXTURE_2D</i>,
+ * <i>GL_TEXTURE_3D</i> or <i>GL_TEXTURE_2D_ARRAY</i>
+ * @miplevel: The mipmap level of the texture to use
+ * @texture: The GL texture handle
+ *
+ * Creates a new image buffer from a mipmap level of a GL texture with any
+ * target. The image type, size and pixel format are taken from the texture.
+ * Same requirements as in gocl_image_new_from_gl_texture() apply.
+ *
+ * Returns: (transfer full): A newly created #GoclImage, or %NULL on error
+ **/
+GoclImage *
+gocl_image_new_from_gl_texture_full (GoclContext *context,
+                                     guint        flags,
+                                     guint        target,
+                                     gint         miplevel,
+                                     guint        texture)
 {
   GError **error;
 
   g_return_val_if_fail (GOCL_IS_CONTEXT (context), NULL);
   g_return_val_if_fail (texture > 0, NULL);
+  g_return_val_if_fail (miplevel >= 0, NULL);
 
   error = gocl_error_prepare ();
 
@@ -451,9 +884,659 @@ gocl_image_new_from_gl_texture (GoclContext *context,
                          "context", context,
                          "flags", flags,
                          "gl-texture", texture,
+                         "gl-target", target,
+                         "gl-miplevel", miplevel,
                          NULL);
 }
 
+/**
+ * gocl_image_get_channel_order:
+ * @self: The #GoclImage
+ *
+ * Retrieves the channel order of the image pixels.
+ *
+ * Returns: A value from #GoclImageChannelOrder, or any other channel order
+ * supported by the platform
+ **/
+guint
+gocl_image_get_channel_order (GoclImage *self)
+{
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), 0);
+
+  return self->priv->format.image_channel_order;
+}
+
+/**
+ * gocl_image_get_channel_type:
+ * @self: The #GoclImage
+ *
+ * Retrieves the data type of the channels of the image pixels.
+ *
+ * Returns: A value from #GoclImageChannelType
+ **/
+guint
+gocl_image_get_channel_type (GoclImage *self)
+{
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), 0);
+
+  return self->priv->format.image_channel_data_type;
+}
+
+/**
+ * gocl_image_get_element_size:
+ * @self: The #GoclImage
+ *
+ * Retrieves the size of each pixel of the image, as reported by the OpenCL
+ * platform.
+ *
+ * Returns: The size of a pixel, in bytes
+ **/
+gsize
+gocl_image_get_element_size (GoclImage *self)
+{
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), 0);
+
+  return self->priv->element_size;
+}
+
+/**
+ * gocl_image_read_sync:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: The host memory to read the pixels into
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * read, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * read, in pixels, or %NULL to read the whole image
+ * @row_pitch: The length of each row in @target_ptr, in bytes, or zero if
+ * rows are tightly packed
+ * @slice_pitch: The size of each 2D slice in @target_ptr, in bytes, or zero
+ * if slices are tightly packed
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Reads a region of the image into host memory. This call blocks the
+ * program execution until the read finishes. For a non-blocking version of
+ * this method, see gocl_image_read().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_image_read_sync (GoclImage   *self,
+                      GoclQueue   *queue,
+                      gpointer     target_ptr,
+                      const gsize *origin,
+                      const gsize *region,
+                      gsize        row_pitch,
+                      gsize        slice_pitch,
+                      GList       *event_wait_list)
+{
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (target_ptr != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  enqueue_read (self,
+                queue,
+                TRUE,
+                target_ptr,
+                origin,
+                region,
+                row_pitch,
+                slice_pitch,
+                &wait_list,
+                &err_code);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_image_read:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target_ptr: The host memory to read the pixels into
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * read, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * read, in pixels, or %NULL to read the whole image
+ * @row_pitch: The length of each row in @target_ptr, in bytes, or zero if
+ * rows are tightly packed
+ * @slice_pitch: The size of each 2D slice in @target_ptr, in bytes, or zero
+ * if slices are tightly packed
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously reads a region of the image into host memory. The contents
+ * of @target_ptr must not be accessed until the returned #GoclEvent
+ * triggers. For a blocking version of this method, see
+ * gocl_image_read_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the read
+ * finishes
+ **/
+GoclEvent *
+gocl_image_read (GoclImage   *self,
+                 GoclQueue   *queue,
+                 gpointer     target_ptr,
+                 const gsize *origin,
+                 const gsize *region,
+                 gsize        row_pitch,
+                 gsize        slice_pitch,
+                 GList       *event_wait_list)
+{
+  cl_int err_code;
+  GoclEvent *event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (target_ptr != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = enqueue_read (self,
+                        queue,
+                        FALSE,
+                        target_ptr,
+                        origin,
+                        region,
+                        row_pitch,
+                        slice_pitch,
+                        &wait_list,
+                        &err_code);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
+/**
+ * gocl_image_write_sync:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @data: The host memory to write the pixels from
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * write, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * write, in pixels, or %NULL to write the whole image
+ * @row_pitch: The length of each row in @data, in bytes, or zero if rows
+ * are tightly packed
+ * @slice_pitch: The size of each 2D slice in @data, in bytes, or zero if
+ * slices are tightly packed
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Writes host memory into a region of the image. This call blocks the
+ * program execution until the write finishes. For a non-blocking version of
+ * this method, see gocl_image_write().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_image_write_sync (GoclImage     *self,
+                       GoclQueue     *queue,
+                       gconstpointer  data,
+                       const gsize   *origin,
+                       const gsize   *region,
+                       gsize          row_pitch,
+                       gsize          slice_pitch,
+                       GList         *event_wait_list)
+{
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (data != NULL, FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  enqueue_write (self,
+                 queue,
+                 TRUE,
+                 data,
+                 origin,
+                 region,
+                 row_pitch,
+                 slice_pitch,
+                 &wait_list,
+                 &err_code);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_image_write:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @data: The host memory to write the pixels from
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * write, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * write, in pixels, or %NULL to write the whole image
+ * @row_pitch: The length of each row in @data, in bytes, or zero if rows
+ * are tightly packed
+ * @slice_pitch: The size of each 2D slice in @data, in bytes, or zero if
+ * slices are tightly packed
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously writes host memory into a region of the image. The contents
+ * of @data must not be modified until the returned #GoclEvent triggers. For
+ * a blocking version of this method, see gocl_image_write_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the write
+ * finishes
+ **/
+GoclEvent *
+gocl_image_write (GoclImage     *self,
+                  GoclQueue     *queue,
+                  gconstpointer  data,
+                  const gsize   *origin,
+                  const gsize   *region,
+                  gsize          row_pitch,
+                  gsize          slice_pitch,
+                  GList         *event_wait_list)
+{
+  cl_int err_code;
+  GoclEvent *event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (data != NULL, NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = enqueue_write (self,
+                         queue,
+                         FALSE,
+                         data,
+                         origin,
+                         region,
+                         row_pitch,
+                         slice_pitch,
+                         &wait_list,
+                         &err_code);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
+/**
+ * gocl_image_map_sync:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * map, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to map,
+ * in pixels, or %NULL to map the whole image
+ * @row_pitch: (out) (allow-none): A pointer to retrieve the length of each
+ * mapped row, in bytes, or %NULL
+ * @slice_pitch: (out) (allow-none): A pointer to retrieve the size of each
+ * mapped 2D slice, in bytes, or %NULL
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Maps a region of the image into the host address space, blocking the
+ * program execution until the operation finishes. For an asynchronous
+ * version of this method, see gocl_image_map().
+ *
+ * The mapped region must be unmapped with gocl_buffer_unmap_sync() or
+ * gocl_buffer_unmap().
+ *
+ * Returns: (transfer none): A pointer to the mapped region, or %NULL on error
+ **/
+gpointer
+gocl_image_map_sync (GoclImage   *self,
+                     GoclQueue   *queue,
+                     guint        map_flags,
+                     const gsize *origin,
+                     const gsize *region,
+                     gsize       *row_pitch,
+                     gsize       *slice_pitch,
+                     GList       *event_wait_list)
+{
+  cl_int err_code;
+  GoclEventWaitList wait_list;
+  gsize _origin[3] = {0, };
+  gsize _region[3];
+  gsize _row_pitch;
+  gsize _slice_pitch;
+  gpointer mapped_ptr;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  get_region (self, origin, region, _origin, _region);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  mapped_ptr = clEnqueueMapImage (gocl_queue_get_queue (queue),
+                                  gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                                  CL_TRUE,
+                                  map_flags,
+                                  _origin,
+                                  _region,
+                                  &_row_pitch,
+                                  &_slice_pitch,
+                                  wait_list.len,
+                                  wait_list.events,
+                                  NULL,
+                                  &err_code);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return NULL;
+
+  if (row_pitch != NULL)
+    *row_pitch = _row_pitch;
+  if (slice_pitch != NULL)
+    *slice_pitch = _slice_pitch;
+
+  return mapped_ptr;
+}
+
+/**
+ * gocl_image_map:
+ * @self: The #GoclImage
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @map_flags: An OR'ed combination of values from #GoclMapFlags
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * map, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to map,
+ * in pixels, or %NULL to map the whole image
+ * @row_pitch: (out) (allow-none): A pointer to retrieve the length of each
+ * mapped row, in bytes, or %NULL
+ * @slice_pitch: (out) (allow-none): A pointer to retrieve the size of each
+ * mapped 2D slice, in bytes, or %NULL
+ * @mapped_ptr: (out) (transfer none): A pointer to retrieve the address of
+ * the mapped region
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously maps a region of the image into the host address space.
+ * The address of the mapped region is stored in @mapped_ptr right away, but
+ * its contents must not be accessed until the returned #GoclEvent triggers.
+ * For a synchronous version of this method, see gocl_image_map_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the map
+ * operation finishes
+ **/
+GoclEvent *
+gocl_image_map (GoclImage   *self,
+                GoclQueue   *queue,
+                guint        map_flags,
+                const gsize *origin,
+                const gsize *region,
+                gsize       *row_pitch,
+                gsize       *slice_pitch,
+                gpointer    *mapped_ptr,
+                GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+  gsize _origin[3] = {0, };
+  gsize _region[3];
+  gsize _row_pitch = 0;
+  gsize _slice_pitch = 0;
+  gpointer ptr;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (mapped_ptr != NULL, NULL);
+
+  get_region (self, origin, region, _origin, _region);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  ptr = clEnqueueMapImage (gocl_queue_get_queue (queue),
+                           gocl_buffer_get_buffer (GOCL_BUFFER (self)),
+                           CL_FALSE,
+                           map_flags,
+                           _origin,
+                           _region,
+                           &_row_pitch,
+                           &_slice_pitch,
+                           wait_list.len,
+                           wait_list.events,
+                           &event,
+                           &err_code);
+
+  *mapped_ptr = err_code == CL_SUCCESS ? ptr : NULL;
+
+  if (row_pitch != NULL)
+    *row_pitch = _row_pitch;
+  if (slice_pitch != NULL)
+    *slice_pitch = _slice_pitch;
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_image_copy_to_buffer_sync:
+ * @self: The #GoclImage to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * copy, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * copy, in pixels, or %NULL to copy the whole image
+ * @dst_offset: The offset in @target to start copying to
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Copies a region of the image into @target, tightly packed, without going
+ * through host memory. This call blocks the program execution until the
+ * copy finishes. For a non-blocking version of this method, see
+ * gocl_image_copy_to_buffer().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_image_copy_to_buffer_sync (GoclImage   *self,
+                                GoclQueue   *queue,
+                                GoclBuffer  *target,
+                                const gsize *origin,
+                                const gsize *region,
+                                goffset      dst_offset,
+                                GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_to_buffer (self,
+                                     queue,
+                                     target,
+                                     origin,
+                                     region,
+                                     dst_offset,
+                                     &wait_list,
+                                     &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_image_copy_to_buffer:
+ * @self: The #GoclImage to copy from
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @target: The #GoclBuffer to copy to
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * copy, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * copy, in pixels, or %NULL to copy the whole image
+ * @dst_offset: The offset in @target to start copying to
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously copies a region of the image into @target, tightly packed,
+ * without going through host memory. For a blocking version of this method,
+ * see gocl_image_copy_to_buffer_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the copy
+ * finishes
+ **/
+GoclEvent *
+gocl_image_copy_to_buffer (GoclImage   *self,
+                           GoclQueue   *queue,
+                           GoclBuffer  *target,
+                           const gsize *origin,
+                           const gsize *region,
+                           goffset      dst_offset,
+                           GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (GOCL_IS_BUFFER (target), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_to_buffer (self,
+                                     queue,
+                                     target,
+                                     origin,
+                                     region,
+                                     dst_offset,
+                                     &wait_list,
+                                     &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_image_copy_from_buffer_sync:
+ * @self: The #GoclImage to copy to
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @source: The #GoclBuffer to copy from
+ * @src_offset: The offset in @source to start copying from
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * write, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * write, in pixels, or %NULL to write the whole image
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Copies tightly packed pixel data from @source into a region of the image,
+ * without going through host memory. This call blocks the program execution
+ * until the copy finishes. For a non-blocking version of this method, see
+ * gocl_image_copy_from_buffer().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_image_copy_from_buffer_sync (GoclImage   *self,
+                                  GoclQueue   *queue,
+                                  GoclBuffer  *source,
+                                  goffset      src_offset,
+                                  const gsize *origin,
+                                  const gsize *region,
+                                  GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (source), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_from_buffer (self,
+                                       queue,
+                                       source,
+                                       src_offset,
+                                       origin,
+                                       region,
+                                       &wait_list,
+                                       &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_image_copy_from_buffer:
+ * @self: The #GoclImage to copy to
+ * @queue: A #GoclQueue where the operation will be enqueued
+ * @source: The #GoclBuffer to copy from
+ * @src_offset: The offset in @source to start copying from
+ * @origin: (array fixed-size=3) (allow-none): The origin of the region to
+ * write, in pixels, or %NULL to start at the first pixel
+ * @region: (array fixed-size=3) (allow-none): The size of the region to
+ * write, in pixels, or %NULL to write the whole image
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List or #GoclEvent
+ * object to wait for, or %NULL
+ *
+ * Asynchronously copies tightly packed pixel data from @source into a region
+ * of the image, without going through host memory. For a blocking version of
+ * this method, see gocl_image_copy_from_buffer_sync().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when the copy
+ * finishes
+ **/
+GoclEvent *
+gocl_image_copy_from_buffer (GoclImage   *self,
+                             GoclQueue   *queue,
+                             GoclBuffer  *source,
+                             goffset      src_offset,
+                             const gsize *origin,
+                             const gsize *region,
+                             GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_IMAGE (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+  g_return_val_if_fail (GOCL_IS_BUFFER (source), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  err_code = enqueue_copy_from_buffer (self,
+                                       queue,
+                                       source,
+                                       src_offset,
+                                       origin,
+                                       region,
+                                       &wait_list,
+                                       &event);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
 #ifdef HAS_COGL
 
 /**
@@ -55,6 +55,90 @@ struct _GoclImageClass
 
 GType                  gocl_image_get_type                   (void) G_GNUC_CONST;
 
+guint                  gocl_image_get_channel_order          (GoclImage *self);
+guint                  gocl_image_get_channel_type           (GoclImage *self);
+gsize                  gocl_image_get_element_size           (GoclImage *self);
+
+gboolean               gocl_image_read_sync                  (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              gpointer     target_ptr,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              gsize        row_pitch,
+                                                              gsize        slice_pitch,
+                                                              GList       *event_wait_list);
+GoclEvent *            gocl_image_read                       (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              gpointer     target_ptr,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              gsize        row_pitch,
+                                                              gsize        slice_pitch,
+                                                              GList       *event_wait_list);
+gboolean               gocl_image_write_sync                 (GoclImage     *self,
+                                                              GoclQueue     *queue,
+                                                              gconstpointer  data,
+                                                              const gsize   *origin,
+                                                              const gsize   *region,
+                                                              gsize          row_pitch,
+                                                              gsize          slice_pitch,
+                                                              GList         *event_wait_list);
+GoclEvent *            gocl_image_write                      (GoclImage     *self,
+                                                              GoclQueue     *queue,
+                                                              gconstpointer  data,
+                                                              const gsize   *origin,
+                                                              const gsize   *region,
+                                                              gsize          row_pitch,
+                                                              gsize          slice_pitch,
+                                                              GList         *event_wait_list);
+
+gpointer               gocl_image_map_sync                   (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              guint        map_flags,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              gsize       *row_pitch,
+                                                              gsize       *slice_pitch,
+                                                              GList       *event_wait_list);
+GoclEvent *            gocl_image_map                        (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              guint        map_flags,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              gsize       *row_pitch,
+                                                              gsize       *slice_pitch,
+                                                              gpointer    *mapped_ptr,
+                                                              GList       *event_wait_list);
+
+gboolean               gocl_image_copy_to_buffer_sync        (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              GoclBuffer  *target,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              goffset      dst_offset,
+                                                              GList       *event_wait_list);
+GoclEvent *            gocl_image_copy_to_buffer             (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              GoclBuffer  *target,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              goffset      dst_offset,
+                                                              GList       *event_wait_list);
+gboolean               gocl_image_copy_from_buffer_sync      (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              GoclBuffer  *source,
+                                                              goffset      src_offset,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              GList       *event_wait_list);
+GoclEvent *            gocl_image_copy_from_buffer           (GoclImage   *self,
+                                                              GoclQueue   *queue,
+                                                              GoclBuffer  *source,
+                                                              goffset      src_offset,
+                                                              const gsize *origin,
+                                                              const gsize *region,
+                                                              GList       *event_wait_list);
+
 G_END_DECLS
 
 #endif /* __GOCL_IMAGE_H__ */
@@ -29,21 +29,49 @@
  * function.
  *
  * A #GoclKernel is not created directly. Instead, it is obtained from a
- * #GoclProgram by calling gocl_program_get_kernel() method.
+ * #GoclProgram by calling gocl_program_get_kernel() method. The exception
+ * are kernels run only on the host, created with gocl_kernel_new_host().
  *
  * Before a kernel object can be executed, all its arguments must be set.
  * Several methods are provided for this purpose, and depending on the type
  * of the argument to set, one or other is used.
  * gocl_kernel_set_argument(), gocl_kernel_set_argument_int32() and
  * gocl_kernel_set_argument_buffer() are examples of such methods.
- * More will be added soon.
+ * OpenCL vector types, like <i>float4</i> or <i>int2</i>, are set with
+ * gocl_kernel_set_argument_float_vector() and the other <i>_vector</i>
+ * methods, and half precision values with gocl_kernel_set_argument_half().
+ * Pointers into shared virtual memory are set with
+ * gocl_kernel_set_argument_svm().
+ * Arguments can also be set by name, with gocl_kernel_set_argument_by_name()
+ * and gocl_kernel_set_argument_buffer_by_name().
+ *
+ * When a kernel is created, the names, types and address spaces of its
+ * arguments are retrieved from OpenCL. This information is used to validate
+ * the values passed to the setter methods, and each argument remembers its
+ * last value, so that setting it again to the same value is skipped. This
+ * makes it cheap to rebind all arguments before every execution.
  *
  * Once all arguments are set, the kernel is ready to be executed on a device.
  * For this, the gocl_kernel_run_in_device() is used for non-blocking execution,
  * and gocl_kernel_run_in_device_sync() for a blocking version. Notice that
- * these methods will use the device's default command queue. In the future,
- * methods will be provided to run the kernel on arbitrary command queues
- * as well.
+ * these methods pick the command queue with gocl_device_get_compute_queue().
+ * To run the kernel on an arbitrary command queue, use
+ * gocl_kernel_run_in_queue() and gocl_kernel_run_in_queue_sync() instead.
+ *
+ * To use every device of a multi-device context at once,
+ * gocl_kernel_run_across_devices() splits the global work size across all
+ * the devices, weighted by their number of compute units, and returns
+ * a single #GoclEvent that triggers when every share has finished.
+ *
+ * The local work size can be tuned automatically for each device and
+ * global work size with gocl_kernel_autotune_sync(), or on blocking runs by
+ * enabling gocl_kernel_set_autotune().
+ *
+ * Kernels can also be executed on the host by a native C function, split
+ * across all the processors. A function is bound to a kernel with
+ * gocl_kernel_set_host_func() and called by gocl_kernel_run_on_host(), and
+ * gocl_kernel_new_host() creates kernels that only run on the host, for
+ * systems without an OpenCL CPU runtime.
  **/
 
 /**
@@ -59,10 +87,65 @@
 #include "gocl-kernel.h"
 
 #include "gocl-private.h"
+#include "gocl-error.h"
 #include "gocl-program.h"
 
+/* number of timed runs per candidate local work size, after a warm-up */
+#define AUTOTUNE_RUNS 3
+
+#define AUTOTUNE_CACHE_SUFFIX ".wg"
+
+/* host runs are split in this many chunks per thread, so that threads
+   finishing early pick up the remaining work */
+#define HOST_CHUNKS_PER_THREAD 4
+
+/* values of arguments are copied to host runs at this alignment, which
+   covers every OpenCL scalar and most vector types */
+#define HOST_ARG_ALIGNMENT 16
+#define HOST_ARG_ALIGN(size) \
+  (((size) + HOST_ARG_ALIGNMENT - 1) & ~((gsize) HOST_ARG_ALIGNMENT - 1))
+
 typedef gsize WorkSize[3];
 
+/* how missing tuned sizes are dealt with */
+typedef enum
+{
+  TUNE_NEVER,  /* only use sizes tuned before */
+  TUNE_ONCE,   /* tune, unless a previous attempt failed */
+  TUNE_ALWAYS  /* tune, even if a previous attempt failed */
+} TuneMode;
+
+typedef enum
+{
+  TUNED_STATE_UNKNOWN,
+  TUNED_STATE_FOUND,
+  TUNED_STATE_FAILED
+} TunedState;
+
+typedef struct
+{
+  TunedState state;
+  WorkSize size;
+} TunedSize;
+
+typedef struct
+{
+  gchar *name;
+  gchar *type_name;
+  cl_kernel_arg_address_qualifier address_qualifier;
+  gsize type_size;
+
+  /* last value passed to clSetKernelArg(), or to clSetKernelArgSVMPointer()
+     if @is_svm is set */
+  gboolean is_set;
+  gboolean is_svm;
+  gsize size;
+  gpointer value;
+
+  /* the object behind a buffer value, which host runs map */
+  GoclBuffer *buffer;
+} KernelArg;
+
 struct _GoclKernelPrivate
 {
   cl_kernel kernel;
@@ -73,14 +156,81 @@ struct _GoclKernelPrivate
   WorkSize global_work_size;
   WorkSize local_work_size;
   guint8 work_dim;
+
+  GPtrArray *devices;
+
+  KernelArg *args;
+  guint num_args;
+
+  gboolean autotune;
+  GHashTable *tuned;
+
+  GoclKernelHostFunc host_func;
+  gpointer host_user_data;
+  GDestroyNotify host_notify;
 };
 
+typedef struct
+{
+  GoclEvent *event;
+  GoclEventResolverFunc resolver_func;
+  guint num_pending;
+  GError *error;
+} SplitClosure;
+
+/* a buffer argument of a host run, mapped into host memory while the
+   function runs, through the default queue of the first device of its
+   context */
+typedef struct
+{
+  guint index;
+  GoclBuffer *buffer;
+  GoclDevice *device;
+  gpointer ptr;
+} HostBuffer;
+
+typedef struct
+{
+  gint ref_count;
+
+  GoclKernel *self;
+  GoclKernelHostFunc func;
+  gpointer user_data;
+
+  /* NULL for blocking runs, which are signalled through @cond instead */
+  GoclEvent *event;
+  GoclEventResolverFunc resolver_func;
+  GMutex mutex;
+  GCond cond;
+  gboolean done;
+
+  /* dependencies not triggered yet, plus one while they are being set */
+  gint pending;
+  GError *error;
+
+  guint work_dim;
+  WorkSize global_size;
+  guint split_dim;
+  gsize chunk_size;
+  gint num_chunks;
+  gint next_chunk;
+  gint chunks_left;
+
+  /* argument values, copied in the same block as the array */
+  gconstpointer *args;
+
+  HostBuffer *buffers;
+  guint num_buffers;
+  gsize buffers_mapped;
+} HostRun;
+
 /* properties */
 enum
 {
   PROP_0,
   PROP_PROGRAM,
-  PROP_NAME
+  PROP_NAME,
+  PROP_AUTOTUNE
 };
 
 static void           gocl_kernel_class_init            (GoclKernelClass *class);
@@ -91,6 +241,10 @@ static gboolean       gocl_kernel_initable_init         (GInitable     *initable
 static void           gocl_kernel_init                  (GoclKernel *self);
 static void           gocl_kernel_finalize              (GObject *obj);
 
+static void           load_arguments                     (GoclKernel *self);
+static void           free_arguments                     (GoclKernel *self);
+static void           free_tuned_size                    (gpointer data);
+
 static void           set_property                       (GObject      *obj,
                                                           guint         prop_id,
                                                           const GValue *value,
@@ -100,6 +254,10 @@ static void           get_property                       (GObject    *obj,
                                                           GValue     *value,
                                                           GParamSpec *pspec);
 
+G_LOCK_DEFINE_STATIC (host_pool);
+static GThreadPool *host_pool = NULL;
+static guint num_host_threads = 0;
+
 G_DEFINE_TYPE_WITH_CODE (GoclKernel, gocl_kernel, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
                                                 gocl_kernel_initable_iface_init));
@@ -134,6 +292,14 @@ gocl_kernel_class_init (GoclKernelClass *class)
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                         G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (obj_class, PROP_AUTOTUNE,
+                                   g_param_spec_boolean ("autotune",
+                                                         "Autotune",
+                                                         "Whether the local work size is tuned automatically",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE |
+                                                         G_PARAM_STATIC_STRINGS));
+
   g_type_class_add_private (class, sizeof (GoclKernelPrivate));
 }
 
@@ -158,6 +324,8 @@ gocl_kernel_initable_init (GInitable     *initable,
   if (gocl_error_check_opencl (err_code, error))
     return FALSE;
 
+  load_arguments (self);
+
   return TRUE;
 }
 
@@ -168,9 +336,26 @@ gocl_kernel_init (GoclKernel *self)
 
   self->priv = priv = GOCL_KERNEL_GET_PRIVATE (self);
 
+  GOCL_TRACE_OBJECT_NEW (GOCL_TRACE_OBJECT_KERNEL);
+
   priv->work_dim = 1;
-  memset (&priv->global_work_size, 0, 3);
-  memset (&priv->local_work_size, 0, 3);
+  memset (&priv->global_work_size, 0, sizeof (WorkSize));
+  memset (&priv->local_work_size, 0, sizeof (WorkSize));
+
+  priv->devices = NULL;
+
+  priv->args = NULL;
+  priv->num_args = 0;
+
+  priv->autotune = FALSE;
+  priv->tuned = g_hash_table_new_full (g_str_hash,
+                                       g_str_equal,
+                                       g_free,
+                                       free_tuned_size);
+
+  priv->host_func = NULL;
+  priv->host_user_data = NULL;
+  priv->host_notify = NULL;
 }
 
 static void
@@ -180,9 +365,24 @@ gocl_kernel_finalize (GObject *obj)
 
   g_free (self->priv->name);
 
-  g_object_unref (self->priv->program);
+  if (self->priv->program != NULL)
+    g_object_unref (self->priv->program);
+
+  if (self->priv->devices != NULL)
+    g_ptr_array_unref (self->priv->devices);
+
+  free_arguments (self);
 
-  clReleaseKernel (self->priv->kernel);
+  g_hash_table_unref (self->priv->tuned);
+
+  if (self->priv->host_notify != NULL)
+    self->priv->host_notify (self->priv->host_user_data);
+
+  /* host kernels have no OpenCL kernel */
+  if (self->priv->kernel != NULL)
+    clReleaseKernel (self->priv->kernel);
+
+  GOCL_TRACE_OBJECT_FREE (GOCL_TRACE_OBJECT_KERNEL);
 
   G_OBJECT_CLASS (gocl_kernel_parent_class)->finalize (obj);
 }
@@ -207,6 +407,10 @@ set_property (GObject      *obj,
       self->priv->name = g_value_dup_string (value);
       break;
 
+    case PROP_AUTOTUNE:
+      self->priv->autotune = g_value_get_boolean (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -233,287 +437,2961 @@ get_property (GObject    *obj,
       g_value_set_string (value, self->priv->name);
       break;
 
+    case PROP_AUTOTUNE:
+      g_value_set_boolean (value, self->priv->autotune);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
     }
 }
 
-/* public */
+static gchar *
+get_argument_info_string (GoclKernel         *self,
+                          guint               index,
+                          cl_kernel_arg_info  param)
+{
+  cl_int err_code;
+  gsize size;
+  gchar *str;
+
+  err_code = clGetKernelArgInfo (self->priv->kernel,
+                                 index,
+                                 param,
+                                 0,
+                                 NULL,
+                                 &size);
+  if (err_code != CL_SUCCESS)
+    return NULL;
+
+  str = g_malloc0 (size + 1);
+  err_code = clGetKernelArgInfo (self->priv->kernel,
+                                 index,
+                                 param,
+                                 size,
+                                 str,
+                                 NULL);
+  if (err_code != CL_SUCCESS)
+    {
+      g_free (str);
+      return NULL;
+    }
 
-/**
- * gocl_kernel_get_kernel:
- * @self: The #GoclKernel
- *
- * Retrieves the internal OpenCL #cl_kernel object. This is not normally
- * called by applications. It is rather a low-level, internal API.
- *
- * Returns: (transfer none) (type guint64): The internal #cl_kernel object
- **/
-cl_kernel
-gocl_kernel_get_kernel (GoclKernel *self)
+  return str;
+}
+
+/* returns the size of a private argument of type @type_name, or 0 if it
+   is not a scalar or vector type we know about */
+static gsize
+get_type_size (const gchar *type_name)
 {
-  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  static const struct
+  {
+    const gchar *name;
+    gsize size;
+  } types[] = {
+    { "char",   1 }, { "uchar",  1 },
+    { "short",  2 }, { "ushort", 2 }, { "half", 2 },
+    { "int",    4 }, { "uint",   4 }, { "float", 4 },
+    { "long",   8 }, { "ulong",  8 }, { "double", 8 },
+    { "sampler_t", sizeof (cl_sampler) }
+  };
+  guint i;
+
+  if (type_name == NULL)
+    return 0;
+
+  for (i = 0; i < G_N_ELEMENTS (types); i++)
+    {
+      gsize len;
+      guint64 width;
+      gchar *end;
+
+      len = strlen (types[i].name);
+      if (strncmp (type_name, types[i].name, len) != 0)
+        continue;
+
+      if (type_name[len] == '\0')
+        return types[i].size;
+
+      /* vector types, where 3-component vectors take the size of 4 */
+      width = g_ascii_strtoull (type_name + len, &end, 10);
+      if (*end != '\0')
+        continue;
+
+      switch (width)
+        {
+        case 2: case 4: case 8: case 16:
+          return types[i].size * width;
+        case 3:
+          return types[i].size * 4;
+        default:
+          return 0;
+        }
+    }
 
-  return self->priv->kernel;
+  return 0;
 }
 
-/**
- * gocl_kernel_set_argument:
- * @self: The #GoclKernel
- * @index: The index of this argument in the kernel function
- * @size: The size of @buffer, in bytes
- * @buffer: A pointer to an arbitrary block of memory
- *
- * Sets the value of the kernel argument at @index, as an arbitrary block of
- * memory.
- *
- * Returns: %TRUE on success, %FALSE on error
- **/
-gboolean
-gocl_kernel_set_argument (GoclKernel      *self,
-                          guint            index,
-                          gsize            size,
-                          const gpointer  *buffer)
+/* argument info is optional in OpenCL, so any failure here just leaves
+   the information unknown and disables the corresponding checks. Programs
+   built for OpenCL 1.1 devices have none, and are not even queried */
+static void
+load_arguments (GoclKernel *self)
 {
   cl_int err_code;
+  cl_uint num_args;
+  guint i;
 
-  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  err_code = clGetKernelInfo (self->priv->kernel,
+                              CL_KERNEL_NUM_ARGS,
+                              sizeof (cl_uint),
+                              &num_args,
+                              NULL);
+  if (err_code != CL_SUCCESS || num_args == 0)
+    return;
 
-  err_code = clSetKernelArg (self->priv->kernel,
-                             index,
-                             size,
-                             buffer);
+  self->priv->num_args = num_args;
+  self->priv->args = g_new0 (KernelArg, num_args);
 
-  return ! gocl_error_check_opencl_internal (err_code);
+  if (! gocl_program_has_kernel_arg_info (self->priv->program))
+    return;
+
+  for (i = 0; i < num_args; i++)
+    {
+      KernelArg *arg = &self->priv->args[i];
+
+      arg->name = get_argument_info_string (self, i, CL_KERNEL_ARG_NAME);
+      arg->type_name = get_argument_info_string (self,
+                                                 i,
+                                                 CL_KERNEL_ARG_TYPE_NAME);
+
+      err_code = clGetKernelArgInfo (self->priv->kernel,
+                                     i,
+                                     CL_KERNEL_ARG_ADDRESS_QUALIFIER,
+                                     sizeof (cl_kernel_arg_address_qualifier),
+                                     &arg->address_qualifier,
+                                     NULL);
+      if (err_code != CL_SUCCESS)
+        arg->address_qualifier = 0;
+
+      if (arg->address_qualifier == CL_KERNEL_ARG_ADDRESS_PRIVATE)
+        arg->type_size = get_type_size (arg->type_name);
+    }
 }
 
-/**
- * gocl_kernel_set_argument_int32:
- * @self: The #GoclKernel
- * @index: The index of this argument in the kernel function
- * @num_elements: The number of int32 elements in @buffer
- * @buffer: (array length=num_elements) (element-type guint32): Array of int32
- * values
- *
- * Sets the value of the kernel argument at @index, as an array of int32.
- *
- * Returns: %TRUE on success, %FALSE on error
- **/
-gboolean
-gocl_kernel_set_argument_int32 (GoclKernel  *self,
-                                guint        index,
-                                gsize        num_elements,
-                                gint32      *buffer)
+static void
+free_arguments (GoclKernel *self)
 {
-  return gocl_kernel_set_argument (self,
-                                   index,
-                                   sizeof (cl_uint) * num_elements,
-                                   (const gpointer) buffer);
+  guint i;
+
+  for (i = 0; i < self->priv->num_args; i++)
+    {
+      g_free (self->priv->args[i].name);
+      g_free (self->priv->args[i].type_name);
+      g_free (self->priv->args[i].value);
+      if (self->priv->args[i].buffer != NULL)
+        g_object_unref (self->priv->args[i].buffer);
+    }
+
+  g_free (self->priv->args);
+  self->priv->args = NULL;
+  self->priv->num_args = 0;
 }
 
-/**
- * gocl_kernel_set_argument_float:
- * @self: The #GoclKernel
- * @index: The index of this argument in the kernel function
- * @num_elements: The number of float elements in @buffer
- * @buffer: (array length=num_elements) (element-type gfloat): Array of float
- * values
- *
- * Sets the value of the kernel argument at @index, as an array of floats.
- *
- * Returns: %TRUE on success, %FALSE on error
- **/
-gboolean
-gocl_kernel_set_argument_float (GoclKernel  *self,
-                                guint        index,
-                                gsize        num_elements,
-                                gfloat      *buffer)
+static void
+free_tuned_size (gpointer data)
 {
-  return gocl_kernel_set_argument (self,
-                                   index,
-                                   sizeof (cl_float) * num_elements,
-                                   (const gpointer) buffer);
+  g_slice_free (TunedSize, data);
 }
 
-/**
- * gocl_kernel_set_argument_buffer:
- * @self: The #GoclKernel
- * @index: The index of this argument in the kernel function
- * @buffer: A #GoclBuffer
- *
- * Sets the value of the kernel argument at @index, as a buffer object.
- *
- * Returns: %TRUE on success, %FALSE on error
- **/
-gboolean
-gocl_kernel_set_argument_buffer (GoclKernel  *self,
-                                 guint        index,
-                                 GoclBuffer  *buffer)
+/* checks a value against the argument's address space and type. Returns
+   CL_SUCCESS if the value is acceptable, or if nothing is known about the
+   argument */
+static cl_int
+check_argument (KernelArg *arg, gsize size, gconstpointer value)
 {
-  cl_int err_code;
-  cl_mem buf;
+  switch (arg->address_qualifier)
+    {
+    case CL_KERNEL_ARG_ADDRESS_LOCAL:
+      if (value != NULL || size == 0)
+        return CL_INVALID_ARG_VALUE;
+      break;
 
-  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+    case CL_KERNEL_ARG_ADDRESS_GLOBAL:
+    case CL_KERNEL_ARG_ADDRESS_CONSTANT:
+      if (size != sizeof (cl_mem))
+        return CL_INVALID_ARG_SIZE;
+      break;
 
-  buf = gocl_buffer_get_buffer (buffer);
+    case CL_KERNEL_ARG_ADDRESS_PRIVATE:
+      if (value == NULL)
+        return CL_INVALID_ARG_VALUE;
+      if (arg->type_size != 0 && size != arg->type_size)
+        return CL_INVALID_ARG_SIZE;
+      break;
 
-  err_code = clSetKernelArg (self->priv->kernel,
-                             index,
-                             sizeof (cl_mem),
-                             &buf);
+    default:
+      break;
+    }
 
-  return ! gocl_error_check_opencl_internal (err_code);
+  return CL_SUCCESS;
 }
 
-/**
- * gocl_kernel_run_in_device_sync:
- * @self: The #GoclKernel
- * @device: A #GoclDevice to run the kernel on
- * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
- * events to wait for, or %NULL
- *
- * Runs the kernel on the specified device, blocking the program
- * until the kernel execution finishes. For non-blocking version,
- * gocl_kernel_run_in_device() is provided.
- *
- * If @event_wait_list is provided, the kernel execution will start
- * only when all the events in the list have triggered.
- *
- * Returns: %TRUE on success, %FALSE on error
- **/
-gboolean
-gocl_kernel_run_in_device_sync (GoclKernel  *self,
-                                GoclDevice  *device,
-                                GList       *event_wait_list)
+static gboolean
+argument_is_cached (KernelArg *arg, gsize size, gconstpointer value)
 {
-  cl_int err_code;
-  cl_event event;
-  GoclQueue *queue;
-  cl_command_queue _queue;
-  cl_event *_event_wait_list = NULL;
-
-  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
-  g_return_val_if_fail (GOCL_IS_DEVICE (device), FALSE);
-
-  queue = gocl_device_get_default_queue (device);
-  if (queue == NULL)
+  if (! arg->is_set || arg->is_svm || arg->size != size)
     return FALSE;
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list, NULL);
-
-  _queue = gocl_queue_get_queue (queue);
+  if (value == NULL || arg->value == NULL)
+    return value == arg->value;
 
-  err_code =
-    clEnqueueNDRangeKernel (_queue,
-                            self->priv->kernel,
-                            self->priv->work_dim,
-                            NULL,
-                            self->priv->global_work_size[0] == 0 ?
-                              NULL : (gsize *) &self->priv->global_work_size,
-                            self->priv->local_work_size[0] == 0 ?
-                              NULL : (gsize *) &self->priv->local_work_size,
-                            g_list_length (event_wait_list),
-                            _event_wait_list,
-                            &event);
-  g_free (_event_wait_list);
+  return memcmp (arg->value, value, size) == 0;
+}
 
-  if (gocl_error_check_opencl_internal (err_code))
-    return FALSE;
+static void
+cache_argument (KernelArg *arg, gsize size, gconstpointer value)
+{
+  if (arg->buffer != NULL)
+    {
+      g_object_unref (arg->buffer);
+      arg->buffer = NULL;
+    }
 
-  clWaitForEvents (1, &event);
-  clReleaseEvent (event);
+  arg->is_set = TRUE;
+  arg->is_svm = FALSE;
+  arg->size = size;
 
-  return TRUE;
+  if (value == NULL)
+    {
+      g_free (arg->value);
+      arg->value = NULL;
+    }
+  else
+    {
+      arg->value = g_realloc (arg->value, size);
+      memcpy (arg->value, value, size);
+    }
 }
 
-/**
- * gocl_kernel_run_in_device:
- * @self: The #GoclKernel
- * @device: A #GoclDevice to run the kernel on
- * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
- * events to wait for, or %NULL
- *
- * Runs the kernel on the specified device, asynchronously. A #GoclEvent
- * is returned, and can be used to get notified when the execution finishes,
- * or as wait event input to other operations on the device.
- *
- * If @event_wait_list is provided, the kernel execution will start
- * only when all the events in the list have triggered.
- *
- * Returns: (transfer none): A #GoclEvent to get notified when execution
- * finishes
- **/
-GoclEvent *
-gocl_kernel_run_in_device (GoclKernel *self,
-                           GoclDevice *device,
-                           GList      *event_wait_list)
+/* the largest work-group any candidate may use on @device */
+static gsize
+get_max_local_size (GoclKernel *self, GoclDevice *device, WorkSize item_sizes)
 {
-  GError *error = NULL;
-
   cl_int err_code;
-  cl_event event;
-  GoclQueue *queue = NULL;
-  cl_command_queue _queue;
+  gsize kernel_max = 0;
+  gsize device_max;
+
+  device_max = gocl_device_get_max_work_group_size (device);
+
+  err_code = clGetKernelWorkGroupInfo (self->priv->kernel,
+                                       gocl_device_get_id (device),
+                                       CL_KERNEL_WORK_GROUP_SIZE,
+                                       sizeof (gsize),
+                                       &kernel_max,
+                                       NULL);
+  if (err_code != CL_SUCCESS || kernel_max == 0)
+    kernel_max = device_max;
+
+  memcpy (item_sizes,
+          gocl_device_get_info (device)->max_work_item_sizes,
+          sizeof (WorkSize));
+  if (item_sizes[0] == 0)
+    {
+      item_sizes[0] = kernel_max;
+      item_sizes[1] = kernel_max;
+      item_sizes[2] = kernel_max;
+    }
 
-  GoclEvent *_event = NULL;
-  GoclEventResolverFunc resolver_func;
+  return MIN (kernel_max, device_max);
+}
 
-  cl_event *_event_wait_list = NULL;
-  guint event_wait_list_len;
+/* candidates are power-of-two sizes on each dimension that divide the
+   global size, plus the implementation's own choice (all zeros) */
+static GArray *
+get_candidates (GoclKernel *self, GoclDevice *device)
+{
+  GArray *candidates;
+  WorkSize item_sizes;
+  WorkSize size = { 0, };
+  gsize max_size;
+  gsize x, y, z;
+  guint dim;
 
-  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
-  g_return_val_if_fail (GOCL_IS_DEVICE (device), FALSE);
+  candidates = g_array_new (FALSE, FALSE, sizeof (WorkSize));
+  g_array_append_val (candidates, size);
 
-  _event_wait_list = gocl_event_list_to_array (event_wait_list,
-                                               &event_wait_list_len);
+  max_size = get_max_local_size (self, device, item_sizes);
+  dim = self->priv->work_dim;
 
-  queue = gocl_device_get_default_queue (device);
-  if (queue == NULL)
-    goto out;
+  for (x = 1; x <= item_sizes[0] && x <= max_size; x <<= 1)
+    {
+      if (self->priv->global_work_size[0] % x != 0)
+        continue;
+
+      for (y = 1; y <= (dim > 1 ? item_sizes[1] : 1) && x * y <= max_size; y <<= 1)
+        {
+          if (dim > 1 && self->priv->global_work_size[1] % y != 0)
+            continue;
+
+          for (z = 1; z <= (dim > 2 ? item_sizes[2] : 1) && x * y * z <= max_size; z <<= 1)
+            {
+              if (dim > 2 && self->priv->global_work_size[2] % z != 0)
+                continue;
+
+              size[0] = x;
+              size[1] = dim > 1 ? y : 0;
+              size[2] = dim > 2 ? z : 0;
+              g_array_append_val (candidates, size);
+            }
+        }
+    }
+
+  return candidates;
+}
+
+/* enqueues an execution of the kernel with the given work sizes. A
+   @local_work_size of zeros leaves the choice to OpenCL */
+static cl_int
+enqueue_kernel (GoclKernel       *self,
+                cl_command_queue  queue,
+                const gsize      *global_work_offset,
+                const gsize      *global_work_size,
+                const gsize      *local_work_size,
+                guint             num_events,
+                const cl_event   *event_wait_list,
+                cl_event         *event)
+{
+  return clEnqueueNDRangeKernel (queue,
+                                 self->priv->kernel,
+                                 self->priv->work_dim,
+                                 global_work_offset,
+                                 global_work_size[0] == 0 ?
+                                   NULL : global_work_size,
+                                 local_work_size[0] == 0 ?
+                                   NULL : local_work_size,
+                                 num_events,
+                                 num_events > 0 ? event_wait_list : NULL,
+                                 event);
+}
+
+/* returns the shortest execution time of the kernel with @local_work_size,
+   or G_MAXUINT64 if it cannot run with it */
+static guint64
+time_local_work_size (GoclKernel       *self,
+                      cl_command_queue  queue,
+                      const gsize      *local_work_size)
+{
+  guint64 best = G_MAXUINT64;
+  guint i;
+
+  for (i = 0; i <= AUTOTUNE_RUNS; i++)
+    {
+      cl_int err_code;
+      cl_event event;
+      cl_ulong start, end;
+
+      err_code = enqueue_kernel (self,
+                                 queue,
+                                 NULL,
+                                 self->priv->global_work_size,
+                                 local_work_size,
+                                 0,
+                                 NULL,
+                                 &event);
+      if (err_code != CL_SUCCESS)
+        return G_MAXUINT64;
+
+      err_code = clWaitForEvents (1, &event);
+
+      /* the first run is a warm-up */
+      if (err_code == CL_SUCCESS && i > 0)
+        {
+          err_code = clGetEventProfilingInfo (event,
+                                              CL_PROFILING_COMMAND_START,
+                                              sizeof (cl_ulong),
+                                              &start,
+                                              NULL);
+          if (err_code == CL_SUCCESS)
+            err_code = clGetEventProfilingInfo (event,
+                                                CL_PROFILING_COMMAND_END,
+                                                sizeof (cl_ulong),
+                                                &end,
+                                                NULL);
+          if (err_code == CL_SUCCESS)
+            best = MIN (best, end - start);
+        }
+
+      clReleaseEvent (event);
+
+      if (err_code != CL_SUCCESS)
+        return G_MAXUINT64;
+    }
+
+  return best;
+}
+
+static gboolean
+tune_local_work_size (GoclKernel *self, GoclDevice *device, WorkSize best)
+{
+  GoclQueue *queue;
+  GArray *candidates;
+  guint64 best_time = G_MAXUINT64;
+  guint i;
+
+  queue = gocl_queue_new (device, GOCL_QUEUE_FLAGS_PROFILING);
+  if (queue == NULL)
+    return FALSE;
+
+  candidates = get_candidates (self, device);
+  for (i = 0; i < candidates->len; i++)
+    {
+      gsize *candidate = g_array_index (candidates, WorkSize, i);
+      guint64 time;
+
+      time = time_local_work_size (self,
+                                   gocl_queue_get_queue (queue),
+                                   candidate);
+      if (time < best_time)
+        {
+          best_time = time;
+          memcpy (best, candidate, sizeof (WorkSize));
+        }
+    }
+
+  g_array_unref (candidates);
+  g_object_unref (queue);
+
+  return best_time != G_MAXUINT64;
+}
+
+static gchar *
+get_autotune_key (GoclKernel *self, GoclDevice *device)
+{
+  GChecksum *checksum;
+  gchar *global_size;
+  gchar *key;
+
+  checksum = gocl_cache_checksum_new (gocl_device_get_id (device));
+  gocl_cache_checksum_add_string (checksum,
+                                  gocl_program_get_source (self->priv->program));
+  gocl_cache_checksum_add_string (checksum, self->priv->name);
+
+  /* variants of a program share its source, but not their build options */
+  gocl_cache_checksum_add_string (checksum,
+                                  gocl_program_get_build_options (self->priv->program));
+
+  global_size = g_strdup_printf ("%u:%" G_GSIZE_FORMAT ":%" G_GSIZE_FORMAT ":%" G_GSIZE_FORMAT,
+                                 self->priv->work_dim,
+                                 self->priv->global_work_size[0],
+                                 self->priv->global_work_size[1],
+                                 self->priv->global_work_size[2]);
+  gocl_cache_checksum_add_string (checksum, global_size);
+  g_free (global_size);
+
+  key = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+
+  return key;
+}
+
+/* blocks until every event in @wait_list completes, so that tuning runs
+   on the inputs the kernel execution was meant to see */
+static gboolean
+wait_for_dependencies (const GoclEventWaitList *wait_list)
+{
+  guint i;
+
+  if (wait_list == NULL)
+    return TRUE;
+
+  for (i = 0; i < wait_list->len; i++)
+    if (! gocl_event_wait (wait_list->gocl_events[i]))
+      return FALSE;
+
+  return TRUE;
+}
+
+/* looks up the tuned local work size for @device and the current global
+   work size, in memory first, then on disk. Depending on @mode, tunes it
+   if it is not found, after the events in @wait_list have completed.
+   Failed attempts are remembered, and only retried with TUNE_ALWAYS */
+static gboolean
+get_tuned_local_work_size (GoclKernel              *self,
+                           GoclDevice              *device,
+                           TuneMode                 mode,
+                           const GoclEventWaitList *wait_list,
+                           WorkSize                 size)
+{
+  gchar *key;
+  TunedSize *tuned;
+  guint64 *data;
+  gsize data_size;
+  guint64 stored[3];
+
+  key = get_autotune_key (self, device);
+
+  tuned = g_hash_table_lookup (self->priv->tuned, key);
+  if (tuned == NULL)
+    {
+      tuned = g_slice_new0 (TunedSize);
+      tuned->state = TUNED_STATE_UNKNOWN;
+
+      /* the on-disk cache is only checked once */
+      data = gocl_cache_load (key, AUTOTUNE_CACHE_SUFFIX, &data_size);
+      if (data != NULL && data_size == sizeof (stored))
+        {
+          tuned->state = TUNED_STATE_FOUND;
+          tuned->size[0] = data[0];
+          tuned->size[1] = data[1];
+          tuned->size[2] = data[2];
+        }
+      g_free (data);
+
+      /* the hash table takes ownership of the key */
+      g_hash_table_insert (self->priv->tuned, key, tuned);
+    }
+  else
+    {
+      g_free (key);
+      key = NULL;
+    }
+
+  if (tuned->state == TUNED_STATE_FOUND)
+    {
+      memcpy (size, tuned->size, sizeof (WorkSize));
+      return TRUE;
+    }
+
+  if (mode == TUNE_NEVER ||
+      (mode == TUNE_ONCE && tuned->state == TUNED_STATE_FAILED))
+    {
+      return FALSE;
+    }
+
+  /* a failed dependency is not a failure of the tuning itself */
+  if (! wait_for_dependencies (wait_list))
+    return FALSE;
+
+  if (! tune_local_work_size (self, device, size))
+    {
+      tuned->state = TUNED_STATE_FAILED;
+      return FALSE;
+    }
+
+  tuned->state = TUNED_STATE_FOUND;
+  memcpy (tuned->size, size, sizeof (WorkSize));
+
+  stored[0] = size[0];
+  stored[1] = size[1];
+  stored[2] = size[2];
+  key = get_autotune_key (self, device);
+  gocl_cache_save (key, AUTOTUNE_CACHE_SUFFIX, stored, sizeof (stored));
+  g_free (key);
+
+  return TRUE;
+}
+
+/* fills @local_work_size with the size a run on @device uses: the tuned
+   one if autotune is enabled and one is known for the current global work
+   size, or the one set by the application otherwise. The kernel's own
+   local work size is never replaced, so a tuned size never outlives the
+   global work size it was found for. Asynchronous runs use TUNE_NEVER, so
+   they never execute the kernel behind the caller's back nor block */
+static void
+get_run_local_work_size (GoclKernel              *self,
+                         GoclDevice              *device,
+                         TuneMode                 mode,
+                         const GoclEventWaitList *wait_list,
+                         WorkSize                 local_work_size)
+{
+  WorkSize size;
+
+  memcpy (local_work_size, self->priv->local_work_size, sizeof (WorkSize));
+
+  if (! self->priv->autotune || self->priv->global_work_size[0] == 0)
+    return;
+
+  if (get_tuned_local_work_size (self, device, mode, wait_list, size))
+    memcpy (local_work_size, size, sizeof (WorkSize));
+}
+
+static cl_int
+enqueue_ndrange (GoclKernel              *self,
+                 GoclQueue               *queue,
+                 const gsize             *global_work_offset,
+                 const gsize             *global_work_size,
+                 const gsize             *local_work_size,
+                 const GoclEventWaitList *wait_list,
+                 cl_event                *event)
+{
+  cl_command_queue _queue;
 
   _queue = gocl_queue_get_queue (queue);
+  if (_queue == NULL)
+    return CL_INVALID_COMMAND_QUEUE;
+
+  return enqueue_kernel (self,
+                         _queue,
+                         global_work_offset,
+                         global_work_size,
+                         local_work_size,
+                         wait_list->len,
+                         wait_list->events,
+                         event);
+}
+
+static guint
+get_num_host_threads (void)
+{
+  G_LOCK (host_pool);
+
+  if (num_host_threads == 0)
+    {
+#if GLIB_CHECK_VERSION (2, 36, 0)
+      num_host_threads = g_get_num_processors ();
+#else
+      num_host_threads = 1;
+#endif
+    }
+
+  G_UNLOCK (host_pool);
+
+  return num_host_threads;
+}
+
+static HostRun *
+host_run_ref (HostRun *run)
+{
+  g_atomic_int_inc (&run->ref_count);
+
+  return run;
+}
+
+static void
+host_run_unref (HostRun *run)
+{
+  guint i;
+
+  if (! g_atomic_int_dec_and_test (&run->ref_count))
+    return;
+
+  if (run->event != NULL)
+    g_object_unref (run->event);
+
+  if (run->error != NULL)
+    g_error_free (run->error);
+
+  g_mutex_clear (&run->mutex);
+  g_cond_clear (&run->cond);
+
+  for (i = 0; i < run->num_buffers; i++)
+    {
+      g_object_unref (run->buffers[i].buffer);
+      if (run->buffers[i].device != NULL)
+        g_object_unref (run->buffers[i].device);
+    }
+  g_free (run->buffers);
+
+  g_free (run->args);
+  g_object_unref (run->self);
+
+  g_slice_free (HostRun, run);
+}
+
+/* checks that @self can run on the host with its current work size */
+static cl_int
+check_host_run (GoclKernel *self)
+{
+  guint i;
+
+  if (self->priv->host_func == NULL)
+    return CL_INVALID_OPERATION;
+
+  for (i = 0; i < self->priv->work_dim; i++)
+    if (self->priv->global_work_size[i] == 0)
+      return CL_INVALID_GLOBAL_WORK_SIZE;
+
+  return CL_SUCCESS;
+}
+
+/* copies the current argument values, so that arguments can be changed
+   for the next run while this one executes. Buffers are left out, since
+   they are passed as their mapped memory */
+static gconstpointer *
+copy_host_arguments (GoclKernel *self)
+{
+  gconstpointer *args;
+  gsize size;
+  guint8 *values;
+  guint i;
+
+  size = HOST_ARG_ALIGN (sizeof (gconstpointer) * self->priv->num_args);
+  for (i = 0; i < self->priv->num_args; i++)
+    if (self->priv->args[i].is_set
+        && self->priv->args[i].value != NULL
+        && self->priv->args[i].buffer == NULL)
+      size += HOST_ARG_ALIGN (self->priv->args[i].size);
+
+  args = g_malloc0 (MAX (size, 1));
+  values = (guint8 *) args +
+    HOST_ARG_ALIGN (sizeof (gconstpointer) * self->priv->num_args);
+
+  /* arguments not set, or living in local memory, are passed as NULL */
+  for (i = 0; i < self->priv->num_args; i++)
+    {
+      KernelArg *arg = &self->priv->args[i];
+
+      if (! arg->is_set || arg->value == NULL || arg->buffer != NULL)
+        continue;
+
+      memcpy (values, arg->value, arg->size);
+      args[i] = values;
+      values += HOST_ARG_ALIGN (arg->size);
+    }
+
+  return args;
+}
+
+/* takes the buffer arguments of a run, except images, which can't be
+   mapped as plain memory and are passed as NULL */
+static void
+copy_host_buffers (GoclKernel *self, HostRun *run)
+{
+  guint i;
+
+  for (i = 0; i < self->priv->num_args; i++)
+    if (self->priv->args[i].is_set
+        && self->priv->args[i].buffer != NULL
+        && ! GOCL_IS_IMAGE (self->priv->args[i].buffer))
+      run->num_buffers++;
+
+  if (run->num_buffers == 0)
+    return;
+
+  run->buffers = g_new0 (HostBuffer, run->num_buffers);
+  run->num_buffers = 0;
+
+  for (i = 0; i < self->priv->num_args; i++)
+    {
+      KernelArg *arg = &self->priv->args[i];
+      HostBuffer *buffer;
+
+      if (! arg->is_set || arg->buffer == NULL || GOCL_IS_IMAGE (arg->buffer))
+        continue;
+
+      buffer = &run->buffers[run->num_buffers++];
+      buffer->index = i;
+      buffer->buffer = g_object_ref (arg->buffer);
+    }
+}
+
+/* maps every buffer argument of @run, once its dependencies are done.
+   Returns FALSE and sets the error of @run on failure */
+static gboolean
+host_run_map_buffers (HostRun *run)
+{
+  guint i;
+
+  for (i = 0; i < run->num_buffers; i++)
+    {
+      HostBuffer *buffer = &run->buffers[i];
+      GoclQueue *queue;
+
+      buffer->device =
+        gocl_context_get_device_by_index (gocl_buffer_get_context (buffer->buffer),
+                                          0);
+      queue = buffer->device != NULL ?
+        gocl_device_get_default_queue (buffer->device) : NULL;
+
+      if (queue != NULL)
+        buffer->ptr = gocl_buffer_map_sync (buffer->buffer,
+                                            queue,
+                                            GOCL_MAP_FLAGS_READ |
+                                            GOCL_MAP_FLAGS_WRITE,
+                                            gocl_buffer_get_size (buffer->buffer),
+                                            0,
+                                            NULL);
+      else
+        gocl_error_check_opencl_internal (CL_INVALID_COMMAND_QUEUE);
+
+      if (buffer->ptr == NULL)
+        {
+          GError *error = gocl_error_get_last ();
+
+          if (! g_atomic_pointer_compare_and_exchange (&run->error, NULL, error))
+            g_error_free (error);
+
+          return FALSE;
+        }
+
+      run->args[buffer->index] = buffer->ptr;
+    }
+
+  return TRUE;
+}
+
+/* unmaps the buffers mapped by host_run_map_buffers(), blocking until the
+   device sees what the function wrote */
+static void
+host_run_unmap_buffers (HostRun *run)
+{
+  guint i;
+
+  for (i = 0; i < run->num_buffers; i++)
+    {
+      HostBuffer *buffer = &run->buffers[i];
+
+      if (buffer->ptr == NULL)
+        continue;
+
+      if (! gocl_buffer_unmap_sync (buffer->buffer,
+                                    gocl_device_get_default_queue (buffer->device),
+                                    buffer->ptr,
+                                    NULL))
+        {
+          GError *error = gocl_error_get_last ();
+
+          if (! g_atomic_pointer_compare_and_exchange (&run->error, NULL, error))
+            g_error_free (error);
+        }
+
+      buffer->ptr = NULL;
+      run->args[buffer->index] = NULL;
+    }
+}
+
+static HostRun *
+host_run_new (GoclKernel *self, GoclEvent *event)
+{
+  HostRun *run;
+  gsize total;
+  gsize granularity;
+  gsize num_groups;
+  gsize max_chunks;
+
+  run = g_slice_new0 (HostRun);
+  run->ref_count = 1;
+
+  run->self = g_object_ref (self);
+  run->func = self->priv->host_func;
+  run->user_data = self->priv->host_user_data;
+
+  if (event != NULL)
+    {
+      run->event = g_object_ref (event);
+      run->resolver_func = gocl_event_steal_resolver_func (event);
+    }
+
+  g_mutex_init (&run->mutex);
+  g_cond_init (&run->cond);
+
+  run->work_dim = self->priv->work_dim;
+  memcpy (run->global_size, self->priv->global_work_size, sizeof (WorkSize));
+  run->args = copy_host_arguments (self);
+  copy_host_buffers (self, run);
+
+  /* the outermost dimension is split, so that each chunk covers
+     contiguous rows or slices, in multiples of the local work size */
+  run->split_dim = run->work_dim - 1;
+  total = run->global_size[run->split_dim];
+  granularity = MAX (self->priv->local_work_size[run->split_dim], 1);
+  num_groups = (total + granularity - 1) / granularity;
+
+  max_chunks = (gsize) get_num_host_threads () * HOST_CHUNKS_PER_THREAD;
+  run->chunk_size =
+    ((num_groups + max_chunks - 1) / max_chunks) * granularity;
+  run->num_chunks = (total + run->chunk_size - 1) / run->chunk_size;
+  run->next_chunk = 0;
+  run->chunks_left = run->num_chunks;
+
+  return run;
+}
+
+static void
+host_run_complete (HostRun *run)
+{
+  host_run_unmap_buffers (run);
+
+  if (run->event != NULL)
+    {
+      run->resolver_func (run->event, run->error);
+      return;
+    }
+
+  g_mutex_lock (&run->mutex);
+  run->done = TRUE;
+  g_cond_broadcast (&run->cond);
+  g_mutex_unlock (&run->mutex);
+}
+
+/* runs chunks until none is left. Any thread of the pool, and the caller
+   of a blocking run, may be executing this concurrently */
+static void
+host_run_work (HostRun *run)
+{
+  gint chunk;
+
+  /* the first thread to arrive maps the buffers, while the others wait. On
+     failure no chunk is left to run, and the run completes right away */
+  if (g_once_init_enter (&run->buffers_mapped))
+    {
+      if (! host_run_map_buffers (run))
+        {
+          g_atomic_int_set (&run->next_chunk, run->num_chunks);
+          host_run_complete (run);
+        }
+
+      g_once_init_leave (&run->buffers_mapped, 1);
+    }
+
+  while ((chunk = g_atomic_int_add (&run->next_chunk, 1)) < run->num_chunks)
+    {
+      WorkSize offset = { 0, };
+      WorkSize size;
+      guint dim = run->split_dim;
+      gint64 trace_start;
+
+      memcpy (size, run->global_size, sizeof (WorkSize));
+      offset[dim] = (gsize) chunk * run->chunk_size;
+      size[dim] = MIN (run->chunk_size, run->global_size[dim] - offset[dim]);
+
+      trace_start = GOCL_TRACE_BEGIN ();
+      run->func (run->self,
+                 run->work_dim,
+                 offset,
+                 size,
+                 run->args,
+                 run->user_data);
+      GOCL_TRACE_END ("kernel", "host-chunk", run->self->priv->name,
+                      trace_start);
+
+      if (g_atomic_int_dec_and_test (&run->chunks_left))
+        host_run_complete (run);
+    }
+}
+
+static void
+host_run_in_pool (gpointer data, gpointer user_data)
+{
+  HostRun *run = data;
+
+  host_run_work (run);
+  host_run_unref (run);
+}
+
+/* hands the chunks of @run to the pool. When @num_helpers is less than
+   the number of chunks, the caller is expected to work on them too */
+static void
+host_run_dispatch (HostRun *run, guint num_helpers)
+{
+  guint i;
+
+  num_helpers = MIN (num_helpers, (guint) run->num_chunks);
+  if (num_helpers == 0)
+    return;
+
+  G_LOCK (host_pool);
+
+  if (host_pool == NULL)
+    host_pool = g_thread_pool_new (host_run_in_pool,
+                                   NULL,
+                                   num_host_threads,
+                                   FALSE,
+                                   NULL);
+
+  for (i = 0; i < num_helpers; i++)
+    g_thread_pool_push (host_pool, host_run_ref (run), NULL);
+
+  G_UNLOCK (host_pool);
+}
+
+static void
+host_run_release_pending (HostRun *run)
+{
+  if (! g_atomic_int_dec_and_test (&run->pending))
+    return;
+
+  if (run->error != NULL)
+    host_run_complete (run);
+  else
+    host_run_dispatch (run, get_num_host_threads ());
+
+  host_run_unref (run);
+}
+
+static void
+host_dependency_on_complete (GoclEvent *event,
+                             GError    *error,
+                             gpointer   user_data)
+{
+  HostRun *run = user_data;
 
-  err_code =
-    clEnqueueNDRangeKernel (_queue,
-                            self->priv->kernel,
-                            self->priv->work_dim,
-                            NULL,
-                            self->priv->global_work_size[0] == 0 ?
-                              NULL : (gsize *) &self->priv->global_work_size,
-                            self->priv->local_work_size[0] == 0 ?
-                              NULL : (gsize *) &self->priv->local_work_size,
-                            event_wait_list_len,
-                            _event_wait_list,
-                            &event);
-  g_free (_event_wait_list);
-
-  if (! gocl_error_check_opencl (err_code, &error))
-    {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             "event", event,
-                             NULL);
-      gocl_event_set_event_wait_list (_event, event_wait_list);
-      gocl_event_steal_resolver_func (_event);
-    }
-
- out:
+  /* the first failed dependency fails the run */
   if (error != NULL)
     {
-      _event = g_object_new (GOCL_TYPE_EVENT,
-                             "queue", queue,
-                             NULL);
-      resolver_func = gocl_event_steal_resolver_func (_event);
-      resolver_func (_event, error);
+      GError *_error = g_error_copy (error);
+
+      if (! g_atomic_pointer_compare_and_exchange (&run->error, NULL, _error))
+        g_error_free (_error);
+    }
+
+  host_run_release_pending (run);
+}
+
+static GoclEvent *
+run_on_host (GoclKernel *self, const GoclEventWaitList *wait_list)
+{
+  GoclEvent *event;
+  HostRun *run;
+  cl_int err_code;
+  GError *error = NULL;
+  guint i;
+
+  event = gocl_event_new_host ();
+  gocl_event_set_label (event, self->priv->name);
+  gocl_event_idle_unref (event);
+
+  err_code = check_host_run (self);
+  if (gocl_error_check_opencl (err_code, &error))
+    {
+      GoclEventResolverFunc resolver_func;
+
+      resolver_func = gocl_event_steal_resolver_func (event);
+      resolver_func (event, error);
       g_error_free (error);
+
+      return event;
+    }
+
+  run = host_run_new (self, event);
+
+  /* the reference of the run is released with the last pending count */
+  run->pending = wait_list->len + 1;
+  for (i = 0; i < wait_list->len; i++)
+    gocl_event_then (wait_list->gocl_events[i],
+                     host_dependency_on_complete,
+                     run);
+
+  host_run_release_pending (run);
+
+  return event;
+}
+
+static gboolean
+run_on_host_sync (GoclKernel *self, const GoclEventWaitList *wait_list)
+{
+  HostRun *run;
+  cl_int err_code;
+  guint i;
+
+  err_code = check_host_run (self);
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  for (i = 0; i < wait_list->len; i++)
+    if (! gocl_event_wait (wait_list->gocl_events[i]))
+      return ! gocl_error_check_opencl_internal (
+                 CL_EXEC_STATUS_ERROR_FOR_EVENTS_IN_WAIT_LIST);
+
+  run = host_run_new (self, NULL);
+
+  /* this thread takes chunks too, so blocking runs issued from a host
+     function always make progress */
+  host_run_dispatch (run, get_num_host_threads () - 1);
+  host_run_work (run);
+
+  g_mutex_lock (&run->mutex);
+  while (! run->done)
+    g_cond_wait (&run->cond, &run->mutex);
+  g_mutex_unlock (&run->mutex);
+
+  if (run->error != NULL)
+    {
+      g_propagate_error (gocl_error_prepare (), g_error_copy (run->error));
+      host_run_unref (run);
+      return FALSE;
     }
 
+  host_run_unref (run);
+
+  gocl_error_prepare ();
+
+  return TRUE;
+}
+
+static GoclEvent *
+run_in_queue (GoclKernel              *self,
+              GoclQueue               *queue,
+              const GoclEventWaitList *wait_list)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+  WorkSize local_work_size;
+  gint64 trace_start;
+
+  /* host kernels ignore the queue */
+  if (self->priv->kernel == NULL)
+    return run_on_host (self, wait_list);
+
+  get_run_local_work_size (self,
+                           gocl_queue_get_device (queue),
+                           TUNE_NEVER,
+                           NULL,
+                           local_work_size);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = enqueue_ndrange (self,
+                              queue,
+                              NULL,
+                              self->priv->global_work_size,
+                              local_work_size,
+                              wait_list,
+                              &event);
+  GOCL_TRACE_END ("kernel", "enqueue", self->priv->name, trace_start);
+
+  _event = gocl_event_new_from_result (queue, err_code, event, wait_list);
+  gocl_event_set_label (_event, self->priv->name);
   gocl_event_idle_unref (_event);
 
   return _event;
 }
 
+/* devices of the kernel's context are created once and kept, so that
+   their command queues are reused across runs */
+static GPtrArray *
+get_context_devices (GoclKernel *self)
+{
+  GoclContext *context;
+  guint num_devices;
+  guint i;
+
+  if (self->priv->devices != NULL)
+    return self->priv->devices;
+
+  context = gocl_program_get_context (self->priv->program);
+  num_devices = gocl_context_get_num_devices (context);
+
+  self->priv->devices = g_ptr_array_new_with_free_func (g_object_unref);
+  for (i = 0; i < num_devices; i++)
+    {
+      GoclDevice *device;
+
+      device = gocl_context_get_device_by_index (context, i);
+      g_ptr_array_add (self->priv->devices, device);
+    }
+
+  return self->priv->devices;
+}
+
+/* picks the devices of the kernel's context that take a share of a split
+   run, along with the compute queue each share is enqueued on. Devices
+   whose queue cannot be created are left out, so that the work is split
+   across the others instead of being dropped */
+static GPtrArray *
+get_split_devices (GoclKernel *self, GPtrArray **queues)
+{
+  GPtrArray *devices;
+  GPtrArray *split;
+  guint i;
+
+  devices = get_context_devices (self);
+
+  split = g_ptr_array_sized_new (devices->len);
+  *queues = g_ptr_array_sized_new (devices->len);
+
+  for (i = 0; i < devices->len; i++)
+    {
+      GoclDevice *device = g_ptr_array_index (devices, i);
+      GoclQueue *queue;
+
+      queue = gocl_device_get_compute_queue (device);
+      if (queue == NULL)
+        continue;
+
+      g_ptr_array_add (split, device);
+      g_ptr_array_add (*queues, queue);
+    }
+
+  return split;
+}
+
+/* splits the first dimension of the global work size across @devices,
+   proportionally to their number of compute units, and in multiples of the
+   local work size if one is set. Fills @offsets and @sizes with the share
+   of each device, which can be zero. */
+static void
+split_work_size (GoclKernel *self,
+                 GPtrArray  *devices,
+                 gsize      *offsets,
+                 gsize      *sizes)
+{
+  gsize granularity;
+  gsize num_groups;
+  gsize assigned = 0;
+  guint64 total_weight = 0;
+  guint *weights;
+  guint i;
+
+  granularity = self->priv->local_work_size[0] > 0 ?
+    self->priv->local_work_size[0] : 1;
+  num_groups = self->priv->global_work_size[0] / granularity;
+
+  weights = g_new (guint, devices->len);
+  for (i = 0; i < devices->len; i++)
+    {
+      GoclDevice *device = g_ptr_array_index (devices, i);
+
+      weights[i] = MAX (gocl_device_get_max_compute_units (device), 1);
+      total_weight += weights[i];
+    }
+
+  for (i = 0; i < devices->len; i++)
+    {
+      gsize groups;
+
+      if (i == devices->len - 1)
+        groups = num_groups - assigned;
+      else
+        groups = (gsize) ((guint64) num_groups * weights[i] / total_weight);
+
+      offsets[i] = assigned * granularity;
+      sizes[i] = groups * granularity;
+      assigned += groups;
+    }
+
+  g_free (weights);
+
+  /* whatever is left by a global size that is not a multiple of the
+     local size goes to the last device, where OpenCL will reject it
+     just as it would on a single device */
+  sizes[devices->len - 1] +=
+    self->priv->global_work_size[0] - num_groups * granularity;
+}
+
+static void
+split_share_on_complete (GoclEvent *event, GError *error, gpointer user_data)
+{
+  SplitClosure *closure = user_data;
+
+  if (error != NULL && closure->error == NULL)
+    closure->error = g_error_copy (error);
+
+  closure->num_pending--;
+  if (closure->num_pending > 0)
+    return;
+
+  closure->resolver_func (closure->event, closure->error);
+
+  if (closure->error != NULL)
+    g_error_free (closure->error);
+  g_object_unref (closure->event);
+  g_slice_free (SplitClosure, closure);
+}
+
+/* converts a float to IEEE 754 half precision, rounding to nearest even */
+static guint16
+float_to_half (gfloat value)
+{
+  union
+  {
+    gfloat f;
+    guint32 u;
+  } bits;
+  guint32 sign, mantissa;
+  gint32 exponent;
+
+  bits.f = value;
+  sign = (bits.u >> 16) & 0x8000;
+  exponent = (gint32) ((bits.u >> 23) & 0xff) - 127 + 15;
+  mantissa = bits.u & 0x7fffff;
+
+  /* infinity and NaN, keeping NaNs quiet */
+  if (((bits.u >> 23) & 0xff) == 0xff)
+    return sign | 0x7c00 | (mantissa != 0 ? 0x0200 : 0);
+
+  /* overflow to infinity */
+  if (exponent >= 0x1f)
+    return sign | 0x7c00;
+
+  /* subnormals, or underflow to zero */
+  if (exponent <= 0)
+    {
+      guint32 shift;
+      guint32 half;
+
+      if (exponent < -10)
+        return sign;
+
+      mantissa |= 0x800000;
+      shift = 14 - exponent;
+      half = mantissa >> shift;
+      if ((mantissa >> (shift - 1)) & 1
+          && ((mantissa & ((1 << (shift - 1)) - 1)) != 0 || (half & 1) != 0))
+        half++;
+
+      return sign | half;
+    }
+
+  /* normals; a carry out of the mantissa correctly bumps the exponent */
+  {
+    guint32 half;
+
+    half = ((guint32) exponent << 10) | (mantissa >> 13);
+    if ((mantissa & 0x1000) != 0 && ((mantissa & 0x2fff) != 0))
+      half++;
+
+    return sign | half;
+  }
+}
+
+/* sets an OpenCL vector argument of @width elements of @element_size bytes,
+   padding 3-component vectors to the size of 4 as OpenCL lays them out */
+static gboolean
+set_argument_vector (GoclKernel    *self,
+                     guint          index,
+                     gsize          element_size,
+                     guint          width,
+                     gconstpointer  values)
+{
+  guint8 vector[16 * sizeof (cl_double)];
+  guint padded_width;
+
+  g_return_val_if_fail (values != NULL, FALSE);
+
+  switch (width)
+    {
+    case 1: case 2: case 4: case 8: case 16:
+      padded_width = width;
+      break;
+
+    case 3:
+      padded_width = 4;
+      break;
+
+    default:
+      return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_SIZE);
+    }
+
+  memset (vector, 0, element_size * padded_width);
+  memcpy (vector, values, element_size * width);
+
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   element_size * padded_width,
+                                   (const gpointer) vector);
+}
+
+/* public */
+
+/**
+ * gocl_kernel_new_host:
+ * @name: The name of the kernel
+ * @num_args: The number of arguments of the kernel
+ * @func: (scope notified): The function that computes the kernel
+ * @user_data: (allow-none): Arbitrary data to pass to @func, or %NULL
+ * @notify: (allow-none): A function to free @user_data, or %NULL
+ *
+ * Creates a kernel that is only executed on the host, by calling @func
+ * from a pool of threads as described in gocl_kernel_run_on_host(). Host
+ * kernels do not need any OpenCL platform, which makes them a fallback for
+ * hosts without an OpenCL CPU runtime.
+ *
+ * Host kernels are used like any other #GoclKernel: arguments are set with
+ * the gocl_kernel_set_argument() family of methods, and all the run methods
+ * execute them on the host, ignoring the queue or device passed. The
+ * returned events have no #GoclQueue, so they cannot be waited for by
+ * operations on a device.
+ *
+ * Returns: (transfer full): A newly created #GoclKernel
+ **/
+GoclKernel *
+gocl_kernel_new_host (const gchar        *name,
+                      guint               num_args,
+                      GoclKernelHostFunc  func,
+                      gpointer            user_data,
+                      GDestroyNotify      notify)
+{
+  GoclKernel *self;
+
+  g_return_val_if_fail (func != NULL, NULL);
+
+  self = g_object_new (GOCL_TYPE_KERNEL,
+                       "name", name,
+                       NULL);
+
+  if (num_args > 0)
+    {
+      self->priv->num_args = num_args;
+      self->priv->args = g_new0 (KernelArg, num_args);
+    }
+
+  gocl_kernel_set_host_func (self, func, user_data, notify);
+
+  return self;
+}
+
+/**
+ * gocl_kernel_get_kernel:
+ * @self: The #GoclKernel
+ *
+ * Retrieves the internal OpenCL #cl_kernel object. This is not normally
+ * called by applications. It is rather a low-level, internal API.
+ *
+ * Returns: (transfer none) (type guint64): The internal #cl_kernel object
+ **/
+cl_kernel
+gocl_kernel_get_kernel (GoclKernel *self)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+
+  return self->priv->kernel;
+}
+
+/**
+ * gocl_kernel_get_name:
+ * @self: The #GoclKernel
+ *
+ * Retrieves the name of the kernel function.
+ *
+ * Returns: (transfer none): The kernel name, owned by the kernel
+ **/
+const gchar *
+gocl_kernel_get_name (GoclKernel *self)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+
+  return self->priv->name;
+}
+
+/**
+ * gocl_kernel_enqueue:
+ * @self: The #GoclKernel
+ * @queue: The #cl_command_queue to enqueue the execution on
+ * @global_work_offset: (allow-none): The global work offset, or %NULL
+ * @global_work_size: (allow-none): The global work size, or %NULL to use
+ * the one set with gocl_kernel_set_global_work_size()
+ * @num_events: The number of events in @event_wait_list
+ * @event_wait_list: (allow-none): Array of #cl_event to wait for, or %NULL
+ * @event: (allow-none): Return location for the #cl_event of the execution,
+ * or %NULL
+ *
+ * Enqueues an execution of the kernel using its current work dimension and
+ * local work size. This is a Gocl private function, not exposed to
+ * applications.
+ *
+ * Returns: The OpenCL error code
+ **/
+cl_int
+gocl_kernel_enqueue (GoclKernel       *self,
+                     cl_command_queue  queue,
+                     const gsize      *global_work_offset,
+                     const gsize      *global_work_size,
+                     guint             num_events,
+                     const cl_event   *event_wait_list,
+                     cl_event         *event)
+{
+  if (global_work_size == NULL)
+    global_work_size = self->priv->global_work_size;
+
+  return enqueue_kernel (self,
+                         queue,
+                         global_work_offset,
+                         global_work_size,
+                         self->priv->local_work_size,
+                         num_events,
+                         event_wait_list,
+                         event);
+}
+
+/* sets the cached arguments of @self on @kernel, another kernel object
+   for the same function */
+static cl_int
+replay_arguments (GoclKernel *self, cl_kernel kernel)
+{
+  cl_int err_code = CL_SUCCESS;
+  guint i;
+
+  for (i = 0; i < self->priv->num_args && err_code == CL_SUCCESS; i++)
+    {
+      KernelArg *arg = &self->priv->args[i];
+
+      if (! arg->is_set)
+        return CL_INVALID_KERNEL_ARGS;
+
+#ifdef CL_VERSION_2_0
+      if (arg->is_svm)
+        {
+          err_code = clSetKernelArgSVMPointer (kernel,
+                                               i,
+                                               *(gconstpointer *) arg->value);
+          continue;
+        }
+#endif
+
+      err_code = clSetKernelArg (kernel, i, arg->size, arg->value);
+    }
+
+  return err_code;
+}
+
+/**
+ * gocl_kernel_copy:
+ * @self: The #GoclKernel
+ * @err_code: (out): Return location for the OpenCL error code
+ *
+ * Creates a new #cl_kernel object for the same function as @self, with the
+ * same argument values. The copy is made with clCloneKernel() when OpenCL
+ * 2.1 is available. Otherwise, a new kernel object is created and the
+ * arguments remembered by @self are set on it, which fails with
+ * %CL_INVALID_KERNEL_ARGS if some argument was not set through Gocl. This
+ * is a Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer full): A new #cl_kernel object, or %NULL on error
+ **/
+cl_kernel
+gocl_kernel_copy (GoclKernel *self, cl_int *err_code)
+{
+  cl_kernel kernel;
+
+  if (self->priv->kernel == NULL)
+    {
+      *err_code = CL_INVALID_KERNEL;
+      return NULL;
+    }
+
+#ifdef CL_VERSION_2_1
+  kernel = clCloneKernel (self->priv->kernel, err_code);
+  if (*err_code == CL_SUCCESS)
+    return kernel;
+#endif
+
+  kernel = clCreateKernel (gocl_program_get_program (self->priv->program),
+                           self->priv->name,
+                           err_code);
+  if (*err_code != CL_SUCCESS)
+    return NULL;
+
+  *err_code = replay_arguments (self, kernel);
+  if (*err_code != CL_SUCCESS)
+    {
+      clReleaseKernel (kernel);
+      return NULL;
+    }
+
+  return kernel;
+}
+
+/**
+ * gocl_kernel_get_launch_size:
+ * @self: The #GoclKernel
+ * @device: The #GoclDevice the kernel is going to run on
+ * @work_dim: (out): Return location for the work dimension
+ * @global_work_size: (out) (array fixed-size=3): Return location for the
+ * global work size
+ * @local_work_size: (out) (array fixed-size=3): Return location for the
+ * local work size, with zeros if it is left to OpenCL
+ *
+ * Retrieves the work sizes the kernel would run with on @device, after
+ * tuning the local work size if autotune is enabled. This is a Gocl
+ * private function, not exposed to applications.
+ **/
+void
+gocl_kernel_get_launch_size (GoclKernel *self,
+                             GoclDevice *device,
+                             guint      *work_dim,
+                             gsize      *global_work_size,
+                             gsize      *local_work_size)
+{
+  get_run_local_work_size (self, device, TUNE_ONCE, NULL, local_work_size);
+
+  *work_dim = self->priv->work_dim;
+  memcpy (global_work_size, self->priv->global_work_size, sizeof (WorkSize));
+}
+
+/**
+ * gocl_kernel_set_argument:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @size: The size of @buffer, in bytes
+ * @buffer: A pointer to an arbitrary block of memory
+ *
+ * Sets the value of the kernel argument at @index, as an arbitrary block of
+ * memory. For arguments in the local address space, @buffer must be %NULL
+ * and @size is the amount of local memory to allocate.
+ *
+ * When the kernel's argument information is available, @size and @buffer
+ * are validated against the address space and type of the argument. Also,
+ * the value is remembered, so setting an argument again to the same value
+ * does not reach the OpenCL implementation.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument (GoclKernel      *self,
+                          guint            index,
+                          gsize            size,
+                          const gpointer  *buffer)
+{
+  cl_int err_code;
+  KernelArg *arg = NULL;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  if (self->priv->args != NULL)
+    {
+      if (index >= self->priv->num_args)
+        return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_INDEX);
+
+      arg = &self->priv->args[index];
+
+      err_code = check_argument (arg, size, buffer);
+      if (gocl_error_check_opencl_internal (err_code))
+        return FALSE;
+
+      if (argument_is_cached (arg, size, buffer))
+        return TRUE;
+    }
+
+  /* arguments of host kernels only live in the cache */
+  if (self->priv->kernel == NULL)
+    {
+      if (arg == NULL)
+        return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_INDEX);
+
+      cache_argument (arg, size, buffer);
+      return TRUE;
+    }
+
+  err_code = clSetKernelArg (self->priv->kernel,
+                             index,
+                             size,
+                             buffer);
+  if (gocl_error_check_opencl_internal (err_code))
+    {
+      if (arg != NULL)
+        arg->is_set = FALSE;
+      return FALSE;
+    }
+
+  if (arg != NULL)
+    cache_argument (arg, size, buffer);
+
+  return TRUE;
+}
+
+/**
+ * gocl_kernel_set_argument_int32:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of int32 elements in @buffer
+ * @buffer: (array length=num_elements) (element-type guint32): Array of int32
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of int32.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_int32 (GoclKernel  *self,
+                                guint        index,
+                                gsize        num_elements,
+                                gint32      *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_uint) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_float:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of float elements in @buffer
+ * @buffer: (array length=num_elements) (element-type gfloat): Array of float
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of floats.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_float (GoclKernel  *self,
+                                guint        index,
+                                gsize        num_elements,
+                                gfloat      *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_float) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_uint32:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of uint32 elements in @buffer
+ * @buffer: (array length=num_elements) (element-type guint32): Array of uint32
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of uint32.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_uint32 (GoclKernel  *self,
+                                 guint        index,
+                                 gsize        num_elements,
+                                 guint32     *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_uint) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_int64:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of int64 elements in @buffer
+ * @buffer: (array length=num_elements) (element-type gint64): Array of int64
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of int64.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_int64 (GoclKernel  *self,
+                                guint        index,
+                                gsize        num_elements,
+                                gint64      *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_long) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_uint64:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of uint64 elements in @buffer
+ * @buffer: (array length=num_elements) (element-type guint64): Array of uint64
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of uint64.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_uint64 (GoclKernel  *self,
+                                 guint        index,
+                                 gsize        num_elements,
+                                 guint64     *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_ulong) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_double:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @num_elements: The number of double elements in @buffer
+ * @buffer: (array length=num_elements) (element-type gdouble): Array of double
+ * values
+ *
+ * Sets the value of the kernel argument at @index, as an array of double.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_double (GoclKernel  *self,
+                                 guint        index,
+                                 gsize        num_elements,
+                                 gdouble     *buffer)
+{
+  return gocl_kernel_set_argument (self,
+                                   index,
+                                   sizeof (cl_double) * num_elements,
+                                   (const gpointer) buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_int32_vector:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @width: The number of components of the vector: 2, 3, 4, 8 or 16
+ * @values: (array length=width) (element-type gint32): The components of the
+ * vector
+ *
+ * Sets the value of the kernel argument at @index, as a vector of int32
+ * of @width components, like the OpenCL <i>intN</i> types.
+ * 3-component vectors are padded to the size of 4-component ones, as
+ * OpenCL expects.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_int32_vector (GoclKernel    *self,
+                                       guint          index,
+                                       guint          width,
+                                       const gint32  *values)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return set_argument_vector (self, index, sizeof (cl_int), width, values);
+}
+
+/**
+ * gocl_kernel_set_argument_uint32_vector:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @width: The number of components of the vector: 2, 3, 4, 8 or 16
+ * @values: (array length=width) (element-type guint32): The components of the
+ * vector
+ *
+ * Sets the value of the kernel argument at @index, as a vector of uint32
+ * of @width components, like the OpenCL <i>uintN</i> types.
+ * 3-component vectors are padded to the size of 4-component ones, as
+ * OpenCL expects.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_uint32_vector (GoclKernel    *self,
+                                        guint          index,
+                                        guint          width,
+                                        const guint32 *values)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return set_argument_vector (self, index, sizeof (cl_uint), width, values);
+}
+
+/**
+ * gocl_kernel_set_argument_float_vector:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @width: The number of components of the vector: 2, 3, 4, 8 or 16
+ * @values: (array length=width) (element-type gfloat): The components of the
+ * vector
+ *
+ * Sets the value of the kernel argument at @index, as a vector of floats
+ * of @width components, like the OpenCL <i>floatN</i> types.
+ * 3-component vectors are padded to the size of 4-component ones, as
+ * OpenCL expects.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_float_vector (GoclKernel    *self,
+                                       guint          index,
+                                       guint          width,
+                                       const gfloat  *values)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return set_argument_vector (self, index, sizeof (cl_float), width, values);
+}
+
+/**
+ * gocl_kernel_set_argument_double_vector:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @width: The number of components of the vector: 2, 3, 4, 8 or 16
+ * @values: (array length=width) (element-type gdouble): The components of the
+ * vector
+ *
+ * Sets the value of the kernel argument at @index, as a vector of doubles
+ * of @width components, like the OpenCL <i>doubleN</i> types.
+ * 3-component vectors are padded to the size of 4-component ones, as
+ * OpenCL expects.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_double_vector (GoclKernel    *self,
+                                        guint          index,
+                                        guint          width,
+                                        const gdouble *values)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return set_argument_vector (self, index, sizeof (cl_double), width, values);
+}
+
+/**
+ * gocl_kernel_set_argument_half:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @width: The number of components: 1 for a scalar <i>half</i>, or 2, 3, 4,
+ * 8 or 16 for a <i>halfN</i> vector
+ * @values: (array length=width) (element-type gfloat): The values, in single
+ * precision
+ *
+ * Sets the value of the kernel argument at @index, as a half precision
+ * scalar or vector. @values are converted to half precision, rounding to
+ * the nearest value. 3-component vectors are padded to the size of
+ * 4-component ones, as OpenCL expects.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_half (GoclKernel   *self,
+                               guint         index,
+                               guint         width,
+                               const gfloat *values)
+{
+  guint16 halves[16];
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (values != NULL, FALSE);
+
+  if (width > G_N_ELEMENTS (halves))
+    return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_SIZE);
+
+  for (i = 0; i < width; i++)
+    halves[i] = float_to_half (values[i]);
+
+  return set_argument_vector (self, index, sizeof (cl_half), width, halves);
+}
+
+/**
+ * gocl_kernel_set_argument_buffer:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @buffer: A #GoclBuffer
+ *
+ * Sets the value of the kernel argument at @index, as a buffer object.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_buffer (GoclKernel  *self,
+                                 guint        index,
+                                 GoclBuffer  *buffer)
+{
+  cl_mem buf;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_BUFFER (buffer), FALSE);
+
+  buf = gocl_buffer_get_buffer (buffer);
+
+  if (! gocl_kernel_set_argument (self,
+                                  index,
+                                  sizeof (cl_mem),
+                                  (const gpointer) &buf))
+    return FALSE;
+
+  /* kept for host runs, which map the buffer instead of passing cl_mem */
+  if (self->priv->args != NULL && self->priv->args[index].buffer == NULL)
+    self->priv->args[index].buffer = g_object_ref (buffer);
+
+  return TRUE;
+}
+
+/**
+ * gocl_kernel_set_argument_svm:
+ * @self: The #GoclKernel
+ * @index: The index of this argument in the kernel function
+ * @svm_ptr: A pointer into memory allocated with gocl_context_svm_alloc()
+ *
+ * Sets the value of the kernel argument at @index, which must be a pointer
+ * in the global or constant address space, as a pointer into shared virtual
+ * memory. Pointers stored inside that memory can be followed by the kernel
+ * too, but if they point to other allocations, those must be declared with
+ * gocl_kernel_set_svm_pointers(). This requires OpenCL 2.0.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_svm (GoclKernel    *self,
+                              guint          index,
+                              gconstpointer  svm_ptr)
+{
+#ifdef CL_VERSION_2_0
+  cl_int err_code;
+#endif
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  /* host kernels receive the pointer itself */
+  if (self->priv->kernel == NULL)
+    return gocl_kernel_set_argument (self,
+                                     index,
+                                     sizeof (gconstpointer),
+                                     (const gpointer *) &svm_ptr);
+
+#ifdef CL_VERSION_2_0
+  if (self->priv->args != NULL && index >= self->priv->num_args)
+    return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_INDEX);
+
+  err_code = clSetKernelArgSVMPointer (self->priv->kernel, index, svm_ptr);
+
+  /* the pointer is remembered so that the argument can be replayed on
+     copies of the kernel, but never matches a clSetKernelArg() value */
+  if (self->priv->args != NULL)
+    {
+      KernelArg *arg = &self->priv->args[index];
+
+      if (err_code == CL_SUCCESS)
+        {
+          cache_argument (arg, sizeof (gconstpointer), &svm_ptr);
+          arg->is_svm = TRUE;
+        }
+      else
+        {
+          arg->is_set = FALSE;
+        }
+    }
+
+  return ! gocl_error_check_opencl_internal (err_code);
+#else
+  return ! gocl_error_check_opencl_internal (CL_INVALID_OPERATION);
+#endif
+}
+
+/**
+ * gocl_kernel_set_svm_pointers:
+ * @self: The #GoclKernel
+ * @svm_ptrs: (array length=num_ptrs) (allow-none): Array of pointers into
+ * memory allocated with gocl_context_svm_alloc()
+ * @num_ptrs: The number of elements in @svm_ptrs
+ *
+ * Declares the shared virtual memory allocations that the kernel reaches
+ * through pointers stored in other memory, rather than through its
+ * arguments, such as the nodes of a linked data structure spread over
+ * several allocations. The declaration replaces any previous one, and
+ * passing no pointers clears it. This requires OpenCL 2.0.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_svm_pointers (GoclKernel *self,
+                              gpointer   *svm_ptrs,
+                              guint       num_ptrs)
+{
+#ifdef CL_VERSION_2_0
+  cl_int err_code;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (num_ptrs == 0 || svm_ptrs != NULL, FALSE);
+
+  err_code = clSetKernelExecInfo (self->priv->kernel,
+                                  CL_KERNEL_EXEC_INFO_SVM_PTRS,
+                                  sizeof (gpointer) * num_ptrs,
+                                  num_ptrs > 0 ? svm_ptrs : NULL);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+#else
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return ! gocl_error_check_opencl_internal (CL_INVALID_OPERATION);
+#endif
+}
+
+/**
+ * gocl_kernel_get_num_arguments:
+ * @self: The #GoclKernel
+ *
+ * Retrieves the number of arguments of the kernel function.
+ *
+ * Returns: The number of arguments
+ **/
+guint
+gocl_kernel_get_num_arguments (GoclKernel *self)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), 0);
+
+  return self->priv->num_args;
+}
+
+/**
+ * gocl_kernel_get_argument_name:
+ * @self: The #GoclKernel
+ * @index: The index of an argument in the kernel function
+ *
+ * Retrieves the name of the argument at @index, as declared in the source
+ * code of the kernel function.
+ *
+ * Returns: (transfer none): The argument name, or %NULL if not available
+ **/
+const gchar *
+gocl_kernel_get_argument_name (GoclKernel *self, guint index)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (index < self->priv->num_args, NULL);
+
+  return self->priv->args[index].name;
+}
+
+/**
+ * gocl_kernel_get_argument_type_name:
+ * @self: The #GoclKernel
+ * @index: The index of an argument in the kernel function
+ *
+ * Retrieves the type of the argument at @index, as declared in the source
+ * code of the kernel function, like "float4" or "uint*".
+ *
+ * Returns: (transfer none): The argument type name, or %NULL if not
+ * available
+ **/
+const gchar *
+gocl_kernel_get_argument_type_name (GoclKernel *self, guint index)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (index < self->priv->num_args, NULL);
+
+  return self->priv->args[index].type_name;
+}
+
+/**
+ * gocl_kernel_get_argument_index:
+ * @self: The #GoclKernel
+ * @name: The name of an argument
+ *
+ * Looks up the index of the kernel argument called @name.
+ *
+ * Returns: The argument index, or -1 if there is no such argument or the
+ * argument names are not available
+ **/
+gint
+gocl_kernel_get_argument_index (GoclKernel *self, const gchar *name)
+{
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), -1);
+  g_return_val_if_fail (name != NULL, -1);
+
+  for (i = 0; i < self->priv->num_args; i++)
+    if (g_strcmp0 (self->priv->args[i].name, name) == 0)
+      return (gint) i;
+
+  return -1;
+}
+
+/**
+ * gocl_kernel_set_argument_by_name:
+ * @self: The #GoclKernel
+ * @name: The name of the argument in the kernel function
+ * @size: The size of @buffer, in bytes
+ * @buffer: A pointer to an arbitrary block of memory
+ *
+ * Sets the value of the kernel argument called @name. This is the same as
+ * gocl_kernel_set_argument(), using gocl_kernel_get_argument_index() to
+ * find the argument.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_by_name (GoclKernel      *self,
+                                  const gchar     *name,
+                                  gsize            size,
+                                  const gpointer  *buffer)
+{
+  gint index;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (name != NULL, FALSE);
+
+  index = gocl_kernel_get_argument_index (self, name);
+  if (index < 0)
+    return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_INDEX);
+
+  return gocl_kernel_set_argument (self, (guint) index, size, buffer);
+}
+
+/**
+ * gocl_kernel_set_argument_buffer_by_name:
+ * @self: The #GoclKernel
+ * @name: The name of the argument in the kernel function
+ * @buffer: A #GoclBuffer
+ *
+ * Sets the value of the kernel argument called @name, as a buffer object.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_set_argument_buffer_by_name (GoclKernel  *self,
+                                         const gchar *name,
+                                         GoclBuffer  *buffer)
+{
+  gint index;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (name != NULL, FALSE);
+
+  index = gocl_kernel_get_argument_index (self, name);
+  if (index < 0)
+    return ! gocl_error_check_opencl_internal (CL_INVALID_ARG_INDEX);
+
+  return gocl_kernel_set_argument_buffer (self, (guint) index, buffer);
+}
+
+/**
+ * gocl_kernel_run_in_queue_sync:
+ * @self: The #GoclKernel
+ * @queue: A #GoclQueue to enqueue the kernel execution on
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the specified command queue, blocking the program
+ * until the kernel execution finishes. For non-blocking version,
+ * gocl_kernel_run_in_queue() is provided.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_run_in_queue_sync (GoclKernel  *self,
+                               GoclQueue   *queue,
+                               GList       *event_wait_list)
+{
+  cl_int err_code;
+  cl_event event;
+  GoclEventWaitList wait_list;
+  WorkSize local_work_size;
+  gint64 trace_start;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+
+  /* host kernels ignore the queue */
+  if (self->priv->kernel == NULL)
+    return gocl_kernel_run_on_host_sync (self, event_wait_list);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  /* tuning runs the kernel, so it waits for the dependencies first */
+  get_run_local_work_size (self,
+                           gocl_queue_get_device (queue),
+                           TUNE_ONCE,
+                           &wait_list,
+                           local_work_size);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = enqueue_ndrange (self,
+                              queue,
+                              NULL,
+                              self->priv->global_work_size,
+                              local_work_size,
+                              &wait_list,
+                              &event);
+  GOCL_TRACE_END ("kernel", "enqueue", self->priv->name, trace_start);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  clWaitForEvents (1, &event);
+  clReleaseEvent (event);
+
+  return TRUE;
+}
+
+/**
+ * gocl_kernel_run_in_queue:
+ * @self: The #GoclKernel
+ * @queue: A #GoclQueue to enqueue the kernel execution on
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the specified command queue, asynchronously. A #GoclEvent
+ * is returned, and can be used to get notified when the execution finishes,
+ * or as wait event input to other operations, possibly on other queues of
+ * the same context.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes
+ **/
+GoclEvent *
+gocl_kernel_run_in_queue (GoclKernel *self,
+                          GoclQueue  *queue,
+                          GList      *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = run_in_queue (self, queue, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
+/**
+ * gocl_kernel_run_in_queue_v:
+ * @self: The #GoclKernel
+ * @queue: A #GoclQueue to enqueue the kernel execution on
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_kernel_run_in_queue(), but takes the events to wait for as an
+ * array. Wait lists of a few events are passed to OpenCL without allocating
+ * any memory, which makes this the preferred variant for applications that
+ * launch many short kernels.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes
+ **/
+GoclEvent *
+gocl_kernel_run_in_queue_v (GoclKernel        *self,
+                            GoclQueue         *queue,
+                            GoclEvent * const *event_wait_list,
+                            guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  event = run_in_queue (self, queue, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
+/**
+ * gocl_kernel_run_in_queue_detached:
+ * @self: The #GoclKernel
+ * @queue: A #GoclQueue to enqueue the kernel execution on
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_kernel_run_in_queue_v(), but no event is created for the
+ * execution. Its completion is signalled by the next fence of @queue, see
+ * gocl_queue_fence(). The events in @event_wait_list must remain alive
+ * until the execution starts, since no reference to them is kept.
+ *
+ * Host kernels created with gocl_kernel_new_host() don't run on @queue,
+ * so they cannot be run detached.
+ *
+ * Returns: %TRUE if the execution was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_kernel_run_in_queue_detached (GoclKernel        *self,
+                                   GoclQueue         *queue,
+                                   GoclEvent * const *event_wait_list,
+                                   guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  WorkSize local_work_size;
+  cl_int err_code;
+  gint64 trace_start;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), FALSE);
+
+  if (self->priv->kernel == NULL)
+    return ! gocl_error_check_opencl_internal (CL_INVALID_KERNEL);
+
+  get_run_local_work_size (self,
+                           gocl_queue_get_device (queue),
+                           TUNE_NEVER,
+                           NULL,
+                           local_work_size);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = enqueue_ndrange (self,
+                              queue,
+                              NULL,
+                              self->priv->global_work_size,
+                              local_work_size,
+                              &wait_list,
+                              NULL);
+  GOCL_TRACE_END ("kernel", "enqueue", self->priv->name, trace_start);
+
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  gocl_queue_add_detached (queue);
+
+  return TRUE;
+}
+
+/**
+ * gocl_kernel_run_in_device_sync:
+ * @self: The #GoclKernel
+ * @device: A #GoclDevice to run the kernel on
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the specified device, blocking the program
+ * until the kernel execution finishes. For non-blocking version,
+ * gocl_kernel_run_in_device() is provided.
+ *
+ * The kernel is enqueued on the queue returned by
+ * gocl_device_get_compute_queue(), which is the device's default queue
+ * unless several compute queues have been configured.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_run_in_device_sync (GoclKernel  *self,
+                                GoclDevice  *device,
+                                GList       *event_wait_list)
+{
+  GoclQueue *queue;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), FALSE);
+
+  queue = gocl_device_get_compute_queue (device);
+  if (queue == NULL)
+    return FALSE;
+
+  return gocl_kernel_run_in_queue_sync (self, queue, event_wait_list);
+}
+
+/**
+ * gocl_kernel_run_in_device:
+ * @self: The #GoclKernel
+ * @device: A #GoclDevice to run the kernel on
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the specified device, asynchronously. A #GoclEvent
+ * is returned, and can be used to get notified when the execution finishes,
+ * or as wait event input to other operations on the device.
+ *
+ * The kernel is enqueued on the queue returned by
+ * gocl_device_get_compute_queue(), so consecutive calls are spread across
+ * all the compute queues of the device. Dependencies between executions
+ * must then be expressed through @event_wait_list.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes, or %NULL if no command queue could be obtained for @device
+ **/
+GoclEvent *
+gocl_kernel_run_in_device (GoclKernel *self,
+                           GoclDevice *device,
+                           GList      *event_wait_list)
+{
+  GoclQueue *queue;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), NULL);
+
+  queue = gocl_device_get_compute_queue (device);
+  if (queue == NULL)
+    return NULL;
+
+  return gocl_kernel_run_in_queue (self, queue, event_wait_list);
+}
+
+/**
+ * gocl_kernel_run_in_device_v:
+ * @self: The #GoclKernel
+ * @device: A #GoclDevice to run the kernel on
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Same as gocl_kernel_run_in_device(), but takes the events to wait for as
+ * an array, like gocl_kernel_run_in_queue_v().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes, or %NULL if no command queue could be obtained for @device
+ **/
+GoclEvent *
+gocl_kernel_run_in_device_v (GoclKernel        *self,
+                             GoclDevice        *device,
+                             GoclEvent * const *event_wait_list,
+                             guint              num_events)
+{
+  GoclQueue *queue;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), NULL);
+
+  queue = gocl_device_get_compute_queue (device);
+  if (queue == NULL)
+    return NULL;
+
+  return gocl_kernel_run_in_queue_v (self, queue, event_wait_list, num_events);
+}
+
+/**
+ * gocl_kernel_run_across_devices_sync:
+ * @self: The #GoclKernel
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on all the devices of the context of its program, blocking
+ * the program until every device finishes. The first dimension of the
+ * global work size is split across devices proportionally to their number
+ * of compute units (see gocl_device_get_max_compute_units()), and each
+ * device executes its share using a global work offset. The kernel must
+ * therefore not assume that its global ids start at zero. Devices whose
+ * compute queue cannot be created are left out of the split. For
+ * non-blocking version, gocl_kernel_run_across_devices() is provided.
+ *
+ * Shares use the kernel's current local work size, and the global size is
+ * split in multiples of it. Autotune is not applied to split runs, since
+ * tuned sizes are specific to a device and a global work size; tune the
+ * kernel with gocl_kernel_autotune_sync() beforehand if needed.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_run_across_devices_sync (GoclKernel *self,
+                                     GList      *event_wait_list)
+{
+  GPtrArray *devices;
+  GPtrArray *queues;
+  gsize *offsets;
+  gsize *sizes;
+  cl_event *events;
+  guint num_events = 0;
+  cl_int err_code = CL_SUCCESS;
+  guint i;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  /* the host is the only device of host kernels */
+  if (self->priv->kernel == NULL)
+    return gocl_kernel_run_on_host_sync (self, event_wait_list);
+
+  devices = get_split_devices (self, &queues);
+  if (devices->len == 0)
+    {
+      err_code = get_context_devices (self)->len == 0 ?
+        CL_DEVICE_NOT_FOUND : CL_INVALID_COMMAND_QUEUE;
+      g_ptr_array_unref (queues);
+      g_ptr_array_unref (devices);
+      return ! gocl_error_check_opencl_internal (err_code);
+    }
+
+  /* nothing to split */
+  if (devices->len == 1 || self->priv->global_work_size[0] == 0)
+    {
+      gboolean result;
+
+      result = gocl_kernel_run_in_queue_sync (self,
+                                              g_ptr_array_index (queues, 0),
+                                              event_wait_list);
+      g_ptr_array_unref (queues);
+      g_ptr_array_unref (devices);
+      return result;
+    }
+
+  offsets = g_new0 (gsize, devices->len);
+  sizes = g_new0 (gsize, devices->len);
+  events = g_new0 (cl_event, devices->len);
+
+  split_work_size (self, devices, offsets, sizes);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  for (i = 0; i < devices->len && err_code == CL_SUCCESS; i++)
+    {
+      GoclQueue *queue = g_ptr_array_index (queues, i);
+      gsize offset[3] = { 0, };
+      gsize size[3];
+
+      if (sizes[i] == 0)
+        continue;
+
+      offset[0] = offsets[i];
+      memcpy (size, self->priv->global_work_size, sizeof (WorkSize));
+      size[0] = sizes[i];
+
+      err_code = enqueue_ndrange (self,
+                                  queue,
+                                  offset,
+                                  size,
+                                  self->priv->local_work_size,
+                                  &wait_list,
+                                  &events[num_events]);
+      if (err_code == CL_SUCCESS)
+        num_events++;
+    }
+
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (num_events > 0)
+    clWaitForEvents (num_events, events);
+
+  for (i = 0; i < num_events; i++)
+    clReleaseEvent (events[i]);
+
+  g_free (events);
+  g_free (sizes);
+  g_free (offsets);
+  g_ptr_array_unref (queues);
+  g_ptr_array_unref (devices);
+
+  return ! gocl_error_check_opencl_internal (err_code);
+}
+
+/**
+ * gocl_kernel_run_across_devices:
+ * @self: The #GoclKernel
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on all the devices of the context of its program,
+ * asynchronously. The work is split across devices as described in
+ * gocl_kernel_run_across_devices_sync(). A single #GoclEvent is returned,
+ * which triggers when every device has finished its share, or with the
+ * first error that occurred on any of them.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes on all devices, or %NULL on error
+ **/
+GoclEvent *
+gocl_kernel_run_across_devices (GoclKernel *self,
+                                GList      *event_wait_list)
+{
+  GPtrArray *devices;
+  GPtrArray *queues;
+  gsize *offsets;
+  gsize *sizes;
+  GList *shares = NULL;
+  GList *node;
+  SplitClosure *closure;
+  GoclEvent *event = NULL;
+  guint i;
+  GoclEventWaitList wait_list;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+
+  /* the host is the only device of host kernels */
+  if (self->priv->kernel == NULL)
+    return gocl_kernel_run_on_host (self, event_wait_list);
+
+  devices = get_split_devices (self, &queues);
+  if (devices->len == 0)
+    {
+      gocl_error_check_opencl_internal (get_context_devices (self)->len == 0 ?
+                                        CL_DEVICE_NOT_FOUND :
+                                        CL_INVALID_COMMAND_QUEUE);
+      g_ptr_array_unref (queues);
+      g_ptr_array_unref (devices);
+      return NULL;
+    }
+
+  /* nothing to split */
+  if (devices->len == 1 || self->priv->global_work_size[0] == 0)
+    {
+      event = gocl_kernel_run_in_queue (self,
+                                        g_ptr_array_index (queues, 0),
+                                        event_wait_list);
+      g_ptr_array_unref (queues);
+      g_ptr_array_unref (devices);
+      return event;
+    }
+
+  offsets = g_new0 (gsize, devices->len);
+  sizes = g_new0 (gsize, devices->len);
+
+  split_work_size (self, devices, offsets, sizes);
+
+  /* the aggregate event is a user event living on the first queue */
+  event = g_object_new (GOCL_TYPE_EVENT,
+                        "queue", g_ptr_array_index (queues, 0),
+                        NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+
+  for (i = 0; i < devices->len; i++)
+    {
+      GoclQueue *queue = g_ptr_array_index (queues, i);
+      gsize offset[3] = { 0, };
+      gsize size[3];
+      cl_event _event = NULL;
+      cl_int err_code;
+      GoclEvent *share;
+
+      if (sizes[i] == 0)
+        continue;
+
+      offset[0] = offsets[i];
+      memcpy (size, self->priv->global_work_size, sizeof (WorkSize));
+      size[0] = sizes[i];
+
+      err_code = enqueue_ndrange (self,
+                                  queue,
+                                  offset,
+                                  size,
+                                  self->priv->local_work_size,
+                                  &wait_list,
+                                  &_event);
+
+      share = gocl_event_new_from_result (queue,
+                                          err_code,
+                                          _event,
+                                          &wait_list);
+      gocl_event_set_label (share, self->priv->name);
+      shares = g_list_prepend (shares, share);
+    }
+
+  gocl_event_wait_list_clear (&wait_list);
+
+  g_free (sizes);
+  g_free (offsets);
+  g_ptr_array_unref (queues);
+  g_ptr_array_unref (devices);
+
+  closure = g_slice_new0 (SplitClosure);
+  closure->event = g_object_ref (event);
+  closure->resolver_func = gocl_event_steal_resolver_func (event);
+  closure->num_pending = g_list_length (shares);
+  closure->error = NULL;
+
+  for (node = shares; node != NULL; node = node->next)
+    gocl_event_then (GOCL_EVENT (node->data), split_share_on_complete, closure);
+
+  g_list_free_full (shares, g_object_unref);
+
+  gocl_event_idle_unref (event);
+
+  return event;
+}
+
+/**
+ * gocl_kernel_set_host_func:
+ * @self: The #GoclKernel
+ * @func: (scope notified) (allow-none): The function that computes the
+ * kernel on the host, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass to @func, or %NULL
+ * @notify: (allow-none): A function to free @user_data, or %NULL
+ *
+ * Binds a native C function that computes the same results as the kernel,
+ * to be called by gocl_kernel_run_on_host(). This provides a fallback for
+ * hosts where no device can run the kernel. Passing %NULL as @func removes
+ * the current function. The function must not be changed while runs on the
+ * host are in progress.
+ **/
+void
+gocl_kernel_set_host_func (GoclKernel         *self,
+                           GoclKernelHostFunc  func,
+                           gpointer            user_data,
+                           GDestroyNotify      notify)
+{
+  g_return_if_fail (GOCL_IS_KERNEL (self));
+
+  if (self->priv->host_notify != NULL)
+    self->priv->host_notify (self->priv->host_user_data);
+
+  self->priv->host_func = func;
+  self->priv->host_user_data = user_data;
+  self->priv->host_notify = notify;
+}
+
+/**
+ * gocl_kernel_run_on_host_sync:
+ * @self: The #GoclKernel
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the host, blocking the program until the execution
+ * finishes. The calling thread takes part in the execution. For
+ * non-blocking version, gocl_kernel_run_on_host() is provided.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_run_on_host_sync (GoclKernel *self,
+                              GList      *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  gboolean result;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  result = run_on_host_sync (self, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return result;
+}
+
+/**
+ * gocl_kernel_run_on_host:
+ * @self: The #GoclKernel
+ * @event_wait_list: (element-type Gocl.Event) (allow-none): List of #GoclEvent
+ * events to wait for, or %NULL
+ *
+ * Runs the kernel on the host, asynchronously, by calling the function
+ * bound with gocl_kernel_set_host_func() or gocl_kernel_new_host(). The
+ * outermost dimension of the global work size is split in chunks, in
+ * multiples of the local work size if one was set, which are computed by
+ * a pool of as many threads as processors. Each call to the function covers
+ * one chunk, described by its global offset and size, and receives the
+ * values of the arguments at the time of this call. Arguments that were not
+ * set, or that live in local memory, are passed as %NULL.
+ *
+ * Buffer arguments set with gocl_kernel_set_argument_buffer() are mapped
+ * for reading and writing, through the default queue of the first device
+ * of their context, once the dependencies of the run are done. The function
+ * receives a pointer to the mapped contents, and the buffers are unmapped
+ * before the run completes, so that what the function wrote is visible to
+ * later commands. Images are passed as %NULL.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered. Events are waited
+ * for in the thread-default main context, like with gocl_event_then().
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes. The event has no #GoclQueue
+ **/
+GoclEvent *
+gocl_kernel_run_on_host (GoclKernel *self,
+                         GList      *event_wait_list)
+{
+  GoclEventWaitList wait_list;
+  GoclEvent *event;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), NULL);
+
+  gocl_event_wait_list_init (&wait_list, event_wait_list);
+  event = run_on_host (self, &wait_list);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return event;
+}
+
+/**
+ * gocl_kernel_set_autotune:
+ * @self: The #GoclKernel
+ * @autotune: %TRUE to enable local work size tuning, %FALSE to disable it
+ *
+ * Enables or disables the autotune mode of the kernel. In autotune mode,
+ * gocl_kernel_run_in_queue(), gocl_kernel_run_in_device() and their
+ * blocking versions replace the local work size with the best one found
+ * for the device and the current global work size, as done by
+ * gocl_kernel_autotune_sync().
+ *
+ * Only blocking runs, like gocl_kernel_run_in_queue_sync(), and the
+ * creation of a #GoclLaunch tune the kernel, the first time a new
+ * combination of device and global work size is used. A blocking run
+ * waits for its event wait list to complete before tuning. Asynchronous
+ * runs never tune: they use a size tuned earlier in this process or
+ * stored in the on-disk cache, and keep the current local work size
+ * otherwise. If tuning fails, it is not attempted again for the same
+ * combination, except by gocl_kernel_autotune_sync().
+ *
+ * Notice that tuning executes the kernel several times per candidate
+ * local work size, and any side effect it has, like writing to a buffer
+ * it also reads from, is repeated each time. It should only be enabled
+ * for kernels that produce the same result when executed repeatedly with
+ * the same arguments.
+ **/
+void
+gocl_kernel_set_autotune (GoclKernel *self, gboolean autotune)
+{
+  g_return_if_fail (GOCL_IS_KERNEL (self));
+
+  self->priv->autotune = autotune;
+}
+
+/**
+ * gocl_kernel_get_autotune:
+ * @self: The #GoclKernel
+ *
+ * Retrieves whether the autotune mode is enabled for this kernel. See
+ * gocl_kernel_set_autotune().
+ *
+ * Returns: %TRUE if autotune is enabled, %FALSE otherwise
+ **/
+gboolean
+gocl_kernel_get_autotune (GoclKernel *self)
+{
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+
+  return self->priv->autotune;
+}
+
+/**
+ * gocl_kernel_autotune_sync:
+ * @self: The #GoclKernel
+ * @device: The #GoclDevice to tune the kernel for
+ *
+ * Finds the local work size that executes the kernel fastest on @device for
+ * the current work dimension and global work size, and sets it as the
+ * kernel's local work size. The kernel arguments must be set beforehand.
+ *
+ * Candidates are power-of-two sizes that divide the global work size and
+ * fit within the kernel and device work-group limits, plus the size chosen
+ * by the OpenCL implementation. Each one is timed with profiling events on
+ * a temporary queue. The winner is remembered, keyed on the kernel, the
+ * device and the global work size, and is also stored in the on-disk cache
+ * next to the program binaries, so later runs skip the tuning. This method
+ * blocks until tuning completes, and tunes again even if a previous attempt
+ * failed.
+ *
+ * Tuning executes the kernel four times for each candidate, one of them as
+ * a warm-up, so any side effect the kernel has is repeated, see
+ * gocl_kernel_set_autotune().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_kernel_autotune_sync (GoclKernel *self, GoclDevice *device)
+{
+  WorkSize size;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (self), FALSE);
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), FALSE);
+
+  if (! get_tuned_local_work_size (self, device, TUNE_ALWAYS, NULL, size))
+    return ! gocl_error_check_opencl_internal (CL_INVALID_WORK_GROUP_SIZE);
+
+  memcpy (self->priv->local_work_size, size, sizeof (WorkSize));
+
+  return TRUE;
+}
+
 /**
  * gocl_kernel_set_work_dimension:
  * @self: The #GoclKernel
@@ -52,8 +52,39 @@ struct _GoclKernelClass
   GObjectClass parent_class;
 };
 
+/**
+ * GoclKernelHostFunc:
+ * @self: The #GoclKernel being run
+ * @work_dim: The number of work dimensions of the run
+ * @offset: (array fixed-size=3): The first global id of the range to compute,
+ * for each dimension
+ * @size: (array fixed-size=3): The number of work-items of the range to
+ * compute, for each dimension
+ * @args: (array): The values of the kernel arguments, as set when the run
+ * was requested. Buffer arguments point to the buffer contents, mapped
+ * into host memory for the duration of the run
+ * @user_data: The user data passed when the function was bound
+ *
+ * Prototype of the functions that execute a kernel on the host. See
+ * gocl_kernel_run_on_host().
+ **/
+typedef void (* GoclKernelHostFunc) (GoclKernel          *self,
+                                     guint                work_dim,
+                                     const gsize         *offset,
+                                     const gsize         *size,
+                                     const gconstpointer *args,
+                                     gpointer             user_data);
+
 GType                  gocl_kernel_get_type                   (void) G_GNUC_CONST;
 
+GoclKernel *           gocl_kernel_new_host                   (const gchar        *name,
+                                                               guint               num_args,
+                                                               GoclKernelHostFunc  func,
+                                                               gpointer            user_data,
+                                                               GDestroyNotify      notify);
+
+const gchar *          gocl_kernel_get_name                   (GoclKernel *self);
+
 gboolean               gocl_kernel_set_argument               (GoclKernel      *self,
                                                                guint            index,
                                                                gsize            size,
@@ -66,9 +97,66 @@ gboolean               gocl_kernel_set_argument_float         (GoclKernel  *self
                                                                guint        index,
                                                                gsize        num_elements,
                                                                gfloat      *buffer);
+gboolean               gocl_kernel_set_argument_uint32        (GoclKernel  *self,
+                                                               guint        index,
+                                                               gsize        num_elements,
+                                                               guint32     *buffer);
+gboolean               gocl_kernel_set_argument_int64         (GoclKernel  *self,
+                                                               guint        index,
+                                                               gsize        num_elements,
+                                                               gint64      *buffer);
+gboolean               gocl_kernel_set_argument_uint64        (GoclKernel  *self,
+                                                               guint        index,
+                                                               gsize        num_elements,
+                                                               guint64     *buffer);
+gboolean               gocl_kernel_set_argument_double        (GoclKernel  *self,
+                                                               guint        index,
+                                                               gsize        num_elements,
+                                                               gdouble     *buffer);
+gboolean               gocl_kernel_set_argument_int32_vector  (GoclKernel    *self,
+                                                               guint          index,
+                                                               guint          width,
+                                                               const gint32  *values);
+gboolean               gocl_kernel_set_argument_uint32_vector (GoclKernel    *self,
+                                                               guint          index,
+                                                               guint          width,
+                                                               const guint32 *values);
+gboolean               gocl_kernel_set_argument_float_vector  (GoclKernel    *self,
+                                                               guint          index,
+                                                               guint          width,
+                                                               const gfloat  *values);
+gboolean               gocl_kernel_set_argument_double_vector (GoclKernel    *self,
+                                                               guint          index,
+                                                               guint          width,
+                                                               const gdouble *values);
+gboolean               gocl_kernel_set_argument_half          (GoclKernel   *self,
+                                                               guint         index,
+                                                               guint         width,
+                                                               const gfloat *values);
 gboolean               gocl_kernel_set_argument_buffer        (GoclKernel  *self,
                                                                guint        index,
                                                                GoclBuffer  *buffer);
+gboolean               gocl_kernel_set_argument_svm           (GoclKernel    *self,
+                                                               guint          index,
+                                                               gconstpointer  svm_ptr);
+gboolean               gocl_kernel_set_svm_pointers           (GoclKernel *self,
+                                                               gpointer   *svm_ptrs,
+                                                               guint       num_ptrs);
+
+guint                  gocl_kernel_get_num_arguments          (GoclKernel *self);
+const gchar *          gocl_kernel_get_argument_name          (GoclKernel *self,
+                                                               guint       index);
+const gchar *          gocl_kernel_get_argument_type_name     (GoclKernel *self,
+                                                               guint       index);
+gint                   gocl_kernel_get_argument_index         (GoclKernel  *self,
+                                                               const gchar *name);
+gboolean               gocl_kernel_set_argument_by_name       (GoclKernel      *self,
+                                                               const gchar     *name,
+                                                               gsize            size,
+                                                               const gpointer  *buffer);
+gboolean               gocl_kernel_set_argument_buffer_by_name (GoclKernel  *self,
+                                                                const gchar *name,
+                                                                GoclBuffer  *buffer);
 
 gboolean               gocl_kernel_run_in_device_sync         (GoclKernel  *self,
                                                                GoclDevice  *device,
@@ -76,6 +164,37 @@ gboolean               gocl_kernel_run_in_device_sync         (GoclKernel  *self
 GoclEvent *            gocl_kernel_run_in_device              (GoclKernel  *self,
                                                                GoclDevice  *device,
                                                                GList       *event_wait_list);
+GoclEvent *            gocl_kernel_run_in_device_v            (GoclKernel        *self,
+                                                               GoclDevice        *device,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+gboolean               gocl_kernel_run_in_queue_sync          (GoclKernel  *self,
+                                                               GoclQueue   *queue,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_kernel_run_in_queue               (GoclKernel  *self,
+                                                               GoclQueue   *queue,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_kernel_run_in_queue_v             (GoclKernel        *self,
+                                                               GoclQueue         *queue,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+gboolean               gocl_kernel_run_in_queue_detached      (GoclKernel        *self,
+                                                               GoclQueue         *queue,
+                                                               GoclEvent * const *event_wait_list,
+                                                               guint              num_events);
+gboolean               gocl_kernel_run_across_devices_sync    (GoclKernel  *self,
+                                                               GList       *event_wait_list);
+GoclEvent *            gocl_kernel_run_across_devices         (GoclKernel  *self,
+                                                               GList       *event_wait_list);
+
+void                   gocl_kernel_set_host_func              (GoclKernel         *self,
+                                                               GoclKernelHostFunc  func,
+                                                               gpointer            user_data,
+                                                               GDestroyNotify      notify);
+gboolean               gocl_kernel_run_on_host_sync           (GoclKernel *self,
+                                                               GList      *event_wait_list);
+GoclEvent *            gocl_kernel_run_on_host                (GoclKernel *self,
+                                                               GList      *event_wait_list);
 
 void                   gocl_kernel_set_work_dimension         (GoclKernel *self,
                                                                guint8      work_dim);
@@ -88,6 +207,12 @@ void                   gocl_kernel_set_local_work_size        (GoclKernel *self,
                                                                gsize       size2,
                                                                gsize       size3);
 
+void                   gocl_kernel_set_autotune               (GoclKernel *self,
+                                                               gboolean    autotune);
+gboolean               gocl_kernel_get_autotune               (GoclKernel *self);
+gboolean               gocl_kernel_autotune_sync              (GoclKernel *self,
+                                                               GoclDevice *device);
+
 G_END_DECLS
 
 #endif /* __GOCL_KERNEL_H__ */
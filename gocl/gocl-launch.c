@@ -0,0 +1,511 @@
+/*
+ * gocl-launch.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-launch
+ * @short_description: Object that represents a pre-recorded kernel execution
+ * @stability: Unstable
+ *
+ * A #GoclLaunch captures everything needed to execute a #GoclKernel on a
+ * #GoclQueue: the values of the kernel arguments, the work dimension, the
+ * global and local work sizes, and an optional global work offset. It is
+ * created with gocl_launch_new() and cannot be modified afterwards.
+ *
+ * The launch owns a private copy of the OpenCL kernel object, so changing
+ * the arguments or work sizes of the #GoclKernel later does not affect it,
+ * and the kernel can keep being configured for other launches. Since
+ * nothing in a launch changes, it can be submitted repeatedly, and from
+ * several threads at once.
+ *
+ * Submitting a launch does no more than passing the wait list to OpenCL
+ * and enqueuing the kernel: the queue, work sizes and arguments are not
+ * looked up again. gocl_launch_submit() returns a #GoclEvent as
+ * gocl_kernel_run_in_queue() does, and gocl_launch_submit_sync() blocks
+ * until the execution finishes. When no completion notification is
+ * needed, gocl_launch_enqueue() skips the creation of any event,
+ * like gocl_kernel_run_in_queue_detached().
+ *
+ * If the kernel has autotune enabled, the local work size is tuned for the
+ * device of the queue when the launch is created, see
+ * gocl_kernel_set_autotune().
+ **/
+
+/**
+ * GoclLaunchClass:
+ * @parent_class: The parent class
+ *
+ * The class for #GoclLaunch objects.
+ **/
+
+#include <string.h>
+#include <gio/gio.h>
+
+#include "gocl-launch.h"
+
+#include "gocl-private.h"
+
+struct _GoclLaunchPrivate
+{
+  GoclKernel *kernel;
+  GoclQueue *queue;
+
+  /* OpenCL objects used on submission, the kernel being a private copy */
+  cl_kernel _kernel;
+  cl_command_queue _queue;
+
+  guint work_dim;
+  gsize global_work_offset[3];
+  gsize global_work_size[3];
+  gsize local_work_size[3];
+  gboolean has_offset;
+};
+
+/* properties */
+enum
+{
+  PROP_0,
+  PROP_KERNEL,
+  PROP_QUEUE
+};
+
+static void           gocl_launch_class_init            (GoclLaunchClass *class);
+static void           gocl_launch_initable_iface_init   (GInitableIface *iface);
+static gboolean       gocl_launch_initable_init         (GInitable     *initable,
+                                                         GCancellable  *cancellable,
+                                                         GError       **error);
+static void           gocl_launch_init                  (GoclLaunch *self);
+static void           gocl_launch_dispose               (GObject *obj);
+static void           gocl_launch_finalize              (GObject *obj);
+
+static void           set_property                      (GObject      *obj,
+                                                         guint         prop_id,
+                                                         const GValue *value,
+                                                         GParamSpec   *pspec);
+static void           get_property                      (GObject    *obj,
+                                                         guint       prop_id,
+                                                         GValue     *value,
+                                                         GParamSpec *pspec);
+
+G_DEFINE_TYPE_WITH_CODE (GoclLaunch, gocl_launch, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
+                                                gocl_launch_initable_iface_init));
+
+#define GOCL_LAUNCH_GET_PRIVATE(obj)                    \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                  \
+                                GOCL_TYPE_LAUNCH,       \
+                                GoclLaunchPrivate))     \
+
+static void
+gocl_launch_class_init (GoclLaunchClass *class)
+{
+  GObjectClass *obj_class = G_OBJECT_CLASS (class);
+
+  obj_class->dispose = gocl_launch_dispose;
+  obj_class->finalize = gocl_launch_finalize;
+  obj_class->get_property = get_property;
+  obj_class->set_property = set_property;
+
+  g_object_class_install_property (obj_class, PROP_KERNEL,
+                                   g_param_spec_object ("kernel",
+                                                        "Kernel",
+                                                        "The kernel to execute",
+                                                        GOCL_TYPE_KERNEL,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_QUEUE,
+                                   g_param_spec_object ("queue",
+                                                        "Command queue",
+                                                        "The command queue where the kernel is enqueued",
+                                                        GOCL_TYPE_QUEUE,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_type_class_add_private (class, sizeof (GoclLaunchPrivate));
+}
+
+static void
+gocl_launch_initable_iface_init (GInitableIface *iface)
+{
+  iface->init = gocl_launch_initable_init;
+}
+
+static gboolean
+gocl_launch_initable_init (GInitable     *initable,
+                           GCancellable  *cancellable,
+                           GError       **error)
+{
+  GoclLaunch *self = GOCL_LAUNCH (initable);
+  cl_int err_code;
+
+  self->priv->_queue = gocl_queue_get_queue (self->priv->queue);
+  if (self->priv->_queue == NULL)
+    return ! gocl_error_check_opencl (CL_INVALID_COMMAND_QUEUE, error);
+
+  gocl_kernel_get_launch_size (self->priv->kernel,
+                               gocl_queue_get_device (self->priv->queue),
+                               &self->priv->work_dim,
+                               self->priv->global_work_size,
+                               self->priv->local_work_size);
+  if (self->priv->global_work_size[0] == 0)
+    return ! gocl_error_check_opencl (CL_INVALID_GLOBAL_WORK_SIZE, error);
+
+  self->priv->_kernel = gocl_kernel_copy (self->priv->kernel, &err_code);
+  if (gocl_error_check_opencl (err_code, error))
+    return FALSE;
+
+  return TRUE;
+}
+
+static void
+gocl_launch_init (GoclLaunch *self)
+{
+  GoclLaunchPrivate *priv;
+
+  self->priv = priv = GOCL_LAUNCH_GET_PRIVATE (self);
+
+  priv->kernel = NULL;
+  priv->queue = NULL;
+
+  priv->_kernel = NULL;
+  priv->_queue = NULL;
+
+  priv->work_dim = 1;
+  memset (priv->global_work_offset, 0, sizeof (priv->global_work_offset));
+  memset (priv->global_work_size, 0, sizeof (priv->global_work_size));
+  memset (priv->local_work_size, 0, sizeof (priv->local_work_size));
+  priv->has_offset = FALSE;
+}
+
+static void
+gocl_launch_dispose (GObject *obj)
+{
+  GoclLaunch *self = GOCL_LAUNCH (obj);
+
+  if (self->priv->kernel != NULL)
+    {
+      g_object_unref (self->priv->kernel);
+      self->priv->kernel = NULL;
+    }
+
+  if (self->priv->queue != NULL)
+    {
+      g_object_unref (self->priv->queue);
+      self->priv->queue = NULL;
+    }
+
+  G_OBJECT_CLASS (gocl_launch_parent_class)->dispose (obj);
+}
+
+static void
+gocl_launch_finalize (GObject *obj)
+{
+  GoclLaunch *self = GOCL_LAUNCH (obj);
+
+  if (self->priv->_kernel != NULL)
+    clReleaseKernel (self->priv->_kernel);
+
+  G_OBJECT_CLASS (gocl_launch_parent_class)->finalize (obj);
+}
+
+static void
+set_property (GObject      *obj,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GoclLaunch *self = GOCL_LAUNCH (obj);
+
+  switch (prop_id)
+    {
+    case PROP_KERNEL:
+      self->priv->kernel = g_value_dup_object (value);
+      break;
+
+    case PROP_QUEUE:
+      self->priv->queue = g_value_dup_object (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+get_property (GObject    *obj,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GoclLaunch *self = GOCL_LAUNCH (obj);
+
+  switch (prop_id)
+    {
+    case PROP_KERNEL:
+      g_value_set_object (value, self->priv->kernel);
+      break;
+
+    case PROP_QUEUE:
+      g_value_set_object (value, self->priv->queue);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+/* the only work done per submission; everything else was resolved when the
+   launch was created */
+static cl_int
+enqueue (GoclLaunch              *self,
+         const GoclEventWaitList *wait_list,
+         cl_event                *event)
+{
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueNDRangeKernel (self->priv->_queue,
+                                     self->priv->_kernel,
+                                     self->priv->work_dim,
+                                     self->priv->has_offset ?
+                                       self->priv->global_work_offset : NULL,
+                                     self->priv->global_work_size,
+                                     self->priv->local_work_size[0] == 0 ?
+                                       NULL : self->priv->local_work_size,
+                                     wait_list->len,
+                                     wait_list->events,
+                                     event);
+  GOCL_TRACE_END ("launch",
+                  "enqueue",
+                  gocl_kernel_get_name (self->priv->kernel),
+                  trace_start);
+
+  return err_code;
+}
+
+/* public */
+
+/**
+ * gocl_launch_new:
+ * @kernel: The #GoclKernel to execute
+ * @queue: The #GoclQueue to enqueue the execution on
+ * @global_work_offset: (array fixed-size=3) (allow-none): The global work
+ * offset for each dimension, or %NULL to start at zero
+ *
+ * Creates a launch of @kernel on @queue, with the current arguments and
+ * work sizes of @kernel. All the arguments of @kernel must be set. Host
+ * kernels created with gocl_kernel_new_host() cannot be launched this way.
+ * Upon error, %NULL is returned.
+ *
+ * Returns: (transfer full): A newly created #GoclLaunch
+ **/
+GoclLaunch *
+gocl_launch_new (GoclKernel  *kernel,
+                 GoclQueue   *queue,
+                 const gsize *global_work_offset)
+{
+  GoclLaunch *self;
+  GError **error;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (kernel), NULL);
+  g_return_val_if_fail (GOCL_IS_QUEUE (queue), NULL);
+
+  error = gocl_error_prepare ();
+
+  self = g_initable_new (GOCL_TYPE_LAUNCH,
+                         NULL,
+                         error,
+                         "kernel", kernel,
+                         "queue", queue,
+                         NULL);
+  if (self == NULL)
+    return NULL;
+
+  if (global_work_offset != NULL)
+    {
+      memcpy (self->priv->global_work_offset,
+              global_work_offset,
+              sizeof (self->priv->global_work_offset));
+      self->priv->has_offset = TRUE;
+    }
+
+  return self;
+}
+
+/**
+ * gocl_launch_get_kernel:
+ * @self: The #GoclLaunch
+ *
+ * Retrieves the #GoclKernel this launch was created from. Changes made to
+ * the kernel after the launch was created do not affect it.
+ *
+ * Returns: (transfer none): The #GoclKernel of the launch
+ **/
+GoclKernel *
+gocl_launch_get_kernel (GoclLaunch *self)
+{
+  g_return_val_if_fail (GOCL_IS_LAUNCH (self), NULL);
+
+  return self->priv->kernel;
+}
+
+/**
+ * gocl_launch_get_queue:
+ * @self: The #GoclLaunch
+ *
+ * Retrieves the #GoclQueue this launch is enqueued on.
+ *
+ * Returns: (transfer none): The #GoclQueue of the launch
+ **/
+GoclQueue *
+gocl_launch_get_queue (GoclLaunch *self)
+{
+  g_return_val_if_fail (GOCL_IS_LAUNCH (self), NULL);
+
+  return self->priv->queue;
+}
+
+/**
+ * gocl_launch_submit:
+ * @self: The #GoclLaunch
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Enqueues the kernel execution, asynchronously. A #GoclEvent is returned,
+ * and can be used to get notified when the execution finishes, or as wait
+ * event input to other operations. This method can be called from several
+ * threads at once.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when execution
+ * finishes
+ **/
+GoclEvent *
+gocl_launch_submit (GoclLaunch        *self,
+                    GoclEvent * const *event_wait_list,
+                    guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+
+  g_return_val_if_fail (GOCL_IS_LAUNCH (self), NULL);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+
+  err_code = enqueue (self, &wait_list, &event);
+
+  _event = gocl_event_new_from_result (self->priv->queue,
+                                       err_code,
+                                       event,
+                                       &wait_list);
+  gocl_event_set_label (_event, gocl_kernel_get_name (self->priv->kernel));
+  gocl_event_idle_unref (_event);
+
+  gocl_event_wait_list_clear (&wait_list);
+
+  return _event;
+}
+
+/**
+ * gocl_launch_submit_sync:
+ * @self: The #GoclLaunch
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Enqueues the kernel execution, blocking the program until it finishes.
+ * For non-blocking version, gocl_launch_submit() is provided.
+ *
+ * If @event_wait_list is provided, the kernel execution will start
+ * only when all the events in the list have triggered.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_launch_submit_sync (GoclLaunch        *self,
+                         GoclEvent * const *event_wait_list,
+                         guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  cl_int err_code;
+  cl_event event = NULL;
+
+  g_return_val_if_fail (GOCL_IS_LAUNCH (self), FALSE);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  err_code = enqueue (self, &wait_list, &event);
+  gocl_event_wait_list_clear (&wait_list);
+
+  return gocl_event_wait_for_result (err_code, event);
+}
+
+/**
+ * gocl_launch_enqueue:
+ * @self: The #GoclLaunch
+ * @event_wait_list: (array length=num_events) (allow-none): Array of
+ * #GoclEvent events to wait for, or %NULL
+ * @num_events: The number of events in @event_wait_list
+ *
+ * Enqueues the kernel execution without creating any event, which is the
+ * cheapest way to submit it when no completion notification is needed.
+ * Its completion is signalled by the next fence of the queue, see
+ * gocl_queue_fence().
+ *
+ * The events in @event_wait_list must remain alive until the kernel
+ * execution starts, since no reference to them is kept.
+ *
+ * Returns: %TRUE if the execution was enqueued, %FALSE on error
+ **/
+gboolean
+gocl_launch_enqueue (GoclLaunch        *self,
+                     GoclEvent * const *event_wait_list,
+                     guint              num_events)
+{
+  GoclEventWaitList wait_list;
+  cl_int err_code;
+
+  g_return_val_if_fail (GOCL_IS_LAUNCH (self), FALSE);
+
+  gocl_event_wait_list_init_from_array (&wait_list,
+                                        event_wait_list,
+                                        num_events);
+  err_code = enqueue (self, &wait_list, NULL);
+  gocl_event_wait_list_clear (&wait_list);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  gocl_queue_add_detached (self->priv->queue);
+
+  return TRUE;
+}
@@ -0,0 +1,77 @@
+/*
+ * gocl-launch.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+#ifndef __GOCL_LAUNCH_H__
+#define __GOCL_LAUNCH_H__
+
+#include <glib-object.h>
+
+#include "gocl-queue.h"
+#include "gocl-kernel.h"
+#include "gocl-event.h"
+
+G_BEGIN_DECLS
+
+#define GOCL_TYPE_LAUNCH              (gocl_launch_get_type ())
+#define GOCL_LAUNCH(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GOCL_TYPE_LAUNCH, GoclLaunch))
+#define GOCL_LAUNCH_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GOCL_TYPE_LAUNCH, GoclLaunchClass))
+#define GOCL_IS_LAUNCH(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GOCL_TYPE_LAUNCH))
+#define GOCL_IS_LAUNCH_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GOCL_TYPE_LAUNCH))
+#define GOCL_LAUNCH_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GOCL_TYPE_LAUNCH, GoclLaunchClass))
+
+typedef struct _GoclLaunchClass GoclLaunchClass;
+typedef struct _GoclLaunch GoclLaunch;
+typedef struct _GoclLaunchPrivate GoclLaunchPrivate;
+
+struct _GoclLaunch
+{
+  GObject parent_instance;
+
+  GoclLaunchPrivate *priv;
+};
+
+struct _GoclLaunchClass
+{
+  GObjectClass parent_class;
+};
+
+GType                  gocl_launch_get_type                    (void) G_GNUC_CONST;
+
+GoclLaunch *           gocl_launch_new                         (GoclKernel  *kernel,
+                                                                GoclQueue   *queue,
+                                                                const gsize *global_work_offset);
+
+GoclKernel *           gocl_launch_get_kernel                  (GoclLaunch *self);
+GoclQueue *            gocl_launch_get_queue                   (GoclLaunch *self);
+
+GoclEvent *            gocl_launch_submit                      (GoclLaunch        *self,
+                                                                GoclEvent * const *event_wait_list,
+                                                                guint              num_events);
+gboolean               gocl_launch_submit_sync                 (GoclLaunch        *self,
+                                                                GoclEvent * const *event_wait_list,
+                                                                guint              num_events);
+gboolean               gocl_launch_enqueue                     (GoclLaunch        *self,
+                                                                GoclEvent * const *event_wait_list,
+                                                                guint              num_events);
+
+G_END_DECLS
+
+#endif /* __GOCL_LAUNCH_H__ */
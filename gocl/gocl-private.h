@@ -31,20 +31,150 @@
 #include "gocl-buffer.h"
 #include "gocl-queue.h"
 #include "gocl-event.h"
+#include "gocl-trace.h"
 
 G_BEGIN_DECLS
 
+/* trace points cost a single flag check while tracing is inactive, and
+   nothing at all when tracing is not built in. The exception are object
+   counts, which keep being updated with an atomic add while tracing is
+   inactive, so that gocl_trace_get_num_objects() is always accurate */
+#ifdef GOCL_ENABLE_TRACING
+
+extern gint gocl_trace_active;
+
+#define GOCL_TRACE_ACTIVE() G_UNLIKELY (g_atomic_int_get (&gocl_trace_active))
+
+#define GOCL_TRACE_BEGIN() \
+  (GOCL_TRACE_ACTIVE () ? g_get_monotonic_time () : (gint64) 0)
+
+#define GOCL_TRACE_END(category, name, label, start)                      \
+  G_STMT_START {                                                          \
+    if (G_UNLIKELY ((start) != 0))                                        \
+      gocl_trace_add_span ((category), (name), (label), (start),          \
+                           g_get_monotonic_time ());                      \
+  } G_STMT_END
+
+#define GOCL_TRACE_COUNTER(category, name, label, value)                  \
+  G_STMT_START {                                                          \
+    if (GOCL_TRACE_ACTIVE ())                                             \
+      gocl_trace_add_counter ((category), (name), (label), (value));      \
+  } G_STMT_END
+
+/* not gated on GOCL_TRACE_ACTIVE(): a count started mid-run would be off
+   by the objects created before tracing started */
+#define GOCL_TRACE_OBJECT_NEW(type)  gocl_trace_object_changed ((type), 1)
+#define GOCL_TRACE_OBJECT_FREE(type) gocl_trace_object_changed ((type), -1)
+
+#else
+
+#define GOCL_TRACE_ACTIVE() FALSE
+#define GOCL_TRACE_BEGIN() ((gint64) 0)
+#define GOCL_TRACE_END(category, name, label, start) \
+  G_STMT_START { (void) (start); } G_STMT_END
+#define GOCL_TRACE_COUNTER(category, name, label, value) G_STMT_START { } G_STMT_END
+#define GOCL_TRACE_OBJECT_NEW(type) G_STMT_START { } G_STMT_END
+#define GOCL_TRACE_OBJECT_FREE(type) G_STMT_START { } G_STMT_END
+
+#endif /* GOCL_ENABLE_TRACING */
+
+/* number of events a GoclEventWaitList holds without allocating memory */
+#define GOCL_EVENT_WAIT_LIST_PREALLOC 8
+
+typedef struct
+{
+  GoclEvent **gocl_events;
+  cl_event *events;
+  guint len;
+
+  gboolean owns_gocl_events;
+  GoclEvent *gocl_events_prealloc[GOCL_EVENT_WAIT_LIST_PREALLOC];
+  cl_event events_prealloc[GOCL_EVENT_WAIT_LIST_PREALLOC];
+} GoclEventWaitList;
+
+/* the capabilities of a device, taken once per context and device index */
+typedef struct
+{
+  GoclDeviceInfo info;
+  gchar **extension_names;
+} GoclDeviceSnapshot;
+
 cl_context        gocl_context_get_context         (GoclContext *self);
+void              gocl_context_track_pinned_transfer (GoclContext   *self,
+                                                      gconstpointer  ptr,
+                                                      gsize          size,
+                                                      cl_event       event);
+const GoclDeviceSnapshot *
+                  gocl_context_get_device_snapshot (GoclContext  *self,
+                                                    cl_device_id  device_id);
 
 cl_program        gocl_program_get_program         (GoclProgram *self);
+const gchar *     gocl_program_get_source          (GoclProgram *self);
+const gchar *     gocl_program_get_build_options   (GoclProgram *self);
+gboolean          gocl_program_has_kernel_arg_info (GoclProgram *self);
 
 cl_kernel         gocl_kernel_get_kernel           (GoclKernel *self);
+cl_int            gocl_kernel_enqueue              (GoclKernel       *self,
+                                                    cl_command_queue  queue,
+                                                    const gsize      *global_work_offset,
+                                                    const gsize      *global_work_size,
+                                                    guint             num_events,
+                                                    const cl_event   *event_wait_list,
+                                                    cl_event         *event);
+cl_kernel         gocl_kernel_copy                 (GoclKernel *self,
+                                                    cl_int     *err_code);
+void              gocl_kernel_get_launch_size      (GoclKernel *self,
+                                                    GoclDevice *device,
+                                                    guint      *work_dim,
+                                                    gsize      *global_work_size,
+                                                    gsize      *local_work_size);
 
 cl_mem            gocl_buffer_get_buffer           (GoclBuffer *self);
 
+cl_int            gocl_device_enqueue_gl_objects   (cl_command_queue    queue,
+                                                    gboolean            acquire,
+                                                    GoclBuffer * const *objects,
+                                                    guint               num_objects,
+                                                    guint               num_events,
+                                                    const cl_event     *event_wait_list,
+                                                    cl_event           *event);
+void              gocl_device_load_snapshot        (cl_device_id        id,
+                                                    GoclDeviceSnapshot *snapshot);
+void              gocl_device_clear_snapshot       (GoclDeviceSnapshot *snapshot);
+cl_event          gocl_device_create_event_from_gl_sync (GoclDevice *self,
+                                                         gpointer    gl_sync,
+                                                         cl_int     *err_code);
+
 cl_command_queue  gocl_queue_get_queue             (GoclQueue *self);
+void              gocl_queue_add_profile_sample    (GoclQueue   *self,
+                                                    const gchar *name,
+                                                    guint64      queued,
+                                                    guint64      start,
+                                                    guint64      end);
+void              gocl_queue_add_detached          (GoclQueue *self);
 
 cl_event          gocl_event_get_event             (GoclEvent *self);
+GoclEvent *       gocl_event_new_from_result       (GoclQueue               *queue,
+                                                    cl_int                   err_code,
+                                                    cl_event                 event,
+                                                    const GoclEventWaitList *wait_list);
+GoclEvent *       gocl_event_new_host              (void);
+gboolean          gocl_event_wait                  (GoclEvent *self);
+void              gocl_event_wait_list_init        (GoclEventWaitList *wait_list,
+                                                    GList             *event_list);
+void              gocl_event_wait_list_init_from_array (GoclEventWaitList *wait_list,
+                                                        GoclEvent * const *events,
+                                                        guint              num_events);
+void              gocl_event_wait_list_clear       (GoclEventWaitList *wait_list);
+gboolean          gocl_event_wait_for_result       (cl_int    err_code,
+                                                    cl_event  event);
+void              gocl_event_set_label             (GoclEvent   *self,
+                                                    const gchar *label);
+cl_int            gocl_event_add_cl_callback       (cl_event  event,
+                                                    void (CL_CALLBACK *callback) (cl_event,
+                                                                                  cl_int,
+                                                                                  void *),
+                                                    gpointer  user_data);
 
 
 gboolean          gocl_error_check_opencl          (cl_int   err_code,
@@ -54,6 +184,30 @@ gboolean          gocl_error_check_opencl_internal (cl_int err_code);
 GError **         gocl_error_prepare               (void);
 void              gocl_error_free                  (void);
 
+void              gocl_trace_add_span              (const gchar *category,
+                                                    const gchar *name,
+                                                    const gchar *label,
+                                                    gint64       start,
+                                                    gint64       end);
+void              gocl_trace_add_counter           (const gchar *category,
+                                                    const gchar *name,
+                                                    const gchar *label,
+                                                    gint64       value);
+void              gocl_trace_object_changed        (GoclTraceObject type,
+                                                    gint            delta);
+
+const gchar *     gocl_cache_get_dir               (void);
+GChecksum *       gocl_cache_checksum_new          (cl_device_id device_id);
+void              gocl_cache_checksum_add_string   (GChecksum   *checksum,
+                                                    const gchar *str);
+gpointer          gocl_cache_load                  (const gchar *key,
+                                                    const gchar *suffix,
+                                                    gsize       *size);
+gboolean          gocl_cache_save                  (const gchar   *key,
+                                                    const gchar   *suffix,
+                                                    gconstpointer  data,
+                                                    gsize          size);
+
 G_END_DECLS
 
 #endif /* __GOCL_PRIVATE_H__ */
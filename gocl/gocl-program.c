@@ -33,12 +33,29 @@
  * when source code is in a single file.
  *
  * Currently, creating a program from pre-compiled, binary code is not supported,
- * but will be in the future.
+ * but will be in the future. However, built binaries can be transparently
+ * cached on disk and reused by later runs, by enabling the binary cache
+ * with gocl_program_set_use_cache().
+ *
+ * Instead of building each program from its whole source, programs can be
+ * compiled separately with gocl_program_compile_sync(), optionally
+ * including embedded headers, and the resulting objects linked into an
+ * executable program or a library with gocl_program_link_sync(). This
+ * allows compiling code shared by many programs only once.
+ *
+ * A program can also be specialized at build time with preprocessor
+ * macros. gocl_program_get_variant_sync() builds one variant of the
+ * program per dictionary of macros on first use, and keeps it for later.
  *
  * Once a program is created, it needs to be built before kernels can be created
  * from it. To build a program asynchronously, gocl_program_build() and
  * gocl_program_build_finish() methods are provided. For building synchronously,
- * gocl_program_build_sync() is used.
+ * gocl_program_build_sync() is used. Asynchronous builds of all programs
+ * share a thread pool of bounded size, see
+ * gocl_program_set_max_build_threads(). A build can be restricted to some
+ * of the devices of the context with gocl_program_build_for_devices() and
+ * gocl_program_build_for_devices_sync(). When a build fails, its log is
+ * available from gocl_program_get_build_log().
  *
  * Once a program is successfully built, kernels can be obtained from it using
  * gocl_program_get_kernel() method.
@@ -51,6 +68,7 @@
  * The class for #GoclProgram objects.
  **/
 
+#include <stdio.h>
 #include <string.h>
 
 #include "gocl-program.h"
@@ -58,6 +76,13 @@
 #include "gocl-private.h"
 #include "gocl-error.h"
 
+#define BINARY_CACHE_SUFFIX ".bin"
+#define OBJECT_CACHE_SUFFIX ".obj"
+
+#define KERNEL_ARG_INFO_OPTION "-cl-kernel-arg-info"
+
+#define DEFAULT_MAX_BUILD_THREADS 4
+
 struct _GoclProgramPrivate
 {
   cl_program program;
@@ -65,13 +90,45 @@ struct _GoclProgramPrivate
   GoclContext *context;
 
   gboolean building;
+
+  gchar *source;
+  gboolean use_cache;
+
+  gchar *build_log;
+  gchar *build_options;
+  gboolean kernel_arg_info;
+
+  GMutex variants_mutex;
+  GHashTable *variants;
 };
 
+/* an asynchronous build is owned by the pool thread that runs it and, once
+   the build is started with a notify callback, by that callback too. Each
+   one holds a reference, and the first to see the build end claims it */
+typedef struct
+{
+  volatile gint ref_count;
+  volatile gint completed;
+
+  /* set when the driver is done building, and the closure is pushed back
+     to the pool to finish the operation there */
+  gboolean finishing;
+
+  GSimpleAsyncResult *res;
+  GoclProgram *self;
+  GCancellable *cancellable;
+
+  gchar *options;
+  cl_device_id *devices;
+  cl_uint num_devices;
+} BuildClosure;
+
 /* properties */
 enum
 {
   PROP_0,
-  PROP_CONTEXT
+  PROP_CONTEXT,
+  PROP_USE_CACHE
 };
 
 static void           gocl_program_class_init            (GoclProgramClass *class);
@@ -89,6 +146,8 @@ static void           get_property                       (GObject    *obj,
                                                           GValue     *value,
                                                           GParamSpec *pspec);
 
+static void           push_build                         (BuildClosure *closure);
+
 G_DEFINE_TYPE (GoclProgram, gocl_program, G_TYPE_OBJECT);
 
 #define GOCL_PROGRAM_GET_PRIVATE(obj)                   \
@@ -96,6 +155,11 @@ G_DEFINE_TYPE (GoclProgram, gocl_program, G_TYPE_OBJECT);
                                 GOCL_TYPE_PROGRAM,      \
                                 GoclProgramPrivate))    \
 
+/* the pool shared by all asynchronous builds, created on first use */
+G_LOCK_DEFINE_STATIC (build_pool);
+static GThreadPool *build_pool = NULL;
+static guint max_build_threads = 0;
+
 static void
 gocl_program_class_init (GoclProgramClass *class)
 {
@@ -114,6 +178,14 @@ gocl_program_class_init (GoclProgramClass *class)
                                                         G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                         G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (obj_class, PROP_USE_CACHE,
+                                   g_param_spec_boolean ("use-cache",
+                                                         "Use cache",
+                                                         "Whether program binaries are cached on disk",
+                                                         FALSE,
+                                                         G_PARAM_READWRITE |
+                                                         G_PARAM_STATIC_STRINGS));
+
   g_type_class_add_private (class, sizeof (GoclProgramPrivate));
 }
 
@@ -124,7 +196,21 @@ gocl_program_init (GoclProgram *self)
 
   self->priv = priv = GOCL_PROGRAM_GET_PRIVATE (self);
 
+  GOCL_TRACE_OBJECT_NEW (GOCL_TRACE_OBJECT_PROGRAM);
+
+  priv->program = NULL;
   priv->building = FALSE;
+
+  priv->source = NULL;
+  priv->use_cache = FALSE;
+
+  priv->build_log = NULL;
+
+  g_mutex_init (&priv->variants_mutex);
+  priv->variants = g_hash_table_new_full (g_str_hash,
+                                          g_str_equal,
+                                          g_free,
+                                          g_object_unref);
 }
 
 static void
@@ -140,7 +226,17 @@ gocl_program_finalize (GObject *obj)
 
   g_object_unref (self->priv->context);
 
-  clReleaseProgram (self->priv->program);
+  if (self->priv->program != NULL)
+    clReleaseProgram (self->priv->program);
+
+  g_free (self->priv->source);
+  g_free (self->priv->build_log);
+  g_free (self->priv->build_options);
+
+  g_hash_table_unref (self->priv->variants);
+  g_mutex_clear (&self->priv->variants_mutex);
+
+  GOCL_TRACE_OBJECT_FREE (GOCL_TRACE_OBJECT_PROGRAM);
 
   G_OBJECT_CLASS (gocl_program_parent_class)->finalize (obj);
 }
@@ -161,6 +257,10 @@ set_property (GObject      *obj,
       self->priv->context = g_value_dup_object (value);
       break;
 
+    case PROP_USE_CACHE:
+      self->priv->use_cache = g_value_get_boolean (value);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -183,33 +283,784 @@ get_property (GObject    *obj,
       g_value_set_object (value, self->priv->context);
       break;
 
+    case PROP_USE_CACHE:
+      g_value_set_boolean (value, self->priv->use_cache);
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
     }
 }
 
+static cl_device_id *
+get_program_devices (cl_program program, cl_uint *num_devices)
+{
+  cl_device_id *devices;
+  cl_int err_code;
+
+  err_code = clGetProgramInfo (program,
+                               CL_PROGRAM_NUM_DEVICES,
+                               sizeof (cl_uint),
+                               num_devices,
+                               NULL);
+  if (err_code != CL_SUCCESS || *num_devices == 0)
+    return NULL;
+
+  devices = g_new (cl_device_id, *num_devices);
+  err_code = clGetProgramInfo (program,
+                               CL_PROGRAM_DEVICES,
+                               sizeof (cl_device_id) * (*num_devices),
+                               devices,
+                               NULL);
+  if (err_code != CL_SUCCESS)
+    {
+      g_free (devices);
+      return NULL;
+    }
+
+  return devices;
+}
+
+static gchar *
+get_cache_key (GoclProgram  *self,
+               cl_device_id  device_id,
+               const gchar  *options)
+{
+  GChecksum *checksum;
+  gchar *key;
+
+  checksum = gocl_cache_checksum_new (device_id);
+  gocl_cache_checksum_add_string (checksum, self->priv->source);
+  gocl_cache_checksum_add_string (checksum, options);
+
+  key = g_strdup (g_checksum_get_string (checksum));
+  g_checksum_free (checksum);
+
+  return key;
+}
+
+/* drivers are not required to keep kernel argument info in program
+   binaries, even when built with KERNEL_ARG_INFO_OPTION, so a program
+   created from one may lack it. Checked on the first argument of the first
+   kernel that has any */
+static gboolean
+has_kernel_arg_info (cl_program program)
+{
+  cl_kernel *kernels;
+  cl_uint num_kernels = 0;
+  gboolean result = TRUE;
+  cl_int err_code;
+  guint i;
+
+  err_code = clCreateKernelsInProgram (program, 0, NULL, &num_kernels);
+  if (err_code != CL_SUCCESS || num_kernels == 0)
+    return TRUE;
+
+  kernels = g_new0 (cl_kernel, num_kernels);
+  err_code = clCreateKernelsInProgram (program, num_kernels, kernels, NULL);
+  if (err_code != CL_SUCCESS)
+    {
+      g_free (kernels);
+      return TRUE;
+    }
+
+  for (i = 0; i < num_kernels; i++)
+    {
+      cl_uint num_args = 0;
+      gsize size;
+
+      clGetKernelInfo (kernels[i],
+                       CL_KERNEL_NUM_ARGS,
+                       sizeof (cl_uint),
+                       &num_args,
+                       NULL);
+      if (num_args == 0)
+        continue;
+
+      err_code = clGetKernelArgInfo (kernels[i],
+                                     0,
+                                     CL_KERNEL_ARG_NAME,
+                                     0,
+                                     NULL,
+                                     &size);
+      result = err_code != CL_KERNEL_ARG_INFO_NOT_AVAILABLE;
+      break;
+    }
+
+  for (i = 0; i < num_kernels; i++)
+    clReleaseKernel (kernels[i]);
+  g_free (kernels);
+
+  return result;
+}
+
+/* attempts to replace the program by one created from cached binaries,
+   for @devices, returning FALSE if any binary is missing or fails to load or
+   build, or if the built program lost its kernel argument info, in which
+   case the original program is left untouched and is built from source.
+   Compiled objects are cached under their own suffix and are not built,
+   since they are only meant to be linked */
+static gboolean
+load_from_cache (GoclProgram        *self,
+                 const cl_device_id *devices,
+                 cl_uint             num_devices,
+                 const gchar        *options,
+                 const gchar        *suffix)
+{
+  guchar **binaries;
+  gsize *lengths;
+  cl_int *binary_status;
+  cl_program program = NULL;
+  cl_int err_code;
+  gboolean result = FALSE;
+  guint i;
+
+  binaries = g_new0 (guchar *, num_devices);
+  lengths = g_new0 (gsize, num_devices);
+  binary_status = g_new0 (cl_int, num_devices);
+
+  for (i = 0; i < num_devices; i++)
+    {
+      gchar *key;
+
+      key = get_cache_key (self, devices[i], options);
+      binaries[i] = gocl_cache_load (key, suffix, &lengths[i]);
+      g_free (key);
+
+      if (binaries[i] == NULL)
+        goto out;
+    }
+
+  program =
+    clCreateProgramWithBinary (gocl_context_get_context (self->priv->context),
+                               num_devices,
+                               devices,
+                               lengths,
+                               (const guchar **) binaries,
+                               binary_status,
+                               &err_code);
+  if (err_code != CL_SUCCESS)
+    goto out;
+
+  for (i = 0; i < num_devices; i++)
+    if (binary_status[i] != CL_SUCCESS)
+      goto out;
+
+  if (g_strcmp0 (suffix, BINARY_CACHE_SUFFIX) == 0)
+    {
+      err_code = clBuildProgram (program,
+                                 num_devices,
+                                 devices,
+                                 options,
+                                 NULL,
+                                 NULL);
+      if (err_code != CL_SUCCESS
+          || (self->priv->kernel_arg_info && ! has_kernel_arg_info (program)))
+        goto out;
+    }
+
+  clReleaseProgram (self->priv->program);
+  self->priv->program = program;
+  program = NULL;
+
+  result = TRUE;
+
+ out:
+  if (program != NULL)
+    clReleaseProgram (program);
+
+  for (i = 0; i < num_devices; i++)
+    g_free (binaries[i]);
+  g_free (binaries);
+  g_free (lengths);
+  g_free (binary_status);
+
+  return result;
+}
+
 static void
-build_in_thread (GSimpleAsyncResult *res,
-                 GObject            *object,
-                 GCancellable       *cancellable)
+save_to_cache (GoclProgram *self, const gchar *options, const gchar *suffix)
 {
-  GoclProgram *self = GOCL_PROGRAM (object);
-  gchar *options;
+  cl_device_id *devices;
+  cl_uint num_devices;
+  guchar **binaries;
+  gsize *lengths;
+  cl_int err_code;
+  guint i;
+
+  devices = get_program_devices (self->priv->program, &num_devices);
+  if (devices == NULL)
+    return;
+
+  binaries = g_new0 (guchar *, num_devices);
+  lengths = g_new0 (gsize, num_devices);
+
+  err_code = clGetProgramInfo (self->priv->program,
+                               CL_PROGRAM_BINARY_SIZES,
+                               sizeof (gsize) * num_devices,
+                               lengths,
+                               NULL);
+  if (err_code != CL_SUCCESS)
+    goto out;
+
+  for (i = 0; i < num_devices; i++)
+    binaries[i] = g_malloc (lengths[i]);
+
+  err_code = clGetProgramInfo (self->priv->program,
+                               CL_PROGRAM_BINARIES,
+                               sizeof (guchar *) * num_devices,
+                               binaries,
+                               NULL);
+  if (err_code != CL_SUCCESS)
+    goto out;
+
+  for (i = 0; i < num_devices; i++)
+    {
+      gchar *key;
+
+      if (lengths[i] == 0)
+        continue;
+
+      key = get_cache_key (self, devices[i], options);
+      gocl_cache_save (key, suffix, binaries[i], lengths[i]);
+      g_free (key);
+    }
+
+ out:
+  for (i = 0; i < num_devices; i++)
+    g_free (binaries[i]);
+  g_free (binaries);
+  g_free (lengths);
+  g_free (devices);
+}
+
+/* KERNEL_ARG_INFO_OPTION is new in OpenCL 1.2, and older compilers reject
+   it with CL_INVALID_BUILD_OPTIONS */
+static gboolean
+devices_support_kernel_arg_info (const cl_device_id *devices,
+                                 cl_uint             num_devices)
+{
+  guint i;
+
+  if (num_devices == 0)
+    return FALSE;
+
+  for (i = 0; i < num_devices; i++)
+    {
+      gchar version[128] = { 0, };
+      guint major = 0;
+      guint minor = 0;
+      cl_int err_code;
+
+      err_code = clGetDeviceInfo (devices[i],
+                                  CL_DEVICE_VERSION,
+                                  sizeof (version) - 1,
+                                  version,
+                                  NULL);
+      if (err_code != CL_SUCCESS
+          || sscanf (version, "OpenCL %u.%u", &major, &minor) != 2
+          || major < 1
+          || (major == 1 && minor < 2))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* kernel argument info is requested whenever all the devices the program
+   is built for support it, since kernels use it to validate and cache
+   their arguments. Without it they bind arguments unchecked */
+static gchar *
+get_build_options (GoclProgram        *self,
+                   const cl_device_id *devices,
+                   cl_uint             num_devices,
+                   const gchar        *options)
+{
+  cl_device_id *program_devices = NULL;
+
+  if (devices == NULL)
+    devices = program_devices = get_program_devices (self->priv->program,
+                                                     &num_devices);
+
+  self->priv->kernel_arg_info =
+    devices_support_kernel_arg_info (devices, num_devices);
+  g_free (program_devices);
+
+  if (! self->priv->kernel_arg_info)
+    return g_strdup (options != NULL ? options : "");
+
+  return g_strconcat (options != NULL ? options : "",
+                      " " KERNEL_ARG_INFO_OPTION,
+                      NULL);
+}
+
+static cl_device_id *
+get_device_ids_from_list (GList *devices, cl_uint *num_devices)
+{
+  cl_device_id *device_ids;
+  GList *node;
+  guint i = 0;
+
+  *num_devices = g_list_length (devices);
+  if (*num_devices == 0)
+    return NULL;
+
+  device_ids = g_new (cl_device_id, *num_devices);
+  for (node = devices; node != NULL; node = node->next)
+    device_ids[i++] = gocl_device_get_id (GOCL_DEVICE (node->data));
+
+  return device_ids;
+}
+
+/* a build started with a notify callback may return success before the
+   build is done, so the outcome is taken from the status of each device */
+static cl_int
+get_build_result (cl_program          program,
+                  const cl_device_id *devices,
+                  cl_uint             num_devices)
+{
+  guint i;
+
+  for (i = 0; i < num_devices; i++)
+    {
+      cl_build_status status;
+      cl_int err_code;
+
+      err_code = clGetProgramBuildInfo (program,
+                                        devices[i],
+                                        CL_PROGRAM_BUILD_STATUS,
+                                        sizeof (cl_build_status),
+                                        &status,
+                                        NULL);
+      if (err_code != CL_SUCCESS)
+        return err_code;
+
+      if (status != CL_BUILD_SUCCESS)
+        return CL_BUILD_PROGRAM_FAILURE;
+    }
+
+  return CL_SUCCESS;
+}
+
+/* concatenates the logs of the devices that failed to build, or returns
+   NULL if there is none */
+static gchar *
+get_build_log (cl_program          program,
+               const cl_device_id *devices,
+               cl_uint             num_devices)
+{
+  GString *log;
+  guint i;
+
+  log = g_string_new (NULL);
+
+  for (i = 0; i < num_devices; i++)
+    {
+      cl_build_status status;
+      gchar *device_log;
+      gsize size;
+      cl_int err_code;
+
+      err_code = clGetProgramBuildInfo (program,
+                                        devices[i],
+                                        CL_PROGRAM_BUILD_STATUS,
+                                        sizeof (cl_build_status),
+                                        &status,
+                                        NULL);
+      if (err_code != CL_SUCCESS || status != CL_BUILD_ERROR)
+        continue;
+
+      err_code = clGetProgramBuildInfo (program,
+                                        devices[i],
+                                        CL_PROGRAM_BUILD_LOG,
+                                        0,
+                                        NULL,
+                                        &size);
+      if (err_code != CL_SUCCESS || size <= 1)
+        continue;
+
+      device_log = g_malloc (size);
+      err_code = clGetProgramBuildInfo (program,
+                                        devices[i],
+                                        CL_PROGRAM_BUILD_LOG,
+                                        size,
+                                        device_log,
+                                        NULL);
+      if (err_code == CL_SUCCESS)
+        {
+          device_log[size - 1] = '\0';
+          g_string_append (log, device_log);
+          if (log->len > 0 && log->str[log->len - 1] != '\n')
+            g_string_append_c (log, '\n');
+        }
+
+      g_free (device_log);
+    }
+
+  if (log->len == 0)
+    {
+      g_string_free (log, TRUE);
+      return NULL;
+    }
+
+  return g_string_free (log, FALSE);
+}
+
+/* called once the driver is done with a build. On failure the build log is
+   kept in the program and appended to the returned error, so that it is at
+   hand without further queries. On success the options are kept, binaries
+   are cached if enabled, and NULL is returned */
+static GError *
+finish_build (GoclProgram        *self,
+              const cl_device_id *devices,
+              cl_uint             num_devices,
+              const gchar        *options,
+              const gchar        *cache_suffix,
+              cl_int              err_code)
+{
+  GError *error = NULL;
+
+  if (err_code == CL_SUCCESS)
+    err_code = get_build_result (self->priv->program, devices, num_devices);
+
+  if (err_code == CL_SUCCESS)
+    {
+      g_free (self->priv->build_options);
+      self->priv->build_options = g_strdup (options);
+
+      if (self->priv->use_cache)
+        save_to_cache (self, options, cache_suffix);
+
+      return NULL;
+    }
+
+  if (err_code == CL_BUILD_PROGRAM_FAILURE
+      || err_code == CL_COMPILE_PROGRAM_FAILURE
+      || err_code == CL_LINK_PROGRAM_FAILURE)
+    self->priv->build_log = get_build_log (self->priv->program,
+                                           devices,
+                                           num_devices);
+
+  gocl_error_check_opencl (err_code, &error);
+
+  if (self->priv->build_log != NULL)
+    {
+      gchar *message;
+
+      message = g_strdup_printf ("%s:\n%s",
+                                 error->message,
+                                 self->priv->build_log);
+      g_free (error->message);
+      error->message = message;
+    }
+
+  return error;
+}
+
+static gboolean
+build_sync (GoclProgram  *self,
+            cl_device_id *devices,
+            cl_uint       num_devices,
+            const gchar  *options)
+{
+  cl_device_id *program_devices = NULL;
+  gchar *_options;
+  GError *error = NULL;
+  cl_int err_code;
+  gint64 trace_start;
+
+  if (devices == NULL)
+    devices = program_devices = get_program_devices (self->priv->program,
+                                                     &num_devices);
+
+  g_free (self->priv->build_log);
+  self->priv->build_log = NULL;
+
+  _options = get_build_options (self, devices, num_devices, options);
+
+  if (! self->priv->use_cache
+      || num_devices == 0
+      || ! load_from_cache (self,
+                            devices,
+                            num_devices,
+                            _options,
+                            BINARY_CACHE_SUFFIX))
+    {
+      trace_start = GOCL_TRACE_BEGIN ();
+      err_code = clBuildProgram (self->priv->program,
+                                 num_devices,
+                                 devices,
+                                 _options,
+                                 NULL,
+                                 NULL);
+      GOCL_TRACE_END ("program", "build", NULL, trace_start);
+
+      error = finish_build (self,
+                            devices,
+                            num_devices,
+                            _options,
+                            BINARY_CACHE_SUFFIX,
+                            err_code);
+    }
+
+  g_free (_options);
+  g_free (program_devices);
+
+  if (error != NULL)
+    {
+      g_propagate_error (gocl_error_prepare (), error);
+      return FALSE;
+    }
+
+  gocl_error_prepare ();
+
+  return TRUE;
+}
+
+static BuildClosure *
+build_closure_ref (BuildClosure *closure)
+{
+  g_atomic_int_inc (&closure->ref_count);
+
+  return closure;
+}
+
+static void
+build_closure_unref (BuildClosure *closure)
+{
+  if (! g_atomic_int_dec_and_test (&closure->ref_count))
+    return;
+
+  g_object_unref (closure->res);
+  if (closure->cancellable != NULL)
+    g_object_unref (closure->cancellable);
+
+  g_free (closure->options);
+  g_free (closure->devices);
+
+  g_slice_free (BuildClosure, closure);
+}
+
+static gboolean
+build_closure_claim (BuildClosure *closure)
+{
+  return g_atomic_int_compare_and_exchange (&closure->completed, 0, 1);
+}
+
+static void
+build_closure_complete (BuildClosure *closure, GError *error)
+{
+  if (error != NULL)
+    g_simple_async_result_take_error (closure->res, error);
+
+  g_atomic_int_set (&closure->self->priv->building, FALSE);
+
+  g_simple_async_result_complete_in_idle (closure->res);
+}
+
+/* runs in a driver thread, or in the pool thread if the driver calls it
+   before clBuildProgram() returns. Finishing the build, which may write
+   the binary cache, is handed back to the pool */
+static void CL_CALLBACK
+build_notify (cl_program program, void *user_data)
+{
+  BuildClosure *closure = user_data;
+
+  if (build_closure_claim (closure))
+    {
+      closure->finishing = TRUE;
+      push_build (build_closure_ref (closure));
+    }
+
+  build_closure_unref (closure);
+}
+
+static void
+build_in_pool (gpointer data, gpointer user_data)
+{
+  BuildClosure *closure = data;
+  GoclProgram *self = closure->self;
+  GError *error = NULL;
+  cl_int err_code;
+  gint64 trace_start;
+
+  if (closure->finishing)
+    {
+      build_closure_complete (closure, finish_build (self,
+                                                     closure->devices,
+                                                     closure->num_devices,
+                                                     closure->options,
+                                                     BINARY_CACHE_SUFFIX,
+                                                     CL_SUCCESS));
+      goto out;
+    }
+
+  if (g_cancellable_set_error_if_cancelled (closure->cancellable, &error))
+    {
+      build_closure_claim (closure);
+      build_closure_complete (closure, error);
+      goto out;
+    }
+
+  if (closure->devices == NULL)
+    closure->devices = get_program_devices (self->priv->program,
+                                            &closure->num_devices);
+
+  g_free (self->priv->build_log);
+  self->priv->build_log = NULL;
+
+  if (self->priv->use_cache
+      && closure->num_devices > 0
+      && load_from_cache (self,
+                          closure->devices,
+                          closure->num_devices,
+                          closure->options,
+                          BINARY_CACHE_SUFFIX))
+    {
+      build_closure_claim (closure);
+      build_closure_complete (closure, NULL);
+      goto out;
+    }
+
+  /* with a notify callback, drivers that support it return as soon as the
+     build has started, releasing this pool thread. The callback owns the
+     reference taken here, and releases it when called */
+  build_closure_ref (closure);
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clBuildProgram (self->priv->program,
+                             closure->num_devices,
+                             closure->devices,
+                             closure->options,
+                             build_notify,
+                             closure);
+  GOCL_TRACE_END ("program", "build", NULL, trace_start);
+
+  if (err_code == CL_SUCCESS)
+    goto out;
+
+  /* a failed build is still reported to the callback. Any other error
+     means the driver rejected the build as requested, so the callback is
+     never called, and the build is retried blocking this thread */
+  if (err_code != CL_BUILD_PROGRAM_FAILURE)
+    {
+      build_closure_unref (closure);
+
+      trace_start = GOCL_TRACE_BEGIN ();
+      err_code = clBuildProgram (self->priv->program,
+                                 closure->num_devices,
+                                 closure->devices,
+                                 closure->options,
+                                 NULL,
+                                 NULL);
+      GOCL_TRACE_END ("program", "build", NULL, trace_start);
+    }
+
+  if (build_closure_claim (closure))
+    build_closure_complete (closure, finish_build (self,
+                                                   closure->devices,
+                                                   closure->num_devices,
+                                                   closure->options,
+                                                   BINARY_CACHE_SUFFIX,
+                                                   err_code));
+
+ out:
+  build_closure_unref (closure);
+}
+
+/* compiled objects also depend on the headers they include, so their names
+   and sources are added to the options used as cache key */
+static gchar *
+get_compile_cache_options (const gchar         *options,
+                           GoclProgram * const *headers,
+                           const gchar * const *header_names,
+                           guint                num_headers)
+{
+  GString *str;
+  guint i;
+
+  str = g_string_new (options);
+
+  for (i = 0; i < num_headers; i++)
+    {
+      g_string_append_c (str, '\n');
+      g_string_append (str, header_names[i]);
+      g_string_append_c (str, '\n');
+      g_string_append (str, headers[i]->priv->source);
+    }
+
+  return g_string_free (str, FALSE);
+}
+
+/* turns a dictionary of defines into build options, sorted by name so that
+   equal dictionaries always give the same options */
+static gchar *
+get_variant_options (GHashTable *defines, const gchar *options)
+{
+  GString *str;
+  GList *names;
+  GList *node;
+
+  str = g_string_new (NULL);
+
+  if (defines != NULL)
+    {
+      names = g_list_sort (g_hash_table_get_keys (defines),
+                           (GCompareFunc) g_strcmp0);
+
+      for (node = names; node != NULL; node = node->next)
+        {
+          const gchar *value;
+
+          value = g_hash_table_lookup (defines, node->data);
+          if (value != NULL && value[0] != '\0')
+            g_string_append_printf (str, "-D %s=%s ",
+                                    (const gchar *) node->data,
+                                    value);
+          else
+            g_string_append_printf (str, "-D %s ",
+                                    (const gchar *) node->data);
+        }
+
+      g_list_free (names);
+    }
+
+  if (options != NULL)
+    g_string_append (str, options);
+
+  return g_string_free (str, FALSE);
+}
+
+static guint
+get_default_max_build_threads (void)
+{
+#if GLIB_CHECK_VERSION (2, 36, 0)
+  return g_get_num_processors ();
+#else
+  return DEFAULT_MAX_BUILD_THREADS;
+#endif
+}
 
-  options = g_simple_async_result_get_op_res_gpointer (res);
+static void
+push_build (BuildClosure *closure)
+{
+  G_LOCK (build_pool);
 
-  if (! gocl_program_build_sync (self, options))
+  if (build_pool == NULL)
     {
-      GError *error;
+      if (max_build_threads == 0)
+        max_build_threads = get_default_max_build_threads ();
 
-      error = gocl_error_get_last ();
-      g_simple_async_result_take_error (res, error);
+      build_pool = g_thread_pool_new (build_in_pool,
+                                      NULL,
+                                      max_build_threads,
+                                      FALSE,
+                                      NULL);
     }
 
-  g_object_unref (res);
+  g_thread_pool_push (build_pool, closure, NULL);
 
-  self->priv->building = FALSE;
+  G_UNLOCK (build_pool);
 }
 
 /* public */
@@ -232,6 +1083,8 @@ gocl_program_new (GoclContext  *context,
 {
   GoclProgram *self;
   cl_int err_code;
+  GString *source;
+  guint i;
 
   g_return_val_if_fail (GOCL_IS_CONTEXT (context), NULL);
   g_return_val_if_fail (sources != NULL, NULL);
@@ -243,6 +1096,12 @@ gocl_program_new (GoclContext  *context,
   if (num_sources < 1)
     num_sources = g_strv_length ((gchar **) sources);
 
+  /* keep a copy of the whole source, used as binary cache key */
+  source = g_string_new (NULL);
+  for (i = 0; i < num_sources; i++)
+    g_string_append (source, sources[i]);
+  self->priv->source = g_string_free (source, FALSE);
+
   self->priv->program =
     clCreateProgramWithSource (gocl_context_get_context (context),
                                num_sources,
@@ -250,7 +1109,10 @@ gocl_program_new (GoclContext  *context,
                                NULL,
                                &err_code);
   if (gocl_error_check_opencl_internal (err_code))
-    return NULL;
+    {
+      g_object_unref (self);
+      return NULL;
+    }
 
   return self;
 }
@@ -291,6 +1153,103 @@ gocl_program_new_from_file_sync (GoclContext *context, const gchar *filename)
   return self;
 }
 
+/**
+ * gocl_program_link_sync:
+ * @context: The #GoclContext
+ * @programs: (array length=num_programs): Array of programs compiled with
+ *   gocl_program_compile_sync(), or libraries created by a previous link
+ * @num_programs: The number of elements in @programs
+ * @options: (allow-none): A string specifying OpenCL link options, or %NULL
+ *
+ * Links compiled programs into a new #GoclProgram, for all the devices of
+ * @context. By default the resulting program is an executable, and kernels
+ * can be obtained from it directly with gocl_program_get_kernel(), without
+ * building it. If @options contains <i>-create-library</i>, a library is
+ * created instead, which can in turn be linked with other programs.
+ * This method is blocking. Upon error, %NULL is returned, and the link log
+ * is appended to the error message.
+ *
+ * Returns: (transfer full): A newly created #GoclProgram, or %NULL on error
+ **/
+GoclProgram *
+gocl_program_link_sync (GoclContext         *context,
+                        GoclProgram * const *programs,
+                        guint                num_programs,
+                        const gchar         *options)
+{
+  GoclProgram *self;
+  cl_program *input_programs;
+  cl_device_id *devices;
+  cl_uint num_devices = 0;
+  GString *source;
+  GError *error;
+  cl_int err_code;
+  gint64 trace_start;
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_CONTEXT (context), NULL);
+  g_return_val_if_fail (programs != NULL && num_programs > 0, NULL);
+
+  for (i = 0; i < num_programs; i++)
+    g_return_val_if_fail (GOCL_IS_PROGRAM (programs[i]), NULL);
+
+  self = g_object_new (GOCL_TYPE_PROGRAM,
+                       "context", context,
+                       NULL);
+
+  /* the linked program is identified by the sources of its inputs, which
+     keeps cache keys derived from it distinct */
+  source = g_string_new (NULL);
+  input_programs = g_new (cl_program, num_programs);
+  self->priv->kernel_arg_info = TRUE;
+  for (i = 0; i < num_programs; i++)
+    {
+      g_string_append (source, programs[i]->priv->source);
+      input_programs[i] = programs[i]->priv->program;
+
+      /* kernels keep the argument info of the objects they come from */
+      if (! programs[i]->priv->kernel_arg_info)
+        self->priv->kernel_arg_info = FALSE;
+    }
+  self->priv->source = g_string_free (source, FALSE);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  self->priv->program = clLinkProgram (gocl_context_get_context (context),
+                                       0,
+                                       NULL,
+                                       options,
+                                       num_programs,
+                                       input_programs,
+                                       NULL,
+                                       NULL,
+                                       &err_code);
+  GOCL_TRACE_END ("program", "link", NULL, trace_start);
+  g_free (input_programs);
+
+  devices = NULL;
+  if (self->priv->program != NULL)
+    devices = get_program_devices (self->priv->program, &num_devices);
+
+  error = finish_build (self,
+                        devices,
+                        num_devices,
+                        options,
+                        BINARY_CACHE_SUFFIX,
+                        err_code);
+  g_free (devices);
+
+  if (error != NULL)
+    {
+      g_propagate_error (gocl_error_prepare (), error);
+      g_object_unref (self);
+      return NULL;
+    }
+
+  gocl_error_prepare ();
+
+  return self;
+}
+
 /**
  * gocl_program_get_program:
  * @self: The #GoclProgram
@@ -308,6 +1267,62 @@ gocl_program_get_program (GoclProgram *self)
   return self->priv->program;
 }
 
+/**
+ * gocl_program_get_source:
+ * @self: The #GoclProgram
+ *
+ * Retrieves the whole source code of the program, as the concatenation of
+ * the sources passed to gocl_program_new(). This is a Gocl private
+ * function, not exposed to applications.
+ *
+ * Returns: (transfer none): The program source
+ **/
+const gchar *
+gocl_program_get_source (GoclProgram *self)
+{
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), NULL);
+
+  return self->priv->source;
+}
+
+/**
+ * gocl_program_get_build_options:
+ * @self: The #GoclProgram
+ *
+ * Retrieves the effective options of the last successful build, compile
+ * or link of the program, including the ones added by Gocl. This is a
+ * Gocl private function, not exposed to applications.
+ *
+ * Returns: (transfer none): The build options, or %NULL if the program is
+ * not built
+ **/
+const gchar *
+gocl_program_get_build_options (GoclProgram *self)
+{
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), NULL);
+
+  return self->priv->build_options;
+}
+
+/**
+ * gocl_program_has_kernel_arg_info:
+ * @self: The #GoclProgram
+ *
+ * Tells whether the program was built with kernel argument info, which
+ * requires OpenCL 1.2 on all its devices. Kernels of a program without it
+ * must not query it, and bind their arguments unchecked. This is a Gocl
+ * private function, not exposed to applications.
+ *
+ * Returns: %TRUE if kernel argument info was requested, %FALSE otherwise
+ **/
+gboolean
+gocl_program_has_kernel_arg_info (GoclProgram *self)
+{
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), FALSE);
+
+  return self->priv->kernel_arg_info;
+}
+
 /**
  * gocl_program_get_context:
  * @self: The #GoclProgram
@@ -325,6 +1340,47 @@ gocl_program_get_context (GoclProgram *self)
   return self->priv->context;
 }
 
+/**
+ * gocl_program_set_use_cache:
+ * @self: The #GoclProgram
+ * @use_cache: %TRUE to enable the binary cache, %FALSE to disable it
+ *
+ * Enables or disables the on-disk cache of program binaries. When enabled,
+ * gocl_program_build_sync() and gocl_program_build() first look for
+ * binaries previously built from the same source and options, for the same
+ * devices, drivers and platform, and load them with
+ * clCreateProgramWithBinary() instead of compiling the source. If no binary
+ * is found, or it fails to load, the program is built from source as usual
+ * and the resulting binaries are stored in the cache.
+ *
+ * Binaries are stored under <i>$XDG_CACHE_HOME/gocl</i>. The cache is
+ * disabled by default.
+ **/
+void
+gocl_program_set_use_cache (GoclProgram *self, gboolean use_cache)
+{
+  g_return_if_fail (GOCL_IS_PROGRAM (self));
+
+  self->priv->use_cache = use_cache;
+}
+
+/**
+ * gocl_program_get_use_cache:
+ * @self: The #GoclProgram
+ *
+ * Tells whether the on-disk cache of program binaries is enabled for this
+ * program. See gocl_program_set_use_cache().
+ *
+ * Returns: %TRUE if the binary cache is enabled, %FALSE otherwise
+ **/
+gboolean
+gocl_program_get_use_cache (GoclProgram *self)
+{
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), FALSE);
+
+  return self->priv->use_cache;
+}
+
 /**
  * gocl_program_get_kernel:
  * @self: The #GoclProgram
@@ -367,23 +1423,60 @@ gocl_program_get_kernel (GoclProgram *self, const gchar *kernel_name)
  * documentation website:
  * http://www.khronos.org/registry/cl/sdk/1.0/docs/man/xhtml/clBuildProgram.html
  *
+ * The <i>-cl-kernel-arg-info</i> option is added when all the devices
+ * support OpenCL 1.2 or later, so that kernels can retrieve the names and
+ * types of their arguments. On older devices kernel arguments can only be
+ * set by index, and are not checked.
+ *
+ * If the binary cache is enabled with gocl_program_set_use_cache(), the
+ * program binaries are loaded from the cache when available, and stored
+ * there after a successful build otherwise. Some drivers drop the kernel
+ * argument info from binaries; a cached program without it is discarded
+ * and built from source instead, so that setting arguments by name keeps
+ * working.
+ *
+ * If the build fails, the build log is appended to the error message and
+ * can also be retrieved with gocl_program_get_build_log().
+ *
  * Returns: %TRUE on success or %FALSE on error
  **/
 gboolean
 gocl_program_build_sync (GoclProgram *self, const gchar *options)
 {
-  cl_int err_code;
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), FALSE);
+
+  return build_sync (self, NULL, 0, options);
+}
+
+/**
+ * gocl_program_build_for_devices_sync:
+ * @self: The #GoclProgram
+ * @devices: (element-type Gocl.Device) (allow-none): A #GList of
+ *   #GoclDevice objects of the program's context, or %NULL for all of them
+ * @options: A string specifying OpenCL program build options
+ *
+ * Builds the program like gocl_program_build_sync(), but only for the
+ * devices in @devices. Kernels of the program can then only be run on
+ * those devices. This method is blocking. On error, %FALSE is returned.
+ *
+ * Returns: %TRUE on success or %FALSE on error
+ **/
+gboolean
+gocl_program_build_for_devices_sync (GoclProgram *self,
+                                     GList       *devices,
+                                     const gchar *options)
+{
+  cl_device_id *device_ids;
+  cl_uint num_devices;
+  gboolean result;
 
   g_return_val_if_fail (GOCL_IS_PROGRAM (self), FALSE);
 
-  err_code = clBuildProgram (self->priv->program,
-                             0,
-                             NULL,
-                             options,
-                             NULL,
-                             NULL);
+  device_ids = get_device_ids_from_list (devices, &num_devices);
+  result = build_sync (self, device_ids, num_devices, options);
+  g_free (device_ids);
 
-  return ! gocl_error_check_opencl_internal (err_code);
+  return result;
 }
 
 /**
@@ -399,8 +1492,17 @@ gocl_program_build_sync (GoclProgram *self, const gchar *options)
  * be called when the operation completes, and gocl_program_build_finish()
  * can be used within the callback to retrieve the result of the operation.
  *
+ * Builds run in a thread pool shared by all programs, so that many of them
+ * can be built concurrently without starting a thread for each. The size
+ * of the pool can be changed with gocl_program_set_max_build_threads().
+ * The build is started with a notify callback, so on drivers that build
+ * asynchronously the pool thread is released as soon as the build has
+ * started. Drivers that reject the callback build in the pool thread
+ * instead. Either way, the build is finished, and its binaries stored in
+ * the cache if enabled, in a pool thread rather than a driver thread.
+ *
  * A #GCancellable object can be passed in @cancellable to allow cancelling
- * the operation.
+ * the operation before the build starts.
  **/
 void
 gocl_program_build (GoclProgram         *self,
@@ -408,8 +1510,39 @@ gocl_program_build (GoclProgram         *self,
                     GCancellable        *cancellable,
                     GAsyncReadyCallback  callback,
                     gpointer             user_data)
+{
+  gocl_program_build_for_devices (self,
+                                  NULL,
+                                  options,
+                                  cancellable,
+                                  callback,
+                                  user_data);
+}
+
+/**
+ * gocl_program_build_for_devices:
+ * @self: The #GoclProgram
+ * @devices: (element-type Gocl.Device) (allow-none): A #GList of
+ *   #GoclDevice objects of the program's context, or %NULL for all of them
+ * @options: A string specifying OpenCL program build options
+ * @cancellable: (allow-none): A #GCancellable object, or %NULL
+ * @callback: (allow-none): Callback to be called upon completion, or %NULL
+ * @user_data: (allow-none): Arbitrary data to pass in @callback, or %NULL
+ *
+ * Builds the program like gocl_program_build(), but only for the devices
+ * in @devices. gocl_program_build_finish() is used to retrieve the result
+ * of the operation.
+ **/
+void
+gocl_program_build_for_devices (GoclProgram         *self,
+                                GList               *devices,
+                                const gchar         *options,
+                                GCancellable        *cancellable,
+                                GAsyncReadyCallback  callback,
+                                gpointer             user_data)
 {
   GSimpleAsyncResult *res;
+  BuildClosure *closure;
 
   g_return_if_fail (GOCL_IS_PROGRAM (self));
 
@@ -418,7 +1551,9 @@ gocl_program_build (GoclProgram         *self,
                                    user_data,
                                    gocl_program_build);
 
-  if (self->priv->building)
+  if (! g_atomic_int_compare_and_exchange (&self->priv->building,
+                                           FALSE,
+                                           TRUE))
     {
       g_simple_async_result_set_error (res,
                                        G_IO_ERROR,
@@ -426,23 +1561,23 @@ gocl_program_build (GoclProgram         *self,
                                        "A previous build operation is pending");
       g_simple_async_result_complete_in_idle (res);
       g_object_unref (res);
+      return;
     }
-  else
-    {
-      self->priv->building = TRUE;
-
-      if (options == NULL)
-        options = "";
 
-      g_simple_async_result_set_op_res_gpointer (res,
-                                                 g_strdup (options),
-                                                 g_free);
-
-      g_simple_async_result_run_in_thread (res,
-                                           build_in_thread,
-                                           G_PRIORITY_DEFAULT,
-                                           cancellable);
-    }
+  closure = g_slice_new0 (BuildClosure);
+  closure->ref_count = 1;
+  closure->res = res;
+  closure->self = self;
+  if (cancellable != NULL)
+    closure->cancellable = g_object_ref (cancellable);
+  closure->devices = get_device_ids_from_list (devices,
+                                               &closure->num_devices);
+  closure->options = get_build_options (self,
+                                        closure->devices,
+                                        closure->num_devices,
+                                        options);
+
+  push_build (closure);
 }
 
 /**
@@ -471,3 +1606,262 @@ gocl_program_build_finish (GoclProgram   *self,
     ! g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT (result),
                                              error);
 }
+
+/**
+ * gocl_program_compile_sync:
+ * @self: The #GoclProgram
+ * @options: (allow-none): A string specifying OpenCL compile options, or
+ *   %NULL
+ * @headers: (array length=num_headers) (allow-none): Array of programs
+ *   created from the sources of the headers included by @self, or %NULL
+ * @header_names: (array length=num_headers) (allow-none): Array of the
+ *   names by which each of @headers is included, or %NULL
+ * @num_headers: The number of elements in @headers and @header_names
+ *
+ * Compiles the program into an object for all the devices of its context,
+ * without linking it. Compiled objects are then combined into an
+ * executable or a library with gocl_program_link_sync(), so that code
+ * shared by several programs is compiled only once. This method is
+ * blocking. On error, %FALSE is returned and the build log is available
+ * from gocl_program_get_build_log().
+ *
+ * Headers are programs created with gocl_program_new() from the header
+ * sources, which are never built themselves. Each one is made available
+ * to <i>#include</i> directives under the name at the same position in
+ * @header_names, and can be shared by any number of compilations.
+ *
+ * The <i>-cl-kernel-arg-info</i> option is added as described in
+ * gocl_program_build_sync(). If the binary cache is enabled with gocl_program_set_use_cache(), compiled objects are
+ * loaded from and stored in the cache too, keyed on the source, the
+ * options and the headers. Unlike built programs, cached objects are not
+ * checked for kernel argument info, which some drivers drop from binaries,
+ * so disable the cache for objects whose kernels are set up by name.
+ *
+ * Returns: %TRUE on success or %FALSE on error
+ **/
+gboolean
+gocl_program_compile_sync (GoclProgram         *self,
+                           const gchar         *options,
+                           GoclProgram * const *headers,
+                           const gchar * const *header_names,
+                           guint                num_headers)
+{
+  cl_device_id *devices;
+  cl_uint num_devices = 0;
+  gchar *_options;
+  gchar *cache_options;
+  GError *error = NULL;
+  guint i;
+
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), FALSE);
+  g_return_val_if_fail (num_headers == 0 ||
+                        (headers != NULL && header_names != NULL), FALSE);
+
+  devices = get_program_devices (self->priv->program, &num_devices);
+
+  g_free (self->priv->build_log);
+  self->priv->build_log = NULL;
+
+  _options = get_build_options (self, devices, num_devices, options);
+  cache_options = get_compile_cache_options (_options,
+                                             headers,
+                                             header_names,
+                                             num_headers);
+
+  if (! self->priv->use_cache
+      || num_devices == 0
+      || ! load_from_cache (self,
+                            devices,
+                            num_devices,
+                            cache_options,
+                            OBJECT_CACHE_SUFFIX))
+    {
+      cl_program *header_programs;
+      cl_int err_code;
+      gint64 trace_start;
+
+      header_programs = g_new (cl_program, num_headers);
+      for (i = 0; i < num_headers; i++)
+        header_programs[i] = headers[i]->priv->program;
+
+      trace_start = GOCL_TRACE_BEGIN ();
+      err_code = clCompileProgram (self->priv->program,
+                                   num_devices,
+                                   devices,
+                                   _options,
+                                   num_headers,
+                                   num_headers > 0 ? header_programs : NULL,
+                                   num_headers > 0 ?
+                                   (const gchar **) header_names : NULL,
+                                   NULL,
+                                   NULL);
+      GOCL_TRACE_END ("program", "compile", NULL, trace_start);
+      g_free (header_programs);
+
+      error = finish_build (self,
+                            devices,
+                            num_devices,
+                            cache_options,
+                            OBJECT_CACHE_SUFFIX,
+                            err_code);
+    }
+
+  g_free (cache_options);
+  g_free (_options);
+  g_free (devices);
+
+  if (error != NULL)
+    {
+      g_propagate_error (gocl_error_prepare (), error);
+      return FALSE;
+    }
+
+  gocl_error_prepare ();
+
+  return TRUE;
+}
+
+/**
+ * gocl_program_get_variant_sync:
+ * @self: The #GoclProgram
+ * @defines: (element-type utf8 utf8) (allow-none): A #GHashTable mapping
+ *   the names of preprocessor macros to their values, or %NULL
+ * @options: (allow-none): Additional build options, or %NULL
+ *
+ * Retrieves a variant of the program specialized at build time by
+ * defining the macros in @defines, as if passing <i>-D name=value</i>
+ * build options for each of them. Macros mapped to %NULL or an empty
+ * string are defined without a value. This allows constant values like
+ * tile sizes or unroll factors to be folded by the compiler, instead of
+ * being passed as kernel arguments.
+ *
+ * Each variant is a separate #GoclProgram created from the same source,
+ * built lazily the first time it is requested, and kept by @self for later
+ * calls with equal @defines and @options, regardless of the order of
+ * @defines. Variants inherit the binary cache setting of @self when
+ * created. @self itself does not need to be built. This method is blocking
+ * when the variant is built. On error, %NULL is returned and the variant
+ * is not kept, so a later call builds it again.
+ *
+ * Returns: (transfer none): The built variant, or %NULL on error. The
+ *   returned object is owned by @self, do not free.
+ **/
+GoclProgram *
+gocl_program_get_variant_sync (GoclProgram *self,
+                               GHashTable  *defines,
+                               const gchar *options)
+{
+  GoclProgram *variant;
+  gchar *variant_options;
+
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), NULL);
+
+  variant_options = get_variant_options (defines, options);
+
+  /* the lock is held while building, so that concurrent first requests for
+     a variant build it only once */
+  g_mutex_lock (&self->priv->variants_mutex);
+
+  variant = g_hash_table_lookup (self->priv->variants, variant_options);
+  if (variant != NULL)
+    {
+      gocl_error_prepare ();
+      g_free (variant_options);
+      goto out;
+    }
+
+  variant = gocl_program_new (self->priv->context,
+                              (const gchar **) &self->priv->source,
+                              1);
+  if (variant == NULL)
+    {
+      g_free (variant_options);
+      goto out;
+    }
+
+  variant->priv->use_cache = self->priv->use_cache;
+
+  if (! gocl_program_build_sync (variant, variant_options))
+    {
+      g_object_unref (variant);
+      variant = NULL;
+      g_free (variant_options);
+      goto out;
+    }
+
+  g_hash_table_insert (self->priv->variants, variant_options, variant);
+
+ out:
+  g_mutex_unlock (&self->priv->variants_mutex);
+
+  return variant;
+}
+
+/**
+ * gocl_program_get_build_log:
+ * @self: The #GoclProgram
+ *
+ * Retrieves the log of the last failed build of the program, collected
+ * from the devices that failed when the build finished, so no further
+ * query to the driver is needed. The log is cleared when a new build
+ * starts, and is %NULL if the last build succeeded.
+ *
+ * Returns: (transfer none) (allow-none): The build log, or %NULL. The
+ *   returned string is owned by the program, do not free.
+ **/
+const gchar *
+gocl_program_get_build_log (GoclProgram *self)
+{
+  g_return_val_if_fail (GOCL_IS_PROGRAM (self), NULL);
+
+  return self->priv->build_log;
+}
+
+/**
+ * gocl_program_set_max_build_threads:
+ * @max_threads: The maximum number of threads, or 0 for the default
+ *
+ * Sets the maximum number of threads of the pool shared by all the
+ * asynchronous builds started with gocl_program_build(). Builds pushed
+ * while all threads are busy wait in the pool until one is released. By
+ * default, the number of processors is used.
+ **/
+void
+gocl_program_set_max_build_threads (guint max_threads)
+{
+  G_LOCK (build_pool);
+
+  if (max_threads == 0)
+    max_threads = get_default_max_build_threads ();
+
+  max_build_threads = max_threads;
+
+  if (build_pool != NULL)
+    g_thread_pool_set_max_threads (build_pool, max_threads, NULL);
+
+  G_UNLOCK (build_pool);
+}
+
+/**
+ * gocl_program_get_max_build_threads:
+ *
+ * Retrieves the maximum number of threads of the pool shared by all the
+ * asynchronous builds. See gocl_program_set_max_build_threads().
+ *
+ * Returns: The maximum number of build threads
+ **/
+guint
+gocl_program_get_max_build_threads (void)
+{
+  guint max_threads;
+
+  G_LOCK (build_pool);
+
+  if (max_build_threads == 0)
+    max_build_threads = get_default_max_build_threads ();
+  max_threads = max_build_threads;
+
+  G_UNLOCK (build_pool);
+
+  return max_threads;
+}
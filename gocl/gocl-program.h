@@ -61,23 +61,55 @@ GoclProgram *          gocl_program_new                        (GoclContext  *co
                                                                 guint         num_sources);
 GoclProgram *          gocl_program_new_from_file_sync         (GoclContext *context,
                                                                 const gchar *filename);
+GoclProgram *          gocl_program_link_sync                  (GoclContext         *context,
+                                                                GoclProgram * const *programs,
+                                                                guint                num_programs,
+                                                                const gchar         *options);
 
 GoclContext *          gocl_program_get_context                (GoclProgram *self);
 
+void                   gocl_program_set_use_cache              (GoclProgram *self,
+                                                                gboolean     use_cache);
+gboolean               gocl_program_get_use_cache              (GoclProgram *self);
+
 GoclKernel *           gocl_program_get_kernel                 (GoclProgram *self,
                                                                 const gchar *kernel_name);
 
 gboolean               gocl_program_build_sync                 (GoclProgram *self,
                                                                 const gchar *options);
+gboolean               gocl_program_build_for_devices_sync     (GoclProgram *self,
+                                                                GList       *devices,
+                                                                const gchar *options);
 void                   gocl_program_build                      (GoclProgram         *self,
                                                                 const gchar         *options,
                                                                 GCancellable        *cancellable,
                                                                 GAsyncReadyCallback  callback,
                                                                 gpointer             user_data);
+void                   gocl_program_build_for_devices          (GoclProgram         *self,
+                                                                GList               *devices,
+                                                                const gchar         *options,
+                                                                GCancellable        *cancellable,
+                                                                GAsyncReadyCallback  callback,
+                                                                gpointer             user_data);
 gboolean               gocl_program_build_finish               (GoclProgram   *self,
                                                                 GAsyncResult  *result,
                                                                 GError       **error);
 
+gboolean               gocl_program_compile_sync               (GoclProgram         *self,
+                                                                const gchar         *options,
+                                                                GoclProgram * const *headers,
+                                                                const gchar * const *header_names,
+                                                                guint                num_headers);
+
+GoclProgram *          gocl_program_get_variant_sync           (GoclProgram *self,
+                                                                GHashTable  *defines,
+                                                                const gchar *options);
+
+const gchar *          gocl_program_get_build_log              (GoclProgram *self);
+
+void                   gocl_program_set_max_build_threads      (guint max_threads);
+guint                  gocl_program_get_max_build_threads      (void);
+
 G_END_DECLS
 
 #endif /* __GOCL_PROGRAM_H__ */
@@ -25,14 +25,57 @@
  * @stability: Unstable
  *
  * A #GoclQueue represents an OpenCL command queue that is created from a
- * device, using gocl_device_get_default_queue(). Currently, there is no
- * API for creating command queues directly, but that can change as soon
- * as practical use cases require it.
+ * device, using gocl_device_get_default_queue(), or directly with
+ * gocl_queue_new().
  *
  * For API simplicity, operations on a command queue are handled
  * elsewhere, like gocl_kernel_run_in_device(), which internally enqueues
  * the execution; or gocl_buffer_read_sync() and gocl_buffer_write_sync(), which
  * internally enqueues read/write operations on the command queue.
+ *
+ * When a queue is created with %GOCL_QUEUE_FLAGS_PROFILING, the timing of
+ * every asynchronous operation that completes through a #GoclEvent is
+ * aggregated automatically. Samples are grouped by kernel function name for
+ * kernel executions, and by command type (e.g "read-buffer", "map-image")
+ * for other operations. The list of groups is obtained with
+ * gocl_queue_get_profile_names(), and the statistics of each group with
+ * gocl_queue_get_profile_stats().
+ *
+ * Creating an event for every command has a cost, which dominates when
+ * many small commands are enqueued. Operations like
+ * gocl_buffer_write_detached() or gocl_kernel_run_in_queue_detached()
+ * enqueue a command without creating any event. Their completion is
+ * signalled collectively by fences: markers enqueued with
+ * gocl_queue_fence(), which complete when all the commands enqueued before
+ * them have finished. If #GoclQueue:fence-interval is set, a fence is also
+ * enqueued automatically every that many detached commands, so that
+ * gocl_queue_get_num_pending() keeps track of the progress of the queue.
+ * gocl_queue_finish_sync() blocks until all the commands in the queue have
+ * finished.
+ **/
+
+/**
+ * GOCL_PROFILE_HISTOGRAM_BUCKETS:
+ *
+ * The number of buckets in the histograms of #GoclProfileStats.
+ **/
+
+/**
+ * GoclProfileStats:
+ * @count: The number of operations sampled
+ * @total_queued_ns: Accumulated queue latency, from the time the operation
+ * was enqueued until it started executing, in nanoseconds
+ * @max_queued_ns: Maximum queue latency observed, in nanoseconds
+ * @total_exec_ns: Accumulated execution time, in nanoseconds
+ * @max_exec_ns: Maximum execution time observed, in nanoseconds
+ * @queued_histogram: Histogram of queue latencies
+ * @exec_histogram: Histogram of execution times
+ *
+ * Aggregated timing of a group of operations, as returned by
+ * gocl_queue_get_profile_stats(). The histograms use power-of-two buckets:
+ * bucket N counts durations between 2^N and 2^(N+1) microseconds, except
+ * the first one, which also counts durations under a microsecond, and the
+ * last one, which counts all longer durations.
  **/
 
 /**
@@ -50,6 +93,22 @@
 #include "gocl-decls.h"
 #include "gocl-context.h"
 
+/* the number of detached commands known to have finished, shared with the
+   callbacks of fences, which may run after the queue is finalized */
+typedef struct
+{
+  volatile gint ref_count;
+
+  GMutex mutex;
+  guint64 num_completed;
+} FenceTracker;
+
+typedef struct
+{
+  FenceTracker *tracker;
+  guint64 num_detached;
+} Fence;
+
 struct _GoclQueuePrivate
 {
   cl_command_queue queue;
@@ -57,6 +116,16 @@ struct _GoclQueuePrivate
   GoclDevice *device;
 
   guint flags;
+
+  GMutex profile_mutex;
+  GHashTable *profile;
+
+  /* detached commands, protected by the fence mutex */
+  GMutex fence_mutex;
+  guint fence_interval;
+  guint commands_since_fence;
+  guint64 num_detached;
+  FenceTracker *tracker;
 };
 
 /* properties */
@@ -64,7 +133,8 @@ enum
 {
   PROP_0,
   PROP_DEVICE,
-  PROP_FLAGS
+  PROP_FLAGS,
+  PROP_FENCE_INTERVAL
 };
 
 static void           gocl_queue_class_init            (GoclQueueClass *class);
@@ -72,6 +142,7 @@ static void           gocl_queue_initable_iface_init   (GInitableIface *iface);
 static gboolean       gocl_queue_initable_init         (GInitable     *initable,
                                                         GCancellable  *cancellable,
                                                         GError       **error);
+static void           gocl_queue_async_initable_iface_init (GAsyncInitableIface *iface);
 static void           gocl_queue_init                  (GoclQueue *self);
 static void           gocl_queue_dispose               (GObject *obj);
 static void           gocl_queue_finalize              (GObject *obj);
@@ -85,9 +156,15 @@ static void           get_property                     (GObject    *obj,
                                                         GValue     *value,
                                                         GParamSpec *pspec);
 
+static void           free_profile_stats               (gpointer data);
+
+static void           fence_tracker_unref              (FenceTracker *tracker);
+
 G_DEFINE_TYPE_WITH_CODE (GoclQueue, gocl_queue, G_TYPE_OBJECT,
                          G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE,
-                                                gocl_queue_initable_iface_init));
+                                                gocl_queue_initable_iface_init)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_ASYNC_INITABLE,
+                                                gocl_queue_async_initable_iface_init));
 
 #define GOCL_QUEUE_GET_PRIVATE(obj)                     \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                  \
@@ -122,6 +199,16 @@ gocl_queue_class_init (GoclQueueClass *class)
                                                       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
                                                       G_PARAM_STATIC_STRINGS));
 
+  g_object_class_install_property (obj_class, PROP_FENCE_INTERVAL,
+                                   g_param_spec_uint ("fence-interval",
+                                                      "Fence interval",
+                                                      "The number of detached commands between automatic fences",
+                                                      0,
+                                                      G_MAXUINT,
+                                                      0,
+                                                      G_PARAM_READWRITE |
+                                                      G_PARAM_STATIC_STRINGS));
+
   g_type_class_add_private (class, sizeof (GoclQueuePrivate));
 }
 
@@ -131,6 +218,12 @@ gocl_queue_initable_iface_init (GInitableIface *iface)
   iface->init = gocl_queue_initable_init;
 }
 
+static void
+gocl_queue_async_initable_iface_init (GAsyncInitableIface *iface)
+{
+  /* the default implementation runs GInitable's init in a thread */
+}
+
 static gboolean
 gocl_queue_initable_init (GInitable     *initable,
                           GCancellable  *cancellable,
@@ -163,6 +256,22 @@ gocl_queue_init (GoclQueue *self)
   self->priv = priv = GOCL_QUEUE_GET_PRIVATE (self);
 
   priv->queue = NULL;
+
+  g_mutex_init (&priv->profile_mutex);
+  priv->profile = g_hash_table_new_full (g_str_hash,
+                                         g_str_equal,
+                                         g_free,
+                                         free_profile_stats);
+
+  g_mutex_init (&priv->fence_mutex);
+  priv->fence_interval = 0;
+  priv->commands_since_fence = 0;
+  priv->num_detached = 0;
+
+  priv->tracker = g_slice_new (FenceTracker);
+  priv->tracker->ref_count = 1;
+  g_mutex_init (&priv->tracker->mutex);
+  priv->tracker->num_completed = 0;
 }
 
 static void
@@ -187,6 +296,12 @@ gocl_queue_finalize (GObject *obj)
   if (self->priv->queue != NULL)
     clReleaseCommandQueue (self->priv->queue);
 
+  g_hash_table_unref (self->priv->profile);
+  g_mutex_clear (&self->priv->profile_mutex);
+
+  fence_tracker_unref (self->priv->tracker);
+  g_mutex_clear (&self->priv->fence_mutex);
+
   G_OBJECT_CLASS (gocl_queue_parent_class)->finalize (obj);
 }
 
@@ -210,6 +325,10 @@ set_property (GObject      *obj,
       self->priv->flags = g_value_get_uint (value);
       break;
 
+    case PROP_FENCE_INTERVAL:
+      gocl_queue_set_fence_interval (self, g_value_get_uint (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
@@ -236,12 +355,193 @@ get_property (GObject    *obj,
       g_value_set_uint (value, self->priv->flags);
       break;
 
+    case PROP_FENCE_INTERVAL:
+      g_value_set_uint (value, gocl_queue_get_fence_interval (self));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
       break;
     }
 }
 
+static void
+free_profile_stats (gpointer data)
+{
+  g_slice_free (GoclProfileStats, data);
+}
+
+static guint
+get_histogram_bucket (guint64 ns)
+{
+  guint64 us;
+  guint bucket = 0;
+
+  us = ns / 1000;
+  while (us > 1 && bucket < GOCL_PROFILE_HISTOGRAM_BUCKETS - 1)
+    {
+      us >>= 1;
+      bucket++;
+    }
+
+  return bucket;
+}
+
+static FenceTracker *
+fence_tracker_ref (FenceTracker *tracker)
+{
+  g_atomic_int_inc (&tracker->ref_count);
+
+  return tracker;
+}
+
+static void
+fence_tracker_unref (FenceTracker *tracker)
+{
+  if (! g_atomic_int_dec_and_test (&tracker->ref_count))
+    return;
+
+  g_mutex_clear (&tracker->mutex);
+  g_slice_free (FenceTracker, tracker);
+}
+
+static void
+fence_tracker_complete (FenceTracker *tracker, guint64 num_detached)
+{
+  g_mutex_lock (&tracker->mutex);
+  tracker->num_completed = MAX (tracker->num_completed, num_detached);
+  g_mutex_unlock (&tracker->mutex);
+}
+
+/* called by OpenCL, from any thread. A fence that failed still means that
+   the commands before it are no longer pending */
+static void CL_CALLBACK
+fence_on_complete (cl_event event, cl_int status, gpointer user_data)
+{
+  Fence *fence = user_data;
+
+  fence_tracker_complete (fence->tracker, fence->num_detached);
+
+  fence_tracker_unref (fence->tracker);
+  g_slice_free (Fence, fence);
+}
+
+/* enqueues a marker that completes when all the previous commands have,
+   and accounts the detached commands before it when it does. Called with
+   the fence mutex held */
+static cl_int
+enqueue_fence (GoclQueue *self, cl_event *event)
+{
+  Fence *fence;
+  cl_int err_code;
+  gint64 trace_start;
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clEnqueueMarkerWithWaitList (self->priv->queue, 0, NULL, event);
+  GOCL_TRACE_END ("queue", "fence", NULL, trace_start);
+
+  if (err_code != CL_SUCCESS)
+    return err_code;
+
+  self->priv->commands_since_fence = 0;
+
+  fence = g_slice_new (Fence);
+  fence->tracker = fence_tracker_ref (self->priv->tracker);
+  fence->num_detached = self->priv->num_detached;
+
+  err_code = gocl_event_add_cl_callback (*event, fence_on_complete, fence);
+  if (err_code != CL_SUCCESS)
+    {
+      fence_tracker_unref (fence->tracker);
+      g_slice_free (Fence, fence);
+    }
+
+  return err_code;
+}
+
+/* private */
+
+/**
+ * gocl_queue_add_profile_sample:
+ * @self: The #GoclQueue
+ * @name: The name of the group the sample belongs to
+ * @queued: The time the operation was enqueued, in nanoseconds
+ * @start: The time the operation started executing, in nanoseconds
+ * @end: The time the operation finished executing, in nanoseconds
+ *
+ * Accumulates the timing of a completed operation into the profile of
+ * this queue. This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_queue_add_profile_sample (GoclQueue   *self,
+                               const gchar *name,
+                               guint64      queued,
+                               guint64      start,
+                               guint64      end)
+{
+  GoclProfileStats *stats;
+  guint64 queued_ns;
+  guint64 exec_ns;
+
+  g_return_if_fail (GOCL_IS_QUEUE (self));
+  g_return_if_fail (name != NULL);
+
+  queued_ns = start > queued ? start - queued : 0;
+  exec_ns = end > start ? end - start : 0;
+
+  g_mutex_lock (&self->priv->profile_mutex);
+
+  stats = g_hash_table_lookup (self->priv->profile, name);
+  if (stats == NULL)
+    {
+      stats = g_slice_new0 (GoclProfileStats);
+      g_hash_table_insert (self->priv->profile, g_strdup (name), stats);
+    }
+
+  stats->count++;
+
+  stats->total_queued_ns += queued_ns;
+  stats->max_queued_ns = MAX (stats->max_queued_ns, queued_ns);
+  stats->queued_histogram[get_histogram_bucket (queued_ns)]++;
+
+  stats->total_exec_ns += exec_ns;
+  stats->max_exec_ns = MAX (stats->max_exec_ns, exec_ns);
+  stats->exec_histogram[get_histogram_bucket (exec_ns)]++;
+
+  g_mutex_unlock (&self->priv->profile_mutex);
+}
+
+/**
+ * gocl_queue_add_detached:
+ * @self: The #GoclQueue
+ *
+ * Accounts a command enqueued on this queue without an event, enqueuing a
+ * fence if #GoclQueue:fence-interval commands have been enqueued since the
+ * last one. This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_queue_add_detached (GoclQueue *self)
+{
+  cl_event event;
+
+  g_return_if_fail (GOCL_IS_QUEUE (self));
+
+  g_mutex_lock (&self->priv->fence_mutex);
+
+  self->priv->num_detached++;
+  self->priv->commands_since_fence++;
+
+  /* a failed fence is retried with the next command */
+  if (self->priv->fence_interval > 0 &&
+      self->priv->commands_since_fence >= self->priv->fence_interval &&
+      enqueue_fence (self, &event) == CL_SUCCESS)
+    {
+      clReleaseEvent (event);
+    }
+
+  g_mutex_unlock (&self->priv->fence_mutex);
+}
+
 /* public */
 
 /**
@@ -294,3 +594,226 @@ gocl_queue_get_flags (GoclQueue *self)
 
   return self->priv->flags;
 }
+
+/**
+ * gocl_queue_get_profile_names:
+ * @self: The #GoclQueue
+ *
+ * Retrieves the names of all groups of operations profiled so far on this
+ * queue. Kernel executions are grouped by kernel function name, and other
+ * operations by command type. The queue must have been created with
+ * %GOCL_QUEUE_FLAGS_PROFILING, otherwise the list is always empty.
+ *
+ * Returns: (element-type utf8) (transfer full): A newly allocated list of
+ * strings, free with g_list_free_full() and g_free()
+ **/
+GList *
+gocl_queue_get_profile_names (GoclQueue *self)
+{
+  GList *names = NULL;
+  GHashTableIter iter;
+  gpointer key;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), NULL);
+
+  g_mutex_lock (&self->priv->profile_mutex);
+
+  g_hash_table_iter_init (&iter, self->priv->profile);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    names = g_list_prepend (names, g_strdup (key));
+
+  g_mutex_unlock (&self->priv->profile_mutex);
+
+  return g_list_sort (names, (GCompareFunc) g_strcmp0);
+}
+
+/**
+ * gocl_queue_get_profile_stats:
+ * @self: The #GoclQueue
+ * @name: The name of a group of operations
+ * @stats: (out caller-allocates): A #GoclProfileStats to fill
+ *
+ * Copies the aggregated timing of the operations in the group @name into
+ * @stats. See gocl_queue_get_profile_names() for how groups are named.
+ *
+ * Returns: %TRUE if the group exists, %FALSE otherwise
+ **/
+gboolean
+gocl_queue_get_profile_stats (GoclQueue        *self,
+                              const gchar      *name,
+                              GoclProfileStats *stats)
+{
+  GoclProfileStats *_stats;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), FALSE);
+  g_return_val_if_fail (name != NULL, FALSE);
+  g_return_val_if_fail (stats != NULL, FALSE);
+
+  g_mutex_lock (&self->priv->profile_mutex);
+
+  _stats = g_hash_table_lookup (self->priv->profile, name);
+  if (_stats != NULL)
+    *stats = *_stats;
+
+  g_mutex_unlock (&self->priv->profile_mutex);
+
+  return _stats != NULL;
+}
+
+/**
+ * gocl_queue_reset_profile:
+ * @self: The #GoclQueue
+ *
+ * Discards all the profiling samples collected so far on this queue.
+ **/
+void
+gocl_queue_reset_profile (GoclQueue *self)
+{
+  g_return_if_fail (GOCL_IS_QUEUE (self));
+
+  g_mutex_lock (&self->priv->profile_mutex);
+  g_hash_table_remove_all (self->priv->profile);
+  g_mutex_unlock (&self->priv->profile_mutex);
+}
+
+/**
+ * gocl_queue_set_fence_interval:
+ * @self: The #GoclQueue
+ * @interval: The number of detached commands between automatic fences, or
+ * 0 to disable them
+ *
+ * Sets the #GoclQueue:fence-interval property, which makes the queue
+ * enqueue a fence every @interval detached commands. Fences are cheap, but
+ * not free, so the interval is a trade-off between overhead and how
+ * closely gocl_queue_get_num_pending() follows the progress of the queue.
+ **/
+void
+gocl_queue_set_fence_interval (GoclQueue *self, guint interval)
+{
+  g_return_if_fail (GOCL_IS_QUEUE (self));
+
+  g_mutex_lock (&self->priv->fence_mutex);
+  self->priv->fence_interval = interval;
+  g_mutex_unlock (&self->priv->fence_mutex);
+}
+
+/**
+ * gocl_queue_get_fence_interval:
+ * @self: The #GoclQueue
+ *
+ * Retrieves the #GoclQueue:fence-interval property.
+ *
+ * Returns: The number of detached commands between automatic fences, or 0
+ * if they are disabled
+ **/
+guint
+gocl_queue_get_fence_interval (GoclQueue *self)
+{
+  guint interval;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), 0);
+
+  g_mutex_lock (&self->priv->fence_mutex);
+  interval = self->priv->fence_interval;
+  g_mutex_unlock (&self->priv->fence_mutex);
+
+  return interval;
+}
+
+/**
+ * gocl_queue_get_num_pending:
+ * @self: The #GoclQueue
+ *
+ * Retrieves the number of detached commands enqueued on this queue that
+ * are not known to have finished yet. The count only decreases when a
+ * fence completes, or when gocl_queue_finish_sync() returns, so it is an
+ * upper bound of the commands actually pending.
+ *
+ * Returns: The number of detached commands pending
+ **/
+guint64
+gocl_queue_get_num_pending (GoclQueue *self)
+{
+  guint64 num_detached;
+  guint64 num_completed;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), 0);
+
+  /* completed first, since it never exceeds the detached count */
+  g_mutex_lock (&self->priv->tracker->mutex);
+  num_completed = self->priv->tracker->num_completed;
+  g_mutex_unlock (&self->priv->tracker->mutex);
+
+  g_mutex_lock (&self->priv->fence_mutex);
+  num_detached = self->priv->num_detached;
+  g_mutex_unlock (&self->priv->fence_mutex);
+
+  return num_detached - num_completed;
+}
+
+/**
+ * gocl_queue_fence:
+ * @self: The #GoclQueue
+ *
+ * Enqueues a fence, a marker that completes when all the commands enqueued
+ * on this queue before it have finished, whether they have an event or not.
+ * This is how completion of detached commands is observed: a single event
+ * stands for all of them.
+ *
+ * Returns: (transfer none): A #GoclEvent to get notified when all the
+ * previous commands finish
+ **/
+GoclEvent *
+gocl_queue_fence (GoclQueue *self)
+{
+  cl_int err_code;
+  cl_event event = NULL;
+  GoclEvent *_event;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), NULL);
+
+  g_mutex_lock (&self->priv->fence_mutex);
+  err_code = enqueue_fence (self, &event);
+  g_mutex_unlock (&self->priv->fence_mutex);
+
+  _event = gocl_event_new_from_result (self, err_code, event, NULL);
+  gocl_event_set_label (_event, "fence");
+  gocl_event_idle_unref (_event);
+
+  return _event;
+}
+
+/**
+ * gocl_queue_finish_sync:
+ * @self: The #GoclQueue
+ *
+ * Blocks the program execution until all the commands enqueued on this
+ * queue have finished. For a non-blocking version, use gocl_queue_fence().
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_queue_finish_sync (GoclQueue *self)
+{
+  cl_int err_code;
+  guint64 num_detached;
+  gint64 trace_start;
+
+  g_return_val_if_fail (GOCL_IS_QUEUE (self), FALSE);
+
+  g_mutex_lock (&self->priv->fence_mutex);
+  num_detached = self->priv->num_detached;
+  self->priv->commands_since_fence = 0;
+  g_mutex_unlock (&self->priv->fence_mutex);
+
+  trace_start = GOCL_TRACE_BEGIN ();
+  err_code = clFinish (self->priv->queue);
+  GOCL_TRACE_END ("queue", "finish", NULL, trace_start);
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  fence_tracker_complete (self->priv->tracker, num_detached);
+
+  return TRUE;
+}
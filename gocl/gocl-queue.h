@@ -38,6 +38,21 @@ typedef struct _GoclQueueClass GoclQueueClass;
 typedef struct _GoclQueue GoclQueue;
 typedef struct _GoclQueuePrivate GoclQueuePrivate;
 
+#define GOCL_PROFILE_HISTOGRAM_BUCKETS 24
+
+typedef struct
+{
+  guint64 count;
+
+  guint64 total_queued_ns;
+  guint64 max_queued_ns;
+  guint64 total_exec_ns;
+  guint64 max_exec_ns;
+
+  guint32 queued_histogram[GOCL_PROFILE_HISTOGRAM_BUCKETS];
+  guint32 exec_histogram[GOCL_PROFILE_HISTOGRAM_BUCKETS];
+} GoclProfileStats;
+
 struct _GoclQueue
 {
   GObject parent_instance;
@@ -54,6 +69,19 @@ GType                  gocl_queue_get_type                   (void) G_GNUC_CONST
 
 guint                  gocl_queue_get_flags                  (GoclQueue *self);
 
+GList *                gocl_queue_get_profile_names          (GoclQueue *self);
+gboolean               gocl_queue_get_profile_stats          (GoclQueue        *self,
+                                                              const gchar      *name,
+                                                              GoclProfileStats *stats);
+void                   gocl_queue_reset_profile              (GoclQueue *self);
+
+void                   gocl_queue_set_fence_interval         (GoclQueue *self,
+                                                              guint      interval);
+guint                  gocl_queue_get_fence_interval         (GoclQueue *self);
+guint64                gocl_queue_get_num_pending            (GoclQueue *self);
+
+gboolean               gocl_queue_finish_sync                (GoclQueue *self);
+
 G_END_DECLS
 
 #endif /* __GOCL_QUEUE_H__ */
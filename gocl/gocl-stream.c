@@ -0,0 +1,870 @@
+/*
+ * gocl-stream.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-stream
+ * @short_description: Object that pipelines the processing of large data
+ * sets in chunks
+ * @stability: Unstable
+ *
+ * A #GoclStream processes a data set that is too large to fit in device
+ * memory, by splitting it in chunks that are uploaded, processed by a
+ * #GoclKernel and downloaded back. Instead of doing these three steps one
+ * after another, the stream keeps several chunks in flight, so that
+ * uploading a chunk, running the kernel on the previous one and downloading
+ * the one before overlap in time. Each step is enqueued on a different
+ * command queue of the device, and the steps of a chunk are chained with
+ * events.
+ *
+ * A stream is created with gocl_stream_new(), specifying the kernel, the
+ * device, the size of the chunks, in bytes, and the number of slots. Each
+ * slot holds one chunk in flight, with its own input and output buffers in
+ * device memory, and its own staging memory obtained with
+ * gocl_context_alloc_pinned(). Two slots give double buffering, three slots
+ * give triple buffering, which is the default. The number of slots bounds
+ * the amount of memory used and how far reading input can get ahead of the
+ * device.
+ *
+ * The data is processed with gocl_stream_run_sync(), which obtains the
+ * chunks from a #GoclStreamReadFunc, or with
+ * gocl_stream_run_from_input_stream_sync(), which reads them from a
+ * #GInputStream. The results of each chunk are delivered, in order, to a
+ * #GoclStreamWriteFunc. Both callbacks are called from the thread that runs
+ * the stream.
+ *
+ * The kernel is executed in one dimension, with a global work size equal to
+ * the chunk size divided by the element size (see
+ * gocl_stream_set_element_size()). Its first two arguments are set to the
+ * input and output buffers of the chunk, which have the same size. If the
+ * kernel has a third argument, it is set to the number of valid elements in
+ * the chunk as an int, since the last chunk may be partial. Any other
+ * argument must be set by the application, as well as the local work size.
+ **/
+
+/**
+ * GoclStreamClass:
+ * @parent_class: The parent class
+ *
+ * The class for #GoclStream objects.
+ **/
+
+/**
+ * GoclStreamReadFunc:
+ * @self: The #GoclStream
+ * @buffer: (array length=size) (element-type guint8): The memory to fill
+ * with the next chunk
+ * @size: The size of @buffer, in bytes
+ * @user_data: (closure): The user data passed to gocl_stream_run_sync()
+ *
+ * Prototype of the function that provides the input data of a
+ * #GoclStream. It must copy the next chunk of input into @buffer, filling
+ * it completely unless the end of the input is reached.
+ *
+ * Returns: The number of bytes copied into @buffer, 0 at the end of the
+ * input, or -1 to abort processing
+ **/
+
+/**
+ * GoclStreamWriteFunc:
+ * @self: The #GoclStream
+ * @data: (array length=size) (element-type guint8): The output of a chunk
+ * @size: The size of @data, in bytes
+ * @user_data: (closure): The user data passed to the run method
+ *
+ * Prototype of the function that receives the output data of a
+ * #GoclStream. @data is only valid until this function returns.
+ *
+ * Returns: %TRUE to continue processing, %FALSE to abort
+ **/
+
+#include <string.h>
+
+#include "gocl-stream.h"
+
+#include "gocl-private.h"
+#include "gocl-decls.h"
+#include "gocl-buffer.h"
+#include "gocl-queue.h"
+
+#define DEFAULT_NUM_SLOTS 3
+#define MIN_NUM_SLOTS     2
+#define MAX_NUM_SLOTS     3
+
+/* kernel arguments set by the stream */
+#define INPUT_ARG  0
+#define OUTPUT_ARG 1
+#define COUNT_ARG  2
+
+typedef struct
+{
+  /* device memory */
+  GoclBuffer *input;
+  GoclBuffer *output;
+
+  /* pinned host memory */
+  gpointer input_ptr;
+  gpointer output_ptr;
+
+  /* the upload of the chunk in flight, kept until it is waited for, since
+     it reads the input staging memory even if the rest of the chunk could
+     not be enqueued */
+  cl_event upload_event;
+
+  /* the download of the chunk in flight, or NULL if the slot is free */
+  cl_event event;
+  gsize size;
+} Slot;
+
+typedef struct
+{
+  GInputStream *input_stream;
+  GCancellable *cancellable;
+} InputStreamClosure;
+
+struct _GoclStreamPrivate
+{
+  GoclKernel *kernel;
+  GoclDevice *device;
+  gsize chunk_size;
+  guint num_slots;
+  gsize element_size;
+
+  GoclQueue *upload_queue;
+  GoclQueue *compute_queue;
+  GoclQueue *download_queue;
+
+  Slot slots[MAX_NUM_SLOTS];
+
+  guint64 num_chunks;
+};
+
+/* properties */
+enum
+{
+  PROP_0,
+  PROP_KERNEL,
+  PROP_DEVICE,
+  PROP_CHUNK_SIZE,
+  PROP_NUM_SLOTS,
+  PROP_ELEMENT_SIZE
+};
+
+static void           gocl_stream_class_init            (GoclStreamClass *class);
+static void           gocl_stream_init                  (GoclStream *self);
+static void           gocl_stream_dispose               (GObject *obj);
+
+static void           set_property                      (GObject      *obj,
+                                                         guint         prop_id,
+                                                         const GValue *value,
+                                                         GParamSpec   *pspec);
+static void           get_property                      (GObject    *obj,
+                                                         guint       prop_id,
+                                                         GValue     *value,
+                                                         GParamSpec *pspec);
+
+static gboolean       complete_slot                     (GoclStream          *self,
+                                                         Slot                *slot,
+                                                         GoclStreamWriteFunc  write_func,
+                                                         gpointer             user_data);
+
+G_DEFINE_TYPE (GoclStream, gocl_stream, G_TYPE_OBJECT);
+
+#define GOCL_STREAM_GET_PRIVATE(obj)                    \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj),                  \
+                                GOCL_TYPE_STREAM,       \
+                                GoclStreamPrivate))     \
+
+static void
+gocl_stream_class_init (GoclStreamClass *class)
+{
+  GObjectClass *obj_class = G_OBJECT_CLASS (class);
+
+  obj_class->dispose = gocl_stream_dispose;
+  obj_class->get_property = get_property;
+  obj_class->set_property = set_property;
+
+  g_object_class_install_property (obj_class, PROP_KERNEL,
+                                   g_param_spec_object ("kernel",
+                                                        "Kernel",
+                                                        "The kernel that processes each chunk",
+                                                        GOCL_TYPE_KERNEL,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_DEVICE,
+                                   g_param_spec_object ("device",
+                                                        "Device",
+                                                        "The device where chunks are processed",
+                                                        GOCL_TYPE_DEVICE,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_CHUNK_SIZE,
+                                   g_param_spec_uint64 ("chunk-size",
+                                                        "Chunk size",
+                                                        "The size of each chunk, in bytes",
+                                                        1,
+                                                        G_MAXSIZE,
+                                                        1,
+                                                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_NUM_SLOTS,
+                                   g_param_spec_uint ("num-slots",
+                                                      "Number of slots",
+                                                      "The number of chunks kept in flight",
+                                                      MIN_NUM_SLOTS,
+                                                      MAX_NUM_SLOTS,
+                                                      DEFAULT_NUM_SLOTS,
+                                                      G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                      G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (obj_class, PROP_ELEMENT_SIZE,
+                                   g_param_spec_uint64 ("element-size",
+                                                        "Element size",
+                                                        "The size of each element processed by a work-item, in bytes",
+                                                        1,
+                                                        G_MAXSIZE,
+                                                        1,
+                                                        G_PARAM_READWRITE |
+                                                        G_PARAM_STATIC_STRINGS));
+
+  g_type_class_add_private (class, sizeof (GoclStreamPrivate));
+}
+
+static void
+gocl_stream_init (GoclStream *self)
+{
+  GoclStreamPrivate *priv;
+
+  self->priv = priv = GOCL_STREAM_GET_PRIVATE (self);
+
+  priv->kernel = NULL;
+  priv->device = NULL;
+  priv->chunk_size = 1;
+  priv->num_slots = DEFAULT_NUM_SLOTS;
+  priv->element_size = 1;
+
+  priv->upload_queue = NULL;
+  priv->compute_queue = NULL;
+  priv->download_queue = NULL;
+
+  memset (priv->slots, 0, sizeof (Slot) * MAX_NUM_SLOTS);
+
+  priv->num_chunks = 0;
+}
+
+static void
+gocl_stream_dispose (GObject *obj)
+{
+  GoclStream *self = GOCL_STREAM (obj);
+  guint i;
+
+  for (i = 0; i < MAX_NUM_SLOTS; i++)
+    {
+      Slot *slot = &self->priv->slots[i];
+
+      complete_slot (self, slot, NULL, NULL);
+
+      if (slot->input_ptr != NULL)
+        gocl_context_free_pinned (gocl_device_get_context (self->priv->device),
+                                  slot->input_ptr);
+      if (slot->output_ptr != NULL)
+        gocl_context_free_pinned (gocl_device_get_context (self->priv->device),
+                                  slot->output_ptr);
+
+      if (slot->input != NULL)
+        g_object_unref (slot->input);
+      if (slot->output != NULL)
+        g_object_unref (slot->output);
+
+      memset (slot, 0, sizeof (Slot));
+    }
+
+  if (self->priv->upload_queue != NULL)
+    {
+      g_object_unref (self->priv->upload_queue);
+      self->priv->upload_queue = NULL;
+    }
+
+  if (self->priv->compute_queue != NULL)
+    {
+      g_object_unref (self->priv->compute_queue);
+      self->priv->compute_queue = NULL;
+    }
+
+  if (self->priv->download_queue != NULL)
+    {
+      g_object_unref (self->priv->download_queue);
+      self->priv->download_queue = NULL;
+    }
+
+  if (self->priv->kernel != NULL)
+    {
+      g_object_unref (self->priv->kernel);
+      self->priv->kernel = NULL;
+    }
+
+  if (self->priv->device != NULL)
+    {
+      g_object_unref (self->priv->device);
+      self->priv->device = NULL;
+    }
+
+  G_OBJECT_CLASS (gocl_stream_parent_class)->dispose (obj);
+}
+
+static void
+set_property (GObject      *obj,
+              guint         prop_id,
+              const GValue *value,
+              GParamSpec   *pspec)
+{
+  GoclStream *self = GOCL_STREAM (obj);
+
+  switch (prop_id)
+    {
+    case PROP_KERNEL:
+      self->priv->kernel = g_value_dup_object (value);
+      break;
+
+    case PROP_DEVICE:
+      self->priv->device = g_value_dup_object (value);
+      break;
+
+    case PROP_CHUNK_SIZE:
+      self->priv->chunk_size = g_value_get_uint64 (value);
+      break;
+
+    case PROP_NUM_SLOTS:
+      self->priv->num_slots = g_value_get_uint (value);
+      break;
+
+    case PROP_ELEMENT_SIZE:
+      self->priv->element_size = g_value_get_uint64 (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+get_property (GObject    *obj,
+              guint       prop_id,
+              GValue     *value,
+              GParamSpec *pspec)
+{
+  GoclStream *self = GOCL_STREAM (obj);
+
+  switch (prop_id)
+    {
+    case PROP_KERNEL:
+      g_value_set_object (value, self->priv->kernel);
+      break;
+
+    case PROP_DEVICE:
+      g_value_set_object (value, self->priv->device);
+      break;
+
+    case PROP_CHUNK_SIZE:
+      g_value_set_uint64 (value, self->priv->chunk_size);
+      break;
+
+    case PROP_NUM_SLOTS:
+      g_value_set_uint (value, self->priv->num_slots);
+      break;
+
+    case PROP_ELEMENT_SIZE:
+      g_value_set_uint64 (value, self->priv->element_size);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
+      break;
+    }
+}
+
+/* creates the queues and the memory of every slot. Errors are left in
+   Gocl's internal error */
+static gboolean
+setup (GoclStream *self)
+{
+  GoclContext *context;
+  guint i;
+
+  context = gocl_device_get_context (self->priv->device);
+
+  self->priv->upload_queue = gocl_device_get_transfer_queue (self->priv->device);
+  self->priv->compute_queue = gocl_device_get_compute_queue (self->priv->device);
+  if (self->priv->upload_queue == NULL || self->priv->compute_queue == NULL)
+    return FALSE;
+
+  g_object_ref (self->priv->upload_queue);
+  g_object_ref (self->priv->compute_queue);
+
+  self->priv->download_queue = gocl_queue_new (self->priv->device, 0);
+  if (self->priv->download_queue == NULL)
+    return FALSE;
+
+  for (i = 0; i < self->priv->num_slots; i++)
+    {
+      Slot *slot = &self->priv->slots[i];
+
+      slot->input = gocl_buffer_new (context,
+                                     GOCL_BUFFER_FLAGS_READ_ONLY,
+                                     self->priv->chunk_size,
+                                     NULL);
+      slot->output = gocl_buffer_new (context,
+                                      GOCL_BUFFER_FLAGS_WRITE_ONLY,
+                                      self->priv->chunk_size,
+                                      NULL);
+      if (slot->input == NULL || slot->output == NULL)
+        return FALSE;
+
+      slot->input_ptr = gocl_context_alloc_pinned (context,
+                                                   self->priv->chunk_size);
+      slot->output_ptr = gocl_context_alloc_pinned (context,
+                                                    self->priv->chunk_size);
+      if (slot->input_ptr == NULL || slot->output_ptr == NULL)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* waits for the chunk in flight in @slot, if any, and delivers its output
+   to @write_func, if not %NULL. Returns %FALSE on error or if @write_func
+   asks to abort. Either way, the staging memory of @slot is no longer in
+   use by the device on return */
+static gboolean
+complete_slot (GoclStream          *self,
+               Slot                *slot,
+               GoclStreamWriteFunc  write_func,
+               gpointer             user_data)
+{
+  cl_int err_code;
+
+  if (slot->upload_event != NULL)
+    {
+      clWaitForEvents (1, &slot->upload_event);
+      clReleaseEvent (slot->upload_event);
+      slot->upload_event = NULL;
+    }
+
+  if (slot->event == NULL)
+    return TRUE;
+
+  err_code = clWaitForEvents (1, &slot->event);
+  clReleaseEvent (slot->event);
+  slot->event = NULL;
+
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+
+  if (write_func == NULL)
+    return TRUE;
+
+  self->priv->num_chunks++;
+
+  return write_func (self, slot->output_ptr, slot->size, user_data);
+}
+
+/* enqueues the upload, kernel execution and download of the chunk in the
+   input staging memory of @slot */
+static gboolean
+enqueue_slot (GoclStream *self, Slot *slot, gsize size)
+{
+  cl_int err_code;
+  cl_event compute_event;
+  gsize global_work_size[3];
+  gint32 num_elements;
+
+  err_code = clEnqueueWriteBuffer (gocl_queue_get_queue (self->priv->upload_queue),
+                                   gocl_buffer_get_buffer (slot->input),
+                                   CL_FALSE,
+                                   0,
+                                   size,
+                                   slot->input_ptr,
+                                   0,
+                                   NULL,
+                                   &slot->upload_event);
+  if (gocl_error_check_opencl_internal (err_code))
+    {
+      slot->upload_event = NULL;
+      return FALSE;
+    }
+  clFlush (gocl_queue_get_queue (self->priv->upload_queue));
+
+  gocl_kernel_set_argument_buffer (self->priv->kernel, INPUT_ARG, slot->input);
+  gocl_kernel_set_argument_buffer (self->priv->kernel, OUTPUT_ARG, slot->output);
+  if (gocl_kernel_get_num_arguments (self->priv->kernel) > COUNT_ARG)
+    {
+      num_elements = size / self->priv->element_size;
+      gocl_kernel_set_argument_int32 (self->priv->kernel,
+                                      COUNT_ARG,
+                                      1,
+                                      &num_elements);
+    }
+
+  global_work_size[0] = self->priv->chunk_size / self->priv->element_size;
+  global_work_size[1] = 1;
+  global_work_size[2] = 1;
+
+  err_code = gocl_kernel_enqueue (self->priv->kernel,
+                                  gocl_queue_get_queue (self->priv->compute_queue),
+                                  NULL,
+                                  global_work_size,
+                                  1,
+                                  &slot->upload_event,
+                                  &compute_event);
+  if (gocl_error_check_opencl_internal (err_code))
+    return FALSE;
+  clFlush (gocl_queue_get_queue (self->priv->compute_queue));
+
+  err_code = clEnqueueReadBuffer (gocl_queue_get_queue (self->priv->download_queue),
+                                  gocl_buffer_get_buffer (slot->output),
+                                  CL_FALSE,
+                                  0,
+                                  size,
+                                  slot->output_ptr,
+                                  1,
+                                  &compute_event,
+                                  &slot->event);
+  clReleaseEvent (compute_event);
+  if (gocl_error_check_opencl_internal (err_code))
+    {
+      slot->event = NULL;
+      return FALSE;
+    }
+  clFlush (gocl_queue_get_queue (self->priv->download_queue));
+
+  slot->size = size;
+
+  return TRUE;
+}
+
+static gboolean
+run (GoclStream          *self,
+     GoclStreamReadFunc   read_func,
+     gpointer             read_data,
+     GoclStreamWriteFunc  write_func,
+     gpointer             write_data)
+{
+  gboolean result = TRUE;
+  guint i = 0;
+  guint j;
+
+  self->priv->num_chunks = 0;
+  gocl_kernel_set_work_dimension (self->priv->kernel, 1);
+
+  while (TRUE)
+    {
+      Slot *slot = &self->priv->slots[i];
+      gssize size;
+
+      /* the slot is reused only after its previous chunk is delivered,
+         which bounds how far reading can get ahead of the device */
+      if (! complete_slot (self, slot, write_func, write_data))
+        {
+          result = FALSE;
+          break;
+        }
+
+      size = read_func (self,
+                        slot->input_ptr,
+                        self->priv->chunk_size,
+                        read_data);
+      if (size <= 0)
+        {
+          result = size == 0;
+          break;
+        }
+
+      if (! enqueue_slot (self, slot, MIN ((gsize) size, self->priv->chunk_size)))
+        {
+          result = FALSE;
+          break;
+        }
+
+      i = (i + 1) % self->priv->num_slots;
+    }
+
+  /* drain the chunks still in flight, from the oldest one. After an error,
+     they are waited for but not delivered */
+  for (j = 0; j < self->priv->num_slots; j++)
+    {
+      Slot *slot = &self->priv->slots[(i + j) % self->priv->num_slots];
+
+      if (! complete_slot (self, slot, result ? write_func : NULL, write_data))
+        result = FALSE;
+    }
+
+  return result;
+}
+
+static gssize
+read_input_stream (GoclStream *self,
+                   gpointer    buffer,
+                   gsize       size,
+                   gpointer    user_data)
+{
+  InputStreamClosure *closure = user_data;
+  gsize bytes_read;
+
+  if (! g_input_stream_read_all (closure->input_stream,
+                                 buffer,
+                                 size,
+                                 &bytes_read,
+                                 closure->cancellable,
+                                 gocl_error_prepare ()))
+    {
+      return -1;
+    }
+
+  return bytes_read;
+}
+
+/* public */
+
+/**
+ * gocl_stream_new:
+ * @kernel: The #GoclKernel that processes each chunk
+ * @device: The #GoclDevice where chunks are processed
+ * @chunk_size: The size of each chunk, in bytes
+ * @num_slots: The number of chunks kept in flight, 2 or 3, or 0 to use the
+ * default of 3
+ *
+ * Creates a new stream to process data in chunks of @chunk_size bytes with
+ * @kernel, on @device. Device and pinned host memory for all the slots is
+ * allocated right away.
+ *
+ * Returns: (transfer full): A newly created #GoclStream, or %NULL on error
+ **/
+GoclStream *
+gocl_stream_new (GoclKernel *kernel,
+                 GoclDevice *device,
+                 gsize       chunk_size,
+                 guint       num_slots)
+{
+  GoclStream *self;
+
+  g_return_val_if_fail (GOCL_IS_KERNEL (kernel), NULL);
+  g_return_val_if_fail (GOCL_IS_DEVICE (device), NULL);
+  g_return_val_if_fail (chunk_size > 0, NULL);
+  g_return_val_if_fail (num_slots == 0 ||
+                        (num_slots >= MIN_NUM_SLOTS &&
+                         num_slots <= MAX_NUM_SLOTS), NULL);
+
+  self = g_object_new (GOCL_TYPE_STREAM,
+                       "kernel", kernel,
+                       "device", device,
+                       "chunk-size", (guint64) chunk_size,
+                       "num-slots", num_slots > 0 ? num_slots : DEFAULT_NUM_SLOTS,
+                       NULL);
+
+  if (! setup (self))
+    {
+      g_object_unref (self);
+      return NULL;
+    }
+
+  return self;
+}
+
+/**
+ * gocl_stream_get_kernel:
+ * @self: The #GoclStream
+ *
+ * Retrieves the kernel that processes the chunks of this stream.
+ *
+ * Returns: (transfer none): The #GoclKernel of the stream
+ **/
+GoclKernel *
+gocl_stream_get_kernel (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), NULL);
+
+  return self->priv->kernel;
+}
+
+/**
+ * gocl_stream_get_device:
+ * @self: The #GoclStream
+ *
+ * Retrieves the device where the chunks of this stream are processed.
+ *
+ * Returns: (transfer none): The #GoclDevice of the stream
+ **/
+GoclDevice *
+gocl_stream_get_device (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), NULL);
+
+  return self->priv->device;
+}
+
+/**
+ * gocl_stream_get_chunk_size:
+ * @self: The #GoclStream
+ *
+ * Retrieves the size of the chunks processed by this stream.
+ *
+ * Returns: The chunk size, in bytes
+ **/
+gsize
+gocl_stream_get_chunk_size (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), 0);
+
+  return self->priv->chunk_size;
+}
+
+/**
+ * gocl_stream_get_num_slots:
+ * @self: The #GoclStream
+ *
+ * Retrieves the maximum number of chunks this stream keeps in flight.
+ *
+ * Returns: The number of slots
+ **/
+guint
+gocl_stream_get_num_slots (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), 0);
+
+  return self->priv->num_slots;
+}
+
+/**
+ * gocl_stream_set_element_size:
+ * @self: The #GoclStream
+ * @element_size: The size of the elements, in bytes
+ *
+ * Sets the size of the data elements processed by each work-item of the
+ * kernel, for instance 4 for a kernel that processes floats. The global work
+ * size of the kernel, and the number of valid elements passed to it, are
+ * computed from this value. By default, it is 1. The chunk size should be
+ * a multiple of @element_size.
+ **/
+void
+gocl_stream_set_element_size (GoclStream *self, gsize element_size)
+{
+  g_return_if_fail (GOCL_IS_STREAM (self));
+  g_return_if_fail (element_size > 0);
+
+  self->priv->element_size = element_size;
+}
+
+/**
+ * gocl_stream_get_element_size:
+ * @self: The #GoclStream
+ *
+ * Retrieves the size of the data elements processed by each work-item of
+ * the kernel. See gocl_stream_set_element_size().
+ *
+ * Returns: The element size, in bytes
+ **/
+gsize
+gocl_stream_get_element_size (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), 0);
+
+  return self->priv->element_size;
+}
+
+/**
+ * gocl_stream_get_num_chunks:
+ * @self: The #GoclStream
+ *
+ * Retrieves the number of chunks delivered during the current or last run
+ * of the stream.
+ *
+ * Returns: The number of chunks processed
+ **/
+guint64
+gocl_stream_get_num_chunks (GoclStream *self)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), 0);
+
+  return self->priv->num_chunks;
+}
+
+/**
+ * gocl_stream_run_sync:
+ * @self: The #GoclStream
+ * @read_func: (scope call): The #GoclStreamReadFunc that provides the input
+ * @write_func: (scope call) (allow-none): The #GoclStreamWriteFunc that
+ * receives the output, or %NULL to discard it
+ * @user_data: (closure): User data passed to @read_func and @write_func
+ *
+ * Processes all the input provided by @read_func, and blocks until the
+ * output of the last chunk has been delivered to @write_func. While the
+ * callbacks run, the device keeps processing the other chunks in flight.
+ *
+ * Returns: %TRUE on success, %FALSE on error or if processing was aborted by
+ * any of the callbacks
+ **/
+gboolean
+gocl_stream_run_sync (GoclStream          *self,
+                      GoclStreamReadFunc   read_func,
+                      GoclStreamWriteFunc  write_func,
+                      gpointer             user_data)
+{
+  g_return_val_if_fail (GOCL_IS_STREAM (self), FALSE);
+  g_return_val_if_fail (read_func != NULL, FALSE);
+
+  return run (self, read_func, user_data, write_func, user_data);
+}
+
+/**
+ * gocl_stream_run_from_input_stream_sync:
+ * @self: The #GoclStream
+ * @input_stream: The #GInputStream to read the input from
+ * @cancellable: (allow-none): A #GCancellable to abort reading, or %NULL
+ * @write_func: (scope call) (allow-none): The #GoclStreamWriteFunc that
+ * receives the output, or %NULL to discard it
+ * @user_data: (closure): User data passed to @write_func
+ *
+ * Processes all the data read from @input_stream until its end, and blocks
+ * until the output of the last chunk has been delivered to @write_func. If
+ * reading fails, the I/O error can be retrieved with gocl_error_get_last().
+ *
+ * Returns: %TRUE on success, %FALSE on error or if processing was aborted
+ **/
+gboolean
+gocl_stream_run_from_input_stream_sync (GoclStream          *self,
+                                        GInputStream        *input_stream,
+                                        GCancellable        *cancellable,
+                                        GoclStreamWriteFunc  write_func,
+                                        gpointer             user_data)
+{
+  InputStreamClosure closure;
+
+  g_return_val_if_fail (GOCL_IS_STREAM (self), FALSE);
+  g_return_val_if_fail (G_IS_INPUT_STREAM (input_stream), FALSE);
+
+  closure.input_stream = input_stream;
+  closure.cancellable = cancellable;
+
+  return run (self, read_input_stream, &closure, write_func, user_data);
+}
@@ -0,0 +1,95 @@
+/*
+ * gocl-stream.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+#ifndef __GOCL_STREAM_H__
+#define __GOCL_STREAM_H__
+
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#include "gocl-device.h"
+#include "gocl-kernel.h"
+
+G_BEGIN_DECLS
+
+#define GOCL_TYPE_STREAM              (gocl_stream_get_type ())
+#define GOCL_STREAM(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GOCL_TYPE_STREAM, GoclStream))
+#define GOCL_STREAM_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GOCL_TYPE_STREAM, GoclStreamClass))
+#define GOCL_IS_STREAM(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GOCL_TYPE_STREAM))
+#define GOCL_IS_STREAM_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GOCL_TYPE_STREAM))
+#define GOCL_STREAM_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GOCL_TYPE_STREAM, GoclStreamClass))
+
+typedef struct _GoclStreamClass GoclStreamClass;
+typedef struct _GoclStream GoclStream;
+typedef struct _GoclStreamPrivate GoclStreamPrivate;
+
+struct _GoclStream
+{
+  GObject parent_instance;
+
+  GoclStreamPrivate *priv;
+};
+
+struct _GoclStreamClass
+{
+  GObjectClass parent_class;
+};
+
+typedef gssize   (* GoclStreamReadFunc)  (GoclStream    *self,
+                                          gpointer       buffer,
+                                          gsize          size,
+                                          gpointer       user_data);
+typedef gboolean (* GoclStreamWriteFunc) (GoclStream    *self,
+                                          gconstpointer  data,
+                                          gsize          size,
+                                          gpointer       user_data);
+
+GType                  gocl_stream_get_type                    (void) G_GNUC_CONST;
+
+GoclStream *           gocl_stream_new                         (GoclKernel *kernel,
+                                                                GoclDevice *device,
+                                                                gsize       chunk_size,
+                                                                guint       num_slots);
+
+GoclKernel *           gocl_stream_get_kernel                  (GoclStream *self);
+GoclDevice *           gocl_stream_get_device                  (GoclStream *self);
+gsize                  gocl_stream_get_chunk_size              (GoclStream *self);
+guint                  gocl_stream_get_num_slots               (GoclStream *self);
+
+void                   gocl_stream_set_element_size            (GoclStream *self,
+                                                                gsize       element_size);
+gsize                  gocl_stream_get_element_size            (GoclStream *self);
+
+guint64                gocl_stream_get_num_chunks              (GoclStream *self);
+
+gboolean               gocl_stream_run_sync                    (GoclStream          *self,
+                                                                GoclStreamReadFunc   read_func,
+                                                                GoclStreamWriteFunc  write_func,
+                                                                gpointer             user_data);
+gboolean               gocl_stream_run_from_input_stream_sync  (GoclStream          *self,
+                                                                GInputStream        *input_stream,
+                                                                GCancellable        *cancellable,
+                                                                GoclStreamWriteFunc  write_func,
+                                                                gpointer             user_data);
+
+G_END_DECLS
+
+#endif /* __GOCL_STREAM_H__ */
@@ -0,0 +1,485 @@
+/*
+ * gocl-trace.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+/**
+ * SECTION:gocl-trace
+ * @short_description: Continuous tracing of the library's activity
+ * @stability: Unstable
+ *
+ * Besides the per-command profile of a #GoclQueue, Gocl can record a
+ * continuous trace of what it does on the host: the time spent enqueuing
+ * kernels and buffer transfers, building programs and running kernels on
+ * the host, the time commands waited in their queue, the delay between
+ * the completion of an event and the delivery of its gocl_event_then()
+ * callbacks, and the number of live objects of each type.
+ *
+ * Tracing is built in unless Gocl is configured with
+ * <i>--disable-tracing</i>, and is inactive until gocl_trace_start() is
+ * called. While inactive, each trace point costs a single check of a
+ * global flag, so it can be left built in for production. Once started,
+ * records are written to a fixed-size ring buffer of the calling thread,
+ * without taking any lock, so the oldest records of a thread are
+ * overwritten when its buffer is full.
+ *
+ * The trace is exported with gocl_trace_save_sync(), in the JSON trace
+ * event format understood by <i>chrome://tracing</i> and the Perfetto UI.
+ * Spans are exported as complete events, and queue waits, callback delays
+ * and object counts as counters. Queue waits are only known for queues
+ * created with %GOCL_QUEUE_FLAGS_PROFILING.
+ **/
+
+#include "gocl-trace.h"
+
+#include "gocl-private.h"
+
+/* records kept per thread, a power of two */
+#define TRACE_BUFFER_SIZE 4096
+
+#define NUM_TRACE_OBJECTS (GOCL_TRACE_OBJECT_PROGRAM + 1)
+
+typedef enum
+{
+  TRACE_RECORD_SPAN,
+  TRACE_RECORD_COUNTER
+} TraceRecordType;
+
+typedef struct
+{
+  TraceRecordType type;
+  const gchar *category;
+  const gchar *name;
+
+  /* interned, so that it outlives the object it names */
+  const gchar *label;
+
+  /* microseconds of the monotonic clock */
+  gint64 time;
+
+  /* duration of spans, or value of counters */
+  gint64 value;
+} TraceRecord;
+
+typedef struct
+{
+  guint thread_id;
+  gboolean exited;
+
+  /* number of records ever written. Only the owner thread writes, and
+     readers only see records below this count */
+  guint head;
+  TraceRecord records[TRACE_BUFFER_SIZE];
+} TraceBuffer;
+
+gint gocl_trace_active = 0;
+
+#ifdef GOCL_ENABLE_TRACING
+
+static const gchar *object_names[NUM_TRACE_OBJECTS] = {
+  "GoclBuffer",
+  "GoclEvent",
+  "GoclKernel",
+  "GoclProgram"
+};
+
+static gint object_counts[NUM_TRACE_OBJECTS] = { 0, };
+
+static void           thread_exited                    (gpointer data);
+
+static GPrivate trace_buffer = G_PRIVATE_INIT (thread_exited);
+
+/* buffers of all threads, kept after the threads exit so that their
+   records can still be exported */
+G_LOCK_DEFINE_STATIC (trace_buffers);
+static GSList *trace_buffers = NULL;
+static guint num_trace_threads = 0;
+
+static void
+thread_exited (gpointer data)
+{
+  TraceBuffer *buffer = data;
+
+  G_LOCK (trace_buffers);
+  buffer->exited = TRUE;
+  G_UNLOCK (trace_buffers);
+}
+
+static TraceBuffer *
+get_thread_buffer (void)
+{
+  TraceBuffer *buffer;
+
+  buffer = g_private_get (&trace_buffer);
+  if (G_LIKELY (buffer != NULL))
+    return buffer;
+
+  buffer = g_new0 (TraceBuffer, 1);
+
+  G_LOCK (trace_buffers);
+  buffer->thread_id = ++num_trace_threads;
+  trace_buffers = g_slist_prepend (trace_buffers, buffer);
+  G_UNLOCK (trace_buffers);
+
+  g_private_set (&trace_buffer, buffer);
+
+  return buffer;
+}
+
+static void
+add_record (TraceRecordType  type,
+            const gchar     *category,
+            const gchar     *name,
+            const gchar     *label,
+            gint64           time,
+            gint64           value)
+{
+  TraceBuffer *buffer;
+  TraceRecord *record;
+  guint head;
+
+  buffer = get_thread_buffer ();
+
+  head = buffer->head;
+  record = &buffer->records[head & (TRACE_BUFFER_SIZE - 1)];
+
+  record->type = type;
+  record->category = category;
+  record->name = name;
+  record->label = label != NULL ? g_intern_string (label) : NULL;
+  record->time = time;
+  record->value = value;
+
+  /* publishes the record to readers */
+  g_atomic_int_set (&buffer->head, head + 1);
+}
+
+/**
+ * gocl_trace_add_span:
+ * @category: A static string with the category of the span
+ * @name: A static string with the name of the span
+ * @label: (allow-none): The object the span refers to, like a kernel name,
+ * or %NULL
+ * @start: The start of the span, from g_get_monotonic_time()
+ * @end: The end of the span, from g_get_monotonic_time()
+ *
+ * Records a span of activity in the trace of the calling thread. Use the
+ * GOCL_TRACE_BEGIN() and GOCL_TRACE_END() macros instead, which compile to
+ * nothing when tracing is not built in.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_trace_add_span (const gchar *category,
+                     const gchar *name,
+                     const gchar *label,
+                     gint64       start,
+                     gint64       end)
+{
+  add_record (TRACE_RECORD_SPAN, category, name, label, start, end - start);
+}
+
+/**
+ * gocl_trace_add_counter:
+ * @category: A static string with the category of the counter
+ * @name: A static string with the name of the counter
+ * @label: (allow-none): The series of the counter, like a kernel name, or
+ * %NULL
+ * @value: The current value of the counter
+ *
+ * Records the value of a counter in the trace of the calling thread. Use
+ * the GOCL_TRACE_COUNTER() macro instead, which compiles to nothing when
+ * tracing is not built in.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_trace_add_counter (const gchar *category,
+                        const gchar *name,
+                        const gchar *label,
+                        gint64       value)
+{
+  add_record (TRACE_RECORD_COUNTER,
+              category,
+              name,
+              label,
+              g_get_monotonic_time (),
+              value);
+}
+
+/**
+ * gocl_trace_object_changed:
+ * @type: The #GoclTraceObject type of the object
+ * @delta: 1 when an object is created, -1 when it is destroyed
+ *
+ * Updates the count of live objects of @type, and records it if tracing
+ * is active. Use the GOCL_TRACE_OBJECT_NEW() and GOCL_TRACE_OBJECT_FREE()
+ * macros instead, which compile to nothing when tracing is not built in.
+ *
+ * This is a Gocl private function, not exposed to applications.
+ **/
+void
+gocl_trace_object_changed (GoclTraceObject type, gint delta)
+{
+  gint value;
+
+  value = g_atomic_int_add (&object_counts[type], delta) + delta;
+
+  if (GOCL_TRACE_ACTIVE ())
+    gocl_trace_add_counter ("objects", object_names[type], NULL, value);
+}
+
+static void
+append_json_string (GString *str, const gchar *value)
+{
+  const gchar *p;
+
+  g_string_append_c (str, '"');
+
+  for (p = value; *p != '\0'; p++)
+    {
+      if (*p == '"' || *p == '\\')
+        g_string_append_printf (str, "\\%c", *p);
+      else if ((guchar) *p < 0x20)
+        g_string_append_printf (str, "\\u%04x", (guint) *p);
+      else
+        g_string_append_c (str, *p);
+    }
+
+  g_string_append_c (str, '"');
+}
+
+static void
+append_record (GString           *str,
+               const TraceRecord *record,
+               guint              thread_id)
+{
+  g_string_append (str, "{\"name\":");
+  append_json_string (str, record->name);
+  g_string_append (str, ",\"cat\":");
+  append_json_string (str, record->category);
+
+  g_string_append_printf (str,
+                          ",\"ph\":\"%s\",\"ts\":%" G_GINT64_FORMAT
+                          ",\"pid\":1,\"tid\":%u",
+                          record->type == TRACE_RECORD_SPAN ? "X" : "C",
+                          record->time,
+                          thread_id);
+
+  if (record->type == TRACE_RECORD_SPAN)
+    {
+      g_string_append_printf (str,
+                              ",\"dur\":%" G_GINT64_FORMAT,
+                              record->value);
+
+      if (record->label != NULL)
+        {
+          g_string_append (str, ",\"args\":{\"label\":");
+          append_json_string (str, record->label);
+          g_string_append_c (str, '}');
+        }
+    }
+  else
+    {
+      /* each label is a series of the counter */
+      g_string_append (str, ",\"args\":{");
+      append_json_string (str,
+                          record->label != NULL ? record->label : "value");
+      g_string_append_printf (str, ":%" G_GINT64_FORMAT "}", record->value);
+    }
+
+  g_string_append_c (str, '}');
+}
+
+static GString *
+export_json (void)
+{
+  GString *str;
+  GSList *node;
+  gboolean first = TRUE;
+
+  str = g_string_new ("{\"traceEvents\":[\n");
+
+  G_LOCK (trace_buffers);
+
+  for (node = trace_buffers; node != NULL; node = node->next)
+    {
+      TraceBuffer *buffer = node->data;
+      guint head;
+      guint i;
+
+      head = g_atomic_int_get (&buffer->head);
+      i = head > TRACE_BUFFER_SIZE ? head - TRACE_BUFFER_SIZE : 0;
+
+      for (; i < head; i++)
+        {
+          if (! first)
+            g_string_append (str, ",\n");
+          first = FALSE;
+
+          append_record (str,
+                         &buffer->records[i & (TRACE_BUFFER_SIZE - 1)],
+                         buffer->thread_id);
+        }
+    }
+
+  G_UNLOCK (trace_buffers);
+
+  g_string_append (str, "\n]}\n");
+
+  return str;
+}
+
+#endif /* GOCL_ENABLE_TRACING */
+
+/* public */
+
+/**
+ * gocl_trace_start:
+ *
+ * Starts recording the activity of Gocl in all threads. Does nothing if
+ * tracing was not built in.
+ **/
+void
+gocl_trace_start (void)
+{
+#ifdef GOCL_ENABLE_TRACING
+  g_atomic_int_set (&gocl_trace_active, 1);
+#endif
+}
+
+/**
+ * gocl_trace_stop:
+ *
+ * Stops recording the activity of Gocl. The records gathered so far are
+ * kept, to be exported with gocl_trace_save_sync().
+ **/
+void
+gocl_trace_stop (void)
+{
+  g_atomic_int_set (&gocl_trace_active, 0);
+}
+
+/**
+ * gocl_trace_is_active:
+ *
+ * Retrieves whether the activity of Gocl is being recorded. See
+ * gocl_trace_start().
+ *
+ * Returns: %TRUE if tracing is active, %FALSE otherwise
+ **/
+gboolean
+gocl_trace_is_active (void)
+{
+  return GOCL_TRACE_ACTIVE ();
+}
+
+/**
+ * gocl_trace_clear:
+ *
+ * Discards all the records gathered so far. This must only be called while
+ * tracing is stopped, since threads write their records without locking.
+ **/
+void
+gocl_trace_clear (void)
+{
+#ifdef GOCL_ENABLE_TRACING
+  GSList *node;
+
+  g_return_if_fail (! GOCL_TRACE_ACTIVE ());
+
+  G_LOCK (trace_buffers);
+
+  node = trace_buffers;
+  while (node != NULL)
+    {
+      TraceBuffer *buffer = node->data;
+      GSList *next = node->next;
+
+      /* buffers of exited threads are no longer needed */
+      if (buffer->exited)
+        {
+          trace_buffers = g_slist_delete_link (trace_buffers, node);
+          g_free (buffer);
+        }
+      else
+        {
+          g_atomic_int_set (&buffer->head, 0);
+        }
+
+      node = next;
+    }
+
+  G_UNLOCK (trace_buffers);
+#endif
+}
+
+/**
+ * gocl_trace_save_sync:
+ * @filename: The path of the file to write the trace to
+ * @error: (allow-none): Return location for a #GError, or %NULL
+ *
+ * Writes the records gathered so far to @filename, in the JSON trace event
+ * format. Only the last 4096 records of each thread are kept. The trace can be saved while tracing is active, but
+ * records written concurrently may then be inconsistent, so stopping the
+ * trace first with gocl_trace_stop() is recommended. If tracing was not
+ * built in, an empty trace is written.
+ *
+ * Returns: %TRUE on success, %FALSE on error
+ **/
+gboolean
+gocl_trace_save_sync (const gchar *filename, GError **error)
+{
+  gboolean result;
+  GString *str;
+
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+#ifdef GOCL_ENABLE_TRACING
+  str = export_json ();
+#else
+  str = g_string_new ("{\"traceEvents\":[]}\n");
+#endif
+
+  result = g_file_set_contents (filename, str->str, str->len, error);
+  g_string_free (str, TRUE);
+
+  return result;
+}
+
+/**
+ * gocl_trace_get_num_objects:
+ * @type: A #GoclTraceObject type
+ *
+ * Retrieves the number of live objects of @type. Objects are counted
+ * whether tracing is active or not, as long as tracing was built in.
+ *
+ * Returns: The number of live objects, or 0 if tracing was not built in
+ **/
+guint
+gocl_trace_get_num_objects (GoclTraceObject type)
+{
+  g_return_val_if_fail (type < NUM_TRACE_OBJECTS, 0);
+
+#ifdef GOCL_ENABLE_TRACING
+  return (guint) g_atomic_int_get (&object_counts[type]);
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,43 @@
+/*
+ * gocl-trace.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2012-2013 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License at http://www.gnu.org/licenses/lgpl-3.0.txt
+ * for more details.
+ */
+
+#ifndef __GOCL_TRACE_H__
+#define __GOCL_TRACE_H__
+
+#include <glib.h>
+
+#include "gocl-decls.h"
+
+G_BEGIN_DECLS
+
+void                   gocl_trace_start                        (void);
+void                   gocl_trace_stop                         (void);
+gboolean               gocl_trace_is_active                    (void);
+void                   gocl_trace_clear                        (void);
+
+gboolean               gocl_trace_save_sync                    (const gchar  *filename,
+                                                                GError      **error);
+
+guint                  gocl_trace_get_num_objects              (GoclTraceObject type);
+
+G_END_DECLS
+
+#endif /* __GOCL_TRACE_H__ */
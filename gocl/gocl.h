@@ -27,10 +27,16 @@
 #include "gocl-context.h"
 #include "gocl-device.h"
 #include "gocl-buffer.h"
+#include "gocl-buffer-pool.h"
 #include "gocl-program.h"
 #include "gocl-kernel.h"
+#include "gocl-launch.h"
 #include "gocl-queue.h"
+#include "gocl-command-list.h"
+#include "gocl-graph.h"
+#include "gocl-stream.h"
 #include "gocl-image.h"
+#include "gocl-trace.h"
 
 G_BEGIN_DECLS
 
@@ -0,0 +1,199 @@
+/*
+ * test-common.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2014 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+#include <glib/gstdio.h>
+
+#include "test-common.h"
+
+static const gchar *test_name = NULL;
+
+static gchar *cache_dir = NULL;
+
+static GoclContext *context = NULL;
+static GoclDevice *device = NULL;
+
+static GMainLoop *wait_loop = NULL;
+static GError *wait_error = NULL;
+
+static gboolean skipped = FALSE;
+static gboolean failed = FALSE;
+
+static void
+remove_dir (const gchar *path)
+{
+  GDir *dir;
+  const gchar *name;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir != NULL)
+    {
+      while ((name = g_dir_read_name (dir)) != NULL)
+        {
+          gchar *child;
+
+          child = g_build_filename (path, name, NULL);
+          if (g_file_test (child, G_FILE_TEST_IS_DIR))
+            remove_dir (child);
+          else
+            g_unlink (child);
+          g_free (child);
+        }
+      g_dir_close (dir);
+    }
+
+  g_rmdir (path);
+}
+
+static void
+on_event_complete (GoclEvent *event,
+                   GError    *error,
+                   gpointer   user_data)
+{
+  if (error != NULL)
+    wait_error = g_error_copy (error);
+
+  g_main_loop_quit (wait_loop);
+}
+
+/* Points the Gocl cache to a fresh temporary directory, so that tests never
+ * see the data of earlier runs, and sets up the context and device the test
+ * runs on, trying the GPU first and then the CPU. Returns FALSE if there is
+ * no OpenCL device, in which case the test is skipped.
+ */
+gboolean
+test_init (const gchar *name)
+{
+  GError *error = NULL;
+
+  test_name = name;
+
+  /* must happen before anything asks GLib for the user cache dir */
+  cache_dir = g_dir_make_tmp ("gocl-test-XXXXXX", &error);
+  if (cache_dir == NULL)
+    {
+      g_printerr ("%s: %s\n", test_name, error->message);
+      g_error_free (error);
+      failed = TRUE;
+      return FALSE;
+    }
+  g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
+#ifndef GLIB_VERSION_2_36
+  g_type_init ();
+#endif
+
+  context = gocl_context_get_default_gpu_sync ();
+  if (context == NULL)
+    context = gocl_context_get_default_cpu_sync ();
+
+  if (context == NULL || gocl_context_get_num_devices (context) == 0)
+    {
+      g_print ("%s: no OpenCL device, skipping\n", test_name);
+      skipped = TRUE;
+      return FALSE;
+    }
+
+  device = gocl_context_get_device_by_index (context, 0);
+
+  return TRUE;
+}
+
+/* Frees the resources taken by test_init() and returns the exit code for
+ * main().
+ */
+gint
+test_finish (void)
+{
+  if (wait_loop != NULL)
+    g_main_loop_unref (wait_loop);
+  wait_loop = NULL;
+
+  if (device != NULL)
+    g_object_unref (device);
+  device = NULL;
+
+  if (context != NULL)
+    g_object_unref (context);
+  context = NULL;
+
+  if (cache_dir != NULL)
+    remove_dir (cache_dir);
+  g_free (cache_dir);
+  cache_dir = NULL;
+
+  if (failed)
+    return 1;
+
+  return skipped ? TEST_EXIT_SKIP : 0;
+}
+
+GoclContext *
+test_get_context (void)
+{
+  return context;
+}
+
+GoclDevice *
+test_get_device (void)
+{
+  return device;
+}
+
+/* Runs a main loop until EVENT triggers. Returns FALSE and records a
+ * failure if the command could not be enqueued or failed.
+ */
+gboolean
+test_wait_event (GoclEvent *event)
+{
+  if (! test_check (event != NULL, "enqueue command"))
+    return FALSE;
+
+  if (wait_loop == NULL)
+    wait_loop = g_main_loop_new (NULL, FALSE);
+
+  gocl_event_then (event, on_event_complete, NULL);
+  g_main_loop_run (wait_loop);
+
+  if (wait_error != NULL)
+    {
+      g_printerr ("%s: command failed: %s\n", test_name, wait_error->message);
+      g_error_free (wait_error);
+      wait_error = NULL;
+      failed = TRUE;
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/* Records a failure if CONDITION is FALSE, printing WHAT and the last Gocl
+ * error, if any. Returns CONDITION.
+ */
+gboolean
+test_check (gboolean condition, const gchar *what)
+{
+  GError *error;
+
+  if (condition)
+    return TRUE;
+
+  error = gocl_error_get_last ();
+  g_printerr ("%s: %s failed%s%s\n",
+              test_name,
+              what,
+              error != NULL ? ": " : "",
+              error != NULL ? error->message : "");
+  if (error != NULL)
+    g_error_free (error);
+
+  failed = TRUE;
+
+  return FALSE;
+}
@@ -0,0 +1,34 @@
+/*
+ * test-common.h
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2014 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+#ifndef __TEST_COMMON_H__
+#define __TEST_COMMON_H__
+
+#include <gocl.h>
+
+G_BEGIN_DECLS
+
+/* exit code that tells automake a test was skipped */
+#define TEST_EXIT_SKIP 77
+
+gboolean      test_init                  (const gchar *name);
+gint          test_finish                (void);
+
+GoclContext * test_get_context           (void);
+GoclDevice *  test_get_device            (void);
+
+gboolean      test_wait_event            (GoclEvent *event);
+
+gboolean      test_check                 (gboolean     condition,
+                                          const gchar *what);
+
+G_END_DECLS
+
+#endif /* __TEST_COMMON_H__ */
@@ -0,0 +1,117 @@
+/*
+ * test-host-buffer.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2014 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Runs a host kernel that writes into a buffer argument, and checks that
+ * the device sees what it wrote, for both blocking and asynchronous runs.
+ */
+
+#include "test-common.h"
+
+#define NUM_ITEMS 4096
+
+static void
+fill_on_host (GoclKernel          *kernel,
+              guint                work_dim,
+              const gsize         *offset,
+              const gsize         *size,
+              const gconstpointer *args,
+              gpointer             user_data)
+{
+  guint32 *out = (guint32 *) args[0];
+  guint32 value = *(const guint32 *) args[1];
+  gsize i;
+
+  for (i = offset[0]; i < offset[0] + size[0]; i++)
+    out[i] = value + (guint32) i;
+}
+
+static gboolean
+check_buffer (GoclBuffer *buffer, guint32 value)
+{
+  guint32 *data;
+  gboolean result = TRUE;
+  guint i;
+
+  data = g_new0 (guint32, NUM_ITEMS);
+
+  if (! test_check (gocl_buffer_read_sync (buffer,
+                                           gocl_device_get_default_queue (test_get_device ()),
+                                           data,
+                                           sizeof (guint32) * NUM_ITEMS,
+                                           0,
+                                           NULL),
+                    "read buffer"))
+    {
+      g_free (data);
+      return FALSE;
+    }
+
+  for (i = 0; i < NUM_ITEMS && result; i++)
+    result = test_check (data[i] == value + i, "check result");
+
+  g_free (data);
+
+  return result;
+}
+
+static gboolean
+run (GoclKernel *kernel, GoclBuffer *buffer, guint32 value, gboolean sync)
+{
+  if (! test_check (gocl_kernel_set_argument_buffer (kernel, 0, buffer),
+                    "set buffer argument")
+      || ! test_check (gocl_kernel_set_argument (kernel,
+                                                 1,
+                                                 sizeof (value),
+                                                 (const gpointer *) &value),
+                       "set value argument"))
+    return FALSE;
+
+  if (sync)
+    {
+      if (! test_check (gocl_kernel_run_on_host_sync (kernel, NULL),
+                        "run on host"))
+        return FALSE;
+    }
+  else
+    {
+      if (! test_wait_event (gocl_kernel_run_on_host (kernel, NULL)))
+        return FALSE;
+    }
+
+  return check_buffer (buffer, value);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  GoclKernel *kernel;
+  GoclBuffer *buffer;
+
+  if (! test_init ("test-host-buffer"))
+    return test_finish ();
+
+  kernel = gocl_kernel_new_host ("fill", 2, fill_on_host, NULL, NULL);
+  gocl_kernel_set_global_work_size (kernel, NUM_ITEMS, 0, 0);
+
+  buffer = gocl_buffer_new (test_get_context (),
+                            GOCL_BUFFER_FLAGS_READ_WRITE,
+                            sizeof (guint32) * NUM_ITEMS,
+                            NULL);
+
+  if (test_check (buffer != NULL, "create buffer")
+      && run (kernel, buffer, 1000, TRUE))
+    run (kernel, buffer, 2000, FALSE);
+
+  if (buffer != NULL)
+    g_object_unref (buffer);
+  g_object_unref (kernel);
+
+  return test_finish ();
+}
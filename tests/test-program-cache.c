@@ -0,0 +1,128 @@
+/*
+ * test-program-cache.c
+ *
+ * Gocl - GLib/GObject wrapper for OpenCL
+ * Copyright (C) 2014 Igalia S.L.
+ *
+ * Authors:
+ *  Eduardo Lima Mitev <elima@igalia.com>
+ */
+
+/* Builds a program with the binary cache enabled, then builds it again so
+ * that it is loaded from the cache, and sets the kernel arguments by name on
+ * the cached program, which needs its kernel argument info.
+ */
+
+#include "test-common.h"
+
+#define NUM_ITEMS 64
+#define FILL_VALUE 0xC0FFEE
+
+static const gchar *source =
+  "__kernel void fill (__global uint *out, uint value)\n"
+  "{\n"
+  "  out[get_global_id (0)] = value;\n"
+  "}\n";
+
+static GoclProgram *
+build_program (void)
+{
+  GoclProgram *program;
+
+  program = gocl_program_new (test_get_context (), &source, 1);
+  if (! test_check (program != NULL, "create program"))
+    return NULL;
+
+  gocl_program_set_use_cache (program, TRUE);
+  if (! test_check (gocl_program_build_sync (program, NULL), "build program"))
+    {
+      g_object_unref (program);
+      return NULL;
+    }
+
+  return program;
+}
+
+static void
+run_cached_by_name (void)
+{
+  GoclProgram *program;
+  GoclKernel *kernel = NULL;
+  GoclBuffer *buffer = NULL;
+  guint32 value = FILL_VALUE;
+  guint32 data[NUM_ITEMS] = { 0, };
+  guint i;
+
+  /* the first build fills the cache, the second one loads from it */
+  program = build_program ();
+  if (program == NULL)
+    return;
+  g_object_unref (program);
+
+  program = build_program ();
+  if (program == NULL)
+    return;
+
+  kernel = gocl_program_get_kernel (program, "fill");
+  if (! test_check (kernel != NULL, "get kernel"))
+    goto out;
+
+  buffer = gocl_buffer_new (test_get_context (),
+                            GOCL_BUFFER_FLAGS_READ_WRITE,
+                            sizeof (data),
+                            NULL);
+  if (! test_check (buffer != NULL, "create buffer"))
+    goto out;
+
+  if (! test_check (gocl_kernel_get_argument_index (kernel, "value") == 1,
+                    "find argument by name"))
+    goto out;
+
+  if (! test_check (gocl_kernel_set_argument_buffer_by_name (kernel,
+                                                             "out",
+                                                             buffer),
+                    "set buffer argument by name")
+      || ! test_check (gocl_kernel_set_argument_by_name (kernel,
+                                                         "value",
+                                                         sizeof (value),
+                                                         (const gpointer *) &value),
+                       "set argument by name"))
+    goto out;
+
+  gocl_kernel_set_global_work_size (kernel, NUM_ITEMS, 0, 0);
+
+  if (! test_check (gocl_kernel_run_in_device_sync (kernel,
+                                                    test_get_device (),
+                                                    NULL),
+                    "run kernel"))
+    goto out;
+
+  if (! test_check (gocl_buffer_read_sync (buffer,
+                                           gocl_device_get_default_queue (test_get_device ()),
+                                           data,
+                                           sizeof (data),
+                                           0,
+                                           NULL),
+                    "read buffer"))
+    goto out;
+
+  for (i = 0; i < NUM_ITEMS; i++)
+    if (! test_check (data[i] == FILL_VALUE, "check result"))
+      break;
+
+ out:
+  if (buffer != NULL)
+    g_object_unref (buffer);
+  if (kernel != NULL)
+    g_object_unref (kernel);
+  g_object_unref (program);
+}
+
+gint
+main (gint argc, gchar *argv[])
+{
+  if (test_init ("test-program-cache"))
+    run_cached_by_name ();
+
+  return test_finish ();
+}